@@ -4,6 +4,10 @@
 
 #include "chibi/eval.h"
 
+#if SEXP_USE_PROFILE_LOAD
+#include <sys/time.h>
+#endif
+
 #if SEXP_USE_DEBUG_VM || SEXP_USE_PROFILE_VM || SEXP_USE_STATIC_LIBS
 #include "opt/opcode_names.h"
 #endif
@@ -14,6 +18,11 @@ static int scheme_initialized_p = 0;
 
 static sexp analyze (sexp ctx, sexp x, int depth, int defok);
 
+#if SEXP_USE_PROFILE_LOAD
+static double sexp_load_profile_expanded (void);
+static void sexp_load_profile_macro (sexp ctx, sexp name, double start);
+#endif
+
 #if SEXP_USE_MODULES
 sexp sexp_load_module_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp file, sexp env);
 sexp sexp_find_module_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp file);
@@ -79,9 +88,233 @@ sexp sexp_maybe_wrap_error (sexp ctx, sexp obj) {
 
 /********************** environment utilities ***************************/
 
-static sexp sexp_env_cell_loc1 (sexp env, sexp key, int localp, sexp *varenv) {
+#if SEXP_USE_HASH_ENVS
+
+/* Large frames carry an index of their binding and rename cells in */
+/* open-addressed tables keyed by the identifier.  The alists remain */
+/* the source of truth: the index records the list heads it covers */
+/* and catches up with cells pushed onto the front since then, and */
+/* anything that splices or unlinks cells mid-list bumps the global */
+/* epoch, since binding lists are shared between envs.  A stale index */
+/* is refilled in place on its next use, and only reallocated by the */
+/* next definition if it has outgrown its tables, so lookups remain  */
+/* allocation-free. */
+
+#define SEXP_ENV_INDEX_BINDINGS   0
+#define SEXP_ENV_INDEX_RENAMES    1
+#define SEXP_ENV_INDEX_EPOCH      2
+#define SEXP_ENV_INDEX_BTABLE     3
+#define SEXP_ENV_INDEX_BCOUNT     4
+#define SEXP_ENV_INDEX_RTABLE     5
+#define SEXP_ENV_INDEX_RCOUNT     6
+#define SEXP_ENV_INDEX_SIZE       7
+
+#define SEXP_ENV_INDEX_MAX_PENDING 16
+
+#define sexp_env_index_slot(idx, i) (sexp_vector_data(idx)[i])
+
+#if SEXP_USE_RENAME_BINDINGS
+#define sexp_env_index_renames(env) sexp_env_renames(env)
+#else
+#define sexp_env_index_renames(env) SEXP_NULL
+#endif
+
+/* hash the name rather than the address so images can relocate */
+static sexp_uint_t sexp_env_key_hash (sexp key) {
+  sexp_uint_t acc = 2166136261uL;
+  sexp_uint_t len;
+  char *str;
+  while (sexp_synclop(key))
+    key = sexp_synclo_expr(key);
+  if (sexp_lsymbolp(key)) {
+    for (str=sexp_lsymbol_data(key), len=sexp_lsymbol_length(key); len; len--)
+      acc = (acc * 16777619) ^ (unsigned char)*str++;
+  } else if (sexp_isymbolp(key)) {
+    acc ^= (sexp_uint_t)key;
+    acc *= 16777619;
+  }
+  return acc ^ (acc >> 15);
+}
+
+static sexp sexp_env_index_ref (sexp table, sexp key, sexp_uint_t hash) {
+  sexp_uint_t mask = sexp_vector_length(table) - 1, i = hash & mask;
+  sexp cell;
+  for ( ; sexp_pairp(cell=sexp_vector_data(table)[i]); i = (i+1) & mask)
+    if (sexp_car(cell) == key)
+      return cell;
+  return NULL;
+}
+
+/* returns 1 if the cell took a new slot */
+static int sexp_env_index_insert (sexp table, sexp cell, int overridep) {
+  sexp_uint_t mask = sexp_vector_length(table) - 1;
+  sexp_uint_t i = sexp_env_key_hash(sexp_car(cell)) & mask;
+  sexp x;
+  for ( ; sexp_pairp(x=sexp_vector_data(table)[i]); i = (i+1) & mask)
+    if (sexp_car(x) == sexp_car(cell)) {
+      if (overridep) sexp_vector_data(table)[i] = cell;
+      return 0;
+    }
+  sexp_vector_data(table)[i] = cell;
+  return 1;
+}
+
+/* add cells consed onto the front of ls since the index was built */
+static int sexp_env_index_catch_up (sexp idx, int head, int table, int count, sexp ls) {
+  sexp pending[SEXP_ENV_INDEX_MAX_PENDING];
+  sexp_sint_t k = 0, n;
+  for ( ; ls != sexp_env_index_slot(idx, head); ls=sexp_env_next_cell(ls)) {
+    if (!sexp_pairp(ls) || k >= SEXP_ENV_INDEX_MAX_PENDING)
+      return 0;
+    pending[k++] = ls;
+  }
+  if (k == 0)
+    return 1;
+  n = sexp_unbox_fixnum(sexp_env_index_slot(idx, count));
+  if ((sexp_uint_t)(n + k) * 2 > sexp_vector_length(sexp_env_index_slot(idx, table)))
+    return 0;
+  sexp_env_index_slot(idx, head) = pending[0];
+  while (k-- > 0)               /* oldest first, so newer cells shadow */
+    if (sexp_car(pending[k]) != SEXP_FALSE)
+      n += sexp_env_index_insert(sexp_env_index_slot(idx, table), pending[k], 1);
+  sexp_env_index_slot(idx, count) = sexp_make_fixnum(n);
+  return 1;
+}
+
+static sexp_uint_t sexp_env_index_table_size (sexp_uint_t n) {
+  sexp_uint_t size = 8;
+  while (size < n * 4) size <<= 1;
+  return size;
+}
+
+static sexp sexp_env_index_fill (sexp table, sexp ls) {
+  sexp_sint_t n = 0;
+  for ( ; sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+    if (sexp_car(ls) != SEXP_FALSE)
+      n += sexp_env_index_insert(table, ls, 0);
+  return sexp_make_fixnum(n);
+}
+
+/* rebuild a stale index in its existing tables if they're big enough, */
+/* otherwise drop it until the next definition */
+static int sexp_env_index_refill (sexp ctx, sexp env, sexp idx) {
+  sexp ls, btable = sexp_env_index_slot(idx, SEXP_ENV_INDEX_BTABLE),
+    rtable = sexp_env_index_slot(idx, SEXP_ENV_INDEX_RTABLE);
+  sexp_uint_t i, nb = 0, nr = 0;
+  for (ls=sexp_env_bindings(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+    nb++;
+  for (ls=sexp_env_index_renames(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+    nr++;
+  if (nb * 2 > sexp_vector_length(btable) || nr * 2 > sexp_vector_length(rtable)) {
+    sexp_env_index(env) = NULL;
+    return 0;
+  }
+  for (i=0; i<sexp_vector_length(btable); i++)
+    sexp_vector_data(btable)[i] = SEXP_FALSE;
+  for (i=0; i<sexp_vector_length(rtable); i++)
+    sexp_vector_data(rtable)[i] = SEXP_FALSE;
+  sexp_env_index_slot(idx, SEXP_ENV_INDEX_BCOUNT)
+    = sexp_env_index_fill(btable, sexp_env_bindings(env));
+  sexp_env_index_slot(idx, SEXP_ENV_INDEX_RCOUNT)
+    = sexp_env_index_fill(rtable, sexp_env_index_renames(env));
+  sexp_env_index_slot(idx, SEXP_ENV_INDEX_BINDINGS) = sexp_env_bindings(env);
+  sexp_env_index_slot(idx, SEXP_ENV_INDEX_RENAMES) = sexp_env_index_renames(env);
+  sexp_env_index_slot(idx, SEXP_ENV_INDEX_EPOCH) = sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH);
+  return 1;
+}
+
+/* bring env's index up to date, returning 0 if it can't be used */
+static int sexp_env_index_sync (sexp ctx, sexp env) {
+  sexp idx = sexp_env_index(env);
+  if (!idx || !sexp_vectorp(idx))
+    return 0;
+  if (sexp_env_index_slot(idx, SEXP_ENV_INDEX_EPOCH)
+      != sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH))
+    return sexp_env_index_refill(ctx, env, idx);
+  return (sexp_env_index_catch_up(idx, SEXP_ENV_INDEX_BINDINGS,
+                                  SEXP_ENV_INDEX_BTABLE, SEXP_ENV_INDEX_BCOUNT,
+                                  sexp_env_bindings(env))
+          && sexp_env_index_catch_up(idx, SEXP_ENV_INDEX_RENAMES,
+                                     SEXP_ENV_INDEX_RTABLE, SEXP_ENV_INDEX_RCOUNT,
+                                     sexp_env_index_renames(env)))
+    || sexp_env_index_refill(ctx, env, idx);
+}
+
+/* called after adding to env: index it once it's large enough */
+static void sexp_env_index_update (sexp ctx, sexp env) {
+  sexp ls;
+  sexp_uint_t nb = 0, nr = 0;
+  sexp_gc_var2(idx, table);
+  if (sexp_env_index_sync(ctx, env))
+    return;
+  for (ls=sexp_env_bindings(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+    nb++;
+  for (ls=sexp_env_index_renames(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+    nr++;
+  if (nb + nr < SEXP_ENV_HASH_THRESHOLD) {
+    sexp_env_index(env) = NULL;
+    return;
+  }
+  sexp_gc_preserve2(ctx, idx, table);
+  idx = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_ENV_INDEX_SIZE), SEXP_FALSE);
+  if (!sexp_exceptionp(idx)) {
+    table = sexp_make_vector(ctx, sexp_make_fixnum(sexp_env_index_table_size(nb)), SEXP_FALSE);
+    if (!sexp_exceptionp(table)) {
+      sexp_env_index_slot(idx, SEXP_ENV_INDEX_BTABLE) = table;
+      table = sexp_make_vector(ctx, sexp_make_fixnum(sexp_env_index_table_size(nr)), SEXP_FALSE);
+    }
+    if (!sexp_exceptionp(table)) {
+      sexp_env_index_slot(idx, SEXP_ENV_INDEX_RTABLE) = table;
+      sexp_env_index_slot(idx, SEXP_ENV_INDEX_BCOUNT)
+        = sexp_env_index_fill(sexp_env_index_slot(idx, SEXP_ENV_INDEX_BTABLE),
+                              sexp_env_bindings(env));
+      sexp_env_index_slot(idx, SEXP_ENV_INDEX_RCOUNT)
+        = sexp_env_index_fill(table, sexp_env_index_renames(env));
+      sexp_env_index_slot(idx, SEXP_ENV_INDEX_BINDINGS) = sexp_env_bindings(env);
+      sexp_env_index_slot(idx, SEXP_ENV_INDEX_RENAMES) = sexp_env_index_renames(env);
+      sexp_env_index_slot(idx, SEXP_ENV_INDEX_EPOCH)
+        = sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH);
+      sexp_env_index(env) = idx;
+    }
+  }
+  sexp_gc_release2(ctx);
+}
+
+static void sexp_env_index_invalidate (sexp ctx) {
+  sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH)
+    = sexp_make_fixnum(sexp_unbox_fixnum(sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH)) + 1);
+}
+
+#else
+#define sexp_env_index_update(ctx, env)
+#define sexp_env_index_invalidate(ctx)
+#endif
+
+static sexp sexp_env_cell_loc1 (sexp ctx, sexp env, sexp key, int localp, sexp *varenv) {
   sexp ls;
+#if SEXP_USE_HASH_ENVS
+  sexp_uint_t hash = 0;
+  int hashedp = 0;
+#endif
   do {
+#if SEXP_USE_HASH_ENVS
+    if (sexp_env_index(env) && sexp_env_index_sync(ctx, env)) {
+      if (!hashedp) {
+        hash = sexp_env_key_hash(key);
+        hashedp = 1;
+      }
+      ls = sexp_env_index_ref(sexp_env_index_slot(sexp_env_index(env), SEXP_ENV_INDEX_RTABLE), key, hash);
+      if (ls) {
+        if (varenv) *varenv = env;
+        return sexp_cdr(ls);
+      }
+      ls = sexp_env_index_ref(sexp_env_index_slot(sexp_env_index(env), SEXP_ENV_INDEX_BTABLE), key, hash);
+      if (ls) {
+        if (varenv) *varenv = env;
+        return ls;
+      }
+    } else {
+#endif
 #if SEXP_USE_RENAME_BINDINGS
     for (ls=sexp_env_renames(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
       if (sexp_car(ls) == key) {
@@ -94,6 +327,9 @@ static sexp sexp_env_cell_loc1 (sexp env, sexp key, int localp, sexp *varenv) {
         if (varenv) *varenv = env;
         return ls;
       }
+#if SEXP_USE_HASH_ENVS
+    }
+#endif
     if (localp) break;
     env = sexp_env_parent(env);
   } while (env && sexp_envp(env));
@@ -107,12 +343,12 @@ static sexp sexp_env_cell_loc (sexp ctx, sexp env, sexp key, int localp, sexp *v
       env = sexp_car(ls);
       break;
     }
-  cell = sexp_env_cell_loc1(env, key, localp, varenv);
+  cell = sexp_env_cell_loc1(ctx, env, key, localp, varenv);
   while (!cell && key && sexp_synclop(key)) {
     if (!sexp_pairp(ls) && sexp_not(sexp_memq(ctx, sexp_synclo_expr(key), sexp_synclo_free_vars(key))))
       env = sexp_synclo_env(key);
     key = sexp_synclo_expr(key);
-    cell = sexp_env_cell_loc1(env, key, localp, varenv);
+    cell = sexp_env_cell_loc1(ctx, env, key, localp, varenv);
   }
   return cell;
 }
@@ -121,6 +357,71 @@ sexp sexp_env_cell (sexp ctx, sexp env, sexp key, int localp) {
   return sexp_env_cell_loc(ctx, env, key, localp, NULL);
 }
 
+#if SEXP_USE_LAZY_LOAD
+/* Lazily imported bindings are bound to #(tag thunk name cell), the */
+/* thunk loading the library and returning its env.  The real cell */
+/* is looked up there on the first reference and cached. */
+#define sexp_lazy_bindingp(ctx, x)                                      \
+  (sexp_vectorp(x) && sexp_vector_length(x) == 4                        \
+   && sexp_vector_ref(x, SEXP_ZERO) == sexp_global(ctx, SEXP_G_LAZY_BINDING_TAG))
+
+static sexp sexp_env_cell_force (sexp ctx, sexp cell) {
+  sexp lazy, tmp;
+  sexp_gc_var2(res, env);
+  if (!cell || !sexp_lazy_bindingp(ctx, sexp_cdr(cell)))
+    return cell;
+  sexp_gc_preserve2(ctx, res, env);
+  res = cell;
+  while (sexp_lazy_bindingp(ctx, lazy=sexp_cdr(res))) {
+    tmp = sexp_vector_ref(lazy, SEXP_THREE);
+    if (!sexp_pairp(tmp)) {
+      env = sexp_apply(ctx, sexp_vector_ref(lazy, SEXP_ONE), SEXP_NULL);
+      if (sexp_exceptionp(env)) {
+        res = env;
+        break;
+      }
+      tmp = sexp_envp(env) ? sexp_env_cell(ctx, env, sexp_vector_ref(lazy, SEXP_TWO), 0) : NULL;
+      if (!tmp || tmp == res) {
+        /* the library didn't define it after all */
+        sexp_cdr(res) = SEXP_UNDEF;
+        break;
+      }
+      sexp_vector_set(lazy, SEXP_THREE, tmp);
+    }
+    res = tmp;
+  }
+  sexp_gc_release2(ctx);
+  return res;
+}
+#else
+#define sexp_lazy_bindingp(ctx, x) 0
+#define sexp_env_cell_force(ctx, cell) (cell)
+#endif
+
+/* an env of lazy bindings for the names in ls, or #f if not in lazy mode */
+sexp sexp_make_lazy_env_op (sexp ctx, sexp self, sexp_sint_t n, sexp ls, sexp thunk) {
+#if SEXP_USE_LAZY_LOAD
+  sexp_gc_var3(env, lazy, tmp);
+  if (sexp_not(sexp_global(ctx, SEXP_G_LAZY_LOAD_P)))
+    return SEXP_FALSE;
+  sexp_assert_type(ctx, sexp_procedurep, SEXP_PROCEDURE, thunk);
+  sexp_gc_preserve3(ctx, env, lazy, tmp);
+  env = sexp_make_env(ctx);
+  for ( ; sexp_pairp(ls); ls=sexp_cdr(ls)) {
+    lazy = sexp_make_vector(ctx, SEXP_FOUR, SEXP_FALSE);
+    sexp_vector_set(lazy, SEXP_ZERO, sexp_global(ctx, SEXP_G_LAZY_BINDING_TAG));
+    sexp_vector_set(lazy, SEXP_ONE, thunk);
+    sexp_vector_set(lazy, SEXP_TWO, sexp_car(ls));
+    sexp_env_push(ctx, env, tmp, sexp_car(ls), lazy);
+  }
+  sexp_env_index_update(ctx, env);
+  sexp_gc_release3(ctx);
+  return env;
+#else
+  return SEXP_FALSE;
+#endif
+}
+
 static sexp sexp_env_undefine (sexp ctx, sexp env, sexp key) {
   sexp ls1=NULL, ls2;
   for (ls2=sexp_env_bindings(env); sexp_pairp(ls2);
@@ -128,6 +429,7 @@ static sexp sexp_env_undefine (sexp ctx, sexp env, sexp key) {
     if (sexp_car(ls2) == key) {
       if (ls1) sexp_env_next_cell(ls1) = sexp_env_next_cell(ls2);
       else sexp_env_bindings(env) = sexp_env_next_cell(ls2);
+      sexp_env_index_invalidate(ctx);
       return SEXP_TRUE;
     }
   return SEXP_FALSE;
@@ -139,6 +441,18 @@ sexp sexp_env_cell_define (sexp ctx, sexp env, sexp key,
   while (sexp_env_lambda(env) || sexp_env_syntactic_p(env))
     env = sexp_env_parent(env);
   if (varenv) *varenv = env;
+#if SEXP_USE_HASH_ENVS
+  if (sexp_env_index(env) && sexp_env_index_sync(ctx, env)) {
+    /* the index has the same first match as the scans below */
+    ls = sexp_env_index_ref(sexp_env_index_slot(sexp_env_index(env), SEXP_ENV_INDEX_RTABLE), key, sexp_env_key_hash(key));
+    if (ls) sexp_car(ls) = SEXP_FALSE;
+    ls = sexp_env_index_ref(sexp_env_index_slot(sexp_env_index(env), SEXP_ENV_INDEX_BTABLE), key, sexp_env_key_hash(key));
+    if (ls) {
+      sexp_cdr(ls) = value;
+      return ls;
+    }
+  } else {
+#endif
 #if SEXP_USE_RENAME_BINDINGS
   /* remove any existing renamed definition */
   for (ls=sexp_env_renames(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
@@ -152,8 +466,12 @@ sexp sexp_env_cell_define (sexp ctx, sexp env, sexp key,
       sexp_cdr(ls) = value;
       return ls;
     }
+#if SEXP_USE_HASH_ENVS
+  }
+#endif
   sexp_gc_preserve2(ctx, cell, ls);
   sexp_env_push(ctx, env, cell, key, value);
+  sexp_env_index_update(ctx, env);
   sexp_gc_release2(ctx);
   return cell;
 }
@@ -166,8 +484,8 @@ static sexp sexp_env_cell_create (sexp ctx, sexp env, sexp key,
 }
 
 sexp sexp_env_ref (sexp ctx, sexp env, sexp key, sexp dflt) {
-  sexp cell = sexp_env_cell(ctx, env, key, 0);
-  return (cell ? sexp_cdr(cell) : dflt);
+  sexp cell = sexp_env_cell_force(ctx, sexp_env_cell(ctx, env, key, 0));
+  return (cell ? sexp_exceptionp(cell) ? cell : sexp_cdr(cell) : dflt);
 }
 
 sexp sexp_env_define (sexp ctx, sexp env, sexp key, sexp value) {
@@ -179,11 +497,13 @@ sexp sexp_env_define (sexp ctx, sexp env, sexp key, sexp value) {
     while (sexp_env_syntactic_p(env) && sexp_env_parent(env))
       env = sexp_env_parent(env);
     sexp_env_push(ctx, env, tmp, key, value);
+    sexp_env_index_update(ctx, env);
   } else if (sexp_immutablep(cell)) {
     res = sexp_user_exception(ctx, NULL, "immutable binding", key);
   } else if (sexp_syntacticp(value) && !sexp_syntacticp(sexp_cdr(cell))) {
     sexp_env_undefine(ctx, env, key);
     sexp_env_push(ctx, env, tmp, key, value);
+    sexp_env_index_update(ctx, env);
   } else {
     sexp_cdr(cell) = value;
   }
@@ -194,6 +514,7 @@ sexp sexp_env_define (sexp ctx, sexp env, sexp key, sexp value) {
 sexp sexp_env_rename (sexp ctx, sexp env, sexp key, sexp value) {
   sexp tmp;
   sexp_env_push_rename(ctx, env, tmp, key, value);
+  sexp_env_index_update(ctx, env);
   return SEXP_VOID;
 }
 #endif
@@ -243,6 +564,9 @@ sexp sexp_extend_synclo_env (sexp ctx, sexp env) {
       sexp_env_syntactic_p(e2) = 1;
 #if SEXP_USE_RENAME_BINDINGS
       sexp_env_renames(e2) = sexp_env_renames(e1);
+#endif
+#if SEXP_USE_HASH_ENVS
+      sexp_env_index(e2) = sexp_env_index(e1);  /* valid while heads match */
 #endif
     }
     if (!e2) { return sexp_global(ctx, SEXP_G_OOM_ERROR); }
@@ -267,9 +591,104 @@ static sexp sexp_flatten_dot (sexp ctx, sexp ls) {
   return sexp_nreverse(ctx, sexp_reverse_flatten_dot(ctx, ls));
 }
 
-int sexp_param_index (sexp ctx, sexp lambda, sexp name) {
+/* Large lambdas record an index of their params, locals and free */
+/* vars, keyed on (name, loc), so that code generation can resolve */
+/* each reference without scanning the lists.  The index remembers */
+/* the lists it was built from and is ignored once they change.    */
+
+#define SEXP_LAMBDA_INDEX_MIN 16
+#define SEXP_LAMBDA_INDEX_HEADER 3
+
+static sexp_uint_t sexp_binding_hash (sexp name, sexp loc) {
+  sexp_uint_t h = ((sexp_uint_t)name >> 3) * 0x9E3779B1uL + ((sexp_uint_t)loc >> 3);
+  return h ^ (h >> 16);
+}
+
+static int sexp_lambda_index_validp (sexp lambda) {
+  return sexp_lambdap(lambda) && sexp_vectorp(sexp_lambda_index(lambda))
+    && sexp_vector_ref(sexp_lambda_index(lambda), SEXP_ZERO) == sexp_lambda_params(lambda)
+    && sexp_vector_ref(sexp_lambda_index(lambda), SEXP_ONE) == sexp_lambda_locals(lambda)
+    && sexp_vector_ref(sexp_lambda_index(lambda), SEXP_TWO) == sexp_lambda_fv(lambda);
+}
+
+/* params are keyed by their name with the lambda as the loc, free */
+/* vars by the ref itself, matching how refs resolve to each       */
+static sexp *sexp_lambda_index_slot (sexp index, sexp lambda, sexp name, sexp loc) {
+  sexp *data = sexp_vector_data(index) + SEXP_LAMBDA_INDEX_HEADER, key;
+  sexp_uint_t mask = (sexp_vector_length(index) - SEXP_LAMBDA_INDEX_HEADER) / 2 - 1;
+  sexp_uint_t i = sexp_binding_hash(name, loc) & mask;
+  for ( ; sexp_truep(key = data[i*2]); i = (i + 1) & mask)
+    if (sexp_refp(key) ? (sexp_ref_name(key) == name && sexp_ref_loc(key) == loc)
+        : (key == name && loc == lambda))
+      break;
+  return data + i*2;
+}
+
+static void sexp_lambda_index_insert (sexp index, sexp lambda, sexp key, sexp_sint_t i) {
+  sexp *slot = sexp_refp(key)
+    ? sexp_lambda_index_slot(index, lambda, sexp_ref_name(key), sexp_ref_loc(key))
+    : sexp_lambda_index_slot(index, lambda, key, lambda);
+  if (sexp_not(slot[0])) {   /* the first binding of a name wins */
+    slot[0] = key;
+    slot[1] = sexp_make_fixnum(i);
+  }
+}
+
+static void sexp_index_lambda (sexp ctx, sexp lambda) {
   sexp ls;
+  sexp_sint_t i, n = 0;
+  sexp_uint_t size = 1;
+  sexp_gc_var1(index);
+  sexp_lambda_index(lambda) = SEXP_FALSE;
+  for (ls=sexp_lambda_params(lambda); sexp_pairp(ls); ls=sexp_cdr(ls)) n++;
+  for (ls=sexp_lambda_locals(lambda); sexp_pairp(ls); ls=sexp_cdr(ls)) n++;
+  for (ls=sexp_lambda_fv(lambda); sexp_pairp(ls); ls=sexp_cdr(ls)) n++;
+  if (n < SEXP_LAMBDA_INDEX_MIN)
+    return;
+  while (size < (sexp_uint_t)n*2) size <<= 1;
+  sexp_gc_preserve1(ctx, index);
+  index = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_LAMBDA_INDEX_HEADER + size*2), SEXP_FALSE);
+  if (!sexp_exceptionp(index)) {
+    sexp_vector_set(index, SEXP_ZERO, sexp_lambda_params(lambda));
+    sexp_vector_set(index, SEXP_ONE, sexp_lambda_locals(lambda));
+    sexp_vector_set(index, SEXP_TWO, sexp_lambda_fv(lambda));
+    /* same numbering as the linear scans in sexp_param_index */
+    for (ls=sexp_lambda_params(lambda), i=0; sexp_pairp(ls); ls=sexp_cdr(ls), i++)
+      sexp_lambda_index_insert(index, lambda, sexp_car(ls), i);
+    if (!sexp_nullp(ls))
+      sexp_lambda_index_insert(index, lambda, ls, i);
+    for (ls=sexp_lambda_locals(lambda), i=-1; sexp_pairp(ls); ls=sexp_cdr(ls), i--)
+      sexp_lambda_index_insert(index, lambda, sexp_car(ls), i-4);
+    for (ls=sexp_lambda_fv(lambda), i=0; sexp_pairp(ls); ls=sexp_cdr(ls), i++)
+      sexp_lambda_index_insert(index, lambda, sexp_car(ls), i);
+    sexp_lambda_index(lambda) = index;
+  }
+  sexp_gc_release1(ctx);
+}
+
+static sexp sexp_lambda_index_ref (sexp lambda, sexp name, sexp loc) {
+  if (!sexp_lambda_index_validp(lambda))
+    return SEXP_FALSE;
+  return sexp_lambda_index_slot(sexp_lambda_index(lambda), lambda, name, loc)[1];
+}
+
+int sexp_free_var_index (sexp ctx, sexp lambda, sexp name, sexp loc) {
+  sexp ls = sexp_lambda_index_ref(lambda, name, loc);
+  int i;
+  if (sexp_fixnump(ls))
+    return sexp_unbox_fixnum(ls);
+  for (ls=sexp_lambda_fv(lambda), i=0; sexp_pairp(ls); ls=sexp_cdr(ls), i++)
+    if ((name == sexp_ref_name(sexp_car(ls)))
+        && (loc == sexp_ref_loc(sexp_car(ls))))
+      break;
+  return i;
+}
+
+int sexp_param_index (sexp ctx, sexp lambda, sexp name) {
+  sexp ls = sexp_lambda_index_ref(lambda, name, lambda);
   int i;
+  if (sexp_fixnump(ls))
+    return sexp_unbox_fixnum(ls);
   while (1) {
     ls = sexp_lambda_params(lambda);
     for (i=0; sexp_pairp(ls); ls=sexp_cdr(ls), i++)
@@ -342,9 +761,157 @@ void sexp_emit (sexp ctx, unsigned char c)  {
   sexp_context_pos(ctx) = sexp_fx_add(sexp_context_pos(ctx), SEXP_ONE);
 }
 
+#if SEXP_USE_PEEPHOLE
+
+#define sexp_peephole_jumpp(op) \
+  ((op) == SEXP_OP_JUMP || (op) == SEXP_OP_JUMP_UNLESS)
+#define sexp_peephole_no_fallthroughp(op)                                \
+  ((op) == SEXP_OP_JUMP || (op) == SEXP_OP_RET || (op) == SEXP_OP_DONE   \
+   || (op) == SEXP_OP_TAIL_CALL || (op) == SEXP_OP_TAIL_CALL_KNOWN)
+#define sexp_peephole_pure_pushp(op)                                     \
+  ((op) == SEXP_OP_PUSH || (op) == SEXP_OP_LOCAL_REF                     \
+   || (op) == SEXP_OP_STACK_REF || (op) == SEXP_OP_CLOSURE_REF           \
+   || (op) == SEXP_OP_GLOBAL_KNOWN_REF)
+
+/* Rewrites the bytecode being generated in ctx in place: jumps to */
+/* jumps are threaded, jumps to RET become RET, unreachable code,  */
+/* jumps to the next instruction and pushes immediately dropped    */
+/* are removed, and the remaining code is compacted.               */
+static void sexp_peephole_bytecode (sexp ctx) {
+  unsigned char *data = sexp_bytecode_data(sexp_context_bc(ctx)), *op;
+  sexp_sint_t len = sexp_unbox_fixnum(sexp_context_pos(ctx));
+  sexp_sint_t i, j, t, n, hops, changed;
+  sexp_sint_t *index, *start, *size, *target, *newpos, *incoming;
+  char *live;
+#if SEXP_USE_FULL_SOURCE_INFO
+  sexp ls;
+#endif
+  if (len <= 0 || sexp_exceptionp(sexp_context_exception(ctx))) return;
+  /* a single block holds all tables, each with at most len+1 entries */
+  index = (sexp_sint_t*) calloc(len+1, 6*sizeof(sexp_sint_t) + 2);
+  if (!index) return;
+  start = index + len + 1;
+  size = start + len + 1;
+  target = size + len + 1;
+  newpos = target + len + 1;
+  incoming = newpos + len + 1;
+  live = (char*) (incoming + len + 1);
+  op = (unsigned char*) live + len + 1;
+  /* decode, mapping positions to instruction indexes */
+  for (i=0; i<=len; i++) index[i] = -1;
+  for (n=0, i=0; i<len; n++) {
+    j = sexp_opcode_operand_size(data[i]);
+    if (j < 0) goto done;
+    index[i] = n;
+    start[n] = i;
+    op[n] = data[i];
+    size[n] = 1 + j;
+    i += size[n];
+  }
+  if (i != len) goto done;
+  index[len] = n;
+  for (i=0; i<n; i++) {
+    if (sexp_peephole_jumpp(op[i])) {
+      t = start[i] + 1 + *((sexp_operand_t*)(data+start[i]+1));
+      if (t < 0 || t >= len || index[t] < 0) goto done;
+      target[i] = index[t];
+    }
+  }
+  /* thread jumps to unconditional jumps, and fold jumps to RET */
+  for (i=0; i<n; i++) {
+    if (sexp_peephole_jumpp(op[i])) {
+      for (t=target[i], hops=0; op[t] == SEXP_OP_JUMP && target[t] != t && hops < n; hops++)
+        t = target[t];
+      target[i] = t;
+      if (op[i] == SEXP_OP_JUMP && op[t] == SEXP_OP_RET) {
+        op[i] = SEXP_OP_RET;
+        size[i] = 1;
+      }
+    }
+  }
+  /* mark reachable instructions, using incoming as a work stack */
+  incoming[0] = 0;
+  for (j=1; j>0; ) {
+    i = incoming[--j];
+    for ( ; i<n && !live[i]; i++) {
+      live[i] = 1;
+      if (sexp_peephole_jumpp(op[i]))
+        incoming[j++] = target[i];
+      if (sexp_peephole_no_fallthroughp(op[i]))
+        break;
+    }
+  }
+  /* remove pushes which are immediately dropped and jumps to the */
+  /* next instruction, until nothing changes */
+  do {
+    changed = 0;
+    for (i=0; i<n; i++) incoming[i] = 0;
+    for (i=0; i<n; i++)
+      if (live[i] && sexp_peephole_jumpp(op[i]))
+        incoming[target[i]]++;
+    for (i=0; i<n; i++) {
+      if (!live[i]) continue;
+      for (j=i+1; j<n && !live[j]; j++)
+        ;
+      if (sexp_peephole_pure_pushp(op[i]) && j < n
+          && op[j] == SEXP_OP_DROP && !incoming[j]) {
+        live[i] = live[j] = 0;
+        changed = 1;
+      } else if (sexp_peephole_jumpp(op[i])) {
+        for (t=target[i]; t<n && !live[t]; t++)
+          ;
+        if (t == j) {
+          if (op[i] == SEXP_OP_JUMP) {
+            live[i] = 0;
+          } else {  /* a conditional jump to the next instruction */
+            op[i] = SEXP_OP_DROP;
+            size[i] = 1;
+          }
+          incoming[target[i]]--;
+          changed = 1;
+        }
+      }
+    }
+  } while (changed);
+  /* compute new positions, deleted instructions map to the next live one */
+  newpos[n] = 0;
+  for (i=0; i<n; i++)
+    if (live[i]) newpos[n] += size[i];
+  for (i=n-1, t=newpos[n]; i>=0; i--) {
+    if (live[i]) t -= size[i];
+    newpos[i] = t;
+  }
+  /* compact and patch jump offsets */
+  for (i=0; i<n; i++) {
+    if (!live[i]) continue;
+    memmove(data+newpos[i], data+start[i], size[i]);
+    data[newpos[i]] = op[i];
+    if (sexp_peephole_jumpp(op[i]))
+      *((sexp_operand_t*)(data+newpos[i]+1)) = newpos[target[i]] - (newpos[i]+1);
+  }
+#if SEXP_USE_FULL_SOURCE_INFO
+  /* positions are still in a reversed list of (pos . source) */
+  for (ls=sexp_bytecode_source(sexp_context_bc(ctx)); sexp_pairp(ls); ls=sexp_cdr(ls))
+    if (sexp_pairp(sexp_car(ls)) && sexp_fixnump(sexp_caar(ls))) {
+      for (t=sexp_unbox_fixnum(sexp_caar(ls)); t < len && index[t] < 0; t++)
+        ;
+      if (t <= len)
+        sexp_car(sexp_car(ls)) = sexp_make_fixnum(newpos[index[t]]);
+    }
+#endif
+  sexp_context_pos(ctx) = sexp_make_fixnum(newpos[n]);
+ done:
+  free(index);
+}
+#endif
+
 sexp sexp_complete_bytecode (sexp ctx) {
   sexp bc;
   sexp_emit_return(ctx);
+#if SEXP_USE_PEEPHOLE
+  if (sexp_not(sexp_global(ctx, SEXP_G_NO_PEEPHOLE_P)))
+    sexp_peephole_bytecode(ctx);
+#endif
   sexp_shrink_bcode(ctx, sexp_unbox_fixnum(sexp_context_pos(ctx)));
   bc = sexp_context_bc(ctx);
   if (sexp_pairp(sexp_bytecode_literals(bc))) { /* compress literals */
@@ -416,10 +983,12 @@ sexp sexp_make_lambda (sexp ctx, sexp params) {
   sexp_lambda_params(res) = params;
   sexp_lambda_fv(res) = SEXP_NULL;
   sexp_lambda_sv(res) = SEXP_NULL;
+  sexp_lambda_bv(res) = SEXP_NULL;
   sexp_lambda_locals(res) = SEXP_NULL;
   sexp_lambda_defs(res) = SEXP_NULL;
   sexp_lambda_return_type(res) = SEXP_FALSE;
   sexp_lambda_param_types(res) = SEXP_NULL;
+  sexp_lambda_index(res) = SEXP_FALSE;
   return res;
 }
 
@@ -488,13 +1057,10 @@ static void sexp_init_eval_context_bytecodes (sexp ctx) {
 }
 #endif
 
-void sexp_init_eval_context_globals (sexp ctx) {
+/* also used to reset the path of a context restored from an image */
+void sexp_init_module_path (sexp ctx) {
   const char* no_sys_path;
   const char* user_path;
-  ctx = sexp_make_child_context(ctx, NULL);
-#if ! SEXP_USE_NATIVE_X86
-  sexp_init_eval_context_bytecodes(ctx);
-#endif
   sexp_global(ctx, SEXP_G_MODULE_PATH) = SEXP_NULL;
   no_sys_path = getenv(SEXP_NO_SYSTEM_PATH_VAR);
   if (!no_sys_path || strcmp(no_sys_path, "0")==0)
@@ -502,6 +1068,34 @@ void sexp_init_eval_context_globals (sexp ctx) {
   user_path = getenv(SEXP_MODULE_PATH_VAR);
   if (!user_path) user_path = sexp_default_user_module_path;
   sexp_add_path(ctx, user_path);
+}
+
+void sexp_init_eval_context_globals (sexp ctx) {
+#if SEXP_USE_FASL
+  const char* fasl_dir;
+#endif
+  ctx = sexp_make_child_context(ctx, NULL);
+#if ! SEXP_USE_NATIVE_X86
+  sexp_init_eval_context_bytecodes(ctx);
+#endif
+  sexp_init_module_path(ctx);
+#if SEXP_USE_FASL
+  sexp_global(ctx, SEXP_G_FASL_P) = SEXP_FALSE;
+  fasl_dir = getenv(SEXP_FASL_DIRECTORY_VAR);
+  sexp_global(ctx, SEXP_G_FASL_DIRECTORY)
+    = (fasl_dir && *fasl_dir) ? sexp_c_string(ctx, fasl_dir, -1) : SEXP_FALSE;
+  sexp_global(ctx, SEXP_G_FASL_FILES) = SEXP_FALSE;
+  sexp_global(ctx, SEXP_G_FASL_ENV_SOURCES) = SEXP_NULL;
+  sexp_global(ctx, SEXP_G_FASL_LOADING) = SEXP_NULL;
+  sexp_global(ctx, SEXP_G_FASL_SYNTAX_COUNT) = SEXP_ZERO;
+#endif
+#if SEXP_USE_HASH_ENVS
+  sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH) = SEXP_ZERO;
+#endif
+#if SEXP_USE_LAZY_LOAD
+  sexp_global(ctx, SEXP_G_LAZY_LOAD_P) = SEXP_FALSE;
+  sexp_global(ctx, SEXP_G_LAZY_BINDING_TAG) = sexp_c_string(ctx, "lazy", -1);
+#endif
 #if SEXP_USE_GREEN_THREADS
   sexp_global(ctx, SEXP_G_IO_BLOCK_ERROR)
     = sexp_user_exception(ctx, SEXP_FALSE, "I/O would block", SEXP_NULL);
@@ -653,8 +1247,10 @@ sexp sexp_strip_synclos (sexp ctx, sexp self, sexp_sint_t n, sexp x) {
 
 sexp sexp_identifier_eq_op (sexp ctx, sexp self, sexp_sint_t n, sexp e1, sexp id1, sexp e2, sexp id2) {
   sexp cell1, cell2;
-  cell1 = sexp_env_cell(ctx, e1, id1, 0);
-  cell2 = sexp_env_cell(ctx, e2, id2, 0);
+  cell1 = sexp_env_cell_force(ctx, sexp_env_cell(ctx, e1, id1, 0));
+  if (cell1 && sexp_exceptionp(cell1)) return cell1;
+  cell2 = sexp_env_cell_force(ctx, sexp_env_cell(ctx, e2, id2, 0));
+  if (cell2 && sexp_exceptionp(cell2)) return cell2;
   if (cell1 && (cell1 == cell2))
     return SEXP_TRUE;
   else if (!cell1 && !cell2 && (id1 == id2))
@@ -680,6 +1276,267 @@ sexp sexp_identifier_eq_op (sexp ctx, sexp self, sexp_sint_t n, sexp e1, sexp id
   return SEXP_FALSE;
 }
 
+#if SEXP_USE_NATIVE_SYNTAX_RULES
+
+/* syntax-rules-transformer in init-7.scm compiles each rule to a */
+/* tree of #(tag args ...) vectors, with pattern variables numbered. */
+/* We match the form and instantiate the template directly from that, */
+/* keeping the bindings and identifier renames in a state vector. */
+
+enum sexp_sr_patterns {
+  SEXP_SR_PAT_VAR,              /* #(0 index) */
+  SEXP_SR_PAT_ANY,              /* #(1) */
+  SEXP_SR_PAT_LITERAL,          /* #(2 id) */
+  SEXP_SR_PAT_PAIR,             /* #(3 car cdr) */
+  SEXP_SR_PAT_ELLIPSIS,         /* #(4 elt tail tail-len #(index ...)) */
+  SEXP_SR_PAT_VECTOR,           /* #(5 list) */
+  SEXP_SR_PAT_NULL,             /* #(6) */
+  SEXP_SR_PAT_DATUM             /* #(7 datum) */
+};
+
+enum sexp_sr_templates {
+  SEXP_SR_TMPL_VAR,             /* #(0 index) */
+  SEXP_SR_TMPL_ID,              /* #(1 id) */
+  SEXP_SR_TMPL_PAIR,            /* #(2 car cdr source) */
+  SEXP_SR_TMPL_ELLIPSIS,        /* #(3 elt depth #(index ...) tail) */
+  SEXP_SR_TMPL_NULL,            /* #(4) */
+  SEXP_SR_TMPL_VECTOR,          /* #(5 list) */
+  SEXP_SR_TMPL_DATUM            /* #(6 datum) */
+};
+
+enum sexp_sr_state_slots {
+  SEXP_SR_BINDS,
+  SEXP_SR_RENAMES,
+  SEXP_SR_RENAME,
+  SEXP_SR_USE_ENV,
+  SEXP_SR_NUM_SLOTS
+};
+
+#define sexp_sr_tag(x) sexp_unbox_fixnum(sexp_vector_data(x)[0])
+#define sexp_sr_ref(x, i) (sexp_vector_data(x)[i])
+#define sexp_sr_state(st, i) (sexp_vector_data(st)[i])
+#define sexp_sr_bind(st, i) (sexp_vector_data(sexp_sr_state(st, SEXP_SR_BINDS))[sexp_unbox_fixnum(i)])
+
+/* the renamer memoizes, but calling back into it is much slower than */
+/* remembering its answers here for the rest of the expansion */
+static sexp sexp_sr_rename (sexp ctx, sexp st, sexp id) {
+  sexp cell = sexp_assq(ctx, id, sexp_sr_state(st, SEXP_SR_RENAMES));
+  sexp_gc_var1(res);
+  if (sexp_pairp(cell)) return sexp_cdr(cell);
+  sexp_gc_preserve1(ctx, res);
+  res = sexp_apply1(ctx, sexp_sr_state(st, SEXP_SR_RENAME), id);
+  if (!sexp_exceptionp(res)) {
+    cell = sexp_cons(ctx, id, res);
+    if (!sexp_exceptionp(cell))
+      sexp_push(ctx, sexp_sr_state(st, SEXP_SR_RENAMES), cell);
+  }
+  sexp_gc_release1(ctx);
+  return res;
+}
+
+/* returns #t and fills in the bindings if x matches, otherwise #f */
+static sexp sexp_sr_match (sexp ctx, sexp st, sexp pat, sexp x) {
+  sexp_sint_t i, len, nvars;
+  sexp res = SEXP_TRUE, vars, ls, rest, next;
+  sexp_gc_var2(tmp, acc);
+  switch (sexp_sr_tag(pat)) {
+  case SEXP_SR_PAT_VAR:
+    sexp_sr_bind(st, sexp_sr_ref(pat, 1)) = x;
+    break;
+  case SEXP_SR_PAT_ANY:
+    break;
+  case SEXP_SR_PAT_LITERAL:
+    if (!sexp_idp(x)) return SEXP_FALSE;
+    sexp_gc_preserve1(ctx, tmp);
+    tmp = sexp_sr_rename(ctx, st, sexp_sr_ref(pat, 1));
+    res = sexp_exceptionp(tmp) ? tmp
+      : sexp_identifier_eq(ctx, sexp_sr_state(st, SEXP_SR_USE_ENV), x,
+                           sexp_sr_state(st, SEXP_SR_USE_ENV), tmp);
+    sexp_gc_release1(ctx);
+    break;
+  case SEXP_SR_PAT_PAIR:
+    if (!sexp_pairp(x)) return SEXP_FALSE;
+    res = sexp_sr_match(ctx, st, sexp_sr_ref(pat, 1), sexp_car(x));
+    if (res == SEXP_TRUE)
+      res = sexp_sr_match(ctx, st, sexp_sr_ref(pat, 2), sexp_cdr(x));
+    break;
+  case SEXP_SR_PAT_ELLIPSIS:
+    tmp = sexp_length(ctx, x);
+    if (!sexp_fixnump(tmp)) return SEXP_FALSE;
+    len = sexp_unbox_fixnum(tmp) - sexp_unbox_fixnum(sexp_sr_ref(pat, 3));
+    if (len < 0) return SEXP_FALSE;
+    vars = sexp_sr_ref(pat, 4);
+    nvars = sexp_vector_length(vars);
+    sexp_gc_preserve2(ctx, tmp, acc);
+    /* collect each variable's matches in reverse */
+    acc = sexp_make_vector(ctx, sexp_make_fixnum(nvars), SEXP_NULL);
+    for (ls = x; len > 0 && !sexp_exceptionp(acc); len--, ls = sexp_cdr(ls)) {
+      res = sexp_sr_match(ctx, st, sexp_sr_ref(pat, 1), sexp_car(ls));
+      if (res != SEXP_TRUE) break;
+      for (i = 0; i < nvars; i++) {
+        tmp = sexp_cons(ctx, sexp_sr_bind(st, sexp_vector_data(vars)[i]),
+                        sexp_vector_data(acc)[i]);
+        if (sexp_exceptionp(tmp)) {res = tmp; break;}
+        sexp_vector_data(acc)[i] = tmp;
+      }
+      if (res != SEXP_TRUE) break;
+    }
+    if (sexp_exceptionp(acc)) res = acc;
+    if (res == SEXP_TRUE) {
+      rest = ls;
+      for (i = 0; i < nvars; i++) {
+        for (tmp = SEXP_NULL, ls = sexp_vector_data(acc)[i]; sexp_pairp(ls); ls = next) {
+          next = sexp_cdr(ls);
+          sexp_cdr(ls) = tmp;
+          tmp = ls;
+        }
+        sexp_sr_bind(st, sexp_vector_data(vars)[i]) = tmp;
+      }
+      res = sexp_sr_match(ctx, st, sexp_sr_ref(pat, 2), rest);
+    }
+    sexp_gc_release2(ctx);
+    break;
+  case SEXP_SR_PAT_VECTOR:
+    if (!sexp_vectorp(x)) return SEXP_FALSE;
+    sexp_gc_preserve1(ctx, tmp);
+    tmp = SEXP_NULL;
+    for (i = sexp_vector_length(x) - 1; i >= 0 && !sexp_exceptionp(tmp); i--)
+      tmp = sexp_cons(ctx, sexp_vector_data(x)[i], tmp);
+    res = sexp_exceptionp(tmp) ? tmp : sexp_sr_match(ctx, st, sexp_sr_ref(pat, 1), tmp);
+    sexp_gc_release1(ctx);
+    break;
+  case SEXP_SR_PAT_NULL:
+    res = sexp_make_boolean(sexp_nullp(x));
+    break;
+  default:
+    res = sexp_equalp(ctx, x, sexp_sr_ref(pat, 1));
+    break;
+  }
+  return res;
+}
+
+static sexp sexp_sr_instantiate (sexp ctx, sexp st, sexp tmpl);
+
+/* push the instantiations of elt, nested depth levels deep in the */
+/* ellipsis vars, onto res in reverse */
+static sexp sexp_sr_ellipsis (sexp ctx, sexp st, sexp elt, sexp_sint_t depth, sexp vars, sexp acc) {
+  sexp_sint_t i, nvars = sexp_vector_length(vars);
+  sexp_gc_var3(cur, tmp, res);
+  sexp_gc_preserve3(ctx, cur, tmp, res);
+  res = acc;
+  /* the original bindings followed by the remaining elements */
+  cur = sexp_make_vector(ctx, sexp_make_fixnum(2*nvars), SEXP_NULL);
+  if (sexp_exceptionp(cur)) res = cur;
+  for (i = 0; i < nvars && !sexp_exceptionp(res); i++)
+    sexp_vector_data(cur)[i] = sexp_vector_data(cur)[nvars+i]
+      = sexp_sr_bind(st, sexp_vector_data(vars)[i]);
+  while (!sexp_exceptionp(res)) {
+    for (i = 0; i < nvars; i++)
+      if (!sexp_pairp(sexp_vector_data(cur)[nvars+i]))
+        goto done;
+    for (i = 0; i < nvars; i++) {
+      sexp_sr_bind(st, sexp_vector_data(vars)[i]) = sexp_car(sexp_vector_data(cur)[nvars+i]);
+      sexp_vector_data(cur)[nvars+i] = sexp_cdr(sexp_vector_data(cur)[nvars+i]);
+    }
+    if (depth > 1) {
+      res = sexp_sr_ellipsis(ctx, st, elt, depth-1, vars, res);
+    } else {
+      tmp = sexp_sr_instantiate(ctx, st, elt);
+      res = sexp_exceptionp(tmp) ? tmp : sexp_cons(ctx, tmp, res);
+    }
+  }
+ done:
+  if (!sexp_exceptionp(cur))
+    for (i = 0; i < nvars; i++)
+      sexp_sr_bind(st, sexp_vector_data(vars)[i]) = sexp_vector_data(cur)[i];
+  sexp_gc_release3(ctx);
+  return res;
+}
+
+static sexp sexp_sr_instantiate (sexp ctx, sexp st, sexp tmpl) {
+  sexp ls, next;
+  sexp_gc_var2(res, tmp);
+  switch (sexp_sr_tag(tmpl)) {
+  case SEXP_SR_TMPL_VAR:
+    return sexp_sr_bind(st, sexp_sr_ref(tmpl, 1));
+  case SEXP_SR_TMPL_ID:
+    return sexp_sr_rename(ctx, st, sexp_sr_ref(tmpl, 1));
+  case SEXP_SR_TMPL_NULL:
+    return SEXP_NULL;
+  case SEXP_SR_TMPL_DATUM:
+    return sexp_sr_ref(tmpl, 1);
+  }
+  sexp_gc_preserve2(ctx, res, tmp);
+  switch (sexp_sr_tag(tmpl)) {
+  case SEXP_SR_TMPL_PAIR:
+    tmp = sexp_sr_instantiate(ctx, st, sexp_sr_ref(tmpl, 1));
+    if (sexp_exceptionp(tmp)) {res = tmp; break;}
+    res = sexp_sr_instantiate(ctx, st, sexp_sr_ref(tmpl, 2));
+    if (sexp_exceptionp(res)) break;
+    res = sexp_cons(ctx, tmp, res);
+    if (sexp_pairp(res))
+      sexp_pair_source(res) = sexp_sr_ref(tmpl, 3);
+    break;
+  case SEXP_SR_TMPL_ELLIPSIS:
+    tmp = sexp_sr_ellipsis(ctx, st, sexp_sr_ref(tmpl, 1),
+                           sexp_unbox_fixnum(sexp_sr_ref(tmpl, 2)),
+                           sexp_sr_ref(tmpl, 3), SEXP_NULL);
+    if (sexp_exceptionp(tmp)) {res = tmp; break;}
+    res = sexp_sr_instantiate(ctx, st, sexp_sr_ref(tmpl, 4));
+    if (sexp_exceptionp(res)) break;
+    /* reverse the fresh instantiations onto the tail in place */
+    for (ls = tmp; sexp_pairp(ls); ls = next) {
+      next = sexp_cdr(ls);
+      sexp_cdr(ls) = res;
+      res = ls;
+    }
+    break;
+  case SEXP_SR_TMPL_VECTOR:
+    tmp = sexp_sr_instantiate(ctx, st, sexp_sr_ref(tmpl, 1));
+    res = sexp_exceptionp(tmp) ? tmp : sexp_list_to_vector(ctx, tmp);
+    break;
+  default:
+    res = sexp_xtype_exception(ctx, NULL, "invalid syntax-rules template", tmpl);
+    break;
+  }
+  sexp_gc_release2(ctx);
+  return res;
+}
+
+sexp sexp_syntax_rules_expand_op (sexp ctx, sexp self, sexp_sint_t n, sexp rules, sexp expr, sexp rename, sexp use_env) {
+  sexp ls;
+  sexp_gc_var2(st, res);
+  sexp_assert_type(ctx, sexp_pairp, SEXP_PAIR, expr);
+  sexp_assert_type(ctx, sexp_envp, SEXP_ENV, use_env);
+  sexp_gc_preserve2(ctx, st, res);
+  st = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_SR_NUM_SLOTS), SEXP_NULL);
+  if (sexp_exceptionp(st)) {
+    res = st;
+  } else {
+    sexp_sr_state(st, SEXP_SR_RENAME) = rename;
+    sexp_sr_state(st, SEXP_SR_USE_ENV) = use_env;
+    res = SEXP_FALSE;
+    /* each rule is #(num-vars pattern template) */
+    for (ls = rules; sexp_pairp(ls); ls = sexp_cdr(ls)) {
+      res = sexp_make_vector(ctx, sexp_vector_data(sexp_car(ls))[0], SEXP_VOID);
+      if (sexp_exceptionp(res)) break;
+      sexp_sr_state(st, SEXP_SR_BINDS) = res;
+      res = sexp_sr_match(ctx, st, sexp_vector_data(sexp_car(ls))[1], sexp_cdr(expr));
+      if (res != SEXP_FALSE) break;
+    }
+    if (res == SEXP_TRUE) {
+      res = sexp_sr_instantiate(ctx, st, sexp_vector_data(sexp_car(ls))[2]);
+    } else if (res == SEXP_FALSE) {
+      res = sexp_strip_synclos(ctx, NULL, 1, expr);
+      res = sexp_user_exception(ctx, self, "no expansion for", res);
+    }
+  }
+  sexp_gc_release2(ctx);
+  return res;
+}
+
+#endif
+
 /************************* the compiler ***************************/
 
 static int lambda_envp(sexp ctx) {
@@ -760,6 +1617,12 @@ static sexp analyze_var_ref (sexp ctx, sexp x, sexp *varenv) {
   cell = sexp_env_cell_loc(ctx, env, x, 0, varenv);
   if (! cell) {
     cell = sexp_env_cell_create(ctx, env, x, SEXP_UNDEF, varenv);
+  } else if (sexp_lazy_bindingp(ctx, sexp_cdr(cell))) {
+    cell = sexp_env_cell_force(ctx, cell);
+    if (sexp_exceptionp(cell)) {
+      sexp_gc_release1(ctx);
+      return cell;
+    }
   }
   if (sexp_macrop(sexp_cdr(cell)) || sexp_corep(sexp_cdr(cell))) {
     res = sexp_compile_error(ctx, "invalid use of syntax as value", x);
@@ -981,6 +1844,12 @@ static sexp analyze_bind_syntax (sexp ls, sexp eval_ctx, sexp bind_ctx, int loca
       sexp_env_push(eval_ctx, sexp_context_env(bind_ctx), tmp, name, mac);
     else
       sexp_env_define(eval_ctx, sexp_context_env(bind_ctx), name, mac);
+#if SEXP_USE_FASL
+    /* tells the fasl writer this form can't be replayed as bytecode */
+    if (! localp)
+      sexp_global(eval_ctx, SEXP_G_FASL_SYNTAX_COUNT)
+        = sexp_fx_add(sexp_global(eval_ctx, SEXP_G_FASL_SYNTAX_COUNT), SEXP_ONE);
+#endif
 #if !SEXP_USE_STRICT_TOPLEVEL_BINDINGS
     if (localp)
       sexp_env_cell_syntactic_p(sexp_env_cell(eval_ctx, sexp_context_env(bind_ctx), name, 0)) = 1;
@@ -1032,6 +1901,10 @@ static sexp analyze_letrec_syntax (sexp ctx, sexp x, int depth) {
 }
 
 static sexp analyze (sexp ctx, sexp object, int depth, int defok) {
+  int phase;
+#if SEXP_USE_PROFILE_LOAD
+  double expanded;
+#endif
   sexp op;
   sexp_gc_var4(res, tmp, x, cell);
   sexp_gc_preserve4(ctx, res, tmp, x, cell);
@@ -1045,6 +1918,13 @@ static sexp analyze (sexp ctx, sexp object, int depth, int defok) {
  loop:
   if (sexp_pairp(x)) {
     cell = sexp_idp(sexp_car(x)) ? sexp_env_cell(ctx, sexp_context_env(ctx), sexp_car(x), 0) : NULL;
+    if (cell && sexp_lazy_bindingp(ctx, sexp_cdr(cell))) {
+      cell = sexp_env_cell_force(ctx, cell);
+      if (sexp_exceptionp(cell)) {
+        res = cell;
+        goto error;
+      }
+    }
     if (sexp_not(sexp_listp(ctx, x))
         && !(cell && sexp_macrop(sexp_cdr(cell)))) {
       res = sexp_compile_error(ctx, "dotted list in source", x);
@@ -1099,8 +1979,17 @@ static sexp analyze (sexp ctx, sexp object, int depth, int defok) {
           tmp = sexp_cons(ctx, sexp_context_env(ctx), tmp);
           tmp = sexp_cons(ctx, x, tmp);
           x = sexp_exceptionp(tmp) ? tmp : sexp_make_child_context(ctx, sexp_context_lambda(ctx));
-          if (!sexp_exceptionp(x) && !sexp_exceptionp(sexp_context_exception(ctx)))
+          if (!sexp_exceptionp(x) && !sexp_exceptionp(sexp_context_exception(ctx))) {
+            sexp_load_phase_begin(phase, SEXP_LOAD_PHASE_EXPAND);
+#if SEXP_USE_PROFILE_LOAD
+            expanded = sexp_load_profile_expanded();
+#endif
             x = sexp_apply(x, sexp_macro_proc(op), tmp);
+#if SEXP_USE_PROFILE_LOAD
+            sexp_load_profile_macro(ctx, sexp_caar(tmp), expanded);
+#endif
+            sexp_load_phase_end(phase);
+          }
           if (sexp_exceptionp(x) && sexp_not(sexp_exception_source(x)))
             sexp_exception_source(x) = sexp_pair_source(sexp_car(tmp));
           goto loop;
@@ -1168,77 +2057,262 @@ sexp sexp_analyze (sexp ctx, sexp x) {return analyze(ctx, x, 0, 1);}
 
 /********************** free varable analysis *************************/
 
-static sexp insert_free_var (sexp ctx, sexp x, sexp fv) {
-  sexp name=sexp_ref_name(x), loc=sexp_ref_loc(x), ls;
-  for (ls=fv; sexp_pairp(ls); ls=sexp_cdr(ls))
+/* Free variable sets are lists of refs, newest first, with an open */
+/* addressed table on (name, loc) once they outgrow a linear scan.   */
+/* The table only holds refs already reachable from the list.        */
+
+#define SEXP_FV_TABLE_MIN 16
+
+struct sexp_fv_set {
+  sexp *ls, *table;
+  sexp_uint_t size, count;
+};
+
+static sexp *sexp_fv_set_slot (struct sexp_fv_set *set, sexp name, sexp loc) {
+  sexp_uint_t mask = set->size - 1, i = sexp_binding_hash(name, loc) & mask;
+  for ( ; set->table[i]; i = (i + 1) & mask)
+    if (sexp_refp(set->table[i]) && sexp_ref_name(set->table[i]) == name
+        && sexp_ref_loc(set->table[i]) == loc)
+      break;
+  return set->table + i;
+}
+
+static void sexp_fv_set_rehash (struct sexp_fv_set *set, sexp_uint_t size) {
+  sexp ls;
+  free(set->table);
+  set->table = (sexp*) calloc(size, sizeof(sexp));
+  set->size = set->table ? size : 0;  /* out of memory degrades to scanning */
+  if (set->table)
+    for (ls=*set->ls; sexp_pairp(ls); ls=sexp_cdr(ls))
+      *sexp_fv_set_slot(set, sexp_ref_name(sexp_car(ls)), sexp_ref_loc(sexp_car(ls))) = sexp_car(ls);
+}
+
+static void sexp_fv_set_init (struct sexp_fv_set *set, sexp *ls) {
+  sexp x;
+  set->ls = ls;
+  set->table = NULL;
+  set->size = set->count = 0;
+  for (x=*ls; sexp_pairp(x); x=sexp_cdr(x))
+    set->count++;
+  if (set->count >= SEXP_FV_TABLE_MIN)
+    sexp_fv_set_rehash(set, SEXP_FV_TABLE_MIN * 4);
+  while (set->table && set->size < set->count*2)
+    sexp_fv_set_rehash(set, set->size * 2);
+}
+
+static int sexp_fv_set_memberp (struct sexp_fv_set *set, sexp name, sexp loc) {
+  sexp ls;
+  if (set->table)
+    return *sexp_fv_set_slot(set, name, loc) != NULL;
+  for (ls=*set->ls; sexp_pairp(ls); ls=sexp_cdr(ls))
     if ((name == sexp_ref_name(sexp_car(ls)))
         && (loc == sexp_ref_loc(sexp_car(ls))))
-      return fv;
-  return sexp_cons(ctx, x, fv);
+      return 1;
+  return 0;
 }
 
-static sexp union_free_vars (sexp ctx, sexp fv1, sexp fv2) {
-  sexp_gc_var1(res);
-  if (sexp_nullp(fv2))
-    return fv1;
-  sexp_gc_preserve1(ctx, res);
-  for (res=fv2; sexp_pairp(fv1); fv1=sexp_cdr(fv1))
-    res = insert_free_var(ctx, sexp_car(fv1), res);
-  sexp_gc_release1(ctx);
-  return res;
+static void insert_free_var (sexp ctx, sexp x, struct sexp_fv_set *set) {
+  sexp ls;
+  if (sexp_fv_set_memberp(set, sexp_ref_name(x), sexp_ref_loc(x)))
+    return;
+  ls = sexp_cons(ctx, x, *set->ls);
+  if (sexp_exceptionp(ls))
+    return;
+  *set->ls = ls;
+  set->count++;
+  if (set->table && set->size < set->count*2)
+    sexp_fv_set_rehash(set, set->size * 2);
+  else if (set->table)
+    *sexp_fv_set_slot(set, sexp_ref_name(x), sexp_ref_loc(x)) = x;
+  else if (set->count >= SEXP_FV_TABLE_MIN)
+    sexp_fv_set_rehash(set, SEXP_FV_TABLE_MIN * 4);
 }
 
-static sexp diff_free_vars (sexp ctx, sexp lambda, sexp fv, sexp params) {
+static void union_free_vars (sexp ctx, sexp fv, struct sexp_fv_set *set) {
+  for ( ; sexp_pairp(fv); fv=sexp_cdr(fv))
+    insert_free_var(ctx, sexp_car(fv), set);
+}
+
+static int sexp_lambda_bindsp (sexp lambda, sexp name) {
+  sexp ls;
+  for (ls=sexp_lambda_params(lambda); sexp_pairp(ls); ls=sexp_cdr(ls))
+    if (sexp_car(ls) == name)
+      return 1;
+  return ls == name || sexp_truep(sexp_memq(NULL, name, sexp_lambda_locals(lambda)));
+}
+
+/* Removes the vars bound by lambda from the set of free vars in its */
+/* body, returning the rest in reverse order.  With a table we clear */
+/* each binding's entry instead of searching the params for each ref. */
+static sexp diff_free_vars (sexp ctx, sexp lambda, struct sexp_fv_set *set) {
+  sexp ls, *slot;
   sexp_gc_var1(res);
+  if (set->table) {
+    for (ls=sexp_lambda_params(lambda); ; ls=sexp_cdr(ls)) {
+      slot = sexp_fv_set_slot(set, sexp_pairp(ls) ? sexp_car(ls) : ls, lambda);
+      if (*slot) *slot = SEXP_VOID;  /* tombstone, keeps probe chains */
+      if (!sexp_pairp(ls)) break;
+    }
+    for (ls=sexp_lambda_locals(lambda); sexp_pairp(ls); ls=sexp_cdr(ls)) {
+      slot = sexp_fv_set_slot(set, sexp_car(ls), lambda);
+      if (*slot) *slot = SEXP_VOID;
+    }
+  }
   sexp_gc_preserve1(ctx, res);
   res = SEXP_NULL;
-  for ( ; sexp_pairp(fv); fv=sexp_cdr(fv))
-    if ((sexp_ref_loc(sexp_car(fv)) != lambda)
-        || (sexp_memq(NULL, sexp_ref_name(sexp_car(fv)), params)
-            == SEXP_FALSE))
-      sexp_push(ctx, res, sexp_car(fv));
+  for (ls=*set->ls; sexp_pairp(ls); ls=sexp_cdr(ls))
+    if ((sexp_ref_loc(sexp_car(ls)) != lambda)
+        || (set->table ? sexp_fv_set_memberp(set, sexp_ref_name(sexp_car(ls)), lambda)
+            : !sexp_lambda_bindsp(lambda, sexp_ref_name(sexp_car(ls)))))
+      sexp_push(ctx, res, sexp_car(ls));
   sexp_gc_release1(ctx);
   return res;
 }
 
-sexp sexp_free_vars (sexp ctx, sexp x, sexp fv) {
+#if SEXP_USE_ESCAPE_ANALYSIS
+/* Returns true if evaluating x, outside of any nested lambda bodies, */
+/* may capture a continuation which includes the current frame.  Such */
+/* a continuation copies the stack, so re-entering it would restore   */
+/* stale values of any set! variables kept directly in stack slots.   */
+static int sexp_may_capture_frame_p (sexp ctx, sexp x, int tailp) {
+  sexp ls;
+  if (sexp_pairp(x)) {
+    if (sexp_opcodep(sexp_car(x))) {
+      switch (sexp_opcode_class(sexp_car(x))) {
+      case SEXP_OPC_FOREIGN:
+      case SEXP_OPC_PARAMETER:
+        return 1;
+      case SEXP_OPC_GENERIC:
+        if (sexp_opcode_code(sexp_car(x)) == SEXP_OP_CALLCC
+            || sexp_opcode_code(sexp_car(x)) == SEXP_OP_APPLY1)
+          return 1;
+        break;
+      default:
+        break;
+      }
+    } else if (!tailp || sexp_truep(sexp_global(ctx, SEXP_G_NO_TAIL_CALLS_P))
+               || sexp_may_capture_frame_p(ctx, sexp_car(x), 0)) {
+      /* only tail calls are safe, since they replace the frame */
+      return 1;
+    }
+    for (ls=sexp_cdr(x); sexp_pairp(ls); ls=sexp_cdr(ls))
+      if (sexp_may_capture_frame_p(ctx, sexp_car(ls), 0))
+        return 1;
+  } else if (sexp_cndp(x)) {
+    return sexp_may_capture_frame_p(ctx, sexp_cnd_test(x), 0)
+      || sexp_may_capture_frame_p(ctx, sexp_cnd_pass(x), tailp)
+      || sexp_may_capture_frame_p(ctx, sexp_cnd_fail(x), tailp);
+  } else if (sexp_seqp(x)) {
+    for (ls=sexp_seq_ls(x); sexp_pairp(ls); ls=sexp_cdr(ls))
+      if (sexp_may_capture_frame_p(ctx, sexp_car(ls),
+                                   tailp && sexp_nullp(sexp_cdr(ls))))
+        return 1;
+  } else if (sexp_setp(x)) {
+    return sexp_may_capture_frame_p(ctx, sexp_set_value(x), 0);
+  } else if (sexp_synclop(x)) {
+    return sexp_may_capture_frame_p(ctx, sexp_synclo_expr(x), tailp);
+  }
+  return 0;
+}
+#endif
+
+static void sexp_free_vars_aux (sexp ctx, sexp x, struct sexp_fv_set *set) {
+#if SEXP_USE_ESCAPE_ANALYSIS
+  sexp ls, loc;
+#endif
+  struct sexp_fv_set body;
   sexp_gc_var2(fv1, fv2);
-  sexp_gc_preserve2(ctx, fv1, fv2);
-  fv1 = fv;
   if (sexp_lambdap(x)) {
-    fv1 = sexp_free_vars(ctx, sexp_lambda_body(x), SEXP_NULL);
-    fv2 = sexp_flatten_dot(ctx, sexp_lambda_params(x));
-    fv2 = sexp_append2(ctx, sexp_lambda_locals(x), fv2);
-    fv2 = diff_free_vars(ctx, x, fv1, fv2);
+    sexp_gc_preserve2(ctx, fv1, fv2);
+    sexp_lambda_bv(x) = SEXP_NULL;
+    fv1 = SEXP_NULL;
+    sexp_fv_set_init(&body, &fv1);
+    sexp_free_vars_aux(ctx, sexp_lambda_body(x), &body);
+    fv2 = diff_free_vars(ctx, x, &body);
+    free(body.table);
     sexp_lambda_fv(x) = fv2;
-    fv1 = union_free_vars(ctx, fv2, fv);
+#if SEXP_USE_ESCAPE_ANALYSIS
+    /* set! vars closed over by this lambda must be boxed in their owner */
+    for (ls=fv2; sexp_pairp(ls); ls=sexp_cdr(ls)) {
+      loc = sexp_ref_loc(sexp_car(ls));
+      if (sexp_lambdap(loc)
+          && sexp_truep(sexp_memq(ctx, sexp_ref_name(sexp_car(ls)), sexp_lambda_sv(loc))))
+        sexp_insert(ctx, sexp_lambda_bv(loc), sexp_ref_name(sexp_car(ls)));
+    }
+    if (sexp_pairp(sexp_lambda_sv(x))
+        && sexp_may_capture_frame_p(ctx, sexp_lambda_body(x), 1))
+      sexp_lambda_bv(x) = sexp_lambda_sv(x);
+#else
+    sexp_lambda_bv(x) = sexp_lambda_sv(x);
+#endif
+    sexp_index_lambda(ctx, x);
+    union_free_vars(ctx, fv2, set);
+    sexp_gc_release2(ctx);
   } else if (sexp_pairp(x)) {
     for ( ; sexp_pairp(x); x=sexp_cdr(x))
-      fv1 = sexp_free_vars(ctx, sexp_car(x), fv1);
+      sexp_free_vars_aux(ctx, sexp_car(x), set);
   } else if (sexp_cndp(x)) {
-    fv1 = sexp_free_vars(ctx, sexp_cnd_test(x), fv);
-    fv1 = sexp_free_vars(ctx, sexp_cnd_pass(x), fv1);
-    fv1 = sexp_free_vars(ctx, sexp_cnd_fail(x), fv1);
+    sexp_free_vars_aux(ctx, sexp_cnd_test(x), set);
+    sexp_free_vars_aux(ctx, sexp_cnd_pass(x), set);
+    sexp_free_vars_aux(ctx, sexp_cnd_fail(x), set);
   } else if (sexp_seqp(x)) {
     for (x=sexp_seq_ls(x); sexp_pairp(x); x=sexp_cdr(x))
-      fv1 = sexp_free_vars(ctx, sexp_car(x), fv1);
+      sexp_free_vars_aux(ctx, sexp_car(x), set);
   } else if (sexp_setp(x)) {
-    fv1 = sexp_free_vars(ctx, sexp_set_value(x), fv);
-    fv1 = sexp_free_vars(ctx, sexp_set_var(x), fv1);
+    sexp_free_vars_aux(ctx, sexp_set_value(x), set);
+    sexp_free_vars_aux(ctx, sexp_set_var(x), set);
   } else if (sexp_refp(x) && sexp_lambdap(sexp_ref_loc(x))) {
-    fv1 = insert_free_var(ctx, x, fv);
+    insert_free_var(ctx, x, set);
   } else if (sexp_synclop(x)) {
-    fv1 = sexp_free_vars(ctx, sexp_synclo_expr(x), fv);
+    sexp_free_vars_aux(ctx, sexp_synclo_expr(x), set);
   }
-  sexp_gc_release2(ctx);
-  return fv1;
+}
+
+sexp sexp_free_vars (sexp ctx, sexp x, sexp fv) {
+  struct sexp_fv_set set;
+  sexp_gc_var1(res);
+  sexp_gc_preserve1(ctx, res);
+  res = fv;
+  sexp_fv_set_init(&set, &res);
+  sexp_free_vars_aux(ctx, x, &set);
+  free(set.table);
+  sexp_gc_release1(ctx);
+  return res;
 }
 
 /************************ library procedures **************************/
 
-sexp sexp_open_input_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path) {
+/* give a new stdio port a buffer of size bytes, or by default a larger */
+/* one for regular files.  The buffer is kept in the port's cookie so */
+/* it isn't collected before the stream is closed. */
+static sexp sexp_set_stream_buffer (sexp ctx, sexp self, sexp res, sexp size) {
+  sexp_sint_t len;
+  sexp_gc_var2(port, buf);
+  if (sexp_fixnump(size) && sexp_unbox_fixnum(size) > 0)
+    len = sexp_unbox_fixnum(size);
+  else if (sexp_truep(size))
+    return sexp_xtype_exception(ctx, self, "invalid buffer size", size);
+  else if ((len = sexp_default_port_buffer_size(fileno(sexp_port_stream(res))))
+           <= SEXP_PORT_BUFFER_SIZE)
+    return res;
+#if SEXP_USE_BOEHM
+  return res;
+#else
+  sexp_gc_preserve2(ctx, port, buf);
+  port = res;
+  buf = sexp_make_bytes(ctx, sexp_make_fixnum(len), SEXP_VOID);
+  if (!sexp_exceptionp(buf)
+      && setvbuf(sexp_port_stream(port), sexp_bytes_data(buf), _IOFBF, len) == 0)
+    sexp_port_cookie(port) = buf;
+  sexp_gc_release2(ctx);
+  return port;
+#endif
+}
+
+sexp sexp_open_input_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path, sexp size) {
   FILE *in;
   int count = 0;
+  sexp res;
   sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, path);
   do {
     if (count != 0) sexp_gc(ctx, NULL);
@@ -1249,12 +2323,14 @@ sexp sexp_open_input_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path) {
 #if SEXP_USE_GREEN_THREADS
   fcntl(fileno(in), F_SETFL, O_NONBLOCK);
 #endif
-  return sexp_make_input_port(ctx, in, path);
+  res = sexp_make_input_port(ctx, in, path);
+  return sexp_portp(res) ? sexp_set_stream_buffer(ctx, self, res, size) : res;
 }
 
-sexp sexp_open_output_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path) {
+sexp sexp_open_output_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path, sexp size) {
   FILE *out;
   int count = 0;
+  sexp res;
   sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, path);
   do {
     if (count != 0) sexp_gc(ctx, NULL);
@@ -1265,17 +2341,18 @@ sexp sexp_open_output_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path) {
 #if SEXP_USE_GREEN_THREADS
   fcntl(fileno(out), F_SETFL, O_NONBLOCK);
 #endif
-  return sexp_make_output_port(ctx, out, path);
+  res = sexp_make_output_port(ctx, out, path);
+  return sexp_portp(res) ? sexp_set_stream_buffer(ctx, self, res, size) : res;
 }
 
-sexp sexp_open_binary_input_file (sexp ctx, sexp self, sexp_sint_t n, sexp path) {
-  sexp res = sexp_open_input_file_op(ctx, self, n, path);
+sexp sexp_open_binary_input_file (sexp ctx, sexp self, sexp_sint_t n, sexp path, sexp size) {
+  sexp res = sexp_open_input_file_op(ctx, self, n, path, size);
   if (sexp_portp(res)) sexp_port_binaryp(res) = 1;
   return res;
 }
 
-sexp sexp_open_binary_output_file (sexp ctx, sexp self, sexp_sint_t n, sexp path) {
-  sexp res = sexp_open_output_file_op(ctx, self, n, path);
+sexp sexp_open_binary_output_file (sexp ctx, sexp self, sexp_sint_t n, sexp path, sexp size) {
+  sexp res = sexp_open_output_file_op(ctx, self, n, path, size);
   if (sexp_portp(res)) sexp_port_binaryp(res) = 1;
   return res;
 }
@@ -1418,9 +2495,289 @@ static sexp sexp_load_binary(sexp ctx, sexp file, sexp env) {
 }
 #endif
 
-sexp sexp_load_op (sexp ctx, sexp self, sexp_sint_t n, sexp source, sexp env) {
+#if SEXP_USE_PROFILE_LOAD
+
+/* The start-up profiler keeps a tree of the files loaded, charging */
+/* the time between phase changes to the innermost file's current */
+/* phase, so each node's phases add up to its self time.  Heap */
+/* counters are sampled on each change, since the report is written */
+/* at exit after the heap may already have been freed. */
+
+struct sexp_load_profile_t {
+  char *name;
+  int parent_phase;
+  double start, end, phase[SEXP_LOAD_NUM_PHASES];
+  sexp_uint_t alloc_bytes, gc_count;
+  struct sexp_load_profile_t *parent, *children, *next;
+};
+
+/* expansion time of each macro, keyed by name */
+struct sexp_macro_profile_t {
+  sexp name;
+  char *str;
+  sexp_uint_t count;
+  double time;
+  struct sexp_macro_profile_t *next;
+};
+
+#define SEXP_MACRO_PROFILE_SIZE 256
+#define SEXP_MACRO_PROFILE_REPORT_LIMIT 30
+
+static const char* sexp_load_phase_names[SEXP_LOAD_NUM_PHASES] =
+  {"other", "read", "expand", "analyze", "optimize", "generate", "execute"};
+
+static struct sexp_load_profile_t *sexp_load_profile_root = NULL;
+static struct sexp_load_profile_t *sexp_load_profile_cur = NULL;
+static int sexp_load_profile_cur_phase = SEXP_LOAD_PHASE_OTHER;
+static double sexp_load_profile_last;
+static char *sexp_load_profile_path;
+static FILE *sexp_load_profile_out;
+static struct sexp_macro_profile_t *sexp_macro_profile_table[SEXP_MACRO_PROFILE_SIZE];
+static sexp_uint_t sexp_macro_profile_count;
+static double sexp_load_profile_expand_time;
+static sexp_uint_t sexp_load_profile_alloc_bytes, sexp_load_profile_gc_count;
+#if ! SEXP_USE_BOEHM && ! SEXP_USE_MALLOC
+static sexp_heap sexp_load_profile_heap;
+#define sexp_load_profile_sample() do {                                 \
+    sexp_load_profile_alloc_bytes = sexp_load_profile_heap->alloc_bytes; \
+    sexp_load_profile_gc_count = sexp_load_profile_heap->gc_count;      \
+  } while (0)
+#else
+#define sexp_load_profile_sample()
+#endif
+
+static double sexp_load_profile_now (void) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000.0 + tv.tv_usec;
+}
+
+/* charge the time since the last change and return the current time */
+static double sexp_load_profile_charge (void) {
+  double now = sexp_load_profile_now();
+  sexp_load_profile_cur->phase[sexp_load_profile_cur_phase]
+    += now - sexp_load_profile_last;
+  if (sexp_load_profile_cur_phase == SEXP_LOAD_PHASE_EXPAND)
+    sexp_load_profile_expand_time += now - sexp_load_profile_last;
+  sexp_load_profile_last = now;
+  return now;
+}
+
+int sexp_load_profile_phase (int phase) {
+  int res = sexp_load_profile_cur_phase;
+  if (sexp_load_profile_cur && phase != res) {
+    sexp_load_profile_charge();
+    sexp_load_profile_sample();
+    sexp_load_profile_cur_phase = phase;
+  }
+  return res;
+}
+
+/* the total expansion time so far, to pass to sexp_load_profile_macro */
+static double sexp_load_profile_expanded (void) {
+  if (sexp_load_profile_cur) sexp_load_profile_charge();
+  return sexp_load_profile_expand_time;
+}
+
+static void sexp_load_profile_macro (sexp ctx, sexp name, double start) {
+  struct sexp_macro_profile_t *m;
+  sexp_uint_t i;
+  sexp str;
+  if (!sexp_load_profile_cur) return;
+  while (sexp_synclop(name))
+    name = sexp_synclo_expr(name);
+  if (!sexp_symbolp(name)) return;
+  i = ((sexp_uint_t)name >> 3) % SEXP_MACRO_PROFILE_SIZE;
+  for (m = sexp_macro_profile_table[i]; m && m->name != name; m = m->next)
+    ;
+  if (!m) {
+    str = sexp_symbol_to_string(ctx, name);
+    if (!sexp_stringp(str) || !(m = calloc(1, sizeof(struct sexp_macro_profile_t))))
+      return;
+    m->name = name;
+    m->str = strdup(sexp_string_data(str));
+    m->next = sexp_macro_profile_table[i];
+    sexp_macro_profile_table[i] = m;
+    sexp_macro_profile_count++;
+  }
+  m->count++;
+  m->time += sexp_load_profile_expanded() - start;
+}
+
+static int sexp_macro_profile_cmp (const void *a, const void *b) {
+  double ta = (*(struct sexp_macro_profile_t**)a)->time;
+  double tb = (*(struct sexp_macro_profile_t**)b)->time;
+  return ta < tb ? 1 : ta > tb ? -1 : 0;
+}
+
+/* the macros sorted by decreasing expansion time, or NULL if none */
+static struct sexp_macro_profile_t** sexp_macro_profile_sorted (void) {
+  struct sexp_macro_profile_t **res, *m;
+  sexp_uint_t i, j = 0;
+  if (!sexp_macro_profile_count) return NULL;
+  res = calloc(sexp_macro_profile_count, sizeof(struct sexp_macro_profile_t*));
+  if (!res) return NULL;
+  for (i = 0; i < SEXP_MACRO_PROFILE_SIZE; i++)
+    for (m = sexp_macro_profile_table[i]; m; m = m->next)
+      res[j++] = m;
+  qsort(res, sexp_macro_profile_count, sizeof(struct sexp_macro_profile_t*),
+        sexp_macro_profile_cmp);
+  return res;
+}
+
+static void sexp_load_profile_write_json_string (FILE *out, const char *str) {
+  putc('"', out);
+  for ( ; *str; str++) {
+    if (*str == '"' || *str == '\\') putc('\\', out);
+    if ((unsigned char)*str >= ' ') putc(*str, out);
+  }
+  putc('"', out);
+}
+
+static struct sexp_load_profile_t* sexp_load_profile_make (const char *name) {
+  struct sexp_load_profile_t *res = calloc(1, sizeof(struct sexp_load_profile_t));
+  if (res) {
+    res->name = strdup(name);
+    res->alloc_bytes = sexp_load_profile_alloc_bytes;
+    res->gc_count = sexp_load_profile_gc_count;
+  }
+  return res;
+}
+
+static void sexp_load_profile_finish (struct sexp_load_profile_t *node, double now) {
+  node->end = now;
+  node->alloc_bytes = sexp_load_profile_alloc_bytes - node->alloc_bytes;
+  node->gc_count = sexp_load_profile_gc_count - node->gc_count;
+}
+
+static struct sexp_load_profile_t* sexp_load_profile_begin (sexp source) {
+  struct sexp_load_profile_t *res;
+  if (!sexp_load_profile_cur) return NULL;
+  sexp_load_profile_sample();
+  res = sexp_load_profile_make(sexp_stringp(source) ? sexp_string_data(source) : "<port>");
+  if (res) {
+    res->start = sexp_load_profile_charge();
+    res->parent = sexp_load_profile_cur;
+    res->parent_phase = sexp_load_profile_cur_phase;
+    res->next = res->parent->children;
+    res->parent->children = res;
+    sexp_load_profile_cur = res;
+    /* anything not evaluating is reading */
+    sexp_load_profile_cur_phase = SEXP_LOAD_PHASE_READ;
+  }
+  return res;
+}
+
+static void sexp_load_profile_end (struct sexp_load_profile_t *node) {
+  if (!node) return;
+  sexp_load_profile_sample();
+  sexp_load_profile_finish(node, sexp_load_profile_charge());
+  sexp_load_profile_cur = node->parent;
+  sexp_load_profile_cur_phase = node->parent_phase;
+}
+
+static void sexp_load_profile_write_json (FILE *out, struct sexp_load_profile_t *node, int firstp) {
+  struct sexp_load_profile_t *ls;
+  int i;
+  fprintf(out, "%s\n{\"name\":", firstp ? "" : ",");
+  sexp_load_profile_write_json_string(out, node->name);
+  fprintf(out, ",\"cat\":\"load\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.0f,\"dur\":%.0f,\"args\":{",
+          node->start - sexp_load_profile_root->start, node->end - node->start);
+  for (i=0; i<SEXP_LOAD_NUM_PHASES; i++)
+    fprintf(out, "\"%s_ms\":%.3f,", sexp_load_phase_names[i], node->phase[i] / 1000.0);
+  fprintf(out, "\"alloc_bytes\":%lu,\"gcs\":%lu}}",
+          (unsigned long)node->alloc_bytes, (unsigned long)node->gc_count);
+  for (ls=node->children; ls; ls=ls->next)
+    sexp_load_profile_write_json(out, ls, 0);
+}
+
+/* children are kept newest first, so print them in reverse */
+static void sexp_load_profile_write_tree (FILE *out, struct sexp_load_profile_t *node, int depth) {
+  double self = 0;
+  int i;
+  if (!node) return;
+  sexp_load_profile_write_tree(out, node->next, depth);
+  for (i=0; i<SEXP_LOAD_NUM_PHASES; i++)
+    self += node->phase[i];
+  fprintf(out, "%9.1f %8.1f", (node->end - node->start) / 1000.0, self / 1000.0);
+  for (i=SEXP_LOAD_PHASE_READ; i<SEXP_LOAD_NUM_PHASES; i++)
+    fprintf(out, " %8.1f", node->phase[i] / 1000.0);
+  fprintf(out, " %10lu %4lu  %*s%s\n", (unsigned long)node->alloc_bytes / 1024,
+          (unsigned long)node->gc_count, depth*2, "", node->name);
+  sexp_load_profile_write_tree(out, node->children, depth+1);
+}
+
+static void sexp_load_profile_report (void) {
+  FILE *out;
+  size_t len;
+  sexp_uint_t i;
+  struct sexp_macro_profile_t **macros = sexp_macro_profile_sorted();
+  struct sexp_load_profile_t *root = sexp_load_profile_root;
+  if (!root || sexp_load_profile_cur != root) return;
+  sexp_load_profile_finish(root, sexp_load_profile_charge());
+  sexp_load_profile_cur = NULL;
+  out = sexp_load_profile_out;
+  len = strlen(sexp_load_profile_path);
+  if (len > 5 && strcmp(sexp_load_profile_path + len - 5, ".json") == 0) {
+    fprintf(out, "{\"traceEvents\":[");
+    sexp_load_profile_write_json(out, root, 1);
+    fprintf(out, "\n],\n\"macros\":[");
+    for (i=0; macros && i<sexp_macro_profile_count; i++) {
+      fprintf(out, "%s\n{\"name\":", i ? "," : "");
+      sexp_load_profile_write_json_string(out, macros[i]->str);
+      fprintf(out, ",\"count\":%lu,\"ms\":%.3f}",
+              (unsigned long)macros[i]->count, macros[i]->time / 1000.0);
+    }
+    fprintf(out, "\n]}\n");
+  } else {
+    fprintf(out, " total ms  self ms");
+    for (i=SEXP_LOAD_PHASE_READ; i<SEXP_LOAD_NUM_PHASES; i++)
+      fprintf(out, " %8s", sexp_load_phase_names[i]);
+    fprintf(out, "   alloc KB  gcs  file\n");
+    sexp_load_profile_write_tree(out, root, 0);
+    if (macros) {
+      fprintf(out, "\nexpand ms    count  macro\n");
+      for (i=0; i<sexp_macro_profile_count && i<SEXP_MACRO_PROFILE_REPORT_LIMIT; i++)
+        fprintf(out, "%9.1f %8lu  %s\n", macros[i]->time / 1000.0,
+                (unsigned long)macros[i]->count, macros[i]->str);
+    }
+  }
+  free(macros);
+  fclose(out);
+}
+
+/* profile everything loaded from now on, writing the report at exit */
+void sexp_load_profile_start (sexp ctx, const char *path) {
+  if (sexp_load_profile_root) return;
+#if ! SEXP_USE_BOEHM && ! SEXP_USE_MALLOC
+  sexp_load_profile_heap = sexp_context_heap(ctx);
+  sexp_load_profile_sample();
+#endif
+  sexp_load_profile_path = strdup(path && *path ? path : "-");
+  /* open the output now, the context may close stderr before we exit */
+  sexp_load_profile_out = strcmp(sexp_load_profile_path, "-") == 0
+    ? fdopen(dup(fileno(stderr)), "w") : fopen(sexp_load_profile_path, "w");
+  if (!sexp_load_profile_out) {
+    fprintf(stderr, "couldn't open load profile output: %s\n", sexp_load_profile_path);
+    return;
+  }
+  sexp_load_profile_root = sexp_load_profile_make("<startup>");
+  if (!sexp_load_profile_root) return;
+  sexp_load_profile_root->start = sexp_load_profile_last = sexp_load_profile_now();
+  sexp_load_profile_cur = sexp_load_profile_root;
+  sexp_load_profile_cur_phase = SEXP_LOAD_PHASE_OTHER;
+  atexit(sexp_load_profile_report);
+}
+
+#endif
+
+static sexp sexp_load_aux (sexp ctx, sexp self, sexp_sint_t n, sexp source, sexp env) {
 #if SEXP_USE_DL || SEXP_USE_STATIC_LIBS
   const char *suffix;
+  int phase;
+#endif
+#if SEXP_USE_FASL
+  sexp_fasl_writer fasl;
 #endif
   sexp_gc_var5(ctx2, x, in, res, out);
   if (!env) env = sexp_context_env(ctx);
@@ -1429,10 +2786,18 @@ sexp sexp_load_op (sexp ctx, sexp self, sexp_sint_t n, sexp source, sexp env) {
   suffix = sexp_stringp(source) ? sexp_string_data(source)
     + sexp_string_size(source) - strlen(sexp_so_extension) : "...";
   if (strcmp(suffix, sexp_so_extension) == 0) {
+    sexp_load_phase_begin(phase, SEXP_LOAD_PHASE_EXECUTE);
     res = sexp_load_binary(ctx, source, env);
+    sexp_load_phase_end(phase);
   } else {
 #endif
   res = SEXP_VOID;
+#if SEXP_USE_FASL
+  /* use precompiled bytecode if there's an up to date fasl file */
+  res = sexp_stringp(source) ? sexp_load_fasl(ctx, source, env) : SEXP_FALSE;
+  if (res == SEXP_FALSE) {
+  res = SEXP_VOID;
+#endif
   if (sexp_iportp(source)) {
     in = source;
   } else {
@@ -1448,10 +2813,31 @@ sexp sexp_load_op (sexp ctx, sexp self, sexp_sint_t n, sexp source, sexp env) {
     res = in;
   } else {
     sexp_port_sourcep(in) = 1;
+    sexp_port_line(in) = 1;
+    if (sexp_stringp(source) && !sexp_port_buf(in)) {
+      /* read source through a port buffer so the reader can scan */
+      /* tokens in place rather than a char at a time with getc */
+      x = sexp_make_string(ctx, sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE), SEXP_VOID);
+      if (!sexp_exceptionp(x))
+        x = sexp_cons(ctx, x, sexp_port_cookie(in));  /* keep stdio's buffer */
+      if (!sexp_exceptionp(x)) {
+        sexp_port_cookie(in) = x;
+        sexp_port_buf(in) = sexp_string_data(sexp_car(x));
+        sexp_port_offset(in) = sexp_port_size(in) = SEXP_PORT_BUFFER_SIZE;
+      }
+    }
     ctx2 = sexp_make_eval_context(ctx, NULL, env, 0, 0);
     sexp_context_parent(ctx2) = ctx;
     sexp_context_tailp(ctx2) = 0;
+#if SEXP_USE_FASL
+    fasl = sexp_stringp(source) ? sexp_open_fasl_writer(ctx, source, env) : NULL;
+#endif
     while ((x=sexp_read(ctx2, in)) != (sexp) SEXP_EOF) {
+#if SEXP_USE_FASL
+      if (fasl && !sexp_exceptionp(x))
+        res = sexp_fasl_eval(ctx2, fasl, x, env);
+      else
+#endif
       res = sexp_exceptionp(x) ? x : sexp_eval(ctx2, x, env);
       if (sexp_exceptionp(res))
         break;
@@ -1459,15 +2845,60 @@ sexp sexp_load_op (sexp ctx, sexp self, sexp_sint_t n, sexp source, sexp env) {
     sexp_context_last_fp(ctx) = sexp_context_last_fp(ctx2);
     if (x == SEXP_EOF)
       res = SEXP_VOID;
+#if SEXP_USE_FASL
+    if (fasl)
+      sexp_close_fasl_writer(ctx, fasl, source, x == SEXP_EOF);
+#endif
     sexp_close_port(ctx, in);
   }
   sexp_gc_release5(ctx);
+#if SEXP_USE_FASL
+  }
+#endif
 #if SEXP_USE_DL || SEXP_USE_STATIC_LIBS
   }
 #endif
   return res;
 }
 
+sexp sexp_load_op (sexp ctx, sexp self, sexp_sint_t n, sexp source, sexp env) {
+#if SEXP_USE_PROFILE_LOAD
+  struct sexp_load_profile_t *prof = sexp_load_profile_begin(source);
+  sexp res = sexp_load_aux(ctx, self, n, source, env);
+  sexp_load_profile_end(prof);
+  return res;
+#else
+  return sexp_load_aux(ctx, self, n, source, env);
+#endif
+}
+
+/* profile a module as a whole, so its includes and imports are */
+/* nested under it, returning true if a node was started */
+sexp sexp_load_profile_begin_op (sexp ctx, sexp self, sexp_sint_t n, sexp name) {
+#if SEXP_USE_PROFILE_LOAD
+  struct sexp_load_profile_t *node;
+  sexp_gc_var1(str);
+  if (!sexp_load_profile_cur) return SEXP_FALSE;
+  sexp_gc_preserve1(ctx, str);
+  str = sexp_write_to_string(ctx, name);
+  node = sexp_stringp(str) ? sexp_load_profile_begin(str) : NULL;
+  if (node) sexp_load_profile_cur_phase = SEXP_LOAD_PHASE_OTHER;
+  sexp_gc_release1(ctx);
+  return sexp_make_boolean(node != NULL);
+#else
+  return SEXP_FALSE;
+#endif
+}
+
+sexp sexp_load_profile_end_op (sexp ctx, sexp self, sexp_sint_t n, sexp startedp) {
+#if SEXP_USE_PROFILE_LOAD
+  if (sexp_truep(startedp) && sexp_load_profile_cur
+      && sexp_load_profile_cur != sexp_load_profile_root)
+    sexp_load_profile_end(sexp_load_profile_cur);
+#endif
+  return SEXP_VOID;
+}
+
 sexp sexp_register_optimization (sexp ctx, sexp self, sexp_sint_t n, sexp f, sexp priority) {
   sexp_assert_type(ctx, sexp_applicablep, SEXP_PROCEDURE, f);
   sexp_assert_type(ctx, sexp_fixnump, SEXP_FIXNUM, priority);
@@ -1917,12 +3348,13 @@ void sexp_push_utf8_char (sexp ctx, int i, sexp port) {
   unsigned char ch[6];
   int len = sexp_utf8_char_byte_count(i);
   sexp_utf8_encode_char(ch, len, i);
-  if (sexp_port_stream(port))  {
+  if (sexp_port_buf(port)) {
     while (len>0)
-      ungetc(ch[--len], sexp_port_stream(port));
+      if (sexp_port_buf(port)[--sexp_port_offset(port)] != (char)ch[--len])
+        sexp_port_buf(port)[sexp_port_offset(port)] = ch[len];
   } else {
     while (len>0)
-      sexp_port_buf(port)[--sexp_port_offset(port)] = ch[--len];
+      ungetc(ch[--len], sexp_port_stream(port));
   }
 }
 
@@ -1933,6 +3365,7 @@ void sexp_string_utf8_set (sexp ctx, sexp str, sexp index, sexp ch) {
   unsigned char *p, *q;
   int i = sexp_unbox_string_cursor(index), c = sexp_unbox_character(ch),
     old_len, new_len, len;
+  if (sexp_exceptionp(sexp_string_unshare(ctx, str))) return;
   p = (unsigned char*)sexp_string_data(str) + i;
   old_len = sexp_utf8_initial_byte_count(*p);
   new_len = sexp_utf8_char_byte_count(c);
@@ -1944,6 +3377,7 @@ void sexp_string_utf8_set (sexp ctx, sexp str, sexp index, sexp ch) {
       memcpy(q, sexp_string_data(str), i);
       memcpy(q+i+new_len, p+old_len, len-i-new_len+1);
       sexp_string_bytes(str) = b;
+      sexp_string_offset(str) = 0;
       p = q + i;
     }
     sexp_string_size(str) += new_len - old_len;
@@ -2308,6 +3742,22 @@ sexp sexp_load_module_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp file, se
   sexp_assert_type(ctx, sexp_envp, SEXP_ENV, env);
   return sexp_load_module_file(ctx, sexp_string_data(file), env);
 }
+/* the library declarations in file are a source of the module env */
+sexp sexp_note_module_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp env, sexp file) {
+#if SEXP_USE_FASL
+  sexp_gc_var1(path);
+  sexp_assert_type(ctx, sexp_envp, SEXP_ENV, env);
+  sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, file);
+  if (sexp_truep(sexp_global(ctx, SEXP_G_FASL_P))) {
+    sexp_gc_preserve1(ctx, path);
+    path = sexp_find_module_file(ctx, sexp_string_data(file));
+    if (sexp_stringp(path))
+      sexp_fasl_note_source(ctx, env, path);
+    sexp_gc_release1(ctx);
+  }
+#endif
+  return SEXP_VOID;
+}
 sexp sexp_set_current_environment (sexp ctx, sexp self, sexp_sint_t n, sexp env) {
   sexp oldenv;
   sexp_assert_type(ctx, sexp_envp, SEXP_ENV, env);
@@ -2453,6 +3903,8 @@ sexp sexp_load_standard_env (sexp ctx, sexp e, sexp version) {
       tmp = sexp_cons(ctx, sym, tmp);
       sexp_env_next_cell(tmp) = sexp_env_next_cell(sexp_env_bindings(e));
       sexp_env_next_cell(sexp_env_bindings(e)) = tmp;
+      sexp_env_index_invalidate(ctx);
+      sexp_env_index_update(ctx, e);
     }
   }
 #endif
@@ -2498,6 +3950,10 @@ sexp sexp_env_import_op (sexp ctx, sexp self, sexp_sint_t n, sexp to, sexp from,
 #if SEXP_USE_RENAME_BINDINGS
   sexp_env_renames(value) = sexp_env_renames(to);
   sexp_env_renames(to) = SEXP_NULL;
+#endif
+#if SEXP_USE_HASH_ENVS
+  sexp_env_index(value) = sexp_env_index(to);
+  sexp_env_index(to) = NULL;
 #endif
   sexp_immutablep(value) = sexp_immutablep(to);
   sexp_immutablep(to) = sexp_truep(immutp);
@@ -2507,6 +3963,7 @@ sexp sexp_env_import_op (sexp ctx, sexp self, sexp_sint_t n, sexp to, sexp from,
 #if SEXP_USE_RENAME_BINDINGS
     sexp_env_renames(to) = sexp_env_renames(from);
 #endif
+    sexp_env_index_update(ctx, to);
   } else {
     for ( ; sexp_pairp(ls); ls=sexp_cdr(ls)) {
       if (sexp_pairp(sexp_car(ls))) {
@@ -2525,7 +3982,9 @@ sexp sexp_env_import_op (sexp ctx, sexp self, sexp_sint_t n, sexp to, sexp from,
 #if SEXP_USE_WARN_UNDEFS
         if (oldcell
             && sexp_cdr(oldcell) != SEXP_UNDEF
-            && !sexp_same_bindingp(oldcell, value))
+            && !sexp_same_bindingp(oldcell, value)
+            && !sexp_lazy_bindingp(ctx, sexp_cdr(oldcell))
+            && !sexp_lazy_bindingp(ctx, sexp_cdr(value)))
           sexp_warn(ctx, "importing already defined binding: ", newname);
       } else {
         sexp_warn(ctx, "importing undefined variable: ", oldname);
@@ -2541,10 +4000,17 @@ sexp sexp_env_import_op (sexp ctx, sexp self, sexp_sint_t n, sexp to, sexp from,
 #if SEXP_USE_RENAME_BINDINGS
   sexp_env_renames(value) = sexp_env_renames(to);
   sexp_env_renames(to) = SEXP_NULL;
+#endif
+#if SEXP_USE_HASH_ENVS
+  sexp_env_index(value) = sexp_env_index(to);
+  sexp_env_index(to) = NULL;
 #endif
   sexp_env_parent(to) = value;
   sexp_env_bindings(to) = SEXP_NULL;
   sexp_immutablep(to) = 0;
+#if SEXP_USE_FASL
+  sexp_fasl_note_import(ctx, value, from);
+#endif
   sexp_gc_release3(ctx);
   return SEXP_VOID;
 }
@@ -2575,6 +4041,7 @@ sexp sexp_generate_op (sexp ctx, sexp self, sexp_sint_t n, sexp ast, sexp env) {
 }
 
 sexp sexp_compile_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env) {
+  int phase;
   sexp_gc_var3(ast, tmp, res);
   sexp ctx2;
   if (! env) env = sexp_context_env(ctx);
@@ -2586,19 +4053,23 @@ sexp sexp_compile_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env) {
   } else {
     tmp = sexp_context_child(ctx);
     sexp_context_child(ctx) = ctx2;
+    sexp_load_phase_begin(phase, SEXP_LOAD_PHASE_ANALYZE);
     ast = sexp_analyze(ctx2, obj);
     if (sexp_exceptionp(ast)) {
       res = ast;
     } else {
+      sexp_load_phase_set(SEXP_LOAD_PHASE_OPTIMIZE);
       res = sexp_global(ctx2, SEXP_G_OPTIMIZATIONS);
       for ( ; sexp_pairp(res) && !sexp_exceptionp(ast); res=sexp_cdr(res))
         ast = sexp_apply1(ctx2, sexp_cdar(res), ast);
       if (sexp_exceptionp(ast)) {
         res = ast;
       } else {
+        sexp_load_phase_set(SEXP_LOAD_PHASE_GENERATE);
         res = sexp_generate_op(ctx2, self, n, ast, ctx2);
       }
     }
+    sexp_load_phase_end(phase);
     sexp_context_child(ctx) = tmp;
     sexp_context_last_fp(ctx) = sexp_context_last_fp(ctx2);
   }
@@ -2606,7 +4077,9 @@ sexp sexp_compile_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env) {
   return res;
 }
 
-sexp sexp_eval_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env) {
+/* runs obj, compiling it first unless it's already a compiled thunk */
+static sexp sexp_eval_in_context (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env, int compilep) {
+  int phase;
   sexp_sint_t top;
   sexp ctx2;
   sexp_gc_var3(res, tmp, params);
@@ -2619,9 +4092,15 @@ sexp sexp_eval_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env) {
   ctx2 = sexp_make_eval_context(ctx, NULL, env, 0, 0);
   tmp = sexp_context_child(ctx);
   sexp_context_child(ctx) = ctx2;
-  res = sexp_exceptionp(ctx2) ? ctx2 : sexp_compile_op(ctx2, self, n, obj, env);
-  if (! sexp_exceptionp(res))
+  if (sexp_exceptionp(ctx2))
+    res = ctx2;
+  else
+    res = compilep ? sexp_compile_op(ctx2, self, n, obj, env) : obj;
+  if (! sexp_exceptionp(res)) {
+    sexp_load_phase_begin(phase, SEXP_LOAD_PHASE_EXECUTE);
     res = sexp_apply(ctx2, res, SEXP_NULL);
+    sexp_load_phase_end(phase);
+  }
   sexp_context_child(ctx) = tmp;
   sexp_context_params(ctx) = params;
   sexp_context_top(ctx) = top;
@@ -2630,16 +4109,132 @@ sexp sexp_eval_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env) {
   return res;
 }
 
-sexp sexp_eval_string (sexp ctx, const char *str, sexp_sint_t len, sexp env) {
+sexp sexp_eval_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp env) {
+  return sexp_eval_in_context(ctx, self, n, obj, env, 1);
+}
+
+sexp sexp_compile_string (sexp ctx, const char *str, sexp_sint_t len, sexp env) {
   sexp res;
   sexp_gc_var1(obj);
   sexp_gc_preserve1(ctx, obj);
   obj = sexp_read_from_string(ctx, str, len);
-  res = sexp_eval(ctx, obj, env);
+  res = sexp_exceptionp(obj) ? obj : sexp_compile_op(ctx, NULL, 2, obj, env);
   sexp_gc_release1(ctx);
   return res;
 }
 
+sexp sexp_call_compiled (sexp ctx, sexp proc, sexp env) {
+  if (! sexp_procedurep(proc))
+    return sexp_type_exception(ctx, NULL, SEXP_PROCEDURE, proc);
+  return sexp_eval_in_context(ctx, NULL, 2, proc, env, 0);
+}
+
+/* The eval_string cache is a direct-mapped table of entries keyed */
+/* on the text and env.  Compiled code only refers to global cells, */
+/* so redefining variables is seen by cached entries, but redefining */
+/* syntax is not.  Import replaces the bindings and parent of an env */
+/* in place, after which cached code could refer to stale cells, so */
+/* entries also record those and the env index epoch, and are only */
+/* used while all are unchanged. */
+
+#define SEXP_EVAL_CACHE_TEXT      0
+#define SEXP_EVAL_CACHE_ENV       1
+#define SEXP_EVAL_CACHE_PROC      2
+#define SEXP_EVAL_CACHE_BINDINGS  3
+#define SEXP_EVAL_CACHE_RENAMES   4
+#define SEXP_EVAL_CACHE_PARENT    5
+#define SEXP_EVAL_CACHE_EPOCH     6
+#define SEXP_EVAL_CACHE_SIZE      7
+
+#define sexp_eval_cache_slot_ref(entry, i) (sexp_vector_data(entry)[i])
+
+sexp sexp_set_eval_string_cache (sexp ctx, sexp_uint_t size) {
+  sexp cache = size > 0 ? sexp_make_vector(ctx, sexp_make_fixnum(size), SEXP_FALSE)
+    : SEXP_FALSE;
+  if (sexp_exceptionp(cache)) return cache;
+  sexp_global(ctx, SEXP_G_EVAL_CACHE) = cache;
+  return SEXP_VOID;
+}
+
+static sexp *sexp_eval_cache_slot (sexp ctx, const char *str, sexp_sint_t len, sexp env) {
+  sexp cache = sexp_global(ctx, SEXP_G_EVAL_CACHE);
+  sexp_uint_t h = ((sexp_uint_t)env >> 3) ^ 2166136261uL;
+  sexp_sint_t i;
+  if (! sexp_vectorp(cache)) return NULL;
+  for (i=0; i<len; i++)
+    h = (h ^ (unsigned char)str[i]) * 16777619uL;
+  return sexp_vector_data(cache) + h % sexp_vector_length(cache);
+}
+
+/* record the state of env the entry was compiled against */
+static void sexp_eval_cache_stamp (sexp ctx, sexp entry, sexp env) {
+  sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_BINDINGS) = sexp_env_bindings(env);
+#if SEXP_USE_RENAME_BINDINGS
+  sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_RENAMES) = sexp_env_renames(env);
+#endif
+  sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_PARENT) = sexp_env_parent(env);
+#if SEXP_USE_HASH_ENVS
+  sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_EPOCH) = sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH);
+#endif
+}
+
+static int sexp_eval_cache_hitp (sexp ctx, sexp entry, const char *str, sexp_sint_t len, sexp env) {
+  sexp text;
+  if (! (sexp_vectorp(entry)
+         && sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_ENV) == env
+         && sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_BINDINGS) == sexp_env_bindings(env)
+#if SEXP_USE_RENAME_BINDINGS
+         && sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_RENAMES) == sexp_env_renames(env)
+#endif
+         && sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_PARENT) == sexp_env_parent(env)
+#if SEXP_USE_HASH_ENVS
+         && sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_EPOCH) == sexp_global(ctx, SEXP_G_ENV_INDEX_EPOCH)
+#endif
+         ))
+    return 0;
+  text = sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_TEXT);
+  return sexp_string_size(text) == (sexp_uint_t)len
+    && memcmp(sexp_string_data(text), str, len) == 0;
+}
+
+sexp sexp_eval_string (sexp ctx, const char *str, sexp_sint_t len, sexp env) {
+  sexp res, *slot;
+  sexp_gc_var2(obj, entry);
+  if (sexp_vectorp(sexp_global(ctx, SEXP_G_EVAL_CACHE))) {
+    if (len < 0) len = strlen(str);
+    if (! env) env = sexp_context_env(ctx);
+    slot = sexp_eval_cache_slot(ctx, str, len, env);
+    if (sexp_eval_cache_hitp(ctx, *slot, str, len, env))
+      return sexp_call_compiled(ctx, sexp_eval_cache_slot_ref(*slot, SEXP_EVAL_CACHE_PROC), env);
+  }
+  sexp_gc_preserve2(ctx, obj, entry);
+  if (sexp_vectorp(sexp_global(ctx, SEXP_G_EVAL_CACHE))) {
+    obj = sexp_compile_string(ctx, str, len, env);
+    if (sexp_exceptionp(obj)) {
+      res = obj;
+    } else {
+      entry = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_EVAL_CACHE_SIZE), SEXP_FALSE);
+      if (! sexp_exceptionp(entry)) {
+        sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_ENV) = env;
+        sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_PROC) = obj;
+        /* compiling may have defined cells for free variables in env */
+        sexp_eval_cache_stamp(ctx, entry, env);
+        sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_TEXT) = sexp_c_string(ctx, str, len);
+        /* compiling may have run code which resized the cache */
+        if (sexp_stringp(sexp_eval_cache_slot_ref(entry, SEXP_EVAL_CACHE_TEXT))
+            && (slot = sexp_eval_cache_slot(ctx, str, len, env)))
+          *slot = entry;
+      }
+      res = sexp_call_compiled(ctx, obj, env);
+    }
+  } else {
+    obj = sexp_read_from_string(ctx, str, len);
+    res = sexp_eval(ctx, obj, env);
+  }
+  sexp_gc_release2(ctx);
+  return res;
+}
+
 void sexp_scheme_init (void) {
   if (! scheme_initialized_p) {
     scheme_initialized_p = 1;
@@ -0,0 +1,1505 @@
+/*  fasl.c -- precompiled bytecode files                      */
+/*  Copyright (c) 2009-2026 Alex Shinn.  All rights reserved. */
+/*  BSD-style license: http://synthcode.com/license.txt       */
+
+#include "chibi/eval.h"
+
+#if SEXP_USE_FASL
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/* A fasl file caches the compiled top-level forms of a single source */
+/* file, so that loading it again skips reading, expansion, analysis  */
+/* and code generation.  Each form is stored both as the bytecode of  */
+/* its compiled thunk and as the original datum.  Global references   */
+/* in the bytecode are recorded by name and where they were visible   */
+/* from, and relinked against the load environment, so that a fasl    */
+/* is valid for any environment built the same way.  Forms which      */
+/* defined syntax when compiled are only stored as source, and if     */
+/* anything fails to relink the rest of the file is evaluated from    */
+/* source.  Fasls are only loaded or written when enabled with -c,    */
+/* and a fasl is only used if the contents of the source file and of  */
+/* its dependencies are unchanged: the files loaded into the env it   */
+/* was compiled in, or into envs imported there, and the files loaded */
+/* while compiling it, along with their own dependencies.             */
+
+#define SEXP_FASL_MAGIC "chibi-fasl\n"
+#define SEXP_FASL_VERSION 4
+#define SEXP_FASL_MAX_DEPTH 4096
+#define SEXP_FASL_MAX_LENGTH (1<<24)
+
+enum sexp_fasl_records {
+  SEXP_FASL_RECORD_END,
+  SEXP_FASL_RECORD_CODE,
+  SEXP_FASL_RECORD_SOURCE
+};
+
+enum sexp_fasl_tags {
+  SEXP_FASL_NULL = 1,
+  SEXP_FASL_FALSE,
+  SEXP_FASL_TRUE,
+  SEXP_FASL_EOF,
+  SEXP_FASL_VOID,
+  SEXP_FASL_UNDEF,
+  SEXP_FASL_FIXNUM,
+  SEXP_FASL_CHAR,
+  SEXP_FASL_SYMBOL,
+  SEXP_FASL_STRING,
+  SEXP_FASL_PATH,               /* the name of the file being loaded */
+  SEXP_FASL_FLONUM,
+  SEXP_FASL_NUMBER,
+  SEXP_FASL_LIST,
+  SEXP_FASL_VECTOR,
+  SEXP_FASL_BYTES,
+  /* only in compiled code */
+  SEXP_FASL_CELL,
+  SEXP_FASL_VALUE,
+  SEXP_FASL_PROCEDURE,
+  SEXP_FASL_BYTECODE
+};
+
+/* where a global binding was visible from when compiled */
+enum sexp_fasl_places {
+  SEXP_FASL_LOCAL,              /* defined in the load env itself */
+  SEXP_FASL_ENV,                /* imported into the load env */
+  SEXP_FASL_MODULE,             /* from the env of a loaded module */
+  SEXP_FASL_META                /* from the meta env */
+};
+
+/* the object expected from a value reference */
+enum sexp_fasl_kinds {
+  SEXP_FASL_ANY,
+  SEXP_FASL_OPCODE,
+  SEXP_FASL_TYPE
+};
+
+/* pointer and type operands patched into loaded bytecode */
+enum sexp_fasl_fixups {
+  SEXP_FASL_FIX_WORD = 1,       /* any object */
+  SEXP_FASL_FIX_GLOBAL,         /* the cell of a GLOBAL_(KNOWN_)REF */
+  SEXP_FASL_FIX_TYPE            /* the index of a non-core type */
+};
+
+#define SEXP_FASL_PAIR_IMMUTABLE 1
+#define SEXP_FASL_PAIR_LINE 2   /* source is a line in the loaded file */
+#define SEXP_FASL_PAIR_SOURCE 4 /* source is an arbitrary (file . line) */
+
+struct sexp_fasl_buffer {
+  unsigned char *data;
+  size_t len, size;
+  int ok;
+};
+
+struct sexp_fasl_writer_t {
+  struct sexp_fasl_buffer records;
+  char *path;
+  sexp_uint_t hash, size, env_hash, depth;
+};
+
+struct sexp_fasl_out {
+  sexp ctx, env, modules, meta;
+  const char *path;
+  struct sexp_fasl_buffer *buf;
+  int codep;
+};
+
+struct sexp_fasl_in {
+  sexp ctx, env, path;
+  const unsigned char *p, *end;
+};
+
+/************************** utilities *********************************/
+
+/* the size and a hash of the contents of a file, which unlike its */
+/* mtime changes with every edit */
+static int sexp_fasl_stamp (const char *path, sexp_uint_t *hash, sexp_uint_t *size) {
+  unsigned char buf[4096];
+  sexp_uint_t h = (sexp_uint_t)2166136261UL, n = 0;
+  size_t i, len;
+  FILE *in = fopen(path, "rb");
+  if (!in) return 0;
+  while ((len = fread(buf, 1, sizeof(buf), in)) > 0) {
+    for (i=0; i<len; i++)
+      h = (h ^ buf[i]) * 16777619UL;    /* FNV-1a */
+    n += len;
+  }
+  len = ferror(in);
+  fclose(in);
+  if (len) return 0;
+  *hash = h;
+  *size = n;
+  return 1;
+}
+
+/* source.fasl, or dir/source.fasl with the path percent-escaped so */
+/* that distinct sources never share a fasl */
+static char* sexp_fasl_file_name (sexp ctx, sexp path) {
+  sexp dir = sexp_global(ctx, SEXP_G_FASL_DIRECTORY);
+  size_t len = sexp_string_size(path);
+  size_t dlen = sexp_stringp(dir) ? sexp_string_size(dir) : 0;
+  char *res = (char*) malloc(dlen + 1 + 3*len + strlen(sexp_fasl_suffix) + 1);
+  const char *s = sexp_string_data(path);
+  char *p;
+  if (!res) return NULL;
+  p = res;
+  if (dlen > 0) {
+    memcpy(p, sexp_string_data(dir), dlen);
+    p += dlen;
+    *p++ = '/';
+    for ( ; len > 0; s++, len--) {
+      if (*s == '%' || *s == '/' || *s == '\\' || *s == ':') {
+        sprintf(p, "%%%02X", (unsigned char)*s);
+        p += 3;
+      } else {
+        *p++ = *s;
+      }
+    }
+  } else {
+    memcpy(p, s, len);
+    p += len;
+  }
+  strcpy(p, sexp_fasl_suffix);
+  return res;
+}
+
+static sexp sexp_fasl_modules (sexp ctx, sexp *meta) {
+  *meta = sexp_global(ctx, SEXP_G_META_ENV);
+  if (!sexp_envp(*meta)) {
+    *meta = SEXP_FALSE;
+    return SEXP_NULL;
+  }
+  return sexp_env_ref(ctx, *meta, sexp_intern(ctx, "*modules*", -1), SEXP_NULL);
+}
+
+/* modules are (name . #(exports env meta-data ...)) */
+static sexp sexp_fasl_module_env (sexp mod) {
+  if (sexp_pairp(mod) && sexp_vectorp(sexp_cdr(mod))
+      && sexp_vector_length(sexp_cdr(mod)) > 1
+      && sexp_envp(sexp_vector_ref(sexp_cdr(mod), SEXP_ONE)))
+    return sexp_vector_ref(sexp_cdr(mod), SEXP_ONE);
+  return NULL;
+}
+
+/* record accessors may be named by symbols rather than strings */
+static sexp sexp_fasl_opcode_name (sexp ctx, sexp op) {
+  sexp name = sexp_opcode_name(op);
+  return sexp_stringp(name) ? sexp_intern(ctx, sexp_string_data(name), -1) : name;
+}
+
+static sexp_uint_t sexp_fasl_hash_bytes (const char *s, sexp_uint_t len, sexp_uint_t h) {
+  for ( ; len > 0; s++, len--)
+    h = h*31 + (unsigned char)*s;
+  return h;
+}
+
+/* Sources are stamped when they're loaded, and the stamps are kept */
+/* for the rest of the process so that checking and writing the     */
+/* dependencies of other fasls doesn't reread them.  Each file is    */
+/* #(path stamp deps) in a small hash table, where the stamp is #f   */
+/* if it couldn't be read, and deps are the files it depended on.    */
+
+#define SEXP_FASL_FILE_BUCKETS 127
+#define sexp_fasl_file_path(f)  (sexp_vector_data(f)[0])
+#define sexp_fasl_file_stamp(f) (sexp_vector_data(f)[1])
+#define sexp_fasl_file_deps(f)  (sexp_vector_data(f)[2])
+
+static sexp sexp_fasl_file (sexp ctx, const char *path, size_t len, int restampp) {
+  sexp_uint_t i, hash, size;
+  sexp ls, tab = sexp_global(ctx, SEXP_G_FASL_FILES);
+  sexp_gc_var2(file, tmp);
+  i = sexp_fasl_hash_bytes(path, len, 0) % SEXP_FASL_FILE_BUCKETS;
+  file = NULL;
+  if (sexp_vectorp(tab))
+    for (ls=sexp_vector_data(tab)[i]; sexp_pairp(ls); ls=sexp_cdr(ls))
+      if (sexp_string_size(sexp_fasl_file_path(sexp_car(ls))) == len
+          && memcmp(sexp_string_data(sexp_fasl_file_path(sexp_car(ls))), path, len) == 0) {
+        file = sexp_car(ls);
+        if (!restampp) return file;
+        break;
+      }
+  sexp_gc_preserve2(ctx, file, tmp);
+  if (!file) {
+    if (!sexp_vectorp(tab)) {
+      tab = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_FASL_FILE_BUCKETS), SEXP_NULL);
+      if (sexp_exceptionp(tab)) goto fail;
+      sexp_global(ctx, SEXP_G_FASL_FILES) = tab;
+    }
+    file = sexp_make_vector(ctx, SEXP_THREE, SEXP_FALSE);
+    if (sexp_exceptionp(file)) goto fail;
+    tmp = sexp_c_string(ctx, path, len);
+    if (sexp_exceptionp(tmp)) goto fail;
+    sexp_fasl_file_path(file) = tmp;
+    tmp = sexp_cons(ctx, file, sexp_vector_data(tab)[i]);
+    if (sexp_exceptionp(tmp)) goto fail;
+    sexp_vector_data(tab)[i] = tmp;
+  }
+  sexp_fasl_file_stamp(file) = SEXP_FALSE;
+  if (sexp_fasl_stamp(sexp_string_data(sexp_fasl_file_path(file)), &hash, &size)) {
+    tmp = sexp_make_bytes(ctx, sexp_make_fixnum(2*sizeof(sexp_uint_t)), SEXP_ZERO);
+    if (sexp_bytesp(tmp)) {
+      memcpy(sexp_bytes_data(tmp), &hash, sizeof(sexp_uint_t));
+      memcpy(sexp_bytes_data(tmp) + sizeof(sexp_uint_t), &size, sizeof(sexp_uint_t));
+      sexp_fasl_file_stamp(file) = tmp;
+    }
+  }
+  sexp_gc_release2(ctx);
+  return file;
+ fail:
+  sexp_gc_release2(ctx);
+  return NULL;
+}
+
+static int sexp_fasl_file_stamped (sexp file, sexp_uint_t *hash, sexp_uint_t *size) {
+  sexp stamp = sexp_fasl_file_stamp(file);
+  if (!sexp_bytesp(stamp)) return 0;
+  memcpy(hash, sexp_bytes_data(stamp), sizeof(sexp_uint_t));
+  memcpy(size, sexp_bytes_data(stamp) + sizeof(sexp_uint_t), sizeof(sexp_uint_t));
+  return 1;
+}
+
+/* The definitions visible in an env come from the files loaded into */
+/* it and the envs imported into it, which we record as its sources */
+/* in (env . sources).  Where we can, the env is held by an ephemeron */
+/* so that temporary envs can still be collected.                     */
+
+#if SEXP_USE_WEAK_REFERENCES
+#define sexp_fasl_sources_env(x) sexp_ephemeron_key(sexp_car(x))
+#else
+#define sexp_fasl_sources_env(x) sexp_car(x)
+#endif
+#define sexp_fasl_sources(x)     sexp_cdr(x)
+
+static sexp sexp_fasl_env_sources (sexp ctx, sexp env, int createp) {
+  sexp ls, prev = NULL;
+  sexp_gc_var1(res);
+  for (ls=sexp_global(ctx, SEXP_G_FASL_ENV_SOURCES); sexp_pairp(ls); ls=sexp_cdr(ls)) {
+    if (sexp_fasl_sources_env(sexp_car(ls)) == env)
+      return sexp_car(ls);
+    if (!sexp_envp(sexp_fasl_sources_env(sexp_car(ls)))) {
+      /* the env has been collected */
+      if (prev)
+        sexp_cdr(prev) = sexp_cdr(ls);
+      else
+        sexp_global(ctx, SEXP_G_FASL_ENV_SOURCES) = sexp_cdr(ls);
+    } else {
+      prev = ls;
+    }
+  }
+  if (!createp) return NULL;
+  sexp_gc_preserve1(ctx, res);
+#if SEXP_USE_WEAK_REFERENCES
+  res = sexp_make_ephemeron(ctx, env, SEXP_FALSE);
+  if (!sexp_exceptionp(res))
+    res = sexp_cons(ctx, res, SEXP_NULL);
+#else
+  res = sexp_cons(ctx, env, SEXP_NULL);
+#endif
+  if (!sexp_exceptionp(res))
+    sexp_push(ctx, sexp_global(ctx, SEXP_G_FASL_ENV_SOURCES), res);
+  sexp_gc_release1(ctx);
+  return sexp_exceptionp(res) ? NULL : res;
+}
+
+static void sexp_fasl_add_source (sexp ctx, sexp env, sexp x) {
+  sexp_gc_var2(sources, tmp);
+  sexp_gc_preserve2(ctx, sources, tmp);
+  sources = sexp_fasl_env_sources(ctx, env, 1);
+  if (sources && sexp_memq(ctx, x, sexp_fasl_sources(sources)) == SEXP_FALSE) {
+    tmp = sexp_cons(ctx, x, sexp_fasl_sources(sources));
+    if (sexp_pairp(tmp))
+      sexp_fasl_sources(sources) = tmp;
+  }
+  sexp_gc_release2(ctx);
+}
+
+/* The frame holding imported bindings gets the sources from had at */
+/* the time, so that later loads into from aren't counted.            */
+void sexp_fasl_note_import (sexp ctx, sexp frame, sexp from) {
+  sexp_gc_var2(sources, tmp);
+  if (sexp_not(sexp_global(ctx, SEXP_G_FASL_P)) || frame == from)
+    return;
+  sexp_gc_preserve2(ctx, sources, tmp);
+  sources = sexp_fasl_env_sources(ctx, from, 0);
+  tmp = sources ? sexp_fasl_sources(sources) : SEXP_NULL;
+  if (sexp_env_parent(from))
+    tmp = sexp_cons(ctx, sexp_env_parent(from), tmp);
+  if (sexp_pairp(tmp)) {
+    sources = sexp_fasl_env_sources(ctx, frame, 1);
+    if (sources)
+      sexp_fasl_sources(sources) = tmp;
+  }
+  sexp_gc_release2(ctx);
+}
+
+void sexp_fasl_note_source (sexp ctx, sexp env, sexp path) {
+  sexp file;
+  if (sexp_truep(sexp_global(ctx, SEXP_G_FASL_P))
+      && (file = sexp_fasl_file(ctx, sexp_string_data(path), sexp_string_size(path), 0)))
+    sexp_fasl_add_source(ctx, env, file);
+}
+
+/* A completed load is a source of its env, and a dependency of the */
+/* file being compiled while it was loaded, if any.  Library         */
+/* definitions loaded into the meta env only register modules, and   */
+/* are sources of the module envs instead, see %note-module-file.    */
+static void sexp_fasl_note_load (sexp ctx, sexp file, sexp env) {
+  sexp frame, path = sexp_fasl_file_path(file);
+  size_t len = strlen(sexp_meta_file);
+  sexp_gc_var1(tmp);
+  sexp_gc_preserve1(ctx, tmp);
+  if (env != sexp_global(ctx, SEXP_G_META_ENV)
+      || (sexp_string_size(path) >= len
+          && strcmp(sexp_string_data(path) + sexp_string_size(path) - len, sexp_meta_file) == 0))
+    sexp_fasl_add_source(ctx, env, file);
+  frame = sexp_global(ctx, SEXP_G_FASL_LOADING);
+  if (sexp_pairp(frame)
+      && sexp_memq(ctx, file, sexp_cdar(frame)) == SEXP_FALSE) {
+    tmp = sexp_cons(ctx, file, sexp_cdar(frame));
+    if (sexp_pairp(tmp))
+      sexp_cdar(frame) = tmp;
+  }
+  sexp_gc_release1(ctx);
+}
+
+/* the files reachable from the sources of env and its parents, and */
+/* from the files loaded while compiling, other than self            */
+static sexp sexp_fasl_deps (sexp ctx, sexp env, sexp files, sexp self) {
+  sexp x, ls;
+  sexp_gc_var3(res, seen, todo);
+  sexp_gc_preserve3(ctx, res, seen, todo);
+  res = seen = SEXP_NULL;
+  todo = sexp_cons(ctx, env, files);
+  while (sexp_pairp(todo)) {
+    x = sexp_car(todo);
+    todo = sexp_cdr(todo);
+    if (sexp_envp(x)) {
+      if (sexp_memq(ctx, x, seen) != SEXP_FALSE)
+        continue;
+      seen = sexp_cons(ctx, x, seen);
+      if (sexp_env_parent(x) && sexp_envp(sexp_env_parent(x)))
+        todo = sexp_cons(ctx, sexp_env_parent(x), todo);
+      ls = sexp_fasl_env_sources(ctx, x, 0);
+      for (ls=(ls ? sexp_fasl_sources(ls) : SEXP_NULL); sexp_pairp(ls); ls=sexp_cdr(ls))
+        todo = sexp_cons(ctx, sexp_car(ls), todo);
+    } else if (sexp_vectorp(x) && x != self
+               && sexp_memq(ctx, x, res) == SEXP_FALSE) {
+      res = sexp_cons(ctx, x, res);
+      for (ls=sexp_fasl_file_deps(x); sexp_pairp(ls); ls=sexp_cdr(ls))
+        todo = sexp_cons(ctx, sexp_car(ls), todo);
+    }
+    if (sexp_exceptionp(seen) || sexp_exceptionp(res)) {
+      todo = res = SEXP_FALSE;
+    }
+  }
+  if (sexp_exceptionp(todo)) res = SEXP_FALSE;
+  sexp_gc_release3(ctx);
+  return res;
+}
+
+static sexp_uint_t sexp_fasl_hash_binding (sexp name, sexp value) {
+  sexp_uint_t h;
+  sexp src;
+  if (value == SEXP_UNDEF) return 0;
+#if SEXP_USE_HUFF_SYMS
+  if (sexp_isymbolp(name))
+    h = (sexp_uint_t)name;
+  else
+#endif
+  if (sexp_lsymbolp(name))
+    h = sexp_fasl_hash_bytes(sexp_lsymbol_data(name), sexp_lsymbol_length(name), 0);
+  else
+    return 0;
+  if (sexp_opcodep(value) && sexp_stringp(sexp_opcode_name(value)))
+    return sexp_fasl_hash_bytes(sexp_string_data(sexp_opcode_name(value)), sexp_string_size(sexp_opcode_name(value)), h)*4 + 1;
+  if (sexp_opcodep(value))
+    return h*4 + 1;
+  if (sexp_corep(value))
+    return sexp_fasl_hash_bytes(sexp_string_data(sexp_core_name(value)), sexp_string_size(sexp_core_name(value)), h)*4 + 1;
+  if (sexp_macrop(value)) {
+    if (sexp_procedurep(sexp_macro_proc(value))) {
+      src = sexp_bytecode_source(sexp_procedure_code(sexp_macro_proc(value)));
+      if (sexp_pairp(src) && sexp_fixnump(sexp_cdr(src)))
+        h = h*31 + sexp_unbox_fixnum(sexp_cdr(src));
+    }
+    return h*4 + 2;
+  }
+  return h*4 + (sexp_procedurep(value) ? 3 : 0);
+}
+
+/* Included files may be loaded into several envs, and the code     */
+/* compiled for one isn't valid in another which binds different     */
+/* syntax or primitives.  We key fasls on an order independent hash  */
+/* of the kinds of bindings visible when loading starts.             */
+static sexp_uint_t sexp_fasl_env_hash (sexp env) {
+  sexp_uint_t res = 0;
+  sexp ls;
+  for ( ; env && sexp_envp(env); env=sexp_env_parent(env))
+    for (ls=sexp_env_bindings(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+      res += sexp_fasl_hash_binding(sexp_car(ls), sexp_cdr(ls));
+  return res;
+}
+
+static sexp_uint_t sexp_fasl_config (sexp ctx) {
+  int endianess_check = 1;
+  return (*(unsigned char*) &endianess_check ? 1 : 0)
+    + (SEXP_USE_GREEN_THREADS ? 2 : 0)
+    + (SEXP_USE_AUTO_FORCE ? 4 : 0)
+    + (SEXP_USE_FULL_SOURCE_INFO ? 8 : 0)
+    + (SEXP_USE_RESERVE_OPCODE ? 16 : 0)
+    + (SEXP_USE_UNBOXED_LOCALS ? 32 : 0)
+    + (sexp_truep(sexp_global(ctx, SEXP_G_NO_TAIL_CALLS_P)) ? 64 : 0);
+}
+
+/************************** writing ***********************************/
+
+static void sexp_fasl_put_bytes (struct sexp_fasl_buffer *b, const void *src, size_t n) {
+  unsigned char *tmp;
+  size_t size;
+  if (!b->ok) return;
+  if (b->len + n > b->size) {
+    for (size = b->size ? b->size*2 : 256; size < b->len + n; size *= 2)
+      ;
+    tmp = (unsigned char*) realloc(b->data, size);
+    if (!tmp) {
+      b->ok = 0;
+      return;
+    }
+    b->data = tmp;
+    b->size = size;
+  }
+  memcpy(b->data + b->len, src, n);
+  b->len += n;
+}
+
+static void sexp_fasl_put_byte (struct sexp_fasl_buffer *b, int c) {
+  unsigned char ch = (unsigned char) c;
+  sexp_fasl_put_bytes(b, &ch, 1);
+}
+
+static void sexp_fasl_put_uint (struct sexp_fasl_buffer *b, sexp_uint_t n) {
+  do {
+    sexp_fasl_put_byte(b, (n & 0x7F) | (n > 0x7F ? 0x80 : 0));
+    n >>= 7;
+  } while (n > 0);
+}
+
+static void sexp_fasl_put_int (struct sexp_fasl_buffer *b, sexp_sint_t n) {
+  sexp_fasl_put_uint(b, n < 0 ? ((~(sexp_uint_t)n) << 1) | 1 : ((sexp_uint_t)n) << 1);
+}
+
+static void sexp_fasl_put_string (struct sexp_fasl_buffer *b, const char *s, sexp_uint_t n) {
+  sexp_fasl_put_uint(b, n);
+  sexp_fasl_put_bytes(b, s, n);
+}
+
+static void sexp_fasl_put_header (sexp ctx, struct sexp_fasl_buffer *b) {
+  sexp_fasl_put_bytes(b, SEXP_FASL_MAGIC, strlen(SEXP_FASL_MAGIC));
+  sexp_fasl_put_byte(b, SEXP_FASL_VERSION);
+  sexp_fasl_put_uint(b, sizeof(sexp));
+  sexp_fasl_put_uint(b, sizeof(sexp_operand_t));
+  sexp_fasl_put_uint(b, SEXP_OP_NUM_OPCODES);
+  sexp_fasl_put_uint(b, sexp_fasl_config(ctx));
+  sexp_fasl_put_string(b, sexp_version, strlen(sexp_version));
+}
+
+static int sexp_fasl_write (struct sexp_fasl_out *o, sexp x, int depth);
+
+/* find a name under which cell is visible, and where from */
+static sexp sexp_fasl_locate_cell (struct sexp_fasl_out *o, sexp cell, int *place, sexp *modname) {
+  sexp ls, env, name = sexp_car(cell);
+  if (sexp_symbolp(name)) {
+    for (ls=sexp_env_bindings(o->env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+      if (ls == cell) {
+        *place = SEXP_FASL_LOCAL;
+        return name;
+      }
+    if (sexp_env_cell(o->ctx, o->env, name, 0) == cell) {
+      *place = SEXP_FASL_ENV;
+      return name;
+    }
+  }
+#if SEXP_USE_RENAME_BINDINGS
+  for (env=o->env; env && sexp_envp(env); env=sexp_env_parent(env))
+    for (ls=sexp_env_renames(env); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+      if (sexp_cdr(ls) == cell && sexp_symbolp(sexp_car(ls))
+          && sexp_env_cell(o->ctx, o->env, sexp_car(ls), 0) == cell) {
+        *place = SEXP_FASL_ENV;
+        return sexp_car(ls);
+      }
+#endif
+  if (!sexp_symbolp(name))
+    return NULL;
+  for (ls=o->modules; sexp_pairp(ls); ls=sexp_cdr(ls))
+    if ((env=sexp_fasl_module_env(sexp_car(ls)))
+        && sexp_env_cell(o->ctx, env, name, 0) == cell) {
+      *place = SEXP_FASL_MODULE;
+      *modname = sexp_caar(ls);
+      return name;
+    }
+  if (sexp_envp(o->meta) && sexp_env_cell(o->ctx, o->meta, name, 0) == cell) {
+    *place = SEXP_FASL_META;
+    return name;
+  }
+  return NULL;
+}
+
+/* find a name bound to x anywhere in env */
+static sexp sexp_fasl_scan_env (sexp ctx, sexp env, sexp x) {
+  sexp e, ls, cell;
+  for (e=env; e && sexp_envp(e); e=sexp_env_parent(e)) {
+#if SEXP_USE_RENAME_BINDINGS
+    for (ls=sexp_env_renames(e); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+      if (sexp_pairp(sexp_cdr(ls)) && sexp_cdr(sexp_cdr(ls)) == x
+          && sexp_symbolp(sexp_car(ls))
+          && (cell=sexp_env_cell(ctx, env, sexp_car(ls), 0))
+          && sexp_cdr(cell) == x)
+        return sexp_car(ls);
+#endif
+    for (ls=sexp_env_bindings(e); sexp_pairp(ls); ls=sexp_env_next_cell(ls))
+      if (sexp_cdr(ls) == x && sexp_symbolp(sexp_car(ls))
+          && (cell=sexp_env_cell(ctx, env, sexp_car(ls), 0))
+          && sexp_cdr(cell) == x)
+        return sexp_car(ls);
+  }
+  return NULL;
+}
+
+static int sexp_fasl_boundp (sexp ctx, sexp env, sexp name, sexp x) {
+  sexp cell = sexp_env_cell(ctx, env, name, 0);
+  return cell && sexp_cdr(cell) == x;
+}
+
+/* find a name bound to x, trying the suggested name first */
+static sexp sexp_fasl_locate_value (struct sexp_fasl_out *o, sexp x, sexp name, int scanp, int *place, sexp *modname) {
+  sexp ls, env;
+  if (name && sexp_symbolp(name)) {
+    *place = SEXP_FASL_ENV;
+    if (sexp_fasl_boundp(o->ctx, o->env, name, x))
+      return name;
+    *place = SEXP_FASL_MODULE;
+    for (ls=o->modules; sexp_pairp(ls); ls=sexp_cdr(ls))
+      if ((env=sexp_fasl_module_env(sexp_car(ls)))
+          && sexp_fasl_boundp(o->ctx, env, name, x)) {
+        *modname = sexp_caar(ls);
+        return name;
+      }
+    *place = SEXP_FASL_META;
+    if (sexp_envp(o->meta) && sexp_fasl_boundp(o->ctx, o->meta, name, x))
+      return name;
+  }
+  if (scanp) {
+    *place = SEXP_FASL_ENV;
+    if ((name=sexp_fasl_scan_env(o->ctx, o->env, x)))
+      return name;
+    *place = SEXP_FASL_MODULE;
+    for (ls=o->modules; sexp_pairp(ls); ls=sexp_cdr(ls))
+      if ((env=sexp_fasl_module_env(sexp_car(ls)))
+          && (name=sexp_fasl_scan_env(o->ctx, env, x))) {
+        *modname = sexp_caar(ls);
+        return name;
+      }
+    *place = SEXP_FASL_META;
+    if (sexp_envp(o->meta) && (name=sexp_fasl_scan_env(o->ctx, o->meta, x)))
+      return name;
+  }
+  return NULL;
+}
+
+static int sexp_fasl_write_ref (struct sexp_fasl_out *o, int place, sexp modname, sexp name, int depth) {
+  sexp_fasl_put_byte(o->buf, place);
+  if (place == SEXP_FASL_MODULE && !sexp_fasl_write(o, modname, depth+1))
+    return 0;
+  return sexp_fasl_write(o, name, depth+1);
+}
+
+static int sexp_fasl_write_cell (struct sexp_fasl_out *o, sexp cell, int depth) {
+  int place;
+  sexp modname = SEXP_FALSE, name = sexp_fasl_locate_cell(o, cell, &place, &modname);
+  if (!name) return 0;
+  sexp_fasl_put_byte(o->buf, SEXP_FASL_CELL);
+  return sexp_fasl_write_ref(o, place, modname, name, depth);
+}
+
+static int sexp_fasl_write_value (struct sexp_fasl_out *o, sexp x, sexp name, int kind, int scanp, int depth) {
+  int place;
+  sexp modname = SEXP_FALSE;
+  name = sexp_fasl_locate_value(o, x, name, scanp, &place, &modname);
+  if (!name) return 0;
+  sexp_fasl_put_byte(o->buf, SEXP_FASL_VALUE);
+  sexp_fasl_put_byte(o->buf, kind);
+  return sexp_fasl_write_ref(o, place, modname, name, depth);
+}
+
+/* names and source info are only informative */
+static int sexp_fasl_write_optional (struct sexp_fasl_out *o, sexp x, int depth) {
+  size_t len = o->buf->len;
+  int codep = o->codep;
+  o->codep = 0;
+  if (!sexp_fasl_write(o, x, depth+1)) {
+    o->buf->len = len;
+    sexp_fasl_put_byte(o->buf, SEXP_FASL_FALSE);
+  }
+  o->codep = codep;
+  return 1;
+}
+
+static int sexp_fasl_write_list (struct sexp_fasl_out *o, sexp x, int depth) {
+  sexp ls, src;
+  sexp_uint_t n;
+  int flags;
+  for (ls=x, n=0; sexp_pairp(ls); ls=sexp_cdr(ls))
+    if (++n > SEXP_FASL_MAX_LENGTH)
+      return 0;                 /* probably circular */
+  sexp_fasl_put_byte(o->buf, SEXP_FASL_LIST);
+  sexp_fasl_put_uint(o->buf, n);
+  for (ls=x; sexp_pairp(ls); ls=sexp_cdr(ls)) {
+    flags = sexp_immutablep(ls) ? SEXP_FASL_PAIR_IMMUTABLE : 0;
+    src = sexp_pair_source(ls);
+    if (src && sexp_pairp(src) && sexp_fixnump(sexp_cdr(src))) {
+      if (sexp_stringp(sexp_car(src))
+          && strcmp(sexp_string_data(sexp_car(src)), o->path) == 0)
+        flags |= SEXP_FASL_PAIR_LINE;
+      else if (sexp_stringp(sexp_car(src)) || sexp_not(sexp_car(src)))
+        flags |= SEXP_FASL_PAIR_SOURCE;
+    }
+    sexp_fasl_put_byte(o->buf, flags);
+    if (flags & SEXP_FASL_PAIR_SOURCE)
+      sexp_fasl_write(o, sexp_car(src), depth+1);
+    if (flags & (SEXP_FASL_PAIR_LINE|SEXP_FASL_PAIR_SOURCE))
+      sexp_fasl_put_int(o->buf, sexp_unbox_fixnum(sexp_cdr(src)));
+    if (!sexp_fasl_write(o, sexp_car(ls), depth+1))
+      return 0;
+  }
+  return sexp_fasl_write(o, ls, depth+1);
+}
+
+static sexp sexp_fasl_word (unsigned char *data, sexp_uint_t i) {
+  sexp x;
+  memcpy(&x, data+i, sizeof(sexp));
+  return x;
+}
+
+static sexp_sint_t sexp_fasl_operand (unsigned char *data, sexp_uint_t i) {
+  sexp_operand_t n;
+  memcpy(&n, data+i, sizeof(sexp_operand_t));
+  return n;
+}
+
+/* record that the operand at offset i of the bytecode starting at */
+/* start needs to be patched on loading, zeroing any pointer        */
+static void sexp_fasl_put_fixup (struct sexp_fasl_out *o, size_t start, sexp_uint_t i, int kind) {
+  if (o->buf->ok && kind != SEXP_FASL_FIX_TYPE)
+    memset(o->buf->data + start + i, 0, sizeof(sexp));
+  sexp_fasl_put_uint(o->buf, i + 1);
+  sexp_fasl_put_byte(o->buf, kind);
+}
+
+/* an operand that's a user-defined type index is stored as a type */
+static int sexp_fasl_write_type_operand (struct sexp_fasl_out *o, size_t start, unsigned char *data, sexp_uint_t i, int depth) {
+  sexp_sint_t t = sexp_fasl_operand(data, i);
+  if (t < SEXP_NUM_CORE_TYPES) return 1;
+  if (t >= sexp_context_num_types(o->ctx)) return 0;
+  sexp_fasl_put_fixup(o, start, i, SEXP_FASL_FIX_TYPE);
+  return sexp_fasl_write_value(o, sexp_type_by_index(o->ctx, t), NULL, SEXP_FASL_TYPE, 1, depth);
+}
+
+static int sexp_fasl_write_bytecode (struct sexp_fasl_out *o, sexp bc, int depth) {
+  unsigned char *data = sexp_bytecode_data(bc);
+  sexp_uint_t i, next, len = sexp_bytecode_length(bc);
+  size_t start;
+  sexp x, cell;
+  int op, size;
+  if (depth > SEXP_FASL_MAX_DEPTH) return 0;
+  sexp_fasl_put_byte(o->buf, SEXP_FASL_BYTECODE);
+  sexp_fasl_write_optional(o, sexp_bytecode_name(bc), depth);
+  sexp_fasl_write_optional(o, sexp_bytecode_source(bc), depth);
+  sexp_fasl_put_uint(o->buf, sexp_bytecode_max_depth(bc));
+  sexp_fasl_put_uint(o->buf, len);
+  start = o->buf->len;
+  sexp_fasl_put_bytes(o->buf, data, len);
+  for (i=0; i<len; i=next) {
+    op = data[i++];
+    size = sexp_opcode_operand_size(op);
+    if (size < 0 || i + size > len) return 0;
+    next = i + size;
+    switch (op) {
+    case SEXP_OP_FCALL0: case SEXP_OP_FCALL1: case SEXP_OP_FCALL2:
+    case SEXP_OP_FCALL3: case SEXP_OP_FCALL4: case SEXP_OP_FCALLN:
+    case SEXP_OP_PARAMETER_REF:
+      x = sexp_fasl_word(data, i);
+      if (!sexp_opcodep(x)) return 0;
+      sexp_fasl_put_fixup(o, start, i, SEXP_FASL_FIX_WORD);
+      if (!sexp_fasl_write_value(o, x, sexp_fasl_opcode_name(o->ctx, x), SEXP_FASL_OPCODE, 1, depth))
+        return 0;
+      break;
+    case SEXP_OP_PUSH:
+      x = sexp_fasl_word(data, i);
+      sexp_fasl_put_fixup(o, start, i, SEXP_FASL_FIX_WORD);
+      if (!(sexp_pairp(x) && sexp_fasl_write_cell(o, x, depth))) {
+        /* a pair whose identity matters can't be copied */
+        if (sexp_pairp(x) && next < len
+            && (data[next] == SEXP_OP_CDR || data[next] == SEXP_OP_SET_CDR))
+          return 0;
+        if (!sexp_fasl_write(o, x, depth+1))
+          return 0;
+      }
+      break;
+    case SEXP_OP_GLOBAL_REF: case SEXP_OP_GLOBAL_KNOWN_REF:
+      x = sexp_fasl_word(data, i);
+      if (!sexp_pairp(x)) return 0;
+      sexp_fasl_put_fixup(o, start, i, SEXP_FASL_FIX_GLOBAL);
+      if (!sexp_fasl_write_cell(o, x, depth))
+        return 0;
+      break;
+    case SEXP_OP_MAKE_PROCEDURE:
+      for ( ; i<next; i+=sizeof(sexp)) {
+        sexp_fasl_put_fixup(o, start, i, SEXP_FASL_FIX_WORD);
+        if (!sexp_fasl_write(o, sexp_fasl_word(data, i), depth+1))
+          return 0;
+      }
+      break;
+    case SEXP_OP_CALL_KNOWN: case SEXP_OP_TAIL_CALL_KNOWN:
+      i += sizeof(sexp_operand_t);
+      cell = sexp_fasl_word(data, i);
+      if (!sexp_pairp(cell)) return 0;
+      sexp_fasl_put_fixup(o, start, i, SEXP_FASL_FIX_WORD);
+      if (!sexp_fasl_write_cell(o, cell, depth))
+        return 0;
+      break;
+    case SEXP_OP_TYPEP:
+    case SEXP_OP_MAKE: case SEXP_OP_SLOT_REF: case SEXP_OP_SLOT_SET:
+      if (!sexp_fasl_write_type_operand(o, start, data, i, depth))
+        return 0;
+      break;
+    case SEXP_OP_COMPILE_LAZY:
+      /* stubs refer to the uncompiled ast, compile before writing */
+      return 0;
+    default:
+      /* no operands, or only integer operands */
+      break;
+    }
+  }
+  sexp_fasl_put_uint(o->buf, 0);
+  return i == len;
+}
+
+static int sexp_fasl_write (struct sexp_fasl_out *o, sexp x, int depth) {
+  struct sexp_fasl_buffer *b = o->buf;
+  sexp_uint_t i, len;
+  sexp tmp;
+#if SEXP_USE_FLONUMS
+  double d;
+#endif
+  if (depth > SEXP_FASL_MAX_DEPTH) return 0;
+  if (x == SEXP_NULL) {
+    sexp_fasl_put_byte(b, SEXP_FASL_NULL);
+  } else if (x == SEXP_FALSE) {
+    sexp_fasl_put_byte(b, SEXP_FASL_FALSE);
+  } else if (x == SEXP_TRUE) {
+    sexp_fasl_put_byte(b, SEXP_FASL_TRUE);
+  } else if (x == SEXP_EOF) {
+    sexp_fasl_put_byte(b, SEXP_FASL_EOF);
+  } else if (x == SEXP_VOID) {
+    sexp_fasl_put_byte(b, SEXP_FASL_VOID);
+  } else if (x == SEXP_UNDEF) {
+    sexp_fasl_put_byte(b, SEXP_FASL_UNDEF);
+  } else if (sexp_fixnump(x)) {
+    sexp_fasl_put_byte(b, SEXP_FASL_FIXNUM);
+    sexp_fasl_put_int(b, sexp_unbox_fixnum(x));
+  } else if (sexp_charp(x)) {
+    sexp_fasl_put_byte(b, SEXP_FASL_CHAR);
+    sexp_fasl_put_uint(b, sexp_unbox_character(x));
+  } else if (sexp_symbolp(x)) {
+    tmp = sexp_symbol_to_string(o->ctx, x);
+    if (!sexp_stringp(tmp)) return 0;
+    sexp_fasl_put_byte(b, SEXP_FASL_SYMBOL);
+    sexp_fasl_put_string(b, sexp_string_data(tmp), sexp_string_size(tmp));
+#if SEXP_USE_FLONUMS
+  } else if (sexp_flonump(x)) {
+    d = sexp_flonum_value(x);
+    sexp_fasl_put_byte(b, SEXP_FASL_FLONUM);
+    sexp_fasl_put_bytes(b, &d, sizeof(d));
+#endif
+  } else if (sexp_numberp(x)) {
+    tmp = sexp_write_to_string(o->ctx, x);
+    if (!sexp_stringp(tmp)) return 0;
+    sexp_fasl_put_byte(b, SEXP_FASL_NUMBER);
+    sexp_fasl_put_string(b, sexp_string_data(tmp), sexp_string_size(tmp));
+  } else if (!sexp_pointerp(x)) {
+    return 0;
+  } else if (sexp_stringp(x)) {
+    /* usually the port name in source info */
+    if (!sexp_immutablep(x) && strcmp(sexp_string_data(x), o->path) == 0
+        && sexp_string_size(x) == strlen(o->path)) {
+      sexp_fasl_put_byte(b, SEXP_FASL_PATH);
+    } else {
+      sexp_fasl_put_byte(b, SEXP_FASL_STRING);
+      sexp_fasl_put_byte(b, sexp_immutablep(x));
+      sexp_fasl_put_string(b, sexp_string_data(x), sexp_string_size(x));
+    }
+  } else if (sexp_pairp(x)) {
+    return sexp_fasl_write_list(o, x, depth) && b->ok;
+  } else if (sexp_vectorp(x)) {
+    len = sexp_vector_length(x);
+    sexp_fasl_put_byte(b, SEXP_FASL_VECTOR);
+    sexp_fasl_put_byte(b, sexp_immutablep(x));
+    sexp_fasl_put_uint(b, len);
+    for (i=0; i<len; i++)
+      if (!sexp_fasl_write(o, sexp_vector_data(x)[i], depth+1))
+        return 0;
+  } else if (sexp_bytesp(x)) {
+    sexp_fasl_put_byte(b, SEXP_FASL_BYTES);
+    sexp_fasl_put_byte(b, sexp_immutablep(x));
+    sexp_fasl_put_string(b, sexp_bytes_data(x), sexp_bytes_length(x));
+  } else if (!o->codep) {
+    return 0;
+  } else if (sexp_procedurep(x)) {
+    /* a known global procedure, or a copy of a closure with no vars */
+    tmp = sexp_bytecode_name(sexp_procedure_code(x));
+    if (sexp_symbolp(tmp)
+        && sexp_fasl_write_value(o, x, tmp, SEXP_FASL_ANY, 0, depth))
+      return b->ok;
+    if (!(sexp_vectorp(sexp_procedure_vars(x))
+          && sexp_vector_length(sexp_procedure_vars(x)) == 0))
+      return 0;
+    sexp_fasl_put_byte(b, SEXP_FASL_PROCEDURE);
+    sexp_fasl_put_byte(b, (unsigned char) sexp_procedure_flags(x));
+    sexp_fasl_put_uint(b, sexp_procedure_num_args(x));
+    return sexp_fasl_write_bytecode(o, sexp_procedure_code(x), depth+1) && b->ok;
+  } else if (sexp_bytecodep(x)) {
+    return sexp_fasl_write_bytecode(o, x, depth+1) && b->ok;
+  } else if (sexp_opcodep(x)) {
+    return sexp_fasl_write_value(o, x, sexp_fasl_opcode_name(o->ctx, x), SEXP_FASL_OPCODE, 1, depth) && b->ok;
+  } else if (sexp_typep(x)) {
+    return sexp_fasl_write_value(o, x, NULL, SEXP_FASL_TYPE, 1, depth) && b->ok;
+  } else {
+    return 0;
+  }
+  return b->ok;
+}
+
+static void sexp_fasl_init_out (sexp ctx, struct sexp_fasl_out *o, sexp env, const char *path, struct sexp_fasl_buffer *b, int codep) {
+  o->ctx = ctx;
+  o->env = env;
+  o->path = path;
+  o->buf = b;
+  o->codep = codep;
+  o->modules = sexp_fasl_modules(ctx, &o->meta);
+}
+
+sexp_fasl_writer sexp_open_fasl_writer (sexp ctx, sexp path, sexp env) {
+  sexp_fasl_writer w;
+  sexp file;
+  sexp_gc_var1(frame);
+  if (sexp_not(sexp_global(ctx, SEXP_G_FASL_P)) || !sexp_stringp(path))
+    return NULL;
+  w = (sexp_fasl_writer) calloc(1, sizeof(struct sexp_fasl_writer_t));
+  if (!w) return NULL;
+  sexp_gc_preserve1(ctx, frame);
+  w->records.ok = 1;
+  w->path = (char*) malloc(sexp_string_size(path) + 1);
+  /* stamped by sexp_load_fasl just before */
+  file = sexp_fasl_file(ctx, sexp_string_data(path), sexp_string_size(path), 0);
+  frame = file ? sexp_cons(ctx, env, SEXP_NULL) : NULL;
+  if (!w->path || !frame || sexp_exceptionp(frame)
+      || !sexp_fasl_file_stamped(file, &w->hash, &w->size)) {
+    free(w->path);
+    free(w);
+    sexp_gc_release1(ctx);
+    return NULL;
+  }
+  strcpy(w->path, sexp_string_data(path));
+  w->env_hash = sexp_fasl_env_hash(env);
+  /* collects the files loaded while compiling */
+  sexp_push(ctx, sexp_global(ctx, SEXP_G_FASL_LOADING), frame);
+  w->depth = sexp_unbox_fixnum(sexp_length(ctx, sexp_global(ctx, SEXP_G_FASL_LOADING)));
+  sexp_gc_release1(ctx);
+  return w;
+}
+
+/* appends the datum and compiled proc (if non-NULL) for one form */
+static void sexp_fasl_write_record (sexp ctx, sexp_fasl_writer w, sexp obj, sexp proc, sexp env) {
+  struct sexp_fasl_buffer code = {NULL, 0, 0, 1}, datum = {NULL, 0, 0, 1};
+  struct sexp_fasl_out o;
+  sexp_fasl_init_out(ctx, &o, env, w->path, &datum, 0);
+  if (!sexp_fasl_write(&o, obj, 0)) {
+    w->records.ok = 0;          /* can't replay this file */
+  } else {
+    if (proc) {
+      o.buf = &code;
+      o.codep = 1;
+      if (!sexp_fasl_write(&o, proc, 0))
+        code.len = 0;
+    }
+    if (code.len > 0) {
+      sexp_fasl_put_byte(&w->records, SEXP_FASL_RECORD_CODE);
+      sexp_fasl_put_string(&w->records, (char*)code.data, code.len);
+    } else {
+      sexp_fasl_put_byte(&w->records, SEXP_FASL_RECORD_SOURCE);
+    }
+    sexp_fasl_put_string(&w->records, (char*)datum.data, datum.len);
+  }
+  free(code.data);
+  free(datum.data);
+}
+
+/* like sexp_eval, recording the form and its compiled code */
+sexp sexp_fasl_eval (sexp ctx, sexp_fasl_writer w, sexp obj, sexp env) {
+  int phase;
+  sexp_sint_t top;
+  sexp ctx2, syntax;
+  sexp_gc_var3(res, tmp, params);
+  if (! env) env = sexp_context_env(ctx);
+  sexp_gc_preserve3(ctx, res, tmp, params);
+  top = sexp_context_top(ctx);
+  params = sexp_context_params(ctx);
+  sexp_context_params(ctx) = SEXP_NULL;
+  ctx2 = sexp_make_eval_context(ctx, NULL, env, 0, 0);
+  tmp = sexp_context_child(ctx);
+  sexp_context_child(ctx) = ctx2;
+  syntax = sexp_global(ctx, SEXP_G_FASL_SYNTAX_COUNT);
+  res = sexp_exceptionp(ctx2) ? ctx2 : sexp_compile_op(ctx2, NULL, 2, obj, env);
+  if (! sexp_exceptionp(res)) {
+    /* forms defining syntax have compile-time effects, keep the source */
+    sexp_fasl_write_record(ctx2, w, obj, (syntax == sexp_global(ctx, SEXP_G_FASL_SYNTAX_COUNT) ? res : NULL), env);
+    sexp_load_phase_begin(phase, SEXP_LOAD_PHASE_EXECUTE);
+    res = sexp_apply(ctx2, res, SEXP_NULL);
+    sexp_load_phase_end(phase);
+  }
+  sexp_context_child(ctx) = tmp;
+  sexp_context_params(ctx) = params;
+  sexp_context_top(ctx) = top;
+  sexp_context_last_fp(ctx) = sexp_context_last_fp(ctx2);
+  sexp_gc_release3(ctx);
+  return res;
+}
+
+void sexp_close_fasl_writer (sexp ctx, sexp_fasl_writer w, sexp path, int commit) {
+  struct sexp_fasl_buffer b = {NULL, 0, 0, 1};
+  struct sexp_fasl_out o;
+  sexp_uint_t hash, size, n;
+  sexp ls;
+  char *file = NULL, *tmp = NULL;
+  FILE *out;
+  int ok = 0;
+  sexp_gc_var3(src, deps, frame);
+  sexp_gc_preserve3(ctx, src, deps, frame);
+  /* drop the frames of any loads escaped from */
+  while (sexp_unbox_fixnum(sexp_length(ctx, sexp_global(ctx, SEXP_G_FASL_LOADING))) > (sexp_sint_t)w->depth)
+    sexp_global(ctx, SEXP_G_FASL_LOADING) = sexp_cdr(sexp_global(ctx, SEXP_G_FASL_LOADING));
+  frame = SEXP_FALSE;
+  if (sexp_pairp(sexp_global(ctx, SEXP_G_FASL_LOADING))) {
+    frame = sexp_car(sexp_global(ctx, SEXP_G_FASL_LOADING));
+    sexp_global(ctx, SEXP_G_FASL_LOADING) = sexp_cdr(sexp_global(ctx, SEXP_G_FASL_LOADING));
+  }
+  src = sexp_pairp(frame) ? sexp_fasl_file(ctx, w->path, strlen(w->path), 0) : NULL;
+  deps = src ? sexp_fasl_deps(ctx, sexp_car(frame), sexp_cdr(frame), src) : SEXP_FALSE;
+  if (src && sexp_listp(ctx, deps) != SEXP_FALSE)
+    sexp_fasl_file_deps(src) = deps;
+  if (commit && w->records.ok && sexp_listp(ctx, deps) != SEXP_FALSE) {
+    sexp_fasl_put_header(ctx, &b);
+    sexp_fasl_init_out(ctx, &o, sexp_context_env(ctx), w->path, &b, 0);
+    sexp_fasl_write(&o, sexp_global(ctx, SEXP_G_FEATURES), 0);
+    sexp_fasl_put_string(&b, w->path, strlen(w->path));
+    sexp_fasl_put_uint(&b, w->env_hash);
+    sexp_fasl_put_uint(&b, w->hash);
+    sexp_fasl_put_uint(&b, w->size);
+    /* the files loaded or imported into our env or while compiling */
+    for (ls=deps, n=0; sexp_pairp(ls); ls=sexp_cdr(ls))
+      if (sexp_fasl_file_stamped(sexp_car(ls), &hash, &size))
+        n++;
+    sexp_fasl_put_uint(&b, n);
+    for (ls=deps; sexp_pairp(ls); ls=sexp_cdr(ls))
+      if (sexp_fasl_file_stamped(sexp_car(ls), &hash, &size)) {
+        src = sexp_fasl_file_path(sexp_car(ls));
+        sexp_fasl_put_string(&b, sexp_string_data(src), sexp_string_size(src));
+        sexp_fasl_put_uint(&b, hash);
+        sexp_fasl_put_uint(&b, size);
+      }
+    sexp_fasl_put_bytes(&b, w->records.data, w->records.len);
+    sexp_fasl_put_byte(&b, SEXP_FASL_RECORD_END);
+    file = sexp_fasl_file_name(ctx, path);
+    tmp = file ? (char*) malloc(strlen(file) + 32) : NULL;
+    if (b.ok && tmp) {
+      /* write to a temp file and rename so readers never see partial files */
+#ifndef _WIN32
+      sprintf(tmp, "%s.%ld.tmp", file, (long) getpid());
+#else
+      sprintf(tmp, "%s.tmp", file);
+#endif
+      if ((out = fopen(tmp, "wb"))) {
+        ok = fwrite(b.data, 1, b.len, out) == b.len;
+        ok = (fclose(out) == 0) && ok;
+        if (!ok || rename(tmp, file) != 0)
+          remove(tmp);
+      }
+    }
+  }
+  src = sexp_pairp(frame) ? sexp_fasl_file(ctx, w->path, strlen(w->path), 0) : NULL;
+  if (src)
+    sexp_fasl_note_load(ctx, src, sexp_car(frame));
+  sexp_gc_release3(ctx);
+  free(b.data);
+  free(file);
+  free(tmp);
+  free(w->records.data);
+  free(w->path);
+  free(w);
+}
+
+/************************** reading ***********************************/
+
+static int sexp_fasl_get_byte (struct sexp_fasl_in *in) {
+  return in->p < in->end ? *in->p++ : -1;
+}
+
+static int sexp_fasl_get_uint (struct sexp_fasl_in *in, sexp_uint_t *res) {
+  sexp_uint_t n = 0;
+  unsigned int shift = 0;
+  int c;
+  do {
+    if (in->p >= in->end || shift >= sizeof(sexp_uint_t)*8) return 0;
+    c = *in->p++;
+    n |= ((sexp_uint_t)(c & 0x7F)) << shift;
+    shift += 7;
+  } while (c & 0x80);
+  *res = n;
+  return 1;
+}
+
+static int sexp_fasl_get_int (struct sexp_fasl_in *in, sexp_sint_t *res) {
+  sexp_uint_t n;
+  if (!sexp_fasl_get_uint(in, &n)) return 0;
+  *res = (n & 1) ? (sexp_sint_t)~(n >> 1) : (sexp_sint_t)(n >> 1);
+  return 1;
+}
+
+static const unsigned char* sexp_fasl_get_bytes (struct sexp_fasl_in *in, sexp_uint_t n) {
+  const unsigned char *res = in->p;
+  if (n > (sexp_uint_t)(in->end - in->p)) return NULL;
+  in->p += n;
+  return res;
+}
+
+static const unsigned char* sexp_fasl_get_string (struct sexp_fasl_in *in, sexp_uint_t *n) {
+  return sexp_fasl_get_uint(in, n) ? sexp_fasl_get_bytes(in, *n) : NULL;
+}
+
+static sexp sexp_fasl_read (struct sexp_fasl_in *in, int depth);
+
+/* resolve a reference, creating the cell as compilation would have */
+static sexp sexp_fasl_read_ref (struct sexp_fasl_in *in, int cellp, int depth) {
+  sexp ls, meta, env = in->env, res = NULL;
+  int place = sexp_fasl_get_byte(in);
+  sexp_gc_var2(modname, name);
+  sexp_gc_preserve2(in->ctx, modname, name);
+  if (place == SEXP_FASL_MODULE) {
+    env = NULL;
+    if ((modname = sexp_fasl_read(in, depth+1)))
+      for (ls=sexp_fasl_modules(in->ctx, &meta); sexp_pairp(ls); ls=sexp_cdr(ls))
+        if (sexp_pairp(sexp_car(ls))
+            && sexp_truep(sexp_equalp(in->ctx, sexp_caar(ls), modname))) {
+          env = sexp_fasl_module_env(sexp_car(ls));
+          break;
+        }
+  } else if (place == SEXP_FASL_META) {
+    env = sexp_global(in->ctx, SEXP_G_META_ENV);
+  } else if (place != SEXP_FASL_LOCAL && place != SEXP_FASL_ENV) {
+    env = NULL;
+  }
+  name = sexp_fasl_read(in, depth+1);
+  if (env && sexp_envp(env) && name && sexp_symbolp(name)) {
+    res = sexp_env_cell(in->ctx, env, name, place == SEXP_FASL_LOCAL);
+    if (!res && cellp && (place == SEXP_FASL_LOCAL || place == SEXP_FASL_ENV))
+      res = sexp_env_cell_define(in->ctx, env, name, SEXP_UNDEF, NULL);
+    if (res && !sexp_pairp(res))
+      res = NULL;
+  }
+  sexp_gc_release2(in->ctx);
+  return res;
+}
+
+static sexp sexp_fasl_read_list (struct sexp_fasl_in *in, int depth) {
+  sexp_uint_t n;
+  sexp_sint_t line;
+  int flags;
+  sexp_gc_var4(res, last, tmp, src);
+  if (!sexp_fasl_get_uint(in, &n) || n == 0 || n > (sexp_uint_t)(in->end - in->p))
+    return NULL;
+  sexp_gc_preserve4(in->ctx, res, last, tmp, src);
+  res = last = NULL;
+  for ( ; n > 0; n--) {
+    if ((flags = sexp_fasl_get_byte(in)) < 0)
+      goto fail;
+    src = NULL;
+    if (flags & SEXP_FASL_PAIR_SOURCE)
+      if (!(src = sexp_fasl_read(in, depth+1)))
+        goto fail;
+    if (flags & (SEXP_FASL_PAIR_LINE|SEXP_FASL_PAIR_SOURCE)) {
+      if (!sexp_fasl_get_int(in, &line))
+        goto fail;
+      src = sexp_cons(in->ctx, (src ? src : in->path), sexp_make_fixnum(line));
+      if (sexp_exceptionp(src))
+        goto fail;
+    }
+    if (!(tmp = sexp_fasl_read(in, depth+1)))
+      goto fail;
+    tmp = sexp_cons(in->ctx, tmp, SEXP_NULL);
+    if (sexp_exceptionp(tmp))
+      goto fail;
+    if (src) sexp_pair_source(tmp) = src;
+    sexp_immutablep(tmp) = (flags & SEXP_FASL_PAIR_IMMUTABLE) ? 1 : 0;
+    if (last) sexp_cdr(last) = tmp;
+    else res = tmp;
+    last = tmp;
+  }
+  if (!(tmp = sexp_fasl_read(in, depth+1)))
+    goto fail;
+  sexp_cdr(last) = tmp;
+  sexp_gc_release4(in->ctx);
+  return res;
+ fail:
+  sexp_gc_release4(in->ctx);
+  return NULL;
+}
+
+static sexp sexp_fasl_read_bytecode (struct sexp_fasl_in *in, int depth) {
+  sexp_uint_t max_depth, len, off;
+  sexp_operand_t t;
+  const unsigned char *s;
+  sexp res = NULL;
+  int kind;
+  sexp_gc_var4(name, src, bc, tmp);
+  sexp_gc_preserve4(in->ctx, name, src, bc, tmp);
+  if (!(name = sexp_fasl_read(in, depth+1))
+      || !(src = sexp_fasl_read(in, depth+1))
+      || !sexp_fasl_get_uint(in, &max_depth)
+      || !(s = sexp_fasl_get_string(in, &len)))
+    goto done;
+  bc = sexp_alloc_bytecode(in->ctx, len);
+  if (sexp_exceptionp(bc))
+    goto done;
+  sexp_bytecode_name(bc) = name;
+  sexp_bytecode_literals(bc) = SEXP_NULL;
+  sexp_bytecode_source(bc) = src;
+  sexp_bytecode_length(bc) = len;
+  sexp_bytecode_max_depth(bc) = max_depth;
+  memcpy(sexp_bytecode_data(bc), s, len);
+  while (1) {
+    if (!sexp_fasl_get_uint(in, &off))
+      goto done;
+    if (off-- == 0)
+      break;
+    kind = sexp_fasl_get_byte(in);
+    if (off + (kind == SEXP_FASL_FIX_TYPE ? sizeof(sexp_operand_t) : sizeof(sexp)) > len)
+      goto done;
+    if (kind == SEXP_FASL_FIX_WORD || kind == SEXP_FASL_FIX_GLOBAL
+               || kind == SEXP_FASL_FIX_TYPE) {
+      if (!(tmp = sexp_fasl_read(in, depth+1)))
+        goto done;
+    } else {
+      goto done;
+    }
+    if (kind == SEXP_FASL_FIX_TYPE) {
+      if (!sexp_typep(tmp))
+        goto done;
+      t = sexp_type_tag(tmp);
+      memcpy(sexp_bytecode_data(bc) + off, &t, sizeof(t));
+      continue;
+    }
+    if (kind == SEXP_FASL_FIX_GLOBAL) {
+      if (!sexp_pairp(tmp) || off == 0)
+        goto done;
+      /* an unknown global needs the undefined check */
+      if (sexp_bytecode_data(bc)[off-1] == SEXP_OP_GLOBAL_KNOWN_REF
+          && sexp_cdr(tmp) == SEXP_UNDEF)
+        sexp_bytecode_data(bc)[off-1] = SEXP_OP_GLOBAL_REF;
+    }
+    memcpy(sexp_bytecode_data(bc) + off, &tmp, sizeof(sexp));
+    if (sexp_pointerp(tmp) && (SEXP_USE_WEAK_SYMBOLS || !sexp_symbolp(tmp)))
+      sexp_push(in->ctx, sexp_bytecode_literals(bc), tmp);
+  }
+  sexp_bless_bytecode(in->ctx, bc);
+  res = bc;
+ done:
+  sexp_gc_release4(in->ctx);
+  return res;
+}
+
+static sexp sexp_fasl_read (struct sexp_fasl_in *in, int depth) {
+  sexp_uint_t i, n;
+  sexp_sint_t k;
+  const unsigned char *s;
+  sexp res = NULL;
+  int flags;
+#if SEXP_USE_FLONUMS
+  double d;
+#endif
+  sexp_gc_var2(tmp, vec);
+  if (depth > SEXP_FASL_MAX_DEPTH) return NULL;
+  switch (sexp_fasl_get_byte(in)) {
+  case SEXP_FASL_NULL: return SEXP_NULL;
+  case SEXP_FASL_FALSE: return SEXP_FALSE;
+  case SEXP_FASL_TRUE: return SEXP_TRUE;
+  case SEXP_FASL_EOF: return SEXP_EOF;
+  case SEXP_FASL_VOID: return SEXP_VOID;
+  case SEXP_FASL_UNDEF: return SEXP_UNDEF;
+  case SEXP_FASL_PATH: return in->path;
+  case SEXP_FASL_FIXNUM:
+    return sexp_fasl_get_int(in, &k) ? sexp_make_fixnum(k) : NULL;
+  case SEXP_FASL_CHAR:
+    return sexp_fasl_get_uint(in, &n) ? sexp_make_character(n) : NULL;
+  case SEXP_FASL_SYMBOL:
+    if ((s = sexp_fasl_get_string(in, &n)))
+      res = sexp_intern(in->ctx, (const char*)s, n);
+    break;
+  case SEXP_FASL_STRING:
+    flags = sexp_fasl_get_byte(in);
+    if ((s = sexp_fasl_get_string(in, &n))) {
+      res = sexp_c_string(in->ctx, (const char*)s, n);
+      if (sexp_stringp(res)) sexp_immutablep(res) = flags ? 1 : 0;
+    }
+    break;
+#if SEXP_USE_FLONUMS
+  case SEXP_FASL_FLONUM:
+    if ((s = sexp_fasl_get_bytes(in, sizeof(d)))) {
+      memcpy(&d, s, sizeof(d));
+      res = sexp_make_flonum(in->ctx, d);
+    }
+    break;
+#endif
+  case SEXP_FASL_NUMBER:
+    if ((s = sexp_fasl_get_string(in, &n))) {
+      sexp_gc_preserve1(in->ctx, tmp);
+      tmp = sexp_c_string(in->ctx, (const char*)s, n);
+      if (sexp_stringp(tmp))
+        res = sexp_string_to_number(in->ctx, tmp, SEXP_TEN);
+      if (!sexp_numberp(res)) res = NULL;
+      sexp_gc_release1(in->ctx);
+    }
+    return res;
+  case SEXP_FASL_LIST:
+    return sexp_fasl_read_list(in, depth);
+  case SEXP_FASL_VECTOR:
+    flags = sexp_fasl_get_byte(in);
+    if (!sexp_fasl_get_uint(in, &n) || n > (sexp_uint_t)(in->end - in->p))
+      return NULL;
+    sexp_gc_preserve2(in->ctx, tmp, vec);
+    vec = sexp_make_vector(in->ctx, sexp_make_fixnum(n), SEXP_VOID);
+    for (i=0; i<n && sexp_vectorp(vec); i++) {
+      if (!(tmp = sexp_fasl_read(in, depth+1)))
+        break;
+      sexp_vector_data(vec)[i] = tmp;
+    }
+    if (i == n && sexp_vectorp(vec)) {
+      sexp_immutablep(vec) = flags ? 1 : 0;
+      res = vec;
+    }
+    sexp_gc_release2(in->ctx);
+    return res;
+  case SEXP_FASL_BYTES:
+    flags = sexp_fasl_get_byte(in);
+    if ((s = sexp_fasl_get_string(in, &n))) {
+      res = sexp_make_bytes(in->ctx, sexp_make_fixnum(n), SEXP_ZERO);
+      if (sexp_bytesp(res)) {
+        memcpy(sexp_bytes_data(res), s, n);
+        sexp_immutablep(res) = flags ? 1 : 0;
+      }
+    }
+    break;
+  case SEXP_FASL_CELL:
+    return sexp_fasl_read_ref(in, 1, depth);
+  case SEXP_FASL_VALUE:
+    flags = sexp_fasl_get_byte(in);
+    if ((res = sexp_fasl_read_ref(in, 0, depth))) {
+      res = sexp_cdr(res);
+      if ((flags == SEXP_FASL_OPCODE && !sexp_opcodep(res))
+          || (flags == SEXP_FASL_TYPE && !sexp_typep(res)))
+        res = NULL;
+    }
+    return res;
+  case SEXP_FASL_PROCEDURE:
+    flags = sexp_fasl_get_byte(in);
+    if (!sexp_fasl_get_uint(in, &n))
+      return NULL;
+    sexp_gc_preserve2(in->ctx, tmp, vec);
+    tmp = sexp_fasl_read(in, depth+1);
+    if (tmp && sexp_bytecodep(tmp)) {
+      vec = sexp_make_vector(in->ctx, SEXP_ZERO, SEXP_VOID);
+      if (sexp_vectorp(vec))
+        res = sexp_make_procedure(in->ctx, (sexp)(sexp_uint_t)(unsigned char)flags, sexp_make_fixnum(n), tmp, vec);
+    }
+    sexp_gc_release2(in->ctx);
+    break;
+  case SEXP_FASL_BYTECODE:
+    return sexp_fasl_read_bytecode(in, depth);
+  }
+  return (res && sexp_exceptionp(res)) ? NULL : res;
+}
+
+static int sexp_fasl_check_header (struct sexp_fasl_in *in, sexp file) {
+  struct sexp_fasl_buffer b = {NULL, 0, 0, 1};
+  const unsigned char *s;
+  sexp_uint_t hash, h, size, sz, n, len;
+  sexp features;
+  int ok;
+  sexp_gc_var2(dep, deps);
+  sexp_fasl_put_header(in->ctx, &b);
+  ok = b.ok && (s = sexp_fasl_get_bytes(in, b.len)) && memcmp(s, b.data, b.len) == 0;
+  free(b.data);
+  if (!ok) return 0;
+  features = sexp_fasl_read(in, 0);
+  if (!features || !sexp_truep(sexp_equalp(in->ctx, features, sexp_global(in->ctx, SEXP_G_FEATURES))))
+    return 0;
+  if (!(s = sexp_fasl_get_string(in, &len)) || len != sexp_string_size(in->path)
+      || memcmp(s, sexp_string_data(in->path), len) != 0)
+    return 0;
+  if (!sexp_fasl_get_uint(in, &n) || n != sexp_fasl_env_hash(in->env))
+    return 0;
+  if (!sexp_fasl_get_uint(in, &hash) || !sexp_fasl_get_uint(in, &size)
+      || !sexp_fasl_file_stamped(file, &h, &sz)
+      || h != hash || sz != size)
+    return 0;
+  if (!sexp_fasl_get_uint(in, &n))
+    return 0;
+  /* dependencies are compared against the stamps taken when loaded */
+  sexp_gc_preserve2(in->ctx, dep, deps);
+  for (deps=SEXP_NULL, ok=1; ok && n > 0; n--) {
+    ok = (s = sexp_fasl_get_string(in, &len))
+      && sexp_fasl_get_uint(in, &hash) && sexp_fasl_get_uint(in, &size)
+      && (dep = sexp_fasl_file(in->ctx, (const char*)s, len, 0))
+      && sexp_fasl_file_stamped(dep, &h, &sz) && h == hash && sz == size;
+    if (ok) {
+      deps = sexp_cons(in->ctx, dep, deps);
+      ok = sexp_pairp(deps);
+    }
+  }
+  /* and still apply to fasls depending on this one */
+  if (ok)
+    sexp_fasl_file_deps(file) = deps;
+  sexp_gc_release2(in->ctx);
+  return ok;
+}
+
+/* like sexp_eval, for an already compiled thunk */
+static sexp sexp_fasl_apply (sexp ctx, sexp proc, sexp env) {
+  int phase;
+  sexp_sint_t top;
+  sexp ctx2;
+  sexp_gc_var3(res, tmp, params);
+  sexp_gc_preserve3(ctx, res, tmp, params);
+  top = sexp_context_top(ctx);
+  params = sexp_context_params(ctx);
+  sexp_context_params(ctx) = SEXP_NULL;
+  ctx2 = sexp_make_eval_context(ctx, NULL, env, 0, 0);
+  tmp = sexp_context_child(ctx);
+  sexp_context_child(ctx) = ctx2;
+  sexp_load_phase_begin(phase, SEXP_LOAD_PHASE_EXECUTE);
+  res = sexp_exceptionp(ctx2) ? ctx2 : sexp_apply(ctx2, proc, SEXP_NULL);
+  sexp_load_phase_end(phase);
+  sexp_context_child(ctx) = tmp;
+  sexp_context_params(ctx) = params;
+  sexp_context_top(ctx) = top;
+  sexp_context_last_fp(ctx) = sexp_context_last_fp(ctx2);
+  sexp_gc_release3(ctx);
+  return res;
+}
+
+static sexp sexp_fasl_load_records (sexp ctx, struct sexp_fasl_in *in) {
+  const unsigned char *end;
+  sexp_uint_t n;
+  int kind, sourcep = 0;
+  sexp_gc_var3(ctx2, x, res);
+  sexp_gc_preserve3(ctx, ctx2, x, res);
+  res = ctx2 = sexp_make_eval_context(ctx, NULL, in->env, 0, 0);
+  if (!sexp_exceptionp(ctx2)) {
+    sexp_context_parent(ctx2) = ctx;
+    sexp_context_tailp(ctx2) = 0;
+    in->ctx = ctx2;
+    res = SEXP_VOID;
+    while ((kind = sexp_fasl_get_byte(in)) != SEXP_FASL_RECORD_END) {
+      x = NULL;
+      if (kind == SEXP_FASL_RECORD_CODE) {
+        if (!sexp_fasl_get_uint(in, &n) || n > (sexp_uint_t)(in->end - in->p)) {
+          kind = -1;
+          n = 0;
+        }
+        end = in->p + n;
+        /* after any failure to relink, stick to the source */
+        if (kind > 0 && !sourcep && !((x = sexp_fasl_read(in, 0)) && sexp_procedurep(x))) {
+          x = NULL;
+          sourcep = 1;
+        }
+        in->p = end;
+      }
+      if (kind != SEXP_FASL_RECORD_CODE && kind != SEXP_FASL_RECORD_SOURCE) {
+        res = sexp_user_exception(ctx, NULL, "corrupt fasl file", in->path);
+        break;
+      }
+      if (!sexp_fasl_get_uint(in, &n) || n > (sexp_uint_t)(in->end - in->p)) {
+        res = sexp_user_exception(ctx, NULL, "truncated fasl file", in->path);
+        break;
+      }
+      end = in->p + n;
+      if (x) {
+        res = sexp_fasl_apply(ctx2, x, in->env);
+      } else if ((x = sexp_fasl_read(in, 0))) {
+        res = sexp_eval(ctx2, x, in->env);
+      } else {
+        res = sexp_user_exception(ctx, NULL, "corrupt fasl file", in->path);
+      }
+      in->p = end;
+      if (sexp_exceptionp(res))
+        break;
+    }
+    sexp_context_last_fp(ctx) = sexp_context_last_fp(ctx2);
+    if (!sexp_exceptionp(res))
+      res = SEXP_VOID;
+  }
+  sexp_gc_release3(ctx);
+  return res;
+}
+
+/* loads the fasl for path if it's up to date, otherwise returns #f */
+sexp sexp_load_fasl (sexp ctx, sexp path, sexp env) {
+  struct sexp_fasl_in in;
+  unsigned char *data = NULL;
+  char *file;
+  FILE *f;
+  long len = -1;
+  sexp src, res = SEXP_FALSE;
+  if (sexp_not(sexp_global(ctx, SEXP_G_FASL_P)) || !sexp_stringp(path))
+    return SEXP_FALSE;
+  /* the source itself is restamped each time it's loaded */
+  src = sexp_fasl_file(ctx, sexp_string_data(path), sexp_string_size(path), 1);
+  if (!src || !(file = sexp_fasl_file_name(ctx, path)))
+    return SEXP_FALSE;
+  if ((f = fopen(file, "rb"))) {
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) > 0
+        && fseek(f, 0, SEEK_SET) == 0 && (data = (unsigned char*) malloc(len))
+        && fread(data, 1, len, f) != (size_t)len) {
+      free(data);
+      data = NULL;
+    }
+    fclose(f);
+  }
+  free(file);
+  if (data) {
+    in.ctx = ctx;
+    in.env = env ? env : sexp_context_env(ctx);
+    in.path = path;
+    in.p = data;
+    in.end = data + len;
+    if (sexp_fasl_check_header(&in, src)) {
+      res = sexp_fasl_load_records(ctx, &in);
+      if (!sexp_exceptionp(res))
+        sexp_fasl_note_load(ctx, src, in.env);
+    }
+    free(data);
+  }
+  return res;
+}
+
+#endif
@@ -550,6 +550,56 @@ void sexp_mark_global_symbols(sexp ctx) {
 #define sexp_mark_global_symbols(ctx)
 #endif
 
+#if SEXP_USE_WEAK_SYMBOLS
+static sexp sexp_symbol_tables (sexp ctx) {
+  if (!sexp_context_globals(ctx) || !sexp_vectorp(sexp_context_globals(ctx))
+      || !sexp_vectorp(sexp_context_symbols(ctx)))
+    return NULL;
+  return sexp_context_symbols(ctx);
+}
+
+/* mark the tables themselves up front so tracing stops at them */
+static void sexp_premark_symbols (sexp ctx) {
+  int i;
+  sexp tab = sexp_symbol_tables(ctx);
+  if (tab)
+    for (i=SEXP_SYMTAB_TABLE; i<=SEXP_SYMTAB_OLD; i++)
+      if (sexp_vectorp(sexp_vector_data(tab)[i]))
+        sexp_markedp(sexp_vector_data(tab)[i]) = 1;
+}
+
+/* after marking, delete symbols nothing else reached, except those */
+/* interned since the last gc which C code may still hold unrooted */
+static void sexp_sweep_symbols (sexp ctx) {
+  int i;
+  sexp_uint_t j, hash, count;
+  sexp x, table, *v, tab = sexp_symbol_tables(ctx);
+  if (!tab) return;
+  count = sexp_unbox_fixnum(sexp_vector_data(tab)[SEXP_SYMTAB_COUNT]);
+  for (i=SEXP_SYMTAB_TABLE; i<=SEXP_SYMTAB_OLD; i++) {
+    table = sexp_vector_data(tab)[i];
+    if (!sexp_vectorp(table)) continue;
+    v = sexp_vector_data(table);
+    for (j=0; j<sexp_vector_length(table); j+=2) {
+      x = v[j];
+      if (x == SEXP_FALSE || x == SEXP_VOID) continue;
+      hash = sexp_unbox_fixnum(v[j+1]);
+      if (hash & 1) {
+        sexp_markedp(x) = 1;
+        v[j+1] = sexp_make_fixnum(hash & ~(sexp_uint_t)1);
+      } else if (!sexp_markedp(x)) {
+        v[j] = SEXP_VOID;
+        count--;
+      }
+    }
+  }
+  sexp_vector_data(tab)[SEXP_SYMTAB_COUNT] = sexp_make_fixnum(count);
+}
+#else
+#define sexp_premark_symbols(ctx)
+#define sexp_sweep_symbols(ctx)
+#endif
+
 sexp sexp_gc (sexp ctx, size_t *sum_freed) {
   sexp res, finalized SEXP_NO_WARN_UNUSED;
 #if SEXP_USE_TIME_GC
@@ -560,12 +610,17 @@ sexp sexp_gc (sexp ctx, size_t *sum_freed) {
                     sexp_heap_total_size(sexp_context_heap(ctx)));
 #endif
   sexp_mark_global_symbols(ctx);
+  sexp_premark_symbols(ctx);
   sexp_mark(ctx, ctx);
   sexp_conservative_mark(ctx);
+  sexp_sweep_symbols(ctx);
   sexp_reset_weak_references(ctx);
   finalized = sexp_finalize(ctx);
   res = sexp_sweep(ctx, sum_freed);
   ++sexp_context_gc_count(ctx);
+#if SEXP_USE_PROFILE_LOAD
+  ++sexp_context_heap(ctx)->gc_count;
+#endif
 #if SEXP_USE_TIME_GC
   getrusage(RUSAGE_SELF, &end);
   gc_usecs = (end.ru_utime.tv_sec - start.ru_utime.tv_sec) * 1000000 +
@@ -595,6 +650,9 @@ sexp_heap sexp_make_heap (size_t size, size_t max_size, size_t chunk_size) {
   h->data = (char*) sexp_heap_align(sizeof(h->data)+(sexp_uint_t)&(h->data));
   free = h->free_list = (sexp_free_list) h->data;
   h->next = NULL;
+#if SEXP_USE_PROFILE_LOAD
+  h->alloc_bytes = h->gc_count = 0;
+#endif
   next = (sexp_free_list) (((char*)free)+sexp_heap_align(sexp_free_chunk_size));
   free->size = 0; /* actually sexp_heap_align(sexp_free_chunk_size) */
   free->next = next;
@@ -738,6 +796,9 @@ void* sexp_alloc (sexp ctx, size_t size) {
   sexp_context_alloc_count(ctx) += 1;
   sexp_context_alloc_usecs(ctx) += alloc_time;
   sexp_context_alloc_usecs_sq(ctx) += alloc_time*alloc_time;
+#endif
+#if SEXP_USE_PROFILE_LOAD
+  h->alloc_bytes += size;
 #endif
   return res;
 }
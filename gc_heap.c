@@ -176,55 +176,26 @@ static sexp sexp_adjust_fields(sexp dstp, sexp* types, sexp (* adjust_fn)(void *
 static sexp sexp_adjust_bytecode(sexp dstp, sexp (*adjust_fn)(void *, sexp), void *adata) {
   sexp res = SEXP_FALSE;
   sexp   src, dst;
-  sexp*  vec;
+  const char *operands;
   int    i;
-  
+
   for (i=0; i < sexp_bytecode_length(dstp); ) {
-    switch (sexp_bytecode_data(dstp)[i++]) {
-    case SEXP_OP_FCALL0:      case SEXP_OP_FCALL1:
-    case SEXP_OP_FCALL2:      case SEXP_OP_FCALL3:
-    case SEXP_OP_FCALL4:      case SEXP_OP_CALL:
-    case SEXP_OP_TAIL_CALL:   case SEXP_OP_PUSH:
-    case SEXP_OP_GLOBAL_REF:  case SEXP_OP_GLOBAL_KNOWN_REF:
-#if SEXP_USE_GREEN_THREADS
-    case SEXP_OP_PARAMETER_REF:
-#endif
-#if SEXP_USE_EXTENDED_FCALL
-    case SEXP_OP_FCALLN:
-#endif
-      vec = (sexp*)(&(sexp_bytecode_data(dstp)[i]));
-      src = vec[0];
-      if (src && sexp_pointerp(src)) {
-        dst = adjust_fn(adata, src);
-        if (!sexp_pointerp(dst)) {
-          size_t sz = strlen(gc_heap_err_str);
-          snprintf(gc_heap_err_str + sz, ERR_STR_SIZE - sz, " from adjust bytecode, FCALLN");
-          goto done; }
-        vec[0] = dst;
+    operands = sexp_opcode_operands(sexp_bytecode_data(dstp)[i++]);
+    for ( ; operands && *operands; operands++) {
+      if (*operands == 'i') {
+        i += sizeof(sexp_operand_t);
+        continue;
       }
-      /* ... FALLTHROUGH ... */
-    case SEXP_OP_JUMP:        case SEXP_OP_JUMP_UNLESS:
-    case SEXP_OP_STACK_REF:   case SEXP_OP_CLOSURE_REF:
-    case SEXP_OP_LOCAL_REF:   case SEXP_OP_LOCAL_SET:
-    case SEXP_OP_TYPEP:
-#if SEXP_USE_RESERVE_OPCODE
-    case SEXP_OP_RESERVE:
-#endif
-      i += sizeof(sexp); break;
-    case SEXP_OP_MAKE: case SEXP_OP_SLOT_REF: case SEXP_OP_SLOT_SET:
-      i += 2*sizeof(sexp); break;
-    case SEXP_OP_MAKE_PROCEDURE:
-      vec = (sexp*)(&(sexp_bytecode_data(dstp)[i]));
-      src = vec[2];
+      src = *(sexp*)(&(sexp_bytecode_data(dstp)[i]));
       if (src && sexp_pointerp(src)) {
         dst = adjust_fn(adata, src);
-        if (!sexp_pointerp(dst)) { 
+        if (!sexp_pointerp(dst)) {
           size_t sz = strlen(gc_heap_err_str);
-          snprintf(gc_heap_err_str + sz, ERR_STR_SIZE - sz, " from adjust bytecode, PROCEDURE");
+          snprintf(gc_heap_err_str + sz, ERR_STR_SIZE - sz, " from adjust bytecode");
           goto done; }
-        vec[2] = dst;
+        *(sexp*)(&(sexp_bytecode_data(dstp)[i])) = dst;
       }
-      i += 3*sizeof(sexp); break;
+      i += sizeof(sexp);
     }
   }
   res = SEXP_TRUE;
@@ -379,6 +350,26 @@ struct sexp_image_header_t {
   sexp context;
 };
 
+static int is_c_source(const char* filename) {
+  size_t len = strlen(filename);
+  return len > 2 && strcmp(filename + len - 2, ".c") == 0;
+}
+
+/* Write the image as a C array to be linked into an executable. */
+static int save_image_c(FILE *fp, struct sexp_image_header_t* header, void* base, size_t size) {
+  const unsigned char *p;
+  size_t i, j;
+  fprintf(fp, "/* image generated by chibi-scheme -d, do not edit */\n\n"
+          "#include <stddef.h>\n\n"
+          "const unsigned char sexp_static_image[] = {");
+  for (i = j = 0; i < sizeof(*header) + size; i++, j++) {
+    p = i < sizeof(*header) ? (unsigned char*)header + i
+      : (unsigned char*)base + i - sizeof(*header);
+    fprintf(fp, "%s%u,", (j % 20 == 0 ? "\n  " : ""), *p);
+  }
+  fprintf(fp, "\n};\n\nconst size_t sexp_static_image_size = sizeof(sexp_static_image);\n");
+  return !ferror(fp);
+}
 
 sexp sexp_save_image (sexp ctx_in, const char* filename) {
   sexp_heap heap = NULL;
@@ -408,8 +399,10 @@ sexp sexp_save_image (sexp ctx_in, const char* filename) {
   header.base    = base;
   header.context = ctx_out;
 
-  if (! (fwrite(&header, sizeof(header), 1, fp) == 1 &&
-         fwrite(base, size, 1, fp) == 1)) {
+  if (! (is_c_source(filename)
+         ? save_image_c(fp, &header, base, size)
+         : (fwrite(&header, sizeof(header), 1, fp) == 1 &&
+            fwrite(base, size, 1, fp) == 1))) {
     snprintf(gc_heap_err_str, ERR_STR_SIZE, "Error writing image file: %s", filename);
     goto done;
   }
@@ -573,13 +566,7 @@ static sexp load_image_callback_p2 (sexp ctx, sexp dstp, void *user) {
 }
 
 
-static int load_image_header(FILE *fp, struct sexp_image_header_t* header) {
-  if (!fp || !header) { return 0; }
-  
-  if (fread(header, sizeof(struct sexp_image_header_t), 1, fp) != 1) {
-    snprintf(gc_heap_err_str, ERR_STR_SIZE, "couldn't read image header");
-    return 0;
-  }
+static int check_image_header(struct sexp_image_header_t* header) {
   if (memcmp(header->magic, SEXP_IMAGE_MAGIC, sizeof(header->magic)) != 0) {
     snprintf(gc_heap_err_str, ERR_STR_SIZE, "invalid image file magic %s\n", header->magic);
     return 0;
@@ -596,11 +583,64 @@ static int load_image_header(FILE *fp, struct sexp_image_header_t* header) {
   return 1;
 }
 
+static int load_image_header(FILE *fp, struct sexp_image_header_t* header) {
+  if (!fp || !header) { return 0; }
+
+  if (fread(header, sizeof(struct sexp_image_header_t), 1, fp) != 1) {
+    snprintf(gc_heap_err_str, ERR_STR_SIZE, "couldn't read image header");
+    return 0;
+  }
+  return check_image_header(header);
+}
+
 char* sexp_load_image_err() {
   gc_heap_err_str[ERR_STR_SIZE-1] = 0;
   return gc_heap_err_str;
 }
 
+/* Adjust pointers in a packed heap copied to base, returning the context. */
+static sexp load_image_relocate(struct load_image_state* state, struct sexp_image_header_t* header, sexp base, sexp_uint_t heap_max_size) {
+  sexp res = NULL, ctx, *ctx_globals, *ctx_types;
+  int i;
+
+  state->offset = (sexp_sint_t)((sexp_sint_t)base - (sexp_sint_t)header->base);
+  ctx = (sexp)((unsigned char *)header->context + state->offset);
+  sexp_context_heap(ctx) = state->heap;
+
+  /* Type information (specifically, how big types are) is stored as sexps in the
+     heap.  This information is needed to sucessfully walk an arbitrary heap.  A
+     copy of the type array pointers with correct offsets is applied is created outside
+     of the new heap to be used with the pointer adjustment process.
+  */
+  ctx_globals = sexp_vector_data((sexp)((unsigned char*)sexp_context_globals(ctx) + state->offset));
+  ctx_types   = sexp_vector_data((sexp)((unsigned char*)(ctx_globals[SEXP_G_TYPES]) + state->offset));
+  state->types_cnt   = sexp_unbox_fixnum(ctx_globals[SEXP_G_NUM_TYPES]);
+  state->types = malloc(sizeof(sexp) * state->types_cnt);
+  if (!state->types) goto done;
+  for (i = 0; i < state->types_cnt; i++) {
+    state->types[i] = (sexp)((unsigned char *)ctx_types[i] + state->offset);
+  }
+
+  if (sexp_gc_heap_walk(ctx, sexp_context_heap(ctx), state->types, state->types_cnt,
+                        state, NULL, NULL, load_image_callback_p1) != SEXP_TRUE)
+    goto done;
+
+  /* Second pass to fix code references */
+  if (sexp_gc_heap_walk(ctx, sexp_context_heap(ctx), state->types, state->types_cnt,
+                        state, NULL, NULL, load_image_callback_p2) != SEXP_TRUE)
+    goto done;
+
+  if (heap_max_size > SEXP_INITIAL_HEAP_SIZE) {
+    sexp_context_heap(ctx)->max_size = heap_max_size;
+  }
+
+  res = ctx;
+done:
+  if (state->types) free(state->types);
+  state->types = NULL;
+  return res;
+}
+
 static const char* all_paths[] = {sexp_default_module_path, sexp_default_user_module_path};
 
 sexp sexp_load_image (const char* filename, off_t offset, sexp_uint_t heap_free_size, sexp_uint_t heap_max_size) {
@@ -610,7 +650,7 @@ sexp sexp_load_image (const char* filename, off_t offset, sexp_uint_t heap_free_
   char path[512];
   FILE *fp;
   int i, len;
-  sexp res = NULL, ctx = NULL, base, *ctx_globals, *ctx_types;
+  sexp res = NULL, ctx = NULL, base;
 
   gc_heap_err_str[0] = 0;
 
@@ -654,45 +694,45 @@ sexp sexp_load_image (const char* filename, off_t offset, sexp_uint_t heap_free_
     goto done;
   }
 
-  /* Adjust pointers in loaded packed heap. */
+  ctx = load_image_relocate(&state, &header, base, heap_max_size);
 
-  state.offset = (sexp_sint_t)((sexp_sint_t)base - (sexp_sint_t)header.base);
-  ctx = (sexp)((unsigned char *)header.context + state.offset);
-  sexp_context_heap(ctx) = state.heap;
+  res = ctx;
+done:
+  if (fp) fclose(fp);
+  if (state.heap && !ctx) free(state.heap);
+  return res;
+}
 
-  /* Type information (specifically, how big types are) is stored as sexps in the
-     heap.  This information is needed to sucessfully walk an arbitrary heap.  A
-     copy of the type array pointers with correct offsets is applied is created outside
-     of the new heap to be used with the pointer adjustment process.
-  */
-  ctx_globals = sexp_vector_data((sexp)((unsigned char*)sexp_context_globals(ctx) + state.offset));
-  ctx_types   = sexp_vector_data((sexp)((unsigned char*)(ctx_globals[SEXP_G_TYPES]) + state.offset));
-  state.types_cnt   = sexp_unbox_fixnum(ctx_globals[SEXP_G_NUM_TYPES]);
-  state.types = malloc(sizeof(sexp) * state.types_cnt);
-  if (!state.types) goto done;
-  for (i = 0; i < state.types_cnt; i++) {
-    state.types[i] = (sexp)((unsigned char *)ctx_types[i] + state.offset);
-  }
+sexp sexp_load_image_from_memory (const void* image, size_t image_size, sexp_uint_t heap_free_size, sexp_uint_t heap_max_size) {
+  struct load_image_state state;
+  struct sexp_image_header_t header;
+  sexp ctx = NULL, base;
 
-  if (sexp_gc_heap_walk(ctx, sexp_context_heap(ctx), state.types, state.types_cnt,
-                        &state, NULL, NULL, load_image_callback_p1) != SEXP_TRUE)
-    goto done;
+  gc_heap_err_str[0] = 0;
+  memset(&state, 0, sizeof(struct load_image_state));
 
-  /* Second pass to fix code references */
-  if (sexp_gc_heap_walk(ctx, sexp_context_heap(ctx), state.types, state.types_cnt,
-                        &state, NULL, NULL, load_image_callback_p2) != SEXP_TRUE)
-    goto done;
+  if (image_size < sizeof(header)) {
+    snprintf(gc_heap_err_str, ERR_STR_SIZE, "couldn't read image header");
+    return NULL;
+  }
+  memcpy(&header, image, sizeof(header));
+  if (!check_image_header(&header)) return NULL;
+  if (image_size - sizeof(header) < header.size) {
+    snprintf(gc_heap_err_str, ERR_STR_SIZE, "error reading image\n");
+    return NULL;
+  }
 
-  if (heap_max_size > SEXP_INITIAL_HEAP_SIZE) {
-    sexp_context_heap(ctx)->max_size = heap_max_size;
+  state.heap = sexp_gc_packed_heap_make(header.size, heap_free_size);
+  if (!state.heap) {
+    snprintf(gc_heap_err_str, ERR_STR_SIZE, "couldn't malloc heap\n");
+    return NULL;
   }
+  base = sexp_heap_first_block(state.heap);
+  memcpy(base, (const unsigned char*)image + sizeof(header), header.size);
 
-  res = ctx;
-done:
-  if (fp) fclose(fp);
-  if (state.heap && !ctx) free(state.heap);
-  if (state.types) free(state.types);
-  return res;
+  ctx = load_image_relocate(&state, &header, base, heap_max_size);
+  if (!ctx) free(state.heap);
+  return ctx;
 }
 
 #else
@@ -701,6 +741,10 @@ sexp sexp_load_image (const char* filename, sexp_uint_t heap_free_size, sexp_uin
   return NULL;
 }
 
+sexp sexp_load_image_from_memory (const void* image, size_t image_size, sexp_uint_t heap_free_size, sexp_uint_t heap_max_size) {
+  return NULL;
+}
+
 #endif
 
 
@@ -31,6 +31,18 @@ enum sexp_core_form_names {
   SEXP_CORE_LETREC_SYNTAX
 };
 
+/* where the time loading a file goes, for the -P profiler */
+enum sexp_load_phases {
+  SEXP_LOAD_PHASE_OTHER,
+  SEXP_LOAD_PHASE_READ,
+  SEXP_LOAD_PHASE_EXPAND,
+  SEXP_LOAD_PHASE_ANALYZE,
+  SEXP_LOAD_PHASE_OPTIMIZE,
+  SEXP_LOAD_PHASE_GENERATE,
+  SEXP_LOAD_PHASE_EXECUTE,
+  SEXP_LOAD_NUM_PHASES
+};
+
 enum sexp_opcode_classes {
   SEXP_OPC_GENERIC = 1,
   SEXP_OPC_TYPE_PREDICATE,
@@ -50,6 +62,11 @@ enum sexp_opcode_classes {
 SEXP_API const char** sexp_opcode_names;
 #endif
 
+#if SEXP_USE_FASL
+#define sexp_fasl_suffix ".fasl"
+typedef struct sexp_fasl_writer_t *sexp_fasl_writer;
+#endif
+
 /**************************** prototypes ******************************/
 
 SEXP_API void sexp_warn (sexp ctx, const char *msg, sexp x);
@@ -78,11 +95,34 @@ SEXP_API void sexp_expand_bcode (sexp ctx, sexp_sint_t size);
 SEXP_API void sexp_stack_trace (sexp ctx, sexp out);
 SEXP_API sexp sexp_free_vars (sexp context, sexp x, sexp fv);
 SEXP_API int sexp_param_index (sexp ctx, sexp lambda, sexp name);
+SEXP_API int sexp_free_var_index (sexp ctx, sexp lambda, sexp name, sexp loc);
 SEXP_API sexp sexp_compile_op (sexp context, sexp self, sexp_sint_t n, sexp obj, sexp env);
 SEXP_API sexp sexp_generate_op (sexp context, sexp self, sexp_sint_t n, sexp obj, sexp env);
 SEXP_API sexp sexp_eval_op (sexp context, sexp self, sexp_sint_t n, sexp obj, sexp env);
 SEXP_API sexp sexp_eval_string (sexp context, const char *str, sexp_sint_t len, sexp env);
+SEXP_API sexp sexp_compile_string (sexp context, const char *str, sexp_sint_t len, sexp env);
+SEXP_API sexp sexp_call_compiled (sexp context, sexp proc, sexp env);
+SEXP_API sexp sexp_set_eval_string_cache (sexp context, sexp_uint_t size);
 SEXP_API sexp sexp_load_op (sexp context, sexp self, sexp_sint_t n, sexp expr, sexp env);
+#if SEXP_USE_FASL
+SEXP_API sexp sexp_load_fasl (sexp ctx, sexp path, sexp env);
+SEXP_API sexp_fasl_writer sexp_open_fasl_writer (sexp ctx, sexp path, sexp env);
+SEXP_API sexp sexp_fasl_eval (sexp ctx, sexp_fasl_writer w, sexp obj, sexp env);
+SEXP_API void sexp_close_fasl_writer (sexp ctx, sexp_fasl_writer w, sexp path, int commit);
+SEXP_API void sexp_fasl_note_import (sexp ctx, sexp frame, sexp from);
+SEXP_API void sexp_fasl_note_source (sexp ctx, sexp env, sexp path);
+#endif
+#if SEXP_USE_PROFILE_LOAD
+SEXP_API void sexp_load_profile_start (sexp ctx, const char *path);
+SEXP_API int sexp_load_profile_phase (int phase);
+#define sexp_load_phase_begin(var, phase) ((var) = sexp_load_profile_phase(phase))
+#define sexp_load_phase_end(var) sexp_load_profile_phase(var)
+#define sexp_load_phase_set(phase) sexp_load_profile_phase(phase)
+#else
+#define sexp_load_phase_begin(var, phase) ((var) = 0)
+#define sexp_load_phase_end(var) ((void)(var))
+#define sexp_load_phase_set(phase)
+#endif
 SEXP_API sexp sexp_exception_type_op (sexp ctx, sexp self, sexp_sint_t n, sexp exn);
 SEXP_API sexp sexp_make_env_op (sexp context, sexp self, sexp_sint_t n);
 SEXP_API sexp sexp_make_null_env_op (sexp context, sexp self, sexp_sint_t n, sexp version);
@@ -98,22 +138,30 @@ SEXP_API sexp sexp_load_module_file (sexp ctx, const char *file, sexp env);
 SEXP_API sexp sexp_current_module_path_op (sexp ctx, sexp self, sexp_sint_t n, sexp x);
 SEXP_API sexp sexp_find_module_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp file);
 SEXP_API sexp sexp_load_module_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp file, sexp env);
+SEXP_API void sexp_init_module_path (sexp ctx);
 SEXP_API sexp sexp_add_module_directory_op (sexp ctx, sexp self, sexp_sint_t n, sexp dir, sexp appendp);
 SEXP_API sexp sexp_current_environment (sexp ctx, sexp self, sexp_sint_t n);
 SEXP_API sexp sexp_set_current_environment (sexp ctx, sexp self, sexp_sint_t n, sexp env);
 SEXP_API sexp sexp_meta_environment (sexp ctx, sexp self, sexp_sint_t n);
 SEXP_API sexp sexp_extend_env (sexp ctx, sexp env, sexp vars, sexp value);
 SEXP_API sexp sexp_env_import_op (sexp ctx, sexp self, sexp_sint_t n, sexp to, sexp from, sexp ls, sexp immutp);
+SEXP_API sexp sexp_make_lazy_env_op (sexp ctx, sexp self, sexp_sint_t n, sexp ls, sexp thunk);
+SEXP_API sexp sexp_note_module_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp env, sexp file);
+SEXP_API sexp sexp_load_profile_begin_op (sexp ctx, sexp self, sexp_sint_t n, sexp name);
+SEXP_API sexp sexp_load_profile_end_op (sexp ctx, sexp self, sexp_sint_t n, sexp startedp);
 SEXP_API sexp sexp_env_exports_op (sexp ctx, sexp self, sexp_sint_t n, sexp env);
 SEXP_API sexp sexp_identifierp_op(sexp ctx, sexp self, sexp_sint_t n, sexp x);
 SEXP_API sexp sexp_identifier_eq_op(sexp ctx, sexp self, sexp_sint_t n, sexp a, sexp b, sexp c, sexp d);
 SEXP_API sexp sexp_make_synclo_op(sexp ctx, sexp self, sexp_sint_t n, sexp env, sexp fv, sexp expr);
 SEXP_API sexp sexp_strip_synclos(sexp ctx, sexp self, sexp_sint_t n, sexp x);
+#if SEXP_USE_NATIVE_SYNTAX_RULES
+SEXP_API sexp sexp_syntax_rules_expand_op(sexp ctx, sexp self, sexp_sint_t n, sexp rules, sexp expr, sexp rename, sexp use_env);
+#endif
 SEXP_API sexp sexp_syntactic_closure_expr_op(sexp ctx, sexp self, sexp_sint_t n, sexp x);
-SEXP_API sexp sexp_open_input_file_op(sexp ctx, sexp self, sexp_sint_t n, sexp x);
-SEXP_API sexp sexp_open_output_file_op(sexp ctx, sexp self, sexp_sint_t n, sexp x);
-SEXP_API sexp sexp_open_binary_input_file(sexp ctx, sexp self, sexp_sint_t n, sexp x);
-SEXP_API sexp sexp_open_binary_output_file(sexp ctx, sexp self, sexp_sint_t n, sexp x);
+SEXP_API sexp sexp_open_input_file_op(sexp ctx, sexp self, sexp_sint_t n, sexp x, sexp size);
+SEXP_API sexp sexp_open_output_file_op(sexp ctx, sexp self, sexp_sint_t n, sexp x, sexp size);
+SEXP_API sexp sexp_open_binary_input_file(sexp ctx, sexp self, sexp_sint_t n, sexp x, sexp size);
+SEXP_API sexp sexp_open_binary_output_file(sexp ctx, sexp self, sexp_sint_t n, sexp x, sexp size);
 SEXP_API sexp sexp_close_port_op(sexp ctx, sexp self, sexp_sint_t n, sexp x);
 SEXP_API sexp sexp_set_port_line_op (sexp ctx, sexp self, sexp_sint_t n, sexp port, sexp line);
 SEXP_API sexp sexp_env_define (sexp ctx, sexp env, sexp sym, sexp val);
@@ -260,8 +308,8 @@ SEXP_API int sexp_rest_unused_p (sexp lambda);
 #define sexp_identifierp(ctx, x) sexp_identifierp_op(ctx, NULL, 1, x)
 #define sexp_identifier_to_symbol(ctx, x) sexp_syntactic_closure_expr_op(ctx, NULL, 1, x)
 #define sexp_identifier_eq(ctx, a, b, c, d) sexp_identifier_eq_op(ctx, NULL, 4, a, b, c, d)
-#define sexp_open_input_file(ctx, x) sexp_open_input_file_op(ctx, NULL, 1, x)
-#define sexp_open_output_file(ctx, x) sexp_open_output_file_op(ctx, NULL, 1, x)
+#define sexp_open_input_file(ctx, x) sexp_open_input_file_op(ctx, NULL, 1, x, SEXP_FALSE)
+#define sexp_open_output_file(ctx, x) sexp_open_output_file_op(ctx, NULL, 1, x, SEXP_FALSE)
 #define sexp_close_port(ctx, x) sexp_close_port_op(ctx, NULL, 1, x)
 #define sexp_warn_undefs(ctx, from, to, res) sexp_warn_undefs_op(ctx, NULL, 3, from, to, res)
 #define sexp_string_cmp(ctx, a, b, c) sexp_string_cmp_op(ctx, NULL, 3, a, b, c)
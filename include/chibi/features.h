@@ -10,6 +10,10 @@
 /* uncomment this to disable interpreter-based threads */
 /* #define SEXP_USE_GREEN_THREADS 0 */
 
+/* uncomment this to wait for green thread I/O with poll() instead */
+/*   of epoll on Linux */
+/* #define SEXP_USE_EPOLL 0 */
+
 /* uncomment this to enable the experimental native x86 backend */
 /* #define SEXP_USE_NATIVE_X86 1 */
 
@@ -192,6 +196,11 @@
 /*   non-immediate symbols in a single list. */
 /* #define SEXP_USE_HASH_SYMS 0 */
 
+/* uncomment this to keep interned symbols alive forever */
+/*   By default the native GC holds the symbol table weakly, so */
+/*   symbols no longer referenced from anywhere else are freed. */
+/* #define SEXP_USE_WEAK_SYMBOLS 0 */
+
 /* uncomment this to disable extended char names as defined in R7RS */
 /* #define SEXP_USE_EXTENDED_CHAR_NAMES 0 */
 
@@ -210,18 +219,17 @@
 /*   Making them immutable allows for packed UTF-8 strings. */
 /* #define SEXP_USE_MUTABLE_STRINGS 0 */
 
-/* uncomment this to enable precomputed index->cursor tables for strings */
-/*   This makes string-ref faster at the expensive of making string */
-/*   construction (including string-append and I/O) slower. */
-/*   You can configure with SEXP_STRING_INDEX_TABLE_CHUNK_SIZE below, */
-/*   the default is caching every 64th index (<=12.5% string overhead). */
-/*   With a minimum of 1 you'd have up to 8x string overhead, and */
-/*   string-ref would still be slightly slower than string-cursors, */
-/*   and string-append would be marginally slower as well.          */
+/* uncomment this to disable index->cursor tables for strings */
+/*   With UTF-8 strings string-ref and string-set! by index scan from */
+/*   the start.  By default a string which has been scanned by index  */
+/*   lookups for more than its full size is indexed lazily: ASCII-only */
+/*   strings are then indexed directly, and other strings get a table */
+/*   caching every SEXP_STRING_INDEX_TABLE_CHUNK_SIZE'th index (64 by  */
+/*   default, <=12.5% string overhead), so loops over string-ref take */
+/*   amortized O(1) per char.  Construction isn't slowed down, and a  */
+/*   string only pays for its table once it's actually indexed.       */
 /*                                                                  */
-/*   In practice, the overhead of iterating over a string with      */
-/*   string-ref isn't noticeable until about 10k chars.  Times      */
-/*   for iteration using the different approaches:                  */
+/*   Times for iteration using the different approaches:            */
 /*                                                                  */
 /*   impl\len               1000   10000  100000  1000000           */
 /*   string-ref (utf8)         1      97    9622        x           */
@@ -229,7 +237,22 @@
 /*   cursor-ref (srfi 130)     0       4      18      150           */
 /*   text-ref (srfi 135)       2      27     211     2006           */
 /*                                                                  */
-/* #define SEXP_USE_STRING_INDEX_TABLE 1 */
+/* #define SEXP_USE_STRING_INDEX_TABLE 0 */
+
+/* uncomment this to disable shared substrings */
+/*   By default substring (and string-copy) of a long enough suffix */
+/*   of a string returns a view sharing the original bytes, copying */
+/*   them on the first mutation of either string.  Only suffixes    */
+/*   are shared so the data remains NUL-terminated for C code.      */
+/*   Slices shorter than SEXP_SHARED_SUBSTRING_MIN_SIZE bytes, or   */
+/*   less than 1/SEXP_SHARED_SUBSTRING_MAX_RATIO of the parent's    */
+/*   bytes, are still copied so that small strings don't keep huge  */
+/*   parents alive.  Middle ranges, and so most reader tokens,      */
+/*   string-split fields and other short pieces, are always copied. */
+/*   The shared mark is never cleared: once a string's bytes have   */
+/*   been shared, each string using them copies them on its first   */
+/*   mutation, even after all the other strings are collected.      */
+/* #define SEXP_USE_SHARED_SUBSTRINGS 0 */
 
 /* uncomment this to disable automatic closing of ports */
 /*   If enabled, the underlying FILE* for file ports will be */
@@ -237,6 +260,15 @@
 /*   apply to stdin/stdout/stderr. */
 /* #define SEXP_USE_AUTOCLOSE_PORTS 0 */
 
+/* uncomment this to disable memory-mapped input file ports */
+/*   open-mmap-input-file maps the file and reads it in place. */
+/* #define SEXP_USE_MMAP_PORTS 0 */
+
+/* uncomment this to use the default buffer size for regular files */
+/*   Ports on regular files get a larger buffer by default, since */
+/*   they're usually read or written in bulk. */
+/* #define SEXP_FILE_PORT_BUFFER_SIZE SEXP_PORT_BUFFER_SIZE */
+
 /* uncomment this to use a 2010/01/01 epoch */
 /*   By default chibi uses the normal 1970 unix epoch in accordance */
 /*   with R7RS, but this can represent more times as fixnums. */
@@ -261,6 +293,59 @@
 /*   This is required on some platforms, e.g. ARM */
 /* #define SEXP_USE_ALIGNED_BYTECODE */
 
+/* uncomment this to use full words for integer bytecode operands */
+/* #define SEXP_USE_COMPACT_BYTECODE 0 */
+
+/* uncomment this to disable loading and writing precompiled .fasl files */
+/*   When enabled, running with -c writes a <file>.fasl (or one in */
+/*   the directory named by CHIBI_FASL_DIRECTORY) for every source */
+/*   file loaded, and loads an up to date one in place of the source. */
+/* #define SEXP_USE_FASL 0 */
+
+/* uncomment this to boot main from an image linked into the executable */
+/*   Requires image loading.  The chibi-scheme-image make target dumps */
+/*   the standard environment to chibi-image.c and links it in, so */
+/*   startup copies the heap instead of loading any Scheme files. */
+/* #define SEXP_USE_STATIC_IMAGE 1 */
+
+/* uncomment this to disable hashed lookup in large environments */
+/*   Frames with at least SEXP_ENV_HASH_THRESHOLD bindings and renames */
+/*   get an open-addressed index of their cells, which is consulted */
+/*   instead of scanning the binding lists. */
+/* #define SEXP_USE_HASH_ENVS 0 */
+
+/* uncomment this to disable the lazy loading mode (-L) */
+/*   When the mode is on, top-level procedures are compiled on their */
+/*   first call, and libraries with an explicit export list are only */
+/*   loaded once one of their bindings is referenced. */
+/* #define SEXP_USE_LAZY_LOAD 0 */
+
+/* uncomment this to disable the start-up profiler (-P) */
+/*   When running with -P<file>, or with CHIBI_LOAD_PROFILE set to */
+/*   <file>, the time spent reading, expanding, analyzing, optimizing, */
+/*   generating and executing each loaded file, and the time spent */
+/*   in each macro's transformer, is written to <file> at exit, as a */
+/*   Chrome trace if it ends in .json. */
+/* #define SEXP_USE_PROFILE_LOAD 0 */
+
+/* uncomment this to expand syntax-rules macros in Scheme */
+/*   By default each syntax-rules transformer is compiled to a small */
+/*   data representation which is matched and instantiated in C, */
+/*   rather than generating a Scheme procedure per macro. */
+/* #define SEXP_USE_NATIVE_SYNTAX_RULES 0 */
+
+/* uncomment this to find shared structure for write in Scheme */
+/*   By default write and write-shared detect cycles and sharing in */
+/*   C, skipping the search entirely for small acyclic data. */
+/* #define SEXP_USE_NATIVE_WRITE_SHARED 0 */
+
+/* uncomment this to disable the fork-server mode (-Z) */
+/*   A chibi-scheme run with -Z <socket> loads its other options, */
+/*   then forks a worker per connection on <socket>.  Any later run */
+/*   with CHIBI_ZYGOTE=<socket> hands its command line, environment */
+/*   and stdio to a worker instead of starting from scratch. */
+/* #define SEXP_USE_ZYGOTE 0 */
+
 /************************************************************************/
 /* These settings are configurable but only recommended for */
 /* experienced users, and only apply when using the native GC.  */
@@ -395,6 +480,14 @@
 #define SEXP_USE_DEBUG_THREADS 0
 #endif
 
+#ifndef SEXP_USE_EPOLL
+#if defined(__linux__)
+#define SEXP_USE_EPOLL SEXP_USE_GREEN_THREADS
+#else
+#define SEXP_USE_EPOLL 0
+#endif
+#endif
+
 #ifndef SEXP_USE_AUTO_FORCE
 #define SEXP_USE_AUTO_FORCE 0
 #endif
@@ -564,6 +657,38 @@
 #endif
 #endif
 
+#ifndef SEXP_USE_HASH_ENVS
+#define SEXP_USE_HASH_ENVS ! SEXP_USE_NO_FEATURES
+#endif
+
+#ifndef SEXP_ENV_HASH_THRESHOLD
+#define SEXP_ENV_HASH_THRESHOLD 32
+#endif
+
+#ifndef SEXP_USE_LAZY_LOAD
+#define SEXP_USE_LAZY_LOAD ! SEXP_USE_NO_FEATURES
+#endif
+
+#ifndef SEXP_USE_PROFILE_LOAD
+#define SEXP_USE_PROFILE_LOAD ! SEXP_USE_NO_FEATURES
+#endif
+
+#ifndef SEXP_USE_NATIVE_SYNTAX_RULES
+#define SEXP_USE_NATIVE_SYNTAX_RULES ! SEXP_USE_NO_FEATURES
+#endif
+
+#ifndef SEXP_USE_NATIVE_WRITE_SHARED
+#define SEXP_USE_NATIVE_WRITE_SHARED ! SEXP_USE_NO_FEATURES
+#endif
+
+#ifndef SEXP_USE_ZYGOTE
+#if defined(_WIN32) || defined(PLAN9) || defined(EMSCRIPTEN)
+#define SEXP_USE_ZYGOTE 0
+#else
+#define SEXP_USE_ZYGOTE ! SEXP_USE_NO_FEATURES
+#endif
+#endif
+
 #ifndef SEXP_USE_SPLICING_LET_SYNTAX
 #define SEXP_USE_SPLICING_LET_SYNTAX 0
 #endif
@@ -676,6 +801,10 @@
 #define SEXP_USE_HASH_SYMS ! SEXP_USE_NO_FEATURES
 #endif
 
+#ifndef SEXP_USE_WEAK_SYMBOLS
+#define SEXP_USE_WEAK_SYMBOLS (! SEXP_USE_GLOBAL_SYMBOLS && ! SEXP_USE_NO_FEATURES)
+#endif
+
 #ifndef SEXP_USE_FOLD_CASE_SYMS
 #define SEXP_USE_FOLD_CASE_SYMS ! SEXP_USE_NO_FEATURES
 #endif
@@ -684,6 +813,11 @@
 #define SEXP_DEFAULT_FOLD_CASE_SYMS 0
 #endif
 
+/* call globals bound to procedures of known arity without checks */
+#ifndef SEXP_USE_DIRECT_CALLS
+#define SEXP_USE_DIRECT_CALLS ! SEXP_USE_NO_FEATURES
+#endif
+
 /* experimental optimization to use jumps instead of the TAIL-CALL opcode */
 #ifndef SEXP_USE_TAIL_JUMPS
 /* #define SEXP_USE_TAIL_JUMPS ! SEXP_USE_NO_FEATURES */
@@ -694,6 +828,12 @@
 #define SEXP_USE_RESERVE_OPCODE SEXP_USE_TAIL_JUMPS
 #endif
 
+/* only box set! variables which are captured by a closure, or whose */
+/* frame may be captured by a continuation */
+#ifndef SEXP_USE_ESCAPE_ANALYSIS
+#define SEXP_USE_ESCAPE_ANALYSIS ! SEXP_USE_NO_FEATURES
+#endif
+
 /* experimental optimization to avoid boxing locals which aren't set! */
 #ifndef SEXP_USE_UNBOXED_LOCALS
 /* #define SEXP_USE_UNBOXED_LOCALS ! SEXP_USE_NO_FEATURES */
@@ -731,11 +871,11 @@
 #define SEXP_USE_PACKED_STRINGS 1
 #endif
 
-#if SEXP_USE_PACKED_STRINGS
+#if SEXP_USE_PACKED_STRINGS || ! SEXP_USE_UTF8_STRINGS
 #define SEXP_USE_STRING_INDEX_TABLE 0
 #endif
 #ifndef SEXP_USE_STRING_INDEX_TABLE
-#define SEXP_USE_STRING_INDEX_TABLE 0
+#define SEXP_USE_STRING_INDEX_TABLE ! SEXP_USE_NO_FEATURES
 #endif
 
 /* for every chunk_size indexes store the precomputed offset */
@@ -743,6 +883,21 @@
 #define SEXP_STRING_INDEX_TABLE_CHUNK_SIZE 64
 #endif
 
+#if SEXP_USE_PACKED_STRINGS
+#define SEXP_USE_SHARED_SUBSTRINGS 0
+#endif
+#ifndef SEXP_USE_SHARED_SUBSTRINGS
+#define SEXP_USE_SHARED_SUBSTRINGS ! SEXP_USE_NO_FEATURES
+#endif
+
+#ifndef SEXP_SHARED_SUBSTRING_MIN_SIZE
+#define SEXP_SHARED_SUBSTRING_MIN_SIZE 64
+#endif
+
+#ifndef SEXP_SHARED_SUBSTRING_MAX_RATIO
+#define SEXP_SHARED_SUBSTRING_MAX_RATIO 4
+#endif
+
 #ifndef SEXP_USE_DISJOINT_STRING_CURSORS
 #define SEXP_USE_DISJOINT_STRING_CURSORS SEXP_USE_UTF8_STRINGS
 #endif
@@ -767,6 +922,22 @@
 #define SEXP_PORT_BUFFER_SIZE 4096
 #endif
 
+#ifndef SEXP_USE_MMAP_PORTS
+#if defined(PLAN9) || defined(_WIN32)
+#define SEXP_USE_MMAP_PORTS 0
+#else
+#define SEXP_USE_MMAP_PORTS ! SEXP_USE_NO_FEATURES
+#endif
+#endif
+
+#ifndef SEXP_FILE_PORT_BUFFER_SIZE
+#define SEXP_FILE_PORT_BUFFER_SIZE 65536
+#endif
+
+#ifndef SEXP_STRING_PORT_MAX_CHUNK_SIZE
+#define SEXP_STRING_PORT_MAX_CHUNK_SIZE (SEXP_PORT_BUFFER_SIZE*256)
+#endif
+
 #ifndef SEXP_USE_NTP_GETTIME
 #define SEXP_USE_NTP_GETTIME 0
 #endif
@@ -838,6 +1009,10 @@
 #define SEXP_USE_IMAGE_LOADING SEXP_USE_DL && SEXP_64_BIT && !SEXP_USE_GLOBAL_HEAP && !SEXP_USE_BOEHM && !SEXP_USE_NO_FEATURES
 #endif
 
+#ifndef SEXP_USE_STATIC_IMAGE
+#define SEXP_USE_STATIC_IMAGE 0
+#endif
+
 #ifndef SEXP_USE_UNSAFE_PUSH
 #define SEXP_USE_UNSAFE_PUSH 0
 #endif
@@ -880,10 +1055,29 @@
 #endif
 #endif
 
+/* 32-bit integer operands (compact operands would break alignment) */
+#ifndef SEXP_USE_COMPACT_BYTECODE
+#define SEXP_USE_COMPACT_BYTECODE ! SEXP_USE_ALIGNED_BYTECODE
+#endif
+
+/* peephole optimize completed bytecode (compaction would break alignment) */
+#ifndef SEXP_USE_PEEPHOLE
+#define SEXP_USE_PEEPHOLE ! SEXP_USE_NO_FEATURES && ! SEXP_USE_ALIGNED_BYTECODE
+#endif
+
 #ifndef SEXP_USE_SIGNED_SHIFTS
 #define SEXP_USE_SIGNED_SHIFTS 0
 #endif
 
+/* precompiled bytecode files (operands are assumed to be unpadded) */
+#ifndef SEXP_USE_FASL
+#if defined(PLAN9)
+#define SEXP_USE_FASL 0
+#else
+#define SEXP_USE_FASL ! SEXP_USE_NO_FEATURES && ! SEXP_USE_NATIVE_X86 && ! SEXP_USE_ALIGNED_BYTECODE
+#endif
+#endif
+
 #ifdef PLAN9
 #define strcasecmp cistrcmp
 #define strncasecmp cistrncmp
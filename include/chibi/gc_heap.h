@@ -65,6 +65,10 @@ SEXP_API sexp sexp_gc_heap_pack(sexp ctx, sexp_uint_t heap_free_size);
    sexp_load_image, sexp_load_image_err() can also be used to return the
    error condition.
 
+   If filename ends in ".c" the image is instead written as C source
+   defining sexp_static_image, for linking into a SEXP_USE_STATIC_IMAGE
+   executable.
+
    In all cases, upon completion the temporary packed context is deleted 
    and the context provided as an argument is not changed.
 */
@@ -89,6 +93,21 @@ SEXP_API sexp sexp_save_image (sexp ctx, const char* filename);
 SEXP_API sexp sexp_load_image (const char* filename, off_t offset, sexp_uint_t heap_free_size, sexp_uint_t heap_max_size);
 
 
+/* As sexp_load_image, but from an image already in memory, such as
+   the output of sexp_save_image to a ".c" file compiled into the
+   executable.  The image is copied, and can be read-only.
+*/
+SEXP_API sexp sexp_load_image_from_memory (const void* image, size_t image_size, sexp_uint_t heap_free_size, sexp_uint_t heap_max_size);
+
+#if SEXP_USE_STATIC_IMAGE
+/* The image generated by "make chibi-image.c", linked into the
+   executable for SEXP_USE_STATIC_IMAGE builds.
+*/
+extern const unsigned char sexp_static_image[];
+extern const size_t sexp_static_image_size;
+#endif
+
+
 /* In the case that sexp_load_image() returns NULL, this function will return
    a string containing a description of the error condition.
 */
@@ -13,6 +13,9 @@ extern "C" {
 #endif
 
 #define SEXP_MODULE_PATH_VAR "CHIBI_MODULE_PATH"
+#define SEXP_FASL_DIRECTORY_VAR "CHIBI_FASL_DIRECTORY"
+#define SEXP_LOAD_PROFILE_VAR "CHIBI_LOAD_PROFILE"
+#define SEXP_ZYGOTE_VAR "CHIBI_ZYGOTE"
 #define SEXP_NO_SYSTEM_PATH_VAR "CHIBI_IGNORE_SYSTEM_PATH"
 
 #include "chibi/features.h"
@@ -155,6 +158,11 @@ typedef s64int int64_t;
 #define SEXP_SYMBOL_TABLE_SIZE 1
 #endif
 
+/* initial capacity of the growable per-heap symbol table, a power of 2 */
+#ifndef SEXP_SYMBOL_TABLE_INITIAL_SIZE
+#define SEXP_SYMBOL_TABLE_INITIAL_SIZE 512
+#endif
+
 enum sexp_types {
   SEXP_OBJECT,
   SEXP_TYPE,
@@ -360,6 +368,9 @@ struct sexp_heap_t {
   sexp_uint_t size, max_size, chunk_size;
   sexp_free_list free_list;
   sexp_heap next;
+#if SEXP_USE_PROFILE_LOAD
+  sexp_uint_t alloc_bytes, gc_count;  /* totals, kept in the first heap */
+#endif
   /* note this must be aligned on a proper heap boundary, */
   /* so we can't just use char data[] */
   char *data;
@@ -420,6 +431,7 @@ struct sexp_struct {
   unsigned int freep:1;
   unsigned int brokenp:1;
   unsigned int syntacticp:1;
+  unsigned int sharedp:1;
 #if SEXP_USE_TRACK_ALLOC_SOURCE
   const char* source;
   void* backtrace[SEXP_BACKTRACE_SIZE];
@@ -508,6 +520,9 @@ struct sexp_struct {
       sexp parent, lambda, bindings;
 #if SEXP_USE_STABLE_ABI || SEXP_USE_RENAME_BINDINGS
       sexp renames;
+#endif
+#if SEXP_USE_STABLE_ABI || SEXP_USE_HASH_ENVS
+      sexp index;
 #endif
     } env;
     struct {
@@ -534,7 +549,7 @@ struct sexp_struct {
     struct sexp_core_form_struct core;
     /* ast types */
     struct {
-      sexp name, params, body, defs, locals, flags, fv, sv, ret, types, source;
+      sexp name, params, body, defs, locals, flags, fv, sv, ret, types, source, bv, index;
     } lambda;
     struct {
       sexp test, pass, fail, source;
@@ -758,6 +773,7 @@ void* sexp_alloc(sexp ctx, size_t size);
 #define sexp_immutablep(x)       ((x)->immutablep)
 #define sexp_freep(x)            ((x)->freep)
 #define sexp_brokenp(x)          ((x)->brokenp)
+#define sexp_sharedp(x)          ((x)->sharedp)
 #define sexp_pointer_magic(x)    ((x)->magic)
 
 #if SEXP_USE_TRACK_ALLOC_SOURCE
@@ -894,7 +910,8 @@ SEXP_API int sexp_idp(sexp x);
 
 #define sexp_stream_portp(x) (sexp_port_stream(x) != NULL)
 
-#define sexp_port_customp(x) (sexp_vectorp(sexp_port_cookie(x)) && sexp_vector_length(sexp_port_cookie(x)) == 6)
+#define sexp_port_customp(x) (sexp_vectorp(sexp_port_cookie(x)) && sexp_vector_length(sexp_port_cookie(x)) == 8)
+#define sexp_mapped_portp(x) (sexp_cpointerp(sexp_port_cookie(x)) && !sexp_port_stream(x))
 
 /* only valid on custom ports */
 #define sexp_port_buffer(x)  (sexp_vector_ref(sexp_port_cookie(x), SEXP_ONE))
@@ -902,6 +919,8 @@ SEXP_API int sexp_idp(sexp x);
 #define sexp_port_writer(x)  (sexp_vector_ref(sexp_port_cookie(x), SEXP_THREE))
 #define sexp_port_seeker(x)  (sexp_vector_ref(sexp_port_cookie(x), SEXP_FOUR))
 #define sexp_port_closer(x)  (sexp_vector_ref(sexp_port_cookie(x), SEXP_FIVE))
+#define sexp_port_frame(x)   (sexp_vector_ref(sexp_port_cookie(x), SEXP_SIX))
+#define sexp_port_chunks(x)  (sexp_vector_ref(sexp_port_cookie(x), SEXP_SEVEN))
 
 /***************************** constructors ****************************/
 
@@ -1249,6 +1268,7 @@ enum sexp_uniform_vector_type {
 #define sexp_env_parent(x)        (sexp_field(x, env, SEXP_ENV, parent))
 #define sexp_env_bindings(x)      (sexp_field(x, env, SEXP_ENV, bindings))
 #define sexp_env_renames(x)       (sexp_field(x, env, SEXP_ENV, renames))
+#define sexp_env_index(x)         (sexp_field(x, env, SEXP_ENV, index))
 #define sexp_env_local_p(x)       (sexp_env_parent(x))
 #define sexp_env_global_p(x)      (! sexp_env_local_p(x))
 #define sexp_env_lambda(x)        (sexp_field(x, env, SEXP_ENV, lambda))
@@ -1301,9 +1321,11 @@ enum sexp_uniform_vector_type {
 #define sexp_lambda_body(x)        (sexp_field(x, lambda, SEXP_LAMBDA, body))
 #define sexp_lambda_fv(x)          (sexp_field(x, lambda, SEXP_LAMBDA, fv))
 #define sexp_lambda_sv(x)          (sexp_field(x, lambda, SEXP_LAMBDA, sv))
+#define sexp_lambda_bv(x)          (sexp_field(x, lambda, SEXP_LAMBDA, bv))
 #define sexp_lambda_return_type(x) (sexp_field(x, lambda, SEXP_LAMBDA, ret))
 #define sexp_lambda_param_types(x) (sexp_field(x, lambda, SEXP_LAMBDA, types))
 #define sexp_lambda_source(x)      (sexp_field(x, lambda, SEXP_LAMBDA, source))
+#define sexp_lambda_index(x)       (sexp_field(x, lambda, SEXP_LAMBDA, index))
 
 #define sexp_cnd_test(x)      (sexp_field(x, cnd, SEXP_CND, test))
 #define sexp_cnd_pass(x)      (sexp_field(x, cnd, SEXP_CND, pass))
@@ -1415,7 +1437,15 @@ SEXP_API sexp_heap sexp_global_heap;
 #define sexp_context_symbols(ctx) sexp_symbol_table
 SEXP_API sexp sexp_symbol_table[SEXP_SYMBOL_TABLE_SIZE];
 #else
-#define sexp_context_symbols(ctx) sexp_vector_data(sexp_global(ctx, SEXP_G_SYMBOLS))
+/* a vector with an open-addressed table of alternating symbol and */
+/* hash slots, and the smaller table it is being rehashed from */
+#define sexp_context_symbols(ctx) sexp_global(ctx, SEXP_G_SYMBOLS)
+#define SEXP_SYMTAB_TABLE      0
+#define SEXP_SYMTAB_OLD        1  /* #f once fully migrated */
+#define SEXP_SYMTAB_MIGRATE    2  /* next slot of OLD to move */
+#define SEXP_SYMTAB_COUNT      3  /* live symbols in both tables */
+#define SEXP_SYMTAB_USED       4  /* TABLE slots in use, including deleted */
+#define SEXP_SYMTAB_SIZE       5
 #endif
 
 #define sexp_context_types(ctx)    sexp_vector_data(sexp_global(ctx, SEXP_G_TYPES))
@@ -1541,6 +1571,23 @@ enum sexp_context_globals {
   SEXP_G_RANDOM_SOURCE,
   SEXP_G_STRICT_P,
   SEXP_G_NO_TAIL_CALLS_P,
+  SEXP_G_NO_PEEPHOLE_P,
+  SEXP_G_EVAL_CACHE,            /* compiled sexp_eval_string exprs, or #f */
+#if SEXP_USE_FASL
+  SEXP_G_FASL_P,                /* load and write .fasl files for sources */
+  SEXP_G_FASL_DIRECTORY,        /* where to keep them, #f for alongside */
+  SEXP_G_FASL_FILES,            /* stamps and dependencies of sources */
+  SEXP_G_FASL_ENV_SOURCES,      /* files and envs loaded into each env */
+  SEXP_G_FASL_LOADING,          /* files loaded by each file compiling */
+  SEXP_G_FASL_SYNTAX_COUNT,     /* number of top-level syntax definitions */
+#endif
+#if SEXP_USE_HASH_ENVS
+  SEXP_G_ENV_INDEX_EPOCH,       /* bumped to invalidate all env indexes */
+#endif
+#if SEXP_USE_LAZY_LOAD
+  SEXP_G_LAZY_LOAD_P,           /* compile and import lazily (-L) */
+  SEXP_G_LAZY_BINDING_TAG,      /* marks the values of lazy imports */
+#endif
 #if SEXP_USE_STABLE_ABI || SEXP_USE_FOLD_CASE_SYMS
   SEXP_G_FOLD_CASE_P,
 #endif
@@ -1606,7 +1653,7 @@ SEXP_API sexp sexp_push_op(sexp ctx, sexp* loc, sexp x);
 /***************************** general API ****************************/
 
 #define sexp_read_char(x, p) (sexp_port_buf(p) ? ((sexp_port_offset(p) < sexp_port_size(p)) ? ((unsigned char*)sexp_port_buf(p))[sexp_port_offset(p)++] : sexp_buffered_read_char(x, p)) : getc(sexp_port_stream(p)))
-#define sexp_push_char(x, c, p) ((c!=EOF) && (sexp_port_buf(p) ? (sexp_port_buf(p)[--sexp_port_offset(p)] = ((char)(c))) : ungetc(c, sexp_port_stream(p))))
+#define sexp_push_char(x, c, p) ((c!=EOF) && (sexp_port_buf(p) ? (sexp_port_buf(p)[--sexp_port_offset(p)] == ((char)(c)) || (sexp_port_buf(p)[sexp_port_offset(p)] = ((char)(c)))) : ungetc(c, sexp_port_stream(p))))
 #define sexp_write_char(x, c, p) (sexp_port_buf(p) ? ((sexp_port_offset(p) < sexp_port_size(p)) ? ((((sexp_port_buf(p))[sexp_port_offset(p)++]) = (char)(c)), 0) : sexp_buffered_write_char(x, c, p)) : putc(c, sexp_port_stream(p)))
 #define sexp_write_string(x, s, p) (sexp_port_buf(p) ? sexp_buffered_write_string(x, s, p) : fputs(s, sexp_port_stream(p)))
 #define sexp_write_string_n(x, s, n, p) (sexp_port_buf(p) ? sexp_buffered_write_string_n(x, s, n, p) : fwrite(s, 1, n, sexp_port_stream(p)))
@@ -1684,9 +1731,13 @@ SEXP_API sexp sexp_list_to_uvector_op (sexp ctx, sexp self, sexp_sint_t n, sexp
 SEXP_API sexp sexp_make_cpointer (sexp ctx, sexp_uint_t type_id, void* value, sexp parent, int freep);
 SEXP_API int sexp_is_separator(int c);
 SEXP_API sexp sexp_write_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp out);
+#if SEXP_USE_NATIVE_WRITE_SHARED
+SEXP_API sexp sexp_write_shared_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp out, sexp cyclicp);
+#endif
 SEXP_API sexp sexp_flush_output_op (sexp ctx, sexp self, sexp_sint_t n, sexp out);
 SEXP_API sexp sexp_read_string (sexp ctx, sexp in, int sentinel);
 SEXP_API sexp sexp_read_symbol (sexp ctx, sexp in, int init, int internp);
+SEXP_API sexp sexp_read_delimited_op (sexp ctx, sexp self, sexp_sint_t n, sexp in, sexp delims, sexp max);
 SEXP_API sexp sexp_read_number (sexp ctx, sexp in, int base, int exactp);
 #if SEXP_USE_BIGNUMS
 SEXP_API sexp sexp_read_bignum (sexp ctx, sexp in, sexp_uint_t init,
@@ -1694,6 +1745,12 @@ SEXP_API sexp sexp_read_bignum (sexp ctx, sexp in, sexp_uint_t init,
 SEXP_API sexp sexp_write_bignum (sexp ctx, sexp a, sexp out, sexp_uint_t base);
 #endif
 SEXP_API sexp sexp_read_float_tail(sexp ctx, sexp in, double whole, int negp);
+#if SEXP_USE_FLONUMS
+#define SEXP_DOUBLE_BUF_LEN 32
+#define SEXP_MAX_DECIMAL_DIGITS 800
+SEXP_API int sexp_double_to_chars (double f, char *buf);
+SEXP_API double sexp_decimal_to_double (const char *digits, int len, long exp10);
+#endif
 #if SEXP_USE_COMPLEX
 SEXP_API sexp sexp_read_complex_tail(sexp ctx, sexp in, sexp res);
 #endif
@@ -1710,6 +1767,11 @@ SEXP_API sexp sexp_make_input_port (sexp ctx, FILE* in, sexp name);
 SEXP_API sexp sexp_make_output_port (sexp ctx, FILE* out, sexp name);
 SEXP_API sexp sexp_open_input_file_descriptor (sexp ctx, sexp self, sexp_sint_t n, sexp fileno, sexp socketp);
 SEXP_API sexp sexp_open_output_file_descriptor (sexp ctx, sexp self, sexp_sint_t n, sexp fileno, sexp socketp);
+SEXP_API sexp sexp_set_port_buffer_size_op (sexp ctx, sexp self, sexp_sint_t n, sexp port, sexp size);
+#if SEXP_USE_MMAP_PORTS
+SEXP_API sexp sexp_open_mmap_input_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path, sexp binaryp);
+#endif
+SEXP_API sexp_sint_t sexp_default_port_buffer_size (int fd);
 SEXP_API sexp sexp_make_non_null_input_port (sexp ctx, FILE* in, sexp name);
 SEXP_API sexp sexp_make_non_null_output_port (sexp ctx, FILE* out, sexp name);
 SEXP_API sexp sexp_make_non_null_input_output_port (sexp ctx, FILE* io, sexp name);
@@ -1724,8 +1786,9 @@ SEXP_API sexp sexp_set_port_fold_case (sexp ctx, sexp self, sexp_sint_t n, sexp
 SEXP_API sexp sexp_lookup_type_op (sexp ctx, sexp self, sexp_sint_t n, sexp name, sexp id);
 #endif
 SEXP_API sexp sexp_open_input_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp str);
-SEXP_API sexp sexp_open_output_string_op (sexp ctx, sexp self, sexp_sint_t n);
+SEXP_API sexp sexp_open_output_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp size_hint);
 SEXP_API sexp sexp_get_output_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp port);
+SEXP_API sexp sexp_write_output_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp port, sexp dst);
 SEXP_API sexp sexp_make_exception (sexp ctx, sexp kind, sexp message, sexp irritants, sexp procedure, sexp source);
 SEXP_API sexp sexp_user_exception (sexp ctx, sexp self, const char *msg, sexp x);
 SEXP_API sexp sexp_file_exception (sexp ctx, sexp self, const char *msg, sexp x);
@@ -1762,12 +1825,17 @@ SEXP_API int sexp_write_utf8_char (sexp ctx, int c, sexp out);
 #define sexp_string_cursor_set(ctx, s, i)    (sexp_string_utf8_set(ctx, s, i))
 #define sexp_string_cursor_next(s, i) sexp_make_string_cursor(sexp_unbox_string_cursor(i) + sexp_utf8_initial_byte_count(((unsigned char*)sexp_string_data(s))[sexp_unbox_string_cursor(i)]))
 #define sexp_string_cursor_prev(s, i) sexp_make_string_cursor(sexp_string_utf8_prev((unsigned char*)sexp_string_data(s)+sexp_unbox_string_cursor(i)) - sexp_string_data(s))
+#if SEXP_USE_STRING_INDEX_TABLE
+SEXP_API sexp_uint_t sexp_string_indexed_length (sexp s);
+#define sexp_string_length(s) sexp_string_indexed_length(s)
+#else
 #define sexp_string_length(s) sexp_string_utf8_length((unsigned char*)sexp_string_data(s), sexp_string_size(s))
+#endif
 #define sexp_substring(ctx, s, i, j) sexp_utf8_substring_op(ctx, NULL, 3, s, i, j)
 #define sexp_substring_cursor(ctx, s, i, j) sexp_substring_op(ctx, NULL, 3, s, i, j)
 #else  /* ASCII strings */
 #define sexp_string_ref(ctx, s, i)    (sexp_make_character((unsigned char)sexp_string_data(s)[sexp_unbox_fixnum(i)]))
-#define sexp_string_set(ctx, s, i, ch) (sexp_string_data(s)[sexp_unbox_fixnum(i)] = sexp_unbox_character(ch))
+#define sexp_string_set(ctx, s, i, ch) (sexp_string_unshare(ctx, s), sexp_string_data(s)[sexp_unbox_fixnum(i)] = sexp_unbox_character(ch))
 #define sexp_string_cursor_ref(ctx, s, i) sexp_string_ref(ctx, s, i)
 #define sexp_string_cursor_set(ctx, s, i, ch) sexp_string_set(ctx, s, i, ch)
 #define sexp_string_cursor_next(s, i) sexp_make_fixnum(sexp_unbox_fixnum(i) + 1)
@@ -1778,11 +1846,19 @@ SEXP_API int sexp_write_utf8_char (sexp ctx, int c, sexp out);
 #endif
 
 #if SEXP_USE_STRING_INDEX_TABLE
-SEXP_API void sexp_update_string_index_lookup(sexp ctx, sexp s);
+#define sexp_update_string_index_lookup(ctx, s) (sexp_string_charlens(s) = NULL)
 #else
 #define sexp_update_string_index_lookup(ctx, s)
 #endif
 
+/* give a string with shared bytes its own copy before mutating it */
+#if SEXP_USE_SHARED_SUBSTRINGS
+SEXP_API sexp sexp_string_unshare_bytes (sexp ctx, sexp str);
+#define sexp_string_unshare(ctx, s) (sexp_sharedp(sexp_string_bytes(s)) ? sexp_string_unshare_bytes(ctx, s) : SEXP_VOID)
+#else
+#define sexp_string_unshare(ctx, s) SEXP_VOID
+#endif
+
 #if SEXP_USE_GREEN_THREADS
 SEXP_API int sexp_maybe_block_port (sexp ctx, sexp in, int forcep);
 SEXP_API void sexp_maybe_unblock_port (sexp ctx, sexp in);
@@ -1899,7 +1975,8 @@ SEXP_API int sexp_poll_port(sexp ctx, sexp port, int inputp);
 #define sexp_string_concatenate(ctx, ls, s) sexp_string_concatenate_op(ctx, NULL, 2, ls, s)
 #define sexp_memq(ctx, a, b) sexp_memq_op(ctx, NULL, 2, a, b)
 #define sexp_assq(ctx, a, b) sexp_assq_op(ctx, NULL, 2, a, b)
-#define sexp_open_output_string(ctx) sexp_open_output_string_op(ctx, NULL, 0)
+#define sexp_open_output_string(ctx) sexp_open_output_string_op(ctx, NULL, 0, SEXP_FALSE)
+#define sexp_open_output_string_sized(ctx, size) sexp_open_output_string_op(ctx, NULL, 1, sexp_make_fixnum(size))
 #define sexp_open_input_string(ctx, s) sexp_open_input_string_op(ctx, NULL, 1, s)
 #define sexp_get_output_string(ctx, out) sexp_get_output_string_op(ctx, NULL, 1, out)
 #define sexp_expt(ctx, a, b) sexp_expt_op(ctx, NULL, 2, a, b)
@@ -1997,9 +2074,25 @@ enum sexp_opcode_names {
   SEXP_OP_SCP,
   SEXP_OP_SC_LT,
   SEXP_OP_SC_LE,
+  SEXP_OP_CALL_KNOWN,
+  SEXP_OP_TAIL_CALL_KNOWN,
+  SEXP_OP_COMPILE_LAZY,
   SEXP_OP_NUM_OPCODES
 };
 
+/* integer bytecode operands (jump offsets, stack indexes, counts) */
+#if SEXP_USE_COMPACT_BYTECODE
+typedef int sexp_operand_t;
+#else
+typedef sexp_sint_t sexp_operand_t;
+#endif
+
+/* The operands following each opcode, one char per operand: 'w' for */
+/* a full word, 'i' for a sexp_operand_t.  NULL for invalid opcodes. */
+SEXP_API const char* sexp_opcode_operands (int op);
+/* the total size in bytes of the operands, or -1 if op is invalid */
+SEXP_API int sexp_opcode_operand_size (int op);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
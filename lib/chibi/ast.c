@@ -375,9 +375,11 @@ sexp sexp_make_lambda_op (sexp ctx, sexp self, sexp_sint_t n, sexp name, sexp pa
   sexp_lambda_locals(res) = locals;
   sexp_lambda_fv(res) = SEXP_NULL;
   sexp_lambda_sv(res) = SEXP_NULL;
+  sexp_lambda_bv(res) = SEXP_NULL;
   sexp_lambda_defs(res) = SEXP_NULL;
   sexp_lambda_return_type(res) = SEXP_FALSE;
   sexp_lambda_param_types(res) = SEXP_NULL;
+  sexp_lambda_index(res) = SEXP_FALSE;
   return res;
 }
 
@@ -389,9 +391,11 @@ sexp sexp_copy_lambda (sexp ctx, sexp self, sexp_sint_t n, sexp lambda) {
   sexp_lambda_locals(res) = sexp_lambda_locals(lambda);
   sexp_lambda_fv(res) = sexp_lambda_fv(lambda);
   sexp_lambda_sv(res) = sexp_lambda_sv(lambda);
+  sexp_lambda_bv(res) = sexp_lambda_bv(lambda);
   sexp_lambda_defs(res) = sexp_lambda_defs(lambda);
   sexp_lambda_return_type(res) = sexp_lambda_return_type(lambda);
   sexp_lambda_param_types(res) = sexp_lambda_param_types(lambda);
+  sexp_lambda_index(res) = sexp_lambda_index(lambda);
   return res;
 }
 
@@ -522,6 +526,7 @@ sexp sexp_string_contains (sexp ctx, sexp self, sexp_sint_t n, sexp x, sexp y, s
 }
 
 sexp sexp_string_cursor_copy (sexp ctx, sexp self, sexp_sint_t n, sexp dst, sexp sfrom, sexp src, sexp sstart, sexp send) {
+  sexp res;
   unsigned char *pfrom, *pto, *pstart, *pend, *prev, *p;
   sexp_sint_t from = sexp_unbox_fixnum(sfrom), to = sexp_string_size(dst),
     start = sexp_unbox_fixnum(sstart), end = sexp_unbox_fixnum(send);
@@ -536,6 +541,8 @@ sexp sexp_string_cursor_copy (sexp ctx, sexp self, sexp_sint_t n, sexp dst, sexp
     return sexp_user_exception(ctx, self, "string-cursor-copy!: start out of range", sstart);
   if (end < start || end > (sexp_sint_t)sexp_string_size(src))
     return sexp_user_exception(ctx, self, "string-cursor-copy!: end out of range", send);
+  res = sexp_string_unshare(ctx, dst);
+  if (sexp_exceptionp(res)) return res;
   pfrom = (unsigned char*)sexp_string_data(dst) + from;
   pto = (unsigned char*)sexp_string_data(dst) + to;
   pstart = (unsigned char*)sexp_string_data(src) + start;
@@ -549,6 +556,7 @@ sexp sexp_string_cursor_copy (sexp ctx, sexp self, sexp_sint_t n, sexp dst, sexp
       *p = '\0';
     pstart -= pfrom - prev;
   }
+  sexp_update_string_index_lookup(ctx, dst);
   return sexp_make_fixnum(pstart - (unsigned char*)sexp_string_data(src));
 }
 
@@ -670,6 +678,7 @@ sexp sexp_init_library (sexp ctx, sexp self, sexp_sint_t n, sexp env, const char
   sexp_define_accessors(ctx, env, SEXP_LAMBDA, 8, "lambda-return-type", "lambda-return-type-set!");
   sexp_define_accessors(ctx, env, SEXP_LAMBDA, 9, "lambda-param-types", "lambda-param-types-set!");
   sexp_define_accessors(ctx, env, SEXP_LAMBDA, 10, "lambda-source", "lambda-source-set!");
+  sexp_define_accessors(ctx, env, SEXP_LAMBDA, 11, "lambda-boxed-vars", "lambda-boxed-vars-set!");
   sexp_define_accessors(ctx, env, SEXP_CND, 0, "cnd-test", "cnd-test-set!");
   sexp_define_accessors(ctx, env, SEXP_CND, 1, "cnd-pass", "cnd-pass-set!");
   sexp_define_accessors(ctx, env, SEXP_CND, 2, "cnd-fail", "cnd-fail-set!");
@@ -281,6 +281,8 @@
 ;;> \item{\scheme{(lambda-param-types-set! lam x)}}
 ;;> \item{\scheme{(lambda-source lam)} - the source code of the lambda}
 ;;> \item{\scheme{(lambda-source-set! lam x)}}
+;;> \item{\scheme{(lambda-boxed-vars lam)} - the subset of set variables which must be heap allocated}
+;;> \item{\scheme{(lambda-boxed-vars-set! lam x)}}
 ;;> ]
 
 ;;> \subsection{Conditionals}
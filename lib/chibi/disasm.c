@@ -85,44 +85,14 @@ static sexp disasm (sexp ctx, sexp self, sexp bc, sexp out, int depth) {
   labels = (sexp_sint_t*)calloc(sexp_bytecode_length(bc), sizeof(sexp_sint_t));
   ip = sexp_bytecode_data(bc);
   while (ip - sexp_bytecode_data(bc) < (int)sexp_bytecode_length(bc)) {
-    switch (*ip++) {
-    case SEXP_OP_JUMP:
-    case SEXP_OP_JUMP_UNLESS:
-      off = ip - sexp_bytecode_data(bc) + ((sexp_sint_t*)ip)[0];
+    opcode = *ip++;
+    if (opcode == SEXP_OP_JUMP || opcode == SEXP_OP_JUMP_UNLESS) {
+      off = ip - sexp_bytecode_data(bc) + ((sexp_operand_t*)ip)[0];
       if (off >= 0 && off < (int)sexp_bytecode_length(bc) && labels[off] == 0)
         labels[off] = label++;
-    case SEXP_OP_CALL:
-    case SEXP_OP_FCALL0:
-    case SEXP_OP_FCALL1:
-    case SEXP_OP_FCALL2:
-    case SEXP_OP_FCALL3:
-    case SEXP_OP_FCALL4:
-    case SEXP_OP_FCALLN:
-    case SEXP_OP_CLOSURE_REF:
-    case SEXP_OP_GLOBAL_KNOWN_REF:
-    case SEXP_OP_GLOBAL_REF:
-    case SEXP_OP_LOCAL_REF:
-    case SEXP_OP_LOCAL_SET:
-    case SEXP_OP_PARAMETER_REF:
-    case SEXP_OP_PUSH:
-    case SEXP_OP_RESERVE:
-    case SEXP_OP_STACK_REF:
-    case SEXP_OP_TAIL_CALL:
-    case SEXP_OP_TYPEP:
-      ip += sizeof(sexp);
-      break;
-    case SEXP_OP_SLOT_REF:
-    case SEXP_OP_SLOT_SET:
-    case SEXP_OP_MAKE:
-      ip += sizeof(sexp)*2;
-      break;
-    case SEXP_OP_MAKE_PROCEDURE:
-      ip += sizeof(sexp)*3;
-      break;
-    default:
-      /* opcode takes no additional instruction args */
-      break;
     }
+    if (sexp_opcode_operand_size(opcode) > 0)
+      ip += sexp_opcode_operand_size(opcode);
   }
 
   ip = sexp_bytecode_data(bc);
@@ -166,18 +136,20 @@ static sexp disasm (sexp ctx, sexp self, sexp bc, sexp out, int depth) {
   case SEXP_OP_CLOSURE_REF:
   case SEXP_OP_TYPEP:
   case SEXP_OP_RESERVE:
-    sexp_write_integer(ctx, ((sexp_sint_t*)ip)[0], out);
-    ip += sizeof(sexp);
+  case SEXP_OP_TAIL_CALL:
+  case SEXP_OP_CALL:
+    sexp_write_integer(ctx, ((sexp_operand_t*)ip)[0], out);
+    ip += sizeof(sexp_operand_t);
     break;
   case SEXP_OP_JUMP:
   case SEXP_OP_JUMP_UNLESS:
-    sexp_write_integer(ctx, ((sexp_sint_t*)ip)[0], out);
-    off = ip - sexp_bytecode_data(bc) + ((sexp_sint_t*)ip)[0];
+    sexp_write_integer(ctx, ((sexp_operand_t*)ip)[0], out);
+    off = ip - sexp_bytecode_data(bc) + ((sexp_operand_t*)ip)[0];
     if (off >= 0 && off < (sexp_sint_t)sexp_bytecode_length(bc) && labels[off] > 0) {
       sexp_write_string(ctx, " L", out);
       sexp_write_integer(ctx, labels[off], out);
     }
-    ip += sizeof(sexp);
+    ip += sizeof(sexp_operand_t);
     break;
   case SEXP_OP_FCALL0:
   case SEXP_OP_FCALL1:
@@ -193,7 +165,10 @@ static sexp disasm (sexp ctx, sexp self, sexp bc, sexp out, int depth) {
   case SEXP_OP_SLOT_REF:
   case SEXP_OP_SLOT_SET:
   case SEXP_OP_MAKE:
-    ip += sizeof(sexp)*2;
+    sexp_write_integer(ctx, ((sexp_operand_t*)ip)[0], out);
+    sexp_write_char(ctx, ' ', out);
+    sexp_write_integer(ctx, ((sexp_operand_t*)ip)[1], out);
+    ip += sizeof(sexp_operand_t)*2;
     break;
   case SEXP_OP_MAKE_PROCEDURE:
     sexp_write_integer(ctx, ((sexp_sint_t*)ip)[0], out);
@@ -202,11 +177,26 @@ static sexp disasm (sexp ctx, sexp self, sexp bc, sexp out, int depth) {
     tmp = ((sexp*)ip)[2];
     ip += sizeof(sexp)*3;
     break;
+  case SEXP_OP_CALL_KNOWN:
+  case SEXP_OP_TAIL_CALL_KNOWN:
+    sexp_write_integer(ctx, ((sexp_operand_t*)ip)[0], out);
+    sexp_write_char(ctx, ' ', out);
+    tmp = ((sexp*)(ip+sizeof(sexp_operand_t)))[0];
+    sexp_write(ctx, sexp_pairp(tmp) ? sexp_car(tmp) : tmp, out);
+    tmp = NULL;
+    ip += sizeof(sexp_operand_t) + sizeof(sexp);
+    break;
+  case SEXP_OP_COMPILE_LAZY:
+    /* a lazily compiled procedure, show the name of its lambda */
+    tmp = ((sexp*)ip)[0];
+    if (sexp_vectorp(tmp) && sexp_lambdap(sexp_vector_ref(tmp, SEXP_ZERO)))
+      sexp_write(ctx, sexp_lambda_name(sexp_vector_ref(tmp, SEXP_ZERO)), out);
+    tmp = NULL;
+    ip += sizeof(sexp);
+    break;
   case SEXP_OP_GLOBAL_REF:
   case SEXP_OP_GLOBAL_KNOWN_REF:
   case SEXP_OP_PARAMETER_REF:
-  case SEXP_OP_TAIL_CALL:
-  case SEXP_OP_CALL:
   case SEXP_OP_PUSH:
     tmp = ((sexp*)ip)[0];
     if (((opcode == SEXP_OP_GLOBAL_REF) || (opcode == SEXP_OP_GLOBAL_KNOWN_REF))
@@ -246,10 +236,21 @@ static sexp sexp_disasm (sexp ctx, sexp self, sexp_sint_t n, sexp bc, sexp out)
   return disasm(ctx, self, bc, out, 0);
 }
 
+static sexp sexp_peephole_optimize_p (sexp ctx, sexp self, sexp_sint_t n) {
+  return sexp_make_boolean(SEXP_USE_PEEPHOLE && sexp_not(sexp_global(ctx, SEXP_G_NO_PEEPHOLE_P)));
+}
+
+static sexp sexp_peephole_optimize_set (sexp ctx, sexp self, sexp_sint_t n, sexp on) {
+  sexp_global(ctx, SEXP_G_NO_PEEPHOLE_P) = sexp_make_boolean(sexp_not(on));
+  return SEXP_VOID;
+}
+
 sexp sexp_init_library (sexp ctx, sexp self, sexp_sint_t n, sexp env, const char* version, const sexp_abi_identifier_t abi) {
   if (!(sexp_version_compatible(ctx, version, sexp_version)
         && sexp_abi_compatible(ctx, abi, SEXP_ABI_IDENTIFIER)))
     return SEXP_ABI_ERROR;
   sexp_define_foreign_param(ctx, env, "disasm", 2, (sexp_proc1)sexp_disasm, "current-output-port");
+  sexp_define_foreign(ctx, env, "peephole-optimize?", 0, sexp_peephole_optimize_p);
+  sexp_define_foreign(ctx, env, "peephole-optimize?-set!", 1, sexp_peephole_optimize_set);
   return SEXP_VOID;
 }
@@ -0,0 +1,753 @@
+/* Automatically generated by chibi-ffi; version: 0.4 */
+
+#include <chibi/eval.h>
+
+#include <stdio.h>
+#include <chibi/eval.h>
+
+#if SEXP_USE_SEND_FILE
+#include <sys/sendfile.h>
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+#define SEXP_LAST_CONTEXT_CHECK_LIMIT 256
+
+#define sexp_cookie_ctx(vec) sexp_vector_ref((sexp)vec, SEXP_ZERO)
+#define sexp_cookie_buffer(vec) sexp_vector_ref((sexp)vec, SEXP_ONE)
+#define sexp_cookie_read(vec) sexp_vector_ref((sexp)vec, SEXP_TWO)
+#define sexp_cookie_write(vec) sexp_vector_ref((sexp)vec, SEXP_THREE)
+#define sexp_cookie_seek(vec) sexp_vector_ref((sexp)vec, SEXP_FOUR)
+#define sexp_cookie_close(vec) sexp_vector_ref((sexp)vec, SEXP_FIVE)
+
+#define sexp_cookie_ctx_set(vec, x) sexp_vector_set((sexp)vec, SEXP_ZERO, x)
+#define sexp_cookie_buffer_set(vec, x) sexp_vector_set((sexp)vec, SEXP_ONE, x)
+#define sexp_cookie_read_set(vec, x) sexp_vector_set((sexp)vec, SEXP_TWO, x)
+#define sexp_cookie_write_set(vec, x) sexp_vector_set((sexp)vec, SEXP_THREE, x)
+#define sexp_cookie_seek_set(vec, x) sexp_vector_set((sexp)vec, SEXP_FOUR, x)
+#define sexp_cookie_close_set(vec, x) sexp_vector_set((sexp)vec, SEXP_FIVE, x)
+
+#if SEXP_USE_STRING_STREAMS
+#if ! SEXP_USE_BOEHM
+static int in_heap_p (sexp_heap h, sexp p) {
+  for ( ; h; h = h->next)
+    if (((sexp)h < p) && (p < (sexp)((char*)h + h->size)))
+      return 1;
+  return 0;
+}
+#endif
+
+static sexp sexp_last_context (sexp ctx, sexp *cstack) {
+  sexp res=SEXP_FALSE;
+#if ! SEXP_USE_BOEHM
+  sexp p;
+  sexp_sint_t i;
+  sexp_heap h = sexp_context_heap(ctx);
+  for (i=0; i<SEXP_LAST_CONTEXT_CHECK_LIMIT; i++) {
+    p = cstack[i];
+    if (p && (p != ctx) && sexp_pointerp(p) && in_heap_p(h, p)
+        && (sexp_pointer_tag(p) == SEXP_CONTEXT)
+        && (sexp_context_heap(p) == h)) {
+      res = p;
+      break;
+    }
+  }
+#endif
+  return res;
+}
+
+#if SEXP_BSD
+static int sexp_cookie_reader (void *cookie, char *buffer, int size)
+#else
+static ssize_t sexp_cookie_reader (void *cookie, char *buffer, size_t size)
+#endif
+{
+  sexp vec = (sexp)cookie, ctx, res;
+  if (! sexp_procedurep(sexp_cookie_read(vec))) return -1;
+  sexp_gc_var2(ctx2, args);
+  ctx = sexp_cookie_ctx(vec);
+  ctx2 = sexp_last_context(ctx, (sexp*)&cookie);
+  sexp_gc_preserve2(ctx, ctx2, args);
+  if (size > sexp_string_size(sexp_cookie_buffer(vec)))
+    sexp_cookie_buffer_set(vec, sexp_make_string(ctx, sexp_make_fixnum(size), SEXP_VOID));
+  args = sexp_list2(ctx, SEXP_ZERO, sexp_make_fixnum(size));
+  args = sexp_cons(ctx, sexp_cookie_buffer(vec), args);
+  res = sexp_apply(ctx, sexp_cookie_read(vec), args);
+  sexp_gc_release2(ctx);
+  if (sexp_fixnump(res)) {
+    memcpy(buffer, sexp_string_data(sexp_cookie_buffer(vec)), sexp_unbox_fixnum(res));
+    return sexp_unbox_fixnum(res);
+  } else {
+    return -1;
+  }
+}
+
+#if SEXP_BSD
+static int sexp_cookie_writer (void *cookie, const char *buffer, int size)
+#else
+static ssize_t sexp_cookie_writer (void *cookie, const char *buffer, size_t size)
+#endif
+{
+  sexp vec = (sexp)cookie, ctx, res;
+  if (! sexp_procedurep(sexp_cookie_write(vec))) return -1;
+  sexp_gc_var2(ctx2, args);
+  ctx = sexp_cookie_ctx(vec);
+  ctx2 = sexp_last_context(ctx, (sexp*)&cookie);
+  sexp_gc_preserve2(ctx, ctx2, args);
+  if (size > sexp_string_size(sexp_cookie_buffer(vec)))
+    sexp_cookie_buffer_set(vec, sexp_make_string(ctx, sexp_make_fixnum(size), SEXP_VOID));
+  else
+    sexp_string_unshare(ctx, sexp_cookie_buffer(vec));
+  memcpy(sexp_string_data(sexp_cookie_buffer(vec)), buffer, size);
+  sexp_update_string_index_lookup(ctx, sexp_cookie_buffer(vec));
+  args = sexp_list2(ctx, SEXP_ZERO, sexp_make_fixnum(size));
+  args = sexp_cons(ctx, sexp_cookie_buffer(vec), args);
+  res = sexp_apply(ctx, sexp_cookie_write(vec), args);
+  sexp_gc_release2(ctx);
+  return (sexp_fixnump(res) ? sexp_unbox_fixnum(res) : -1);
+}
+
+#if ! SEXP_BSD
+
+#ifdef __CYGWIN__
+#define off64_t off_t
+#endif
+
+static int sexp_cookie_seeker (void *cookie, off64_t *position, int whence) {
+  sexp vec = (sexp)cookie, ctx, res;
+  if (! sexp_procedurep(sexp_cookie_seek(vec))) return -1;
+  sexp_gc_var2(ctx2, args);
+  ctx = sexp_cookie_ctx(vec);
+  ctx2 = sexp_last_context(ctx, (sexp*)&cookie);
+  sexp_gc_preserve2(ctx, ctx2, args);
+  args = sexp_make_integer(ctx, *position);
+  args = sexp_list2(ctx, args, sexp_make_fixnum(whence));
+  res = sexp_apply(ctx, sexp_cookie_seek(vec), args);
+  if (sexp_fixnump(res))
+    *position = sexp_unbox_fixnum(res);
+  sexp_gc_release2(ctx);
+  return sexp_fixnump(res);
+}
+#endif  /* !SEXP_BSD */
+
+static int sexp_cookie_cleaner (void *cookie) {
+  sexp vec = (sexp)cookie, ctx, res;
+  if (! sexp_procedurep(sexp_cookie_close(vec))) return 0;
+  ctx = sexp_cookie_ctx(vec);
+  res = sexp_apply(ctx, sexp_cookie_close(vec), SEXP_NULL);
+  return (sexp_exceptionp(res) ? -1 : sexp_truep(res));
+}
+
+#if !SEXP_BSD
+
+static cookie_io_functions_t sexp_cookie = {
+  .read  = (cookie_read_function_t*)sexp_cookie_reader,
+  .write = (cookie_write_function_t*)sexp_cookie_writer,
+  .seek  = (cookie_seek_function_t*)sexp_cookie_seeker,
+  .close = (cookie_close_function_t*)sexp_cookie_cleaner,
+};
+
+static cookie_io_functions_t sexp_cookie_no_seek = {
+  .read  = (cookie_read_function_t*)sexp_cookie_reader,
+  .write = (cookie_write_function_t*)sexp_cookie_writer,
+  .seek  = NULL,
+  .close = (cookie_close_function_t*)sexp_cookie_cleaner,
+};
+
+#endif  /* !SEXP_BSD */
+
+static sexp sexp_make_custom_port (sexp ctx, sexp self, const char *mode,
+                                   sexp read, sexp write,
+                                   sexp seek, sexp close,
+                                   sexp size, int vectoredp) {
+  FILE *in;
+  sexp res;
+  sexp_gc_var1(vec);
+  if (sexp_truep(read) && ! sexp_procedurep(read))
+    return sexp_type_exception(ctx, self, SEXP_PROCEDURE, read);
+  if (sexp_truep(write) && ! sexp_procedurep(write))
+    return sexp_type_exception(ctx, self, SEXP_PROCEDURE, write);
+  if (sexp_truep(seek) && ! sexp_procedurep(seek))
+    return sexp_type_exception(ctx, self, SEXP_PROCEDURE, seek);
+  if (sexp_truep(close) && ! sexp_procedurep(close))
+    return sexp_type_exception(ctx, self, SEXP_PROCEDURE, close);
+  sexp_gc_preserve1(ctx, vec);
+  vec = sexp_make_vector(ctx, SEXP_EIGHT, SEXP_FALSE);
+  sexp_cookie_ctx_set(vec, ctx);
+  sexp_cookie_buffer_set(vec, sexp_make_string(ctx, sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE), SEXP_VOID));
+  sexp_cookie_read_set(vec, read);
+  sexp_cookie_write_set(vec, write);
+  sexp_cookie_seek_set(vec, seek);
+  sexp_cookie_close_set(vec, close);
+#if SEXP_BSD
+  in = funopen(vec,
+               (sexp_procedurep(read) ? sexp_cookie_reader : NULL),
+               (sexp_procedurep(write) ? sexp_cookie_writer : NULL),
+               NULL, /* (sexp_procedurep(seek) ? sexp_cookie_reader : NULL), */
+               (sexp_procedurep(close) ? sexp_cookie_cleaner : NULL));
+#else
+  in = fopencookie(vec, mode, (sexp_truep(seek) ? sexp_cookie : sexp_cookie_no_seek));
+#endif
+  if (! in) {
+    res = sexp_user_exception(ctx, self, "couldn't make custom port", read);
+  } else {
+    res = sexp_make_input_port(ctx, in, SEXP_FALSE);
+    sexp_port_cookie(res) = vec;  /* for gc preserving */
+  }
+  if (mode && mode[0] == 'w')
+    sexp_pointer_tag(res) = SEXP_OPORT;
+  sexp_gc_release1(ctx);
+  return res;
+}
+
+#else  /* ! SEXP_USE_STRING_STREAMS */
+
+static sexp sexp_make_custom_port (sexp ctx, sexp self,
+                                   const char *mode, sexp read, sexp write,
+                                   sexp seek, sexp close,
+                                   sexp size, int vectoredp) {
+  sexp_gc_var3(res, str, vec);
+  if (sexp_truep(size) && ! sexp_fixnump(size))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, size);
+  if (! sexp_fixnump(size) || sexp_unbox_fixnum(size) < SEXP_PORT_BUFFER_SIZE)
+    size = sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE);
+  sexp_gc_preserve3(ctx, res, str, vec);
+  str = sexp_make_string(ctx, size, SEXP_VOID);
+  if (sexp_exceptionp(str)) return str;
+  res = sexp_open_input_string(ctx, str);
+  if (sexp_exceptionp(res)) return res;
+  if (mode && mode[0] == 'w') {
+    sexp_pointer_tag(res) = SEXP_OPORT;
+    sexp_port_cookie(res) = str;
+  } else {
+    sexp_port_offset(res) = 0;
+    sexp_port_size(res) = 0;
+  }
+  vec = sexp_make_vector(ctx, SEXP_EIGHT, SEXP_FALSE);
+  if (sexp_exceptionp(vec)) return vec;
+  sexp_vector_set(vec, SEXP_ONE, sexp_port_cookie(res));
+  sexp_vector_set(vec, SEXP_TWO, read);
+  sexp_vector_set(vec, SEXP_THREE, write);
+  sexp_vector_set(vec, SEXP_FOUR, seek);
+  sexp_vector_set(vec, SEXP_FIVE, close);
+  /* preallocated (buffer start end) arguments for read and write */
+  str = sexp_list2(ctx, SEXP_ZERO, SEXP_ZERO);
+  sexp_vector_set(vec, SEXP_SIX, sexp_cons(ctx, SEXP_FALSE, str));
+  if (vectoredp) sexp_vector_set(vec, SEXP_SEVEN, sexp_cons(ctx, SEXP_NULL, SEXP_NULL));
+  sexp_port_cookie(res) = vec;
+  sexp_gc_release3(ctx);
+  return res;
+}
+
+#endif
+
+sexp sexp_make_custom_input_port (sexp ctx, sexp self,
+                                  sexp read, sexp seek, sexp close, sexp size) {
+  return sexp_make_custom_port(ctx, self, "r", read, SEXP_FALSE, seek, close, size, 0);
+}
+
+static sexp sexp_make_custom_output_port_aux (sexp ctx, sexp self,
+                                              sexp write, sexp seek, sexp close,
+                                              sexp size, int vectoredp) {
+  sexp res = sexp_make_custom_port(ctx, self, "w", SEXP_FALSE, write, seek, close, size, vectoredp);
+#if SEXP_USE_STRING_STREAMS
+  if (!sexp_exceptionp(res))
+    sexp_pointer_tag(res) = SEXP_OPORT;
+#endif
+  return res;
+}
+
+sexp sexp_make_custom_output_port (sexp ctx, sexp self,
+                                   sexp write, sexp seek, sexp close, sexp size) {
+  return sexp_make_custom_output_port_aux(ctx, self, write, seek, close, size, 0);
+}
+
+sexp sexp_make_custom_vectored_output_port (sexp ctx, sexp self,
+                                            sexp write, sexp seek, sexp close, sexp size) {
+  return sexp_make_custom_output_port_aux(ctx, self, write, seek, close, size, 1);
+}
+
+sexp sexp_make_custom_binary_input_port (sexp ctx, sexp self,
+                                         sexp read, sexp seek, sexp close, sexp size) {
+  sexp res = sexp_make_custom_input_port(ctx, self, read, seek, close, size);
+  sexp_port_binaryp(res) = 1;
+  return res;
+}
+
+sexp sexp_make_custom_binary_output_port (sexp ctx, sexp self,
+                                          sexp write, sexp seek, sexp close, sexp size) {
+  sexp res = sexp_make_custom_output_port(ctx, self, write, seek, close, size);
+  sexp_port_binaryp(res) = 1;
+  return res;
+}
+
+sexp sexp_make_custom_binary_vectored_output_port (sexp ctx, sexp self,
+                                                   sexp write, sexp seek, sexp close, sexp size) {
+  sexp res = sexp_make_custom_vectored_output_port(ctx, self, write, seek, close, size);
+  sexp_port_binaryp(res) = 1;
+  return res;
+}
+
+sexp sexp_bytes_to_string (sexp ctx, sexp vec) {
+  sexp res;
+#if SEXP_USE_PACKED_STRINGS
+  res = sexp_c_string(ctx, sexp_bytes_data(vec), sexp_bytes_length(vec));
+#else
+  res = sexp_alloc_type(ctx, string, SEXP_STRING);
+  sexp_string_bytes(res) = vec;
+  sexp_string_offset(res) = 0;
+  sexp_string_size(res) = sexp_bytes_length(vec);
+#endif
+  return res;
+}
+
+sexp sexp_open_input_bytevector (sexp ctx, sexp self, sexp vec) {
+  sexp_gc_var2(str, res);
+  sexp_assert_type(ctx, sexp_bytesp, SEXP_BYTES, vec);
+  sexp_gc_preserve2(ctx, str, res);
+  str = sexp_bytes_to_string(ctx, vec);
+  res = sexp_open_input_string(ctx, str);
+  sexp_port_binaryp(res) = 1;
+  sexp_gc_release2(ctx);
+  return res;
+}
+
+sexp sexp_open_output_bytevector (sexp ctx, sexp self, sexp size_hint) {
+  sexp res = sexp_open_output_string_op(ctx, self, 1, size_hint);
+  if (sexp_portp(res)) sexp_port_binaryp(res) = 1;
+  return res;
+}
+
+sexp sexp_get_output_bytevector (sexp ctx, sexp self, sexp port) {
+  sexp_gc_var1(res);
+  sexp_assert_type(ctx, sexp_oportp, SEXP_OPORT, port);
+  if (!sexp_port_binaryp(port))
+    return sexp_xtype_exception(ctx, self, "not a binary port", port);
+  sexp_gc_preserve1(ctx, res);
+  res = sexp_get_output_string(ctx, port);
+  if (!sexp_exceptionp(res))
+    res = sexp_string_to_bytes(ctx, res);
+  sexp_gc_release1(ctx);
+  return res;
+}
+
+/* without mmap support these are ordinary file ports */
+sexp sexp_open_mmap_input_file (sexp ctx, sexp self, sexp path) {
+#if SEXP_USE_MMAP_PORTS
+  return sexp_open_mmap_input_file_op(ctx, self, 2, path, SEXP_FALSE);
+#else
+  return sexp_open_input_file_op(ctx, self, 1, path, SEXP_FALSE);
+#endif
+}
+
+sexp sexp_open_binary_mmap_input_file (sexp ctx, sexp self, sexp path) {
+#if SEXP_USE_MMAP_PORTS
+  return sexp_open_mmap_input_file_op(ctx, self, 2, path, SEXP_TRUE);
+#else
+  return sexp_open_binary_input_file(ctx, self, 1, path, SEXP_FALSE);
+#endif
+}
+
+sexp sexp_set_port_buffer_size (sexp ctx, sexp self, sexp port, sexp size) {
+  return sexp_set_port_buffer_size_op(ctx, self, 2, port, size);
+}
+
+sexp sexp_write_output_string (sexp ctx, sexp self, sexp port, sexp out) {
+  return sexp_write_output_string_op(ctx, self, 2, port, out);
+}
+
+sexp sexp_read_delimited (sexp ctx, sexp self, sexp in, sexp delims, sexp max) {
+  return sexp_read_delimited_op(ctx, self, 3, in, delims, max);
+}
+
+sexp sexp_string_count (sexp ctx, sexp self, sexp ch, sexp str, sexp start, sexp end) {
+  const unsigned char *s, *e;
+  sexp_sint_t c, count = 0;
+#if SEXP_USE_UTF8_STRINGS
+  sexp_sint_t i;
+#endif
+  sexp_assert_type(ctx, sexp_charp, SEXP_CHAR, ch);
+  sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, str);
+  sexp_assert_type(ctx, sexp_fixnump, SEXP_FIXNUM, start);
+  if (sexp_not(end)) end = sexp_make_fixnum(sexp_string_size(str));
+  else sexp_assert_type(ctx, sexp_fixnump, SEXP_FIXNUM, end);
+  c = sexp_unbox_character(ch);
+#if SEXP_USE_UTF8_STRINGS
+  if (c < 128) {
+#endif
+    s = (unsigned char*)sexp_string_data(str) + sexp_unbox_fixnum(start);
+    e = (unsigned char*)sexp_string_data(str) + sexp_unbox_fixnum(end);
+    if (e > (unsigned char*)sexp_string_data(str) + sexp_string_size(str))
+      return sexp_user_exception(ctx, self, "string-count: end index out of range", end);
+    /* fast case for ASCII chars */
+    while (s < e) if (*s++ == c) count++;
+#if SEXP_USE_UTF8_STRINGS
+  } else {
+    /* decode utf8 chars */
+    s = (unsigned char*)sexp_string_data(str);
+    for (i = sexp_unbox_fixnum(start); i < sexp_unbox_fixnum(end);
+         i += sexp_utf8_initial_byte_count(s[i]))
+      if (sexp_string_utf8_ref(ctx, str, sexp_make_fixnum(i)) == ch) count++;
+  }
+#endif
+  return sexp_make_fixnum(count);
+}
+
+sexp sexp_string_to_utf8 (sexp ctx, sexp self, sexp str) {
+  sexp res;
+  sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, str);
+  res = sexp_c_string(ctx, sexp_string_data(str), sexp_string_size(str));
+  return sexp_string_to_bytes(ctx, res);
+}
+
+/* TODO: add validation */
+sexp sexp_utf8_to_string_x (sexp ctx, sexp self, sexp vec) {
+  sexp_assert_type(ctx, sexp_bytesp, SEXP_BYTES, vec);
+  return sexp_bytes_to_string(ctx, vec);
+}
+
+sexp sexp_write_u8 (sexp ctx, sexp self, sexp u8, sexp out) {
+  sexp_assert_type(ctx, sexp_fixnump, SEXP_FIXNUM, u8);
+  if (sexp_unbox_fixnum(u8) < 0 || sexp_unbox_fixnum(u8) > 255)
+    return sexp_xtype_exception(ctx, self, "not a u8 value", u8);
+  sexp_assert_type(ctx, sexp_oportp, SEXP_OPORT, out);
+  if (!sexp_port_binaryp(out))
+    return sexp_xtype_exception(ctx, self, "not a binary port", out);
+#if SEXP_USE_GREEN_THREADS
+  errno = 0;
+#endif
+  if (sexp_write_char(ctx, sexp_unbox_fixnum(u8), out) == EOF) {
+    if (sexp_port_stream(out))
+      clearerr(sexp_port_stream(out));
+#if SEXP_USE_GREEN_THREADS
+    if (errno == EAGAIN) {
+      if (sexp_applicablep(sexp_global(ctx, SEXP_G_THREADS_BLOCKER)))
+        sexp_apply2(ctx, sexp_global(ctx, SEXP_G_THREADS_BLOCKER), out, SEXP_FALSE);
+      return sexp_global(ctx, SEXP_G_IO_BLOCK_ERROR);
+    }
+#endif
+  }
+  return SEXP_VOID;
+}
+
+sexp sexp_read_u8 (sexp ctx, sexp self, sexp in) {
+  int c;
+  sexp_assert_type(ctx, sexp_iportp, SEXP_IPORT, in);
+  if (!sexp_port_binaryp(in))
+    return sexp_xtype_exception(ctx, self, "not a binary port", in);
+#if SEXP_USE_GREEN_THREADS
+  errno = 0;
+#endif
+  c = sexp_read_char(ctx, in);
+#if SEXP_USE_GREEN_THREADS
+  if ((c == EOF)
+      && (errno == EAGAIN)) {
+    if (sexp_port_stream(in))
+      clearerr(sexp_port_stream(in));
+    if (sexp_applicablep(sexp_global(ctx, SEXP_G_THREADS_BLOCKER)))
+      sexp_apply2(ctx, sexp_global(ctx, SEXP_G_THREADS_BLOCKER), in, SEXP_FALSE);
+    return sexp_global(ctx, SEXP_G_IO_BLOCK_ERROR);
+  }
+#endif
+  if (c == '\n') sexp_port_line(in)++;
+  return (c==EOF) ? SEXP_EOF : sexp_make_fixnum(c);
+}
+
+sexp sexp_peek_u8 (sexp ctx, sexp self, sexp in) {
+  sexp res = sexp_read_u8(ctx, self, in);
+  if (sexp_fixnump(res))
+    sexp_push_char(ctx, sexp_unbox_fixnum(res), in);
+  return res;
+}
+
+int sexp_is_a_socket_p (int fd) {
+#if defined(PLAN9) || defined(_WIN32)
+  return 0;
+#else
+  struct stat statbuf;
+  fstat(fd, &statbuf);
+  return S_ISSOCK(statbuf.st_mode);
+#endif
+}
+
+sexp sexp_seek (sexp ctx, sexp self, sexp x, off_t offset, int whence) {
+  off_t res;
+  if (! (sexp_portp(x) || sexp_filenop(x)))
+    return sexp_type_exception(ctx, self, SEXP_IPORT, x);
+  if (sexp_filenop(x))
+    return sexp_make_integer(ctx, lseek(sexp_fileno_fd(x), offset, whence));
+  if (sexp_filenop(sexp_port_fd(x))) {
+    res = lseek(sexp_fileno_fd(sexp_port_fd(x)), offset, whence);
+    if (res >= 0 && !(whence == SEEK_CUR && offset == 0))
+      sexp_port_offset(x) = 0;
+    else if (sexp_oportp(x))
+      res += sexp_port_offset(x);
+    return sexp_make_integer(ctx, res);
+  }
+  if (sexp_stream_portp(x))
+    return sexp_make_integer(ctx, fseek(sexp_port_stream(x), offset, whence));
+  if (sexp_iportp(x) && sexp_port_buf(x) && !sexp_port_customp(x)) {
+    /* string and mapped ports hold their whole input in the buffer */
+    if (whence == SEEK_CUR)
+      offset += sexp_port_offset(x);
+    else if (whence == SEEK_END)
+      offset += sexp_port_size(x);
+    if (offset < 0 || offset > (off_t)sexp_port_size(x) || !sexp_port_openp(x))
+      return sexp_make_integer(ctx, -1);
+    sexp_port_offset(x) = offset;
+    return sexp_make_integer(ctx, offset);
+  }
+  return sexp_xtype_exception(ctx, self, "not a seekable port", x);
+}
+
+sexp sexp_tell (sexp ctx, sexp self, sexp x) {
+  if (sexp_portp(x) && sexp_stream_portp(x))
+    return sexp_make_integer(ctx, ftell(sexp_port_stream(x)));
+  return sexp_seek(ctx, self, x, 0, SEEK_CUR);
+}
+
+int sexp_send_file (int fd, int s, off_t offset, off_t len, off_t* res) {
+#if SEXP_USE_SEND_FILE
+  *res = len;
+  return sendfile(fd, s, offset, res, NULL, 0);
+#else
+  *res = 0;
+  return 22; /* EINVAL */
+#endif
+}
+/*
+types: ()
+enums: ()
+*/
+
+sexp sexp_peek_u8_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_peek_u8(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_read_u8_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_read_u8(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_write_u8_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3) {
+  sexp res;
+  res = sexp_write_u8(ctx, self, arg2, arg3);
+  return res;
+}
+
+sexp sexp_utf8_3e_string_x_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_utf8_to_string_x(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_25_string_3e_utf8_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_string_to_utf8(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_string_count_chars_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4, sexp arg5) {
+  sexp res;
+  res = sexp_string_count(ctx, self, arg2, arg3, arg4, arg5);
+  return res;
+}
+
+sexp sexp_25_read_delimited_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4) {
+  sexp res;
+  res = sexp_read_delimited(ctx, self, arg2, arg3, arg4);
+  return res;
+}
+
+sexp sexp_write_output_string_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3) {
+  sexp res;
+  res = sexp_write_output_string(ctx, self, arg2, arg3);
+  return res;
+}
+
+sexp sexp_port_buffer_size_set_x_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3) {
+  sexp res;
+  res = sexp_set_port_buffer_size(ctx, self, arg2, arg3);
+  return res;
+}
+
+sexp sexp_open_binary_mmap_input_file_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_open_binary_mmap_input_file(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_open_mmap_input_file_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_open_mmap_input_file(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_get_output_bytevector_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_get_output_bytevector(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_open_output_bytevector_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_open_output_bytevector(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_open_input_bytevector_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_open_input_bytevector(ctx, self, arg2);
+  return res;
+}
+
+sexp sexp_25_make_custom_binary_vectored_output_port_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4, sexp arg5) {
+  sexp res;
+  res = sexp_make_custom_binary_vectored_output_port(ctx, self, arg2, arg3, arg4, arg5);
+  return res;
+}
+
+sexp sexp_25_make_custom_vectored_output_port_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4, sexp arg5) {
+  sexp res;
+  res = sexp_make_custom_vectored_output_port(ctx, self, arg2, arg3, arg4, arg5);
+  return res;
+}
+
+sexp sexp_25_make_custom_binary_output_port_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4, sexp arg5) {
+  sexp res;
+  res = sexp_make_custom_binary_output_port(ctx, self, arg2, arg3, arg4, arg5);
+  return res;
+}
+
+sexp sexp_25_make_custom_binary_input_port_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4, sexp arg5) {
+  sexp res;
+  res = sexp_make_custom_binary_input_port(ctx, self, arg2, arg3, arg4, arg5);
+  return res;
+}
+
+sexp sexp_25_make_custom_output_port_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4, sexp arg5) {
+  sexp res;
+  res = sexp_make_custom_output_port(ctx, self, arg2, arg3, arg4, arg5);
+  return res;
+}
+
+sexp sexp_25_make_custom_input_port_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4, sexp arg5) {
+  sexp res;
+  res = sexp_make_custom_input_port(ctx, self, arg2, arg3, arg4, arg5);
+  return res;
+}
+
+sexp sexp_25_send_file_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg0, sexp arg1, sexp arg2, sexp arg3) {
+  int err = 0;
+  off_t tmp4;
+  sexp res;
+  sexp_gc_var1(res4);
+  if (! (sexp_filenop(arg0) || sexp_fixnump(arg0)))
+    return sexp_type_exception(ctx, self, SEXP_FILENO, arg0);
+  if (! (sexp_filenop(arg1) || sexp_fixnump(arg1)))
+    return sexp_type_exception(ctx, self, SEXP_FILENO, arg1);
+  if (! sexp_exact_integerp(arg2))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, arg2);
+  if (! sexp_exact_integerp(arg3))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, arg3);
+  sexp_gc_preserve1(ctx, res4);
+  err = sexp_send_file((sexp_filenop(arg0) ? sexp_fileno_fd(arg0) : sexp_unbox_fixnum(arg0)), (sexp_filenop(arg1) ? sexp_fileno_fd(arg1) : sexp_unbox_fixnum(arg1)), sexp_uint_value(arg2), sexp_uint_value(arg3), &tmp4);
+  if (err) {
+  res = SEXP_FALSE;
+  } else {
+  res4 = sexp_make_unsigned_integer(ctx, tmp4);
+  res = res4;
+  }
+  sexp_gc_release1(ctx);
+  return res;
+}
+
+sexp sexp_is_a_socket_p_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg0) {
+  sexp res;
+  if (! (sexp_filenop(arg0) || sexp_fixnump(arg0)))
+    return sexp_type_exception(ctx, self, SEXP_FILENO, arg0);
+  res = sexp_make_boolean(sexp_is_a_socket_p((sexp_filenop(arg0) ? sexp_fileno_fd(arg0) : sexp_unbox_fixnum(arg0))));
+  return res;
+}
+
+sexp sexp_set_file_position_x_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2, sexp arg3, sexp arg4) {
+  sexp res;
+  if (! sexp_exact_integerp(arg3))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, arg3);
+  if (! sexp_exact_integerp(arg4))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, arg4);
+  res = sexp_seek(ctx, self, arg2, sexp_uint_value(arg3), sexp_sint_value(arg4));
+  return res;
+}
+
+sexp sexp_file_position_stub (sexp ctx, sexp self, sexp_sint_t n, sexp arg2) {
+  sexp res;
+  res = sexp_tell(ctx, self, arg2);
+  return res;
+}
+
+
+sexp sexp_init_library (sexp ctx, sexp self, sexp_sint_t n, sexp env, const char* version, const sexp_abi_identifier_t abi) {
+  sexp_gc_var3(name, tmp, op);
+  if (!(sexp_version_compatible(ctx, version, sexp_version)
+        && sexp_abi_compatible(ctx, abi, SEXP_ABI_IDENTIFIER)))
+    return SEXP_ABI_ERROR;
+  sexp_gc_preserve3(ctx, name, tmp, op);
+  name = sexp_intern(ctx, "seek/end", 8);
+  sexp_env_define(ctx, env, name, tmp=sexp_make_integer(ctx, SEEK_END));
+  name = sexp_intern(ctx, "seek/cur", 8);
+  sexp_env_define(ctx, env, name, tmp=sexp_make_integer(ctx, SEEK_CUR));
+  name = sexp_intern(ctx, "seek/set", 8);
+  sexp_env_define(ctx, env, name, tmp=sexp_make_integer(ctx, SEEK_SET));
+  op = sexp_define_foreign_param(ctx, env, "peek-u8", 1, sexp_peek_u8_stub, "current-input-port");
+  op = sexp_define_foreign_param(ctx, env, "read-u8", 1, sexp_read_u8_stub, "current-input-port");
+  op = sexp_define_foreign_param(ctx, env, "write-u8", 2, sexp_write_u8_stub, "current-output-port");
+  op = sexp_define_foreign(ctx, env, "utf8->string!", 1, sexp_utf8_3e_string_x_stub);
+  op = sexp_define_foreign(ctx, env, "%string->utf8", 1, sexp_25_string_3e_utf8_stub);
+  op = sexp_define_foreign_opt(ctx, env, "string-count-chars", 4, sexp_string_count_chars_stub, SEXP_FALSE);
+  op = sexp_define_foreign(ctx, env, "%read-delimited", 3, sexp_25_read_delimited_stub);
+  op = sexp_define_foreign_param(ctx, env, "write-output-string", 2, sexp_write_output_string_stub, "current-output-port");
+  op = sexp_define_foreign(ctx, env, "port-buffer-size-set!", 2, sexp_port_buffer_size_set_x_stub);
+  op = sexp_define_foreign(ctx, env, "open-binary-mmap-input-file", 1, sexp_open_binary_mmap_input_file_stub);
+  op = sexp_define_foreign(ctx, env, "open-mmap-input-file", 1, sexp_open_mmap_input_file_stub);
+  op = sexp_define_foreign(ctx, env, "get-output-bytevector", 1, sexp_get_output_bytevector_stub);
+  op = sexp_define_foreign_opt(ctx, env, "open-output-bytevector", 1, sexp_open_output_bytevector_stub, SEXP_FALSE);
+  op = sexp_define_foreign(ctx, env, "open-input-bytevector", 1, sexp_open_input_bytevector_stub);
+  op = sexp_define_foreign(ctx, env, "%make-custom-binary-vectored-output-port", 4, sexp_25_make_custom_binary_vectored_output_port_stub);
+  op = sexp_define_foreign(ctx, env, "%make-custom-vectored-output-port", 4, sexp_25_make_custom_vectored_output_port_stub);
+  op = sexp_define_foreign(ctx, env, "%make-custom-binary-output-port", 4, sexp_25_make_custom_binary_output_port_stub);
+  op = sexp_define_foreign(ctx, env, "%make-custom-binary-input-port", 4, sexp_25_make_custom_binary_input_port_stub);
+  op = sexp_define_foreign(ctx, env, "%make-custom-output-port", 4, sexp_25_make_custom_output_port_stub);
+  op = sexp_define_foreign(ctx, env, "%make-custom-input-port", 4, sexp_25_make_custom_input_port_stub);
+  op = sexp_define_foreign_opt(ctx, env, "%send-file", 4, sexp_25_send_file_stub, sexp_make_unsigned_integer(ctx, 0));
+  if (sexp_opcodep(op)) {
+    sexp_opcode_return_type(op) = sexp_make_fixnum(SEXP_OBJECT);
+    sexp_opcode_arg1_type(op) = sexp_make_fixnum(SEXP_FILENO);
+    sexp_opcode_arg2_type(op) = sexp_make_fixnum(SEXP_FILENO);
+    sexp_opcode_arg3_type(op) = sexp_make_fixnum(SEXP_FIXNUM);
+    sexp_opcode_argn_type(op) = sexp_make_vector(ctx, SEXP_TWO, sexp_make_fixnum(SEXP_OBJECT));
+    sexp_vector_set(sexp_opcode_argn_type(op), SEXP_ZERO, sexp_make_fixnum(SEXP_FIXNUM));
+    sexp_vector_set(sexp_opcode_argn_type(op), SEXP_ONE, sexp_make_fixnum(SEXP_FIXNUM));
+  }
+  op = sexp_define_foreign(ctx, env, "is-a-socket?", 1, sexp_is_a_socket_p_stub);
+  if (sexp_opcodep(op)) {
+    sexp_opcode_return_type(op) = sexp_make_fixnum(SEXP_BOOLEAN);
+    sexp_opcode_arg1_type(op) = sexp_make_fixnum(SEXP_FILENO);
+  }
+  op = sexp_define_foreign(ctx, env, "set-file-position!", 3, sexp_set_file_position_x_stub);
+  if (sexp_opcodep(op)) {
+    sexp_opcode_return_type(op) = sexp_make_fixnum(SEXP_OBJECT);
+    sexp_opcode_argn_type(op) = sexp_make_vector(ctx, SEXP_TWO, sexp_make_fixnum(SEXP_OBJECT));
+    sexp_vector_set(sexp_opcode_argn_type(op), SEXP_ZERO, sexp_make_fixnum(SEXP_FIXNUM));
+    sexp_vector_set(sexp_opcode_argn_type(op), SEXP_ONE, sexp_make_fixnum(SEXP_FIXNUM));
+  }
+  op = sexp_define_foreign(ctx, env, "file-position", 1, sexp_file_position_stub);
+  sexp_gc_release3(ctx);
+  return SEXP_VOID;
+}
+
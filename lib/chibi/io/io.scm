@@ -27,7 +27,7 @@
       (let ((start (car o))
             (end (if (pair? (cdr o)) (cadr o) (bytevector-length vec))))
         (utf8->string (subbytes vec start end)))
-      (string-copy (utf8->string! vec))))
+      (utf8->string! (subbytes vec 0))))
 
 (define (string->utf8 str . o)
   (if (pair? o)
@@ -75,49 +75,53 @@
 ;;> a string not including the newline.  Reads at most \var{n}
 ;;> characters, defaulting to 8192.
 
-(define (%read-line n in)
-  (cond
-   ((stream-port? in) ;;(port-fileno in)
-    (port-line-set! in (+ 1 (port-line in)))
-    (%%read-line n in))
-   (else
-    (let ((out (open-output-string)))
-      (let lp ((i 0))
-        (let ((ch (peek-char in)))
-          (cond
-           ((eof-object? ch)
-            (let ((res (get-output-string out)))
-              (and (not (equal? res "")) res)))
-           ((eqv? ch #\newline)
-            (read-char in)
-            (get-output-string out))
-           ((eqv? ch #\return)
-            (read-char in)
-            (if (eqv? #\newline (peek-char in))
-                (read-char in))
-            (get-output-string out))
-           ((>= i n)
-            (get-output-string out))
-           (else
-            (write-char (read-char in) out)
-            (lp (+ i 1))))))))))
-
 (define (read-line . o)
   (let ((in (if (pair? o) (car o) (current-input-port)))
         (n (if (and (pair? o) (pair? (cdr o))) (car (cdr o)) 8192)))
-    (let ((res (%read-line n in)))
-      (if (not res)
-          eof
-          (let ((len (string-length res)))
-            (cond  ;; strip crlf
-             ((and (> len 0) (eqv? #\newline (string-ref res (- len 1))))
-              (if (and (> len 1) (eqv? #\return (string-ref res (- len 2))))
-                  (substring res 0 (- len 2))
-                  (substring res 0 (- len 1))))
-             ((and (> len 0) (eqv? #\return (string-ref res (- len 1))))
-              (substring res 0 (- len 1)))
-             (else
-              res)))))))
+    (%read-delimited in #f n)))
+
+;;> \procedure{(read-delimited delims [in [n]])}
+
+;;> Read from the input port \var{in}, defaulting to
+;;> \scheme{(current-input-port)}, up to the next delimiter and
+;;> return the result as a string.  The delimiter is consumed but not
+;;> included in the result.  \var{delims} can be a character, a string
+;;> of characters any of which is a delimiter, or a predicate on
+;;> characters.  Reads at most \var{n} characters, defaulting to no
+;;> limit.  Returns an eof object if no characters remain.
+
+(define (ascii-delimiters? x)
+  (if (char? x)
+      (< (char->integer x) 128)
+      (and (string? x)
+           (let lp ((ls (string->list x)))
+             (or (null? ls)
+                 (and (< (char->integer (car ls)) 128) (lp (cdr ls))))))))
+
+(define (read-delimited delims . o)
+  (let ((in (if (pair? o) (car o) (current-input-port)))
+        (n (and (pair? o) (pair? (cdr o)) (car (cdr o)))))
+    (if (ascii-delimiters? delims)
+        (%read-delimited in delims n)
+        (let ((delim? (cond ((char? delims) (lambda (ch) (eqv? ch delims)))
+                            ((string? delims)
+                             (lambda (ch) (memv ch (string->list delims))))
+                            (else delims)))
+              (out (open-output-string)))
+          (let lp ((i 0))
+            (let ((ch (peek-char in)))
+              (cond
+               ((eof-object? ch)
+                (let ((res (get-output-string out)))
+                  (if (equal? res "") ch res)))
+               ((delim? ch)
+                (read-char in)
+                (get-output-string out))
+               ((and n (>= i n))
+                (get-output-string out))
+               (else
+                (write-char (read-char in) out)
+                (lp (+ i 1))))))))))
 
 ;;> \procedure{(read-string n [in])}
 
@@ -256,22 +260,26 @@
 ;;> \var{read} is a procedure of three arguments:
 ;;> \scheme{(lambda (str start end) ...)} which should fill \var{str} from
 ;;> \var{start} to \var{end} with bytes, returning the actual number
-;;> of bytes filled.
+;;> of bytes filled.  The optional \var{buffer-size} requests a
+;;> larger buffer, so that \var{read} is called less often.
 
 (define (make-custom-input-port read . o)
   (let ((seek (and (pair? o) (car o)))
-        (close (and (pair? o) (pair? (cdr o)) (car (cdr o)))))
-    (%make-custom-input-port read seek close)))
+        (close (and (pair? o) (pair? (cdr o)) (car (cdr o))))
+        (size (and (pair? o) (pair? (cdr o)) (pair? (cddr o)) (car (cddr o)))))
+    (%make-custom-input-port read seek close size)))
 
 ;;> \var{write} is a procedure of three arguments:
 ;;> \scheme{(lambda (str start end) ...)} which should write the bytes of
 ;;> \var{str} from \var{start} to \var{end}, returning the actual
-;;> number of bytes written.
+;;> number of bytes written.  The optional \var{buffer-size} requests
+;;> a larger buffer, so that \var{write} is called less often.
 
 (define (make-custom-output-port write . o)
   (let ((seek (and (pair? o) (car o)))
-        (close (and (pair? o) (pair? (cdr o)) (car (cdr o)))))
-    (%make-custom-output-port write seek close)))
+        (close (and (pair? o) (pair? (cdr o)) (car (cdr o))))
+        (size (and (pair? o) (pair? (cdr o)) (pair? (cddr o)) (car (cddr o)))))
+    (%make-custom-output-port write seek close size)))
 
 ;;> Similar to \scheme{make-custom-input-port} but returns a binary
 ;;> port, and \var{read} receives a bytevector to fill instead of a
@@ -279,8 +287,9 @@
 
 (define (make-custom-binary-input-port read . o)
   (let ((seek (and (pair? o) (car o)))
-        (close (and (pair? o) (pair? (cdr o)) (car (cdr o)))))
-    (%make-custom-binary-input-port read seek close)))
+        (close (and (pair? o) (pair? (cdr o)) (car (cdr o))))
+        (size (and (pair? o) (pair? (cdr o)) (pair? (cddr o)) (car (cddr o)))))
+    (%make-custom-binary-input-port read seek close size)))
 
 ;;> Similar to \scheme{make-custom-output-port} but returns a binary
 ;;> port, and \var{write} receives data from a bytevector instead of a
@@ -288,8 +297,31 @@
 
 (define (make-custom-binary-output-port write . o)
   (let ((seek (and (pair? o) (car o)))
-        (close (and (pair? o) (pair? (cdr o)) (car (cdr o)))))
-    (%make-custom-binary-output-port write seek close)))
+        (close (and (pair? o) (pair? (cdr o)) (car (cdr o))))
+        (size (and (pair? o) (pair? (cdr o)) (pair? (cddr o)) (car (cddr o)))))
+    (%make-custom-binary-output-port write seek close size)))
+
+;;> Similar to \scheme{make-custom-output-port}, but full buffers are
+;;> queued and \var{write} is called with a list of strings, the
+;;> output so far in order, only once enough are pending or when the
+;;> port is flushed or closed.  \var{write} should consume them all,
+;;> returning the number of bytes written.  The strings are fresh
+;;> for each call, so \var{write} may keep them.
+
+(define (make-custom-vectored-output-port write . o)
+  (let ((seek (and (pair? o) (car o)))
+        (close (and (pair? o) (pair? (cdr o)) (car (cdr o))))
+        (size (and (pair? o) (pair? (cdr o)) (pair? (cddr o)) (car (cddr o)))))
+    (%make-custom-vectored-output-port write seek close size)))
+
+;;> Similar to \scheme{make-custom-vectored-output-port} but returns a
+;;> binary port, and \var{write} receives a list of bytevectors.
+
+(define (make-custom-binary-vectored-output-port write . o)
+  (let ((seek (and (pair? o) (car o)))
+        (close (and (pair? o) (pair? (cdr o)) (car (cdr o))))
+        (size (and (pair? o) (pair? (cdr o)) (pair? (cddr o)) (car (cddr o)))))
+    (%make-custom-binary-vectored-output-port write seek close size)))
 
 ;;> A simple /dev/null port which accepts and does nothing with any
 ;;> data written to it.
@@ -95,7 +95,10 @@ static ssize_t sexp_cookie_writer (void *cookie, const char *buffer, size_t size
   sexp_gc_preserve2(ctx, ctx2, args);
   if (size > sexp_string_size(sexp_cookie_buffer(vec)))
     sexp_cookie_buffer_set(vec, sexp_make_string(ctx, sexp_make_fixnum(size), SEXP_VOID));
+  else
+    sexp_string_unshare(ctx, sexp_cookie_buffer(vec));
   memcpy(sexp_string_data(sexp_cookie_buffer(vec)), buffer, size);
+  sexp_update_string_index_lookup(ctx, sexp_cookie_buffer(vec));
   args = sexp_list2(ctx, SEXP_ZERO, sexp_make_fixnum(size));
   args = sexp_cons(ctx, sexp_cookie_buffer(vec), args);
   res = sexp_apply(ctx, sexp_cookie_write(vec), args);
@@ -154,7 +157,8 @@ static cookie_io_functions_t sexp_cookie_no_seek = {
 
 static sexp sexp_make_custom_port (sexp ctx, sexp self, const char *mode,
                                    sexp read, sexp write,
-                                   sexp seek, sexp close) {
+                                   sexp seek, sexp close,
+                                   sexp size, int vectoredp) {
   FILE *in;
   sexp res;
   sexp_gc_var1(vec);
@@ -167,7 +171,7 @@ static sexp sexp_make_custom_port (sexp ctx, sexp self, const char *mode,
   if (sexp_truep(close) && ! sexp_procedurep(close))
     return sexp_type_exception(ctx, self, SEXP_PROCEDURE, close);
   sexp_gc_preserve1(ctx, vec);
-  vec = sexp_make_vector(ctx, SEXP_SIX, SEXP_VOID);
+  vec = sexp_make_vector(ctx, SEXP_EIGHT, SEXP_FALSE);
   sexp_cookie_ctx_set(vec, ctx);
   sexp_cookie_buffer_set(vec, sexp_make_string(ctx, sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE), SEXP_VOID));
   sexp_cookie_read_set(vec, read);
@@ -199,11 +203,15 @@ static sexp sexp_make_custom_port (sexp ctx, sexp self, const char *mode,
 
 static sexp sexp_make_custom_port (sexp ctx, sexp self,
                                    const char *mode, sexp read, sexp write,
-                                   sexp seek, sexp close) {
-  sexp vec;
-  sexp_gc_var2(res, str);
-  sexp_gc_preserve2(ctx, res, str);
-  str = sexp_make_string(ctx, sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE), SEXP_VOID);
+                                   sexp seek, sexp close,
+                                   sexp size, int vectoredp) {
+  sexp_gc_var3(res, str, vec);
+  if (sexp_truep(size) && ! sexp_fixnump(size))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, size);
+  if (! sexp_fixnump(size) || sexp_unbox_fixnum(size) < SEXP_PORT_BUFFER_SIZE)
+    size = sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE);
+  sexp_gc_preserve3(ctx, res, str, vec);
+  str = sexp_make_string(ctx, size, SEXP_VOID);
   if (sexp_exceptionp(str)) return str;
   res = sexp_open_input_string(ctx, str);
   if (sexp_exceptionp(res)) return res;
@@ -214,29 +222,33 @@ static sexp sexp_make_custom_port (sexp ctx, sexp self,
     sexp_port_offset(res) = 0;
     sexp_port_size(res) = 0;
   }
-  vec = sexp_make_vector(ctx, SEXP_SIX, SEXP_VOID);
+  vec = sexp_make_vector(ctx, SEXP_EIGHT, SEXP_FALSE);
   if (sexp_exceptionp(vec)) return vec;
-  sexp_vector_set(vec, SEXP_ZERO, SEXP_FALSE);
   sexp_vector_set(vec, SEXP_ONE, sexp_port_cookie(res));
   sexp_vector_set(vec, SEXP_TWO, read);
   sexp_vector_set(vec, SEXP_THREE, write);
   sexp_vector_set(vec, SEXP_FOUR, seek);
   sexp_vector_set(vec, SEXP_FIVE, close);
+  /* preallocated (buffer start end) arguments for read and write */
+  str = sexp_list2(ctx, SEXP_ZERO, SEXP_ZERO);
+  sexp_vector_set(vec, SEXP_SIX, sexp_cons(ctx, SEXP_FALSE, str));
+  if (vectoredp) sexp_vector_set(vec, SEXP_SEVEN, sexp_cons(ctx, SEXP_NULL, SEXP_NULL));
   sexp_port_cookie(res) = vec;
-  sexp_gc_release2(ctx);
+  sexp_gc_release3(ctx);
   return res;
 }
 
 #endif
 
 sexp sexp_make_custom_input_port (sexp ctx, sexp self,
-                                  sexp read, sexp seek, sexp close) {
-  return sexp_make_custom_port(ctx, self, "r", read, SEXP_FALSE, seek, close);
+                                  sexp read, sexp seek, sexp close, sexp size) {
+  return sexp_make_custom_port(ctx, self, "r", read, SEXP_FALSE, seek, close, size, 0);
 }
 
-sexp sexp_make_custom_output_port (sexp ctx, sexp self,
-                                   sexp write, sexp seek, sexp close) {
-  sexp res = sexp_make_custom_port(ctx, self, "w", SEXP_FALSE, write, seek, close);
+static sexp sexp_make_custom_output_port_aux (sexp ctx, sexp self,
+                                              sexp write, sexp seek, sexp close,
+                                              sexp size, int vectoredp) {
+  sexp res = sexp_make_custom_port(ctx, self, "w", SEXP_FALSE, write, seek, close, size, vectoredp);
 #if SEXP_USE_STRING_STREAMS
   if (!sexp_exceptionp(res))
     sexp_pointer_tag(res) = SEXP_OPORT;
@@ -244,16 +256,33 @@ sexp sexp_make_custom_output_port (sexp ctx, sexp self,
   return res;
 }
 
+sexp sexp_make_custom_output_port (sexp ctx, sexp self,
+                                   sexp write, sexp seek, sexp close, sexp size) {
+  return sexp_make_custom_output_port_aux(ctx, self, write, seek, close, size, 0);
+}
+
+sexp sexp_make_custom_vectored_output_port (sexp ctx, sexp self,
+                                            sexp write, sexp seek, sexp close, sexp size) {
+  return sexp_make_custom_output_port_aux(ctx, self, write, seek, close, size, 1);
+}
+
 sexp sexp_make_custom_binary_input_port (sexp ctx, sexp self,
-                                         sexp read, sexp seek, sexp close) {
-  sexp res = sexp_make_custom_input_port(ctx, self, read, seek, close);
+                                         sexp read, sexp seek, sexp close, sexp size) {
+  sexp res = sexp_make_custom_input_port(ctx, self, read, seek, close, size);
   sexp_port_binaryp(res) = 1;
   return res;
 }
 
 sexp sexp_make_custom_binary_output_port (sexp ctx, sexp self,
-                                          sexp write, sexp seek, sexp close) {
-  sexp res = sexp_make_custom_output_port(ctx, self, write, seek, close);
+                                          sexp write, sexp seek, sexp close, sexp size) {
+  sexp res = sexp_make_custom_output_port(ctx, self, write, seek, close, size);
+  sexp_port_binaryp(res) = 1;
+  return res;
+}
+
+sexp sexp_make_custom_binary_vectored_output_port (sexp ctx, sexp self,
+                                                   sexp write, sexp seek, sexp close, sexp size) {
+  sexp res = sexp_make_custom_vectored_output_port(ctx, self, write, seek, close, size);
   sexp_port_binaryp(res) = 1;
   return res;
 }
@@ -282,9 +311,9 @@ sexp sexp_open_input_bytevector (sexp ctx, sexp self, sexp vec) {
   return res;
 }
 
-sexp sexp_open_output_bytevector (sexp ctx, sexp self) {
-  sexp res = sexp_open_output_string(ctx);
-  sexp_port_binaryp(res) = 1;
+sexp sexp_open_output_bytevector (sexp ctx, sexp self, sexp size_hint) {
+  sexp res = sexp_open_output_string_op(ctx, self, 1, size_hint);
+  if (sexp_portp(res)) sexp_port_binaryp(res) = 1;
   return res;
 }
 
@@ -301,6 +330,35 @@ sexp sexp_get_output_bytevector (sexp ctx, sexp self, sexp port) {
   return res;
 }
 
+/* without mmap support these are ordinary file ports */
+sexp sexp_open_mmap_input_file (sexp ctx, sexp self, sexp path) {
+#if SEXP_USE_MMAP_PORTS
+  return sexp_open_mmap_input_file_op(ctx, self, 2, path, SEXP_FALSE);
+#else
+  return sexp_open_input_file_op(ctx, self, 1, path, SEXP_FALSE);
+#endif
+}
+
+sexp sexp_open_binary_mmap_input_file (sexp ctx, sexp self, sexp path) {
+#if SEXP_USE_MMAP_PORTS
+  return sexp_open_mmap_input_file_op(ctx, self, 2, path, SEXP_TRUE);
+#else
+  return sexp_open_binary_input_file(ctx, self, 1, path, SEXP_FALSE);
+#endif
+}
+
+sexp sexp_set_port_buffer_size (sexp ctx, sexp self, sexp port, sexp size) {
+  return sexp_set_port_buffer_size_op(ctx, self, 2, port, size);
+}
+
+sexp sexp_write_output_string (sexp ctx, sexp self, sexp port, sexp out) {
+  return sexp_write_output_string_op(ctx, self, 2, port, out);
+}
+
+sexp sexp_read_delimited (sexp ctx, sexp self, sexp in, sexp delims, sexp max) {
+  return sexp_read_delimited_op(ctx, self, 3, in, delims, max);
+}
+
 sexp sexp_string_count (sexp ctx, sexp self, sexp ch, sexp str, sexp start, sexp end) {
   const unsigned char *s, *e;
   sexp_sint_t c, count = 0;
@@ -427,6 +485,17 @@ sexp sexp_seek (sexp ctx, sexp self, sexp x, off_t offset, int whence) {
   }
   if (sexp_stream_portp(x))
     return sexp_make_integer(ctx, fseek(sexp_port_stream(x), offset, whence));
+  if (sexp_iportp(x) && sexp_port_buf(x) && !sexp_port_customp(x)) {
+    /* string and mapped ports hold their whole input in the buffer */
+    if (whence == SEEK_CUR)
+      offset += sexp_port_offset(x);
+    else if (whence == SEEK_END)
+      offset += sexp_port_size(x);
+    if (offset < 0 || offset > (off_t)sexp_port_size(x) || !sexp_port_openp(x))
+      return sexp_make_integer(ctx, -1);
+    sexp_port_offset(x) = offset;
+    return sexp_make_integer(ctx, offset);
+  }
   return sexp_xtype_exception(ctx, self, "not a seekable port", x);
 }
 
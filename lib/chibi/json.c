@@ -35,8 +35,10 @@ sexp sexp_json_write_exception (sexp ctx, sexp self, const char* msg, sexp obj)
 }
 
 sexp json_read_number (sexp ctx, sexp self, sexp in) {
-  double res = 0, scale = 1;
-  int sign = 1, inexactp = 0, scale_sign = 1, ch;
+  char digits[SEXP_MAX_DECIMAL_DIGITS + 1];
+  int sign = 1, inexactp = 0, scale_sign = 1, ch, len = 0, stickyp = 0;
+  long exp10 = 0, scale = 0;
+  double res;
   ch = sexp_read_char(ctx, in);
   if (ch == '+') {
     ch = sexp_read_char(ctx, in);
@@ -44,14 +46,26 @@ sexp json_read_number (sexp ctx, sexp self, sexp in) {
     ch = sexp_read_char(ctx, in);
     sign = -1;
   }
-  for ( ; ch != EOF && isdigit(ch); ch = sexp_read_char(ctx, in))
-    res = res * 10 + ch - '0';
+  for ( ; ch != EOF && isdigit(ch); ch = sexp_read_char(ctx, in)) {
+    if (len < SEXP_MAX_DECIMAL_DIGITS) {
+      digits[len++] = ch;
+    } else {
+      exp10++;
+      if (ch != '0') stickyp = 1;
+    }
+  }
   if (ch == '.') {
     inexactp = 1;
-    for (ch = sexp_read_char(ctx, in); isdigit(ch); scale *= 10, ch = sexp_read_char(ctx, in))
-      res = res * 10 + ch - '0';
-    res /= scale;
-  } else if (ch == 'e') {
+    for (ch = sexp_read_char(ctx, in); isdigit(ch); ch = sexp_read_char(ctx, in)) {
+      if (len < SEXP_MAX_DECIMAL_DIGITS) {
+        digits[len++] = ch;
+        exp10--;
+      } else if (ch != '0') {
+        stickyp = 1;
+      }
+    }
+  }
+  if (ch == 'e' || ch == 'E') {
     inexactp = 1;
     ch = sexp_read_char(ctx, in);
     if (ch == '+') {
@@ -60,11 +74,17 @@ sexp json_read_number (sexp ctx, sexp self, sexp in) {
       ch = sexp_read_char(ctx, in);
       scale_sign = -1;
     }
-    for (scale=0; isdigit(ch); ch = sexp_read_char(ctx, in))
-      scale = scale * 10 + ch - '0';
-    res *= pow(10.0, scale_sign * scale);
+    for ( ; isdigit(ch); ch = sexp_read_char(ctx, in))
+      if (scale < 100000)
+        scale = scale * 10 + ch - '0';
+    exp10 += scale_sign * scale;
   }
   if (ch != EOF) sexp_push_char(ctx, ch, in);
+  if (stickyp) {
+    digits[len++] = '1';
+    exp10--;
+  }
+  res = sexp_decimal_to_double(digits, len, exp10);
   return (inexactp || fabs(res) > SEXP_MAX_FIXNUM) ?
     sexp_make_flonum(ctx, sign * res) :
     sexp_make_fixnum(sign * res);  /* always return inexact? */
@@ -322,15 +342,16 @@ sexp sexp_json_read (sexp ctx, sexp self, sexp_sint_t n, sexp in) {
 
 sexp json_write (sexp ctx, sexp self, sexp obj, sexp out);
 
-#define FLONUM_SIGNIFICANT_DIGITS 10
-#define FLONUM_EXP_MAX_DIGITS 3
 sexp json_write_flonum(sexp ctx, sexp self, const sexp obj, sexp out) {
+  char cout[SEXP_DOUBLE_BUF_LEN];
+  int len;
   if (sexp_infp(obj) || sexp_nanp(obj)) {
     return sexp_json_write_exception(ctx, self, "unable to encode number", obj);
   }
-  /* Extra space for signs (x2), dot, E and \0 */
-  char cout[FLONUM_SIGNIFICANT_DIGITS + FLONUM_EXP_MAX_DIGITS + 5];
-  snprintf(cout, sizeof(cout), "%.*G", FLONUM_SIGNIFICANT_DIGITS, sexp_flonum_value(obj));
+  len = sexp_double_to_chars(sexp_flonum_value(obj), cout);
+  /* integral values are written as JSON integers */
+  if (len > 2 && cout[len-2] == '.' && cout[len-1] == '0')
+    cout[len-2] = '\0';
   sexp_write_string(ctx, cout, out);
   return SEXP_VOID;
 }
@@ -1088,22 +1088,110 @@
          ((vector? t) (list _list->vector (lp (vector->list t) dim ell-esc)))
          ((null? t) (list _quote '()))
          (else t))))
-    (list
-     _er-macro-transformer
-     (list _lambda (list _expr _rename _compare)
-           (list
-            _car
-            (cons
-             _or
-             (append
-              (map
-               (lambda (clause) (expand-pattern (car clause) (cadr clause)))
-               forms)
-              (list
-               (list _cons
-                     (list _error "no expansion for"
-                           (list (rename 'strip-syntactic-closures) _expr))
-                     #f)))))))))
+    ;; The native expander takes each rule as #(num-vars pattern
+    ;; template), where patterns and templates are trees of #(tag ...)
+    ;; vectors as described in eval.c, and variables are numbered in
+    ;; the order they're bound.
+    (define (var-index x vars)
+      (length (cdr (memq (assq x vars) vars))))
+    (define (compile-pattern pat k)
+      (let ((vars '()))
+        (define (lp p dim)
+          (cond
+           ((identifier? p)
+            (cond
+             ((ellipsis-mark? p) (error "bad ellipsis" p))
+             ((memq p lits) (vector 2 p))
+             ((compare p _underscore) (vector 1))
+             (else
+              (set! vars (cons (cons p dim) vars))
+              (vector 0 (var-index p vars)))))
+           ((ellipsis? p)
+            (if (any (lambda (x) (and (identifier? x) (ellipsis-mark? x)))
+                     (cddr p))
+                (error "multiple ellipses" p))
+            (let* ((outer vars)
+                   (elt (lp (car p) (+ dim 1)))
+                   (elt-vars (let take ((ls vars) (res '()))
+                               (if (eq? ls outer)
+                                   res
+                                   (take (cdr ls)
+                                         (cons (var-index (caar ls) vars)
+                                               res))))))
+              (vector 4 elt (lp (cddr p) dim) (length* (cddr p))
+                      (list->vector elt-vars))))
+           ((pair? p) (let ((a (lp (car p) dim))) (vector 3 a (lp (cdr p) dim))))
+           ((vector? p) (vector 5 (lp (vector->list p) dim)))
+           ((null? p) (vector 6))
+           (else (vector 7 p))))
+        (let ((res (lp pat 0)))
+          (k res vars))))
+    (define (compile-template tmpl vars)
+      (let lp ((t tmpl) (dim 0) (ell-esc #f))
+        (cond
+         ((identifier? t)
+          (cond
+           ((assq t vars)
+            => (lambda (cell)
+                 (if (<= (cdr cell) dim)
+                     (vector 0 (var-index t vars))
+                     (error "too few ...'s"))))
+           (else
+            (vector 1 t))))
+         ((pair? t)
+          (cond
+           ((and (ellipsis-escape? t) (not ell-esc))
+            (lp (if (and (pair? (cdr t)) (null? (cddr t))) (cadr t) (cdr t)) dim #t))
+           ((and (ellipsis? t) (not ell-esc))
+            (let* ((depth (ellipsis-depth t))
+                   (ell-dim (+ dim depth))
+                   (ell-vars (free-vars (car t) vars ell-dim)))
+              (if (null? ell-vars)
+                  (error "too many ...'s"))
+              (vector 3 (lp (car t) ell-dim ell-esc) depth
+                      (list->vector
+                       (map (lambda (x) (var-index x vars)) ell-vars))
+                      (lp (ellipsis-tail t) dim ell-esc))))
+           (else
+            (vector 2 (lp (car t) dim ell-esc) (lp (cdr t) dim ell-esc)
+                    (pair-source t)))))
+         ((vector? t) (vector 5 (lp (vector->list t) dim ell-esc)))
+         ((null? t) (vector 4))
+         (else (vector 6 t)))))
+    (define (compile-rule clause)
+      (compile-pattern
+       (cdr (car clause))
+       (lambda (pat vars)
+         (vector (length vars) pat (compile-template (cadr clause) vars)))))
+    (cond-expand
+     (native-syntax-rules
+      (list
+       _er-macro-transformer
+       (list _lambda (list _expr _rename _compare)
+             (list (rename '%syntax-rules-expand)
+                   (list _quote (map compile-rule forms))
+                   _expr
+                   _rename
+                   (list _or
+                         (list (rename 'current-usage-environment))
+                         (list (rename 'current-environment)))))))
+     (else
+      (list
+       _er-macro-transformer
+       (list _lambda (list _expr _rename _compare)
+             (list
+              _car
+              (cons
+               _or
+               (append
+                (map
+                 (lambda (clause) (expand-pattern (car clause) (cadr clause)))
+                 forms)
+                (list
+                 (list _cons
+                       (list _error "no expansion for"
+                             (list (rename 'strip-syntactic-closures) _expr))
+                       #f)))))))))))
 
 (define-syntax syntax-rules
   (er-macro-transformer
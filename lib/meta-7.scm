@@ -37,12 +37,21 @@
 (define (module-name-prefix name)
   (string-concatenate (reverse (cdr (cdr (module-name->strings name '()))))))
 
+;; module sources go through the primitive %load, which can use
+;; precompiled .fasl files
+(define (load-module-file path env)
+  (let ((old-env (current-environment)))
+    (dynamic-wind
+      (lambda () (set-current-environment! env))
+      (lambda () (%load path env))
+      (lambda () (set-current-environment! old-env)))))
+
 (define load-module-definition
   (let ((meta-env (current-environment)))
     (lambda (name)
       (let* ((file (module-name->file name))
              (path (find-module-file file)))
-        (if path (load path meta-env))))))
+        (if path (load-module-file path meta-env))))))
 
 (define (find-module name)
   (cond
@@ -158,6 +167,12 @@
         (auto-generate-bindings (cdr x)))
     x))
 
+(define (import-set-module-name x)
+  (if (and (pair? x) (memq (car x) '(prefix drop-prefix only except rename))
+           (pair? (cdr x)) (pair? (cadr x)))
+      (import-set-module-name (cadr x))
+      x))
+
 (define (resolve-module-imports env meta)
   (for-each
    (lambda (x)
@@ -165,9 +180,14 @@
        ((import import-immutable)
         (for-each
          (lambda (m)
-           (let* ((mod2-name+imports (resolve-import m))
-                  (mod2 (load-module (car mod2-name+imports))))
-             (%import env (module-env mod2) (cdr mod2-name+imports) #t)))
+           (define (import!)
+             (let* ((mod2-name+imports (resolve-import m))
+                    (mod2 (load-module (car mod2-name+imports))))
+               (%import env (module-env mod2) (cdr mod2-name+imports) #t)))
+           (let ((name (import-set-module-name m)))
+             (if (module-loaded? name)
+                 (import!)
+                 (profile-module name import!))))
          (cdr x)))))
    meta))
 
@@ -187,7 +207,7 @@
                            (set-port-fold-case! in #t)
                            (load in env)))
                         (else
-                         (load path env)))))
+                         (load-module-file path env)))))
             ((and (pair? o) (car o)) ((car o)))
             (else (error "couldn't find include" f)))))
        files))
@@ -199,6 +219,8 @@
       (module-meta-data-set!
        mod
        `((error "module attempted to reference itself while loading" ,name)))
+      ;; importers of the module depend on its declarations
+      (%note-module-file env (module-name->file name))
       (resolve-module-imports env meta)
       (protect
           (exn (else
@@ -240,11 +262,56 @@
      ls)
     env))
 
+;; In lazy mode (-L) a library with an explicit export list starts out
+;; with an env of placeholders, and is only evaluated once the expander
+;; first resolves one of them.  Returns #f when not in lazy mode.
+(define (lazy-module-env name mod)
+  (and (%module-exports mod)
+       (not (procedure? (module-meta-data mod)))
+       (letrec ((env (%make-lazy-env
+                      (map from-id (%module-exports mod))
+                      (lambda ()
+                        (if (eq? env (module-env mod))
+                            (module-env-set!
+                             mod
+                             (profile-module
+                              name
+                              (lambda () (eval-module name mod)))))
+                        (module-env mod)))))
+         env)))
+
+;; with -P, the files loaded for a module, including its definition
+;; and the modules it imports, are reported nested under its name
+(define profile-module
+  (let ((current #f))
+    (lambda (name thunk)
+      (if (equal? name current)
+          (thunk)
+          (let ((outer current)
+                (started? #f))
+            (dynamic-wind
+              (lambda ()
+                (set! current name)
+                (set! started? (%load-profile-begin name)))
+              thunk
+              (lambda ()
+                (set! current outer)
+                (%load-profile-end started?))))))))
+
+(define (module-loaded? name)
+  (cond ((assoc name *modules*) => (lambda (x) (and (module-env (cdr x)) #t)))
+        (else #f)))
+
 (define (load-module name)
-  (let ((mod (find-module name)))
-    (if (and mod (not (module-env mod)))
-        (module-env-set! mod (eval-module name mod)))
-    mod))
+  (define (load!)
+    (let ((mod (find-module name)))
+      (if (and mod (not (module-env mod)))
+          (module-env-set! mod (or (lazy-module-env name mod)
+                                   (eval-module name mod))))
+      mod))
+  (if (module-loaded? name)
+      (load!)
+      (profile-module name load!)))
 
 (%define-syntax meta-begin begin)
 (%define-syntax meta-define define)
@@ -7,6 +7,10 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <poll.h>
+#if SEXP_USE_EPOLL
+#include <errno.h>
+#include <sys/epoll.h>
+#endif
 
 #define sexp_mutexp(ctx, x)      (sexp_check_tag(x, sexp_unbox_fixnum(sexp_global(ctx, SEXP_G_THREADS_MUTEX_ID))))
 #define sexp_mutex_name(x)       sexp_slot_ref(x, 0)
@@ -18,17 +22,38 @@
 #define sexp_condvar_specific(x) sexp_slot_ref(x, 1)
 #define sexp_condvar_threads(x)  sexp_slot_ref(x, 2)
 
+/* the fds threads are blocked on: registered with epoll where */
+/* available, and otherwise (or for fds epoll doesn't support, such */
+/* as regular files) kept in an array for poll() */
 struct sexp_pollfds_t {
   struct pollfd *fds;
   nfds_t nfds, mfds;
+#if SEXP_USE_EPOLL
+  int epfd, nepfds, mevents;
+  pid_t pid;
+  short *events;                /* the poll events registered per fd */
+#endif
 };
 
 #define SEXP_INIT_POLLFDS_MAX_FDS 16
+#define SEXP_EPOLL_MAX_EVENTS 64
+#define SEXP_MAX_POLL_WAIT 1000000  /* ms */
 
 #define sexp_pollfdsp(ctx, x)    (sexp_check_tag(x, sexp_unbox_fixnum(sexp_global(ctx, SEXP_G_THREADS_POLLFDS_ID))))
 #define sexp_pollfds_fds(x)      (((struct sexp_pollfds_t*)(&(x)->value))->fds)
 #define sexp_pollfds_num_fds(x)  (((struct sexp_pollfds_t*)(&(x)->value))->nfds)
 #define sexp_pollfds_max_fds(x)  (((struct sexp_pollfds_t*)(&(x)->value))->mfds)
+#define sexp_pollfds_epfd(x)     (((struct sexp_pollfds_t*)(&(x)->value))->epfd)
+#define sexp_pollfds_num_epfds(x) (((struct sexp_pollfds_t*)(&(x)->value))->nepfds)
+#define sexp_pollfds_max_events(x) (((struct sexp_pollfds_t*)(&(x)->value))->mevents)
+#define sexp_pollfds_pid(x)      (((struct sexp_pollfds_t*)(&(x)->value))->pid)
+#define sexp_pollfds_events(x)   (((struct sexp_pollfds_t*)(&(x)->value))->events)
+
+#if SEXP_USE_EPOLL
+#define sexp_pollfds_pending(x)  (sexp_pollfds_num_fds(x) + sexp_pollfds_num_epfds(x))
+#else
+#define sexp_pollfds_pending(x)  sexp_pollfds_num_fds(x)
+#endif
 
 #define sexp_sizeof_pollfds (sexp_sizeof_header + sizeof(struct sexp_pollfds_t))
 
@@ -355,6 +380,13 @@ static sexp sexp_make_pollfds (sexp ctx) {
   sexp_pollfds_fds(res) = (struct pollfd*)malloc(SEXP_INIT_POLLFDS_MAX_FDS * sizeof(struct pollfd));
   sexp_pollfds_num_fds(res) = 0;
   sexp_pollfds_max_fds(res) = SEXP_INIT_POLLFDS_MAX_FDS;
+#if SEXP_USE_EPOLL
+  sexp_pollfds_epfd(res) = -1;
+  sexp_pollfds_num_epfds(res) = 0;
+  sexp_pollfds_max_events(res) = 0;
+  sexp_pollfds_pid(res) = 0;
+  sexp_pollfds_events(res) = NULL;
+#endif
   return res;
 }
 
@@ -365,17 +397,25 @@ sexp sexp_free_pollfds (sexp ctx, sexp self, sexp_sint_t n, sexp pollfds) {
     sexp_pollfds_num_fds(pollfds) = 0;
     sexp_pollfds_max_fds(pollfds) = 0;
   }
+#if SEXP_USE_EPOLL
+  if (sexp_pollfds_epfd(pollfds) >= 0) {
+    close(sexp_pollfds_epfd(pollfds));
+    sexp_pollfds_epfd(pollfds) = -1;
+  }
+  if (sexp_pollfds_events(pollfds)) {
+    free(sexp_pollfds_events(pollfds));
+    sexp_pollfds_events(pollfds) = NULL;
+    sexp_pollfds_max_events(pollfds) = 0;
+  }
+  sexp_pollfds_num_epfds(pollfds) = 0;
+#endif
   return SEXP_VOID;
 }
 
 /* return true if this fd was already being polled */
-static sexp sexp_insert_pollfd (sexp ctx, int fd, int events) {
+static sexp sexp_insert_poll_array (sexp pollfds, int fd, int events) {
   int i;
   struct pollfd *pfd;
-  sexp pollfds = sexp_global(ctx, SEXP_G_THREADS_POLL_FDS);
-  if (! (pollfds && sexp_pollfdsp(ctx, pollfds))) {
-    sexp_global(ctx, SEXP_G_THREADS_POLL_FDS) = pollfds = sexp_make_pollfds(ctx);
-  }
   for (i=0; i<sexp_pollfds_num_fds(pollfds); ++i) {
     if (sexp_pollfds_fds(pollfds)[i].fd == fd) {
       sexp_pollfds_fds(pollfds)[i].events |= events;
@@ -396,6 +436,107 @@ static sexp sexp_insert_pollfd (sexp ctx, int fd, int events) {
   return SEXP_FALSE;
 }
 
+#if SEXP_USE_EPOLL
+static int sexp_epoll_ctl (sexp pollfds, int op, int fd, int events) {
+  struct epoll_event ev;
+  ev.events = ((events & POLLIN) ? EPOLLIN : 0) | ((events & POLLOUT) ? EPOLLOUT : 0);
+  ev.data.fd = fd;
+  return epoll_ctl(sexp_pollfds_epfd(pollfds), op, fd, &ev);
+}
+
+/* an epoll instance is shared with any forked child, so the child */
+/* makes its own and re-registers the fds it inherited */
+static void sexp_epoll_reset (sexp pollfds) {
+  int fd;
+  if (sexp_pollfds_epfd(pollfds) >= 0)
+    close(sexp_pollfds_epfd(pollfds));
+  sexp_pollfds_epfd(pollfds) = epoll_create1(EPOLL_CLOEXEC);
+  sexp_pollfds_pid(pollfds) = getpid();
+  sexp_pollfds_num_epfds(pollfds) = 0;
+  for (fd=0; fd<sexp_pollfds_max_events(pollfds); fd++) {
+    if (sexp_pollfds_events(pollfds)[fd]) {
+      if (sexp_pollfds_epfd(pollfds) >= 0
+          && sexp_epoll_ctl(pollfds, EPOLL_CTL_ADD, fd, sexp_pollfds_events(pollfds)[fd]) == 0)
+        sexp_pollfds_num_epfds(pollfds)++;
+      else
+        sexp_insert_poll_array(pollfds, fd, sexp_pollfds_events(pollfds)[fd]);
+      if (sexp_pollfds_epfd(pollfds) < 0)
+        sexp_pollfds_events(pollfds)[fd] = 0;
+    }
+  }
+}
+
+/* return true if the fd is now registered with epoll */
+static int sexp_insert_epoll (sexp pollfds, int fd, int events) {
+  short *tmp;
+  int len;
+  if (sexp_pollfds_pid(pollfds) != getpid())
+    sexp_epoll_reset(pollfds);
+  if (sexp_pollfds_epfd(pollfds) < 0)
+    return 0;
+  if (fd >= sexp_pollfds_max_events(pollfds)) {
+    len = sexp_pollfds_max_events(pollfds) * 2;
+    if (len <= fd) len = fd + SEXP_EPOLL_MAX_EVENTS;
+    tmp = (short*)realloc(sexp_pollfds_events(pollfds), len * sizeof(short));
+    if (!tmp) return 0;
+    memset(tmp + sexp_pollfds_max_events(pollfds), 0,
+           (len - sexp_pollfds_max_events(pollfds)) * sizeof(short));
+    sexp_pollfds_events(pollfds) = tmp;
+    sexp_pollfds_max_events(pollfds) = len;
+  }
+  /* a successful add means any earlier registration was dropped */
+  /* by the kernel when its fd was closed */
+  if (sexp_epoll_ctl(pollfds, EPOLL_CTL_ADD, fd, events) == 0) {
+    if (! sexp_pollfds_events(pollfds)[fd])
+      sexp_pollfds_num_epfds(pollfds)++;
+    sexp_pollfds_events(pollfds)[fd] = events;
+    return 1;
+  } else if (errno == EEXIST) {
+    if (! sexp_pollfds_events(pollfds)[fd])
+      sexp_pollfds_num_epfds(pollfds)++;
+    sexp_pollfds_events(pollfds)[fd] |= events;
+    return sexp_epoll_ctl(pollfds, EPOLL_CTL_MOD, fd, sexp_pollfds_events(pollfds)[fd]) == 0;
+  }
+  return 0;                     /* e.g. EPERM for regular files */
+}
+#endif
+
+static void sexp_insert_pollfd (sexp ctx, int fd, int events) {
+  sexp pollfds = sexp_global(ctx, SEXP_G_THREADS_POLL_FDS);
+  if (! (pollfds && sexp_pollfdsp(ctx, pollfds))) {
+    sexp_global(ctx, SEXP_G_THREADS_POLL_FDS) = pollfds = sexp_make_pollfds(ctx);
+  }
+#if SEXP_USE_EPOLL
+  if (sexp_insert_epoll(pollfds, fd, events))
+    return;
+#endif
+  sexp_insert_poll_array(pollfds, fd, events);
+}
+
+/* SEXP_G_THREADS_FD_THREADS is a vector of the threads blocked on */
+/* each fd, so readiness wakes them without searching all threads */
+static void sexp_insert_fd_thread (sexp ctx, int fd, sexp thread) {
+  sexp_sint_t i, len;
+  sexp_gc_var2(vec, tmp);
+  sexp_gc_preserve2(ctx, vec, tmp);
+  vec = sexp_global(ctx, SEXP_G_THREADS_FD_THREADS);
+  len = sexp_vectorp(vec) ? sexp_vector_length(vec) : 0;
+  if (fd >= len) {
+    tmp = sexp_make_vector(ctx, sexp_make_fixnum(fd < len*2 ? len*2 : fd + SEXP_EPOLL_MAX_EVENTS), SEXP_NULL);
+    if (sexp_vectorp(tmp)) {
+      for (i=0; i<len; i++)
+        sexp_vector_data(tmp)[i] = sexp_vector_data(vec)[i];
+      sexp_global(ctx, SEXP_G_THREADS_FD_THREADS) = vec = tmp;
+    }
+  }
+  if (sexp_vectorp(vec) && fd < sexp_vector_length(vec)
+      && sexp_not(sexp_memq(ctx, thread, sexp_vector_ref(vec, sexp_make_fixnum(fd))))) {
+    tmp = sexp_cons(ctx, thread, sexp_vector_ref(vec, sexp_make_fixnum(fd)));
+    sexp_vector_set(vec, sexp_make_fixnum(fd), tmp);
+  }
+  sexp_gc_release2(ctx);
+}
+
 /* block the current thread on the specified port */
 sexp sexp_blocker (sexp ctx, sexp self, sexp_sint_t n, sexp portorfd, sexp timeout) {
   int fd;
@@ -408,8 +549,10 @@ sexp sexp_blocker (sexp ctx, sexp self, sexp_sint_t n, sexp portorfd, sexp timeo
     fd = sexp_unbox_fixnum(portorfd);
   else
     return sexp_type_exception(ctx, self, SEXP_IPORT, portorfd);
-  if (fd >= 0)
+  if (fd >= 0) {
     sexp_insert_pollfd(ctx, fd, sexp_oportp(portorfd) ? POLLOUT : POLLIN);
+    sexp_insert_fd_thread(ctx, fd, ctx);
+  }
   /* pause the current thread */
   sexp_context_waitp(ctx) = 1;
   sexp_context_event(ctx) = portorfd;
@@ -417,11 +560,117 @@ sexp sexp_blocker (sexp ctx, sexp self, sexp_sint_t n, sexp portorfd, sexp timeo
   return SEXP_VOID;
 }
 
-sexp sexp_scheduler (sexp ctx, sexp self, sexp_sint_t n, sexp root_thread) {
+static int sexp_event_fd (sexp evt) {
+  return sexp_portp(evt) ? sexp_port_fileno(evt)
+    : sexp_filenop(evt) ? sexp_fileno_fd(evt)
+    : sexp_fixnump(evt) ? sexp_unbox_fixnum(evt) : -1;
+}
+
+/* mark the threads still blocked on a ready fd as woken (with an */
+/* event of #t), returning them consed onto the woken list */
+static sexp sexp_wake_fd (sexp ctx, int fd, sexp woken) {
+  sexp ls, res, vec = sexp_global(ctx, SEXP_G_THREADS_FD_THREADS);
+  if (!sexp_vectorp(vec) || fd < 0 || fd >= sexp_vector_length(vec))
+    return woken;
+  ls = res = sexp_vector_ref(vec, sexp_make_fixnum(fd));
+  if (!sexp_pairp(ls))
+    return woken;
+  sexp_vector_set(vec, sexp_make_fixnum(fd), SEXP_NULL);
+  for ( ; ; ls = sexp_cdr(ls)) {
+    /* TODO: distinguish input and output on the same fd? */
+    if (sexp_context_waitp(sexp_car(ls))
+        && sexp_event_fd(sexp_context_event(sexp_car(ls))) == fd) {
+      sexp_context_waitp(sexp_car(ls)) = 0;
+      sexp_context_timeoutp(sexp_car(ls)) = 0;
+      sexp_context_event(sexp_car(ls)) = SEXP_TRUE;
+    }
+    if (!sexp_pairp(sexp_cdr(ls))) break;
+  }
+  sexp_cdr(ls) = woken;
+  return res;
+}
+
+/* wait up to timeout ms (or indefinitely if negative) for any of the */
+/* blocked fds to be ready, and move the threads blocked on them from */
+/* the paused list to the back of the run queue */
+static void sexp_wait_pollfds (sexp ctx, sexp pollfds, int timeout) {
   int i, k;
-  struct timeval tval;
   struct pollfd *pfds;
-  suseconds_t usecs = 0;
+  sexp ls1, ls2, tmp, woken = SEXP_NULL;
+#if SEXP_USE_EPOLL
+  struct epoll_event evs[SEXP_EPOLL_MAX_EVENTS];
+  if (sexp_pollfds_pid(pollfds) && sexp_pollfds_pid(pollfds) != getpid())
+    sexp_epoll_reset(pollfds);
+#endif
+  if (sexp_pollfds_num_fds(pollfds) > 0) {
+    pfds = sexp_pollfds_fds(pollfds);
+#if SEXP_USE_EPOLL
+    /* don't sleep long on the array while epoll fds may be ready */
+    if (sexp_pollfds_num_epfds(pollfds) > 0 && (timeout < 0 || timeout > 10))
+      timeout = 10;
+#endif
+    k = poll(pfds, sexp_pollfds_num_fds(pollfds), timeout);
+    for (i=sexp_pollfds_num_fds(pollfds)-1; i>=0 && k>0; --i) {
+      if (pfds[i].revents > 0) {
+        k--;
+        woken = sexp_wake_fd(ctx, pfds[i].fd, woken);
+        if (i < (sexp_pollfds_num_fds(pollfds) - 1)) {
+          pfds[i] = pfds[sexp_pollfds_num_fds(pollfds) - 1];
+        }
+        sexp_pollfds_num_fds(pollfds) -= 1;
+      }
+    }
+    timeout = 0;
+  }
+#if SEXP_USE_EPOLL
+  if (sexp_pollfds_num_epfds(pollfds) > 0) {
+    k = epoll_wait(sexp_pollfds_epfd(pollfds), evs, SEXP_EPOLL_MAX_EVENTS, timeout);
+    for (i=0; i<k; i++) {
+      sexp_epoll_ctl(pollfds, EPOLL_CTL_DEL, evs[i].data.fd, 0);
+      if (evs[i].data.fd < sexp_pollfds_max_events(pollfds)
+          && sexp_pollfds_events(pollfds)[evs[i].data.fd]) {
+        sexp_pollfds_events(pollfds)[evs[i].data.fd] = 0;
+        sexp_pollfds_num_epfds(pollfds)--;
+      }
+      woken = sexp_wake_fd(ctx, evs[i].data.fd, woken);
+    }
+  }
+#endif
+  if (!sexp_pairp(woken))
+    return;
+  /* move the woken threads to the run queue */
+  for (ls1=SEXP_NULL, ls2=sexp_global(ctx, SEXP_G_THREADS_PAUSED); sexp_pairp(ls2); ) {
+    if (sexp_context_event(sexp_car(ls2)) == SEXP_TRUE) {
+      sexp_context_event(sexp_car(ls2)) = SEXP_FALSE;
+      if (ls1==SEXP_NULL)
+        sexp_global(ctx, SEXP_G_THREADS_PAUSED) = sexp_cdr(ls2);
+      else
+        sexp_cdr(ls1) = sexp_cdr(ls2);
+      tmp = sexp_cdr(ls2);
+      sexp_cdr(ls2) = SEXP_NULL;
+      if (sexp_car(ls2) != ctx) {
+        if (! sexp_pairp(sexp_global(ctx, SEXP_G_THREADS_BACK))) {
+          sexp_global(ctx, SEXP_G_THREADS_FRONT) = ls2;
+        } else {
+          sexp_cdr(sexp_global(ctx, SEXP_G_THREADS_BACK)) = ls2;
+        }
+        sexp_global(ctx, SEXP_G_THREADS_BACK) = ls2;
+      }
+      ls2 = tmp;
+    } else {
+      ls1 = ls2;
+      ls2 = sexp_cdr(ls2);
+    }
+  }
+  /* woken threads which weren't paused (e.g. the current thread) */
+  for ( ; sexp_pairp(woken); woken = sexp_cdr(woken))
+    if (sexp_context_event(sexp_car(woken)) == SEXP_TRUE)
+      sexp_context_event(sexp_car(woken)) = SEXP_FALSE;
+}
+
+sexp sexp_scheduler (sexp ctx, sexp self, sexp_sint_t n, sexp root_thread) {
+  struct timeval tval, deadline;
+  sexp_sint_t usecs = 0;
   sexp res, ls1, ls2, evt, runner, paused, front, pollfds;
   sexp_gc_var1(tmp);
   sexp_gc_preserve1(ctx, tmp);
@@ -451,55 +700,10 @@ sexp sexp_scheduler (sexp ctx, sexp self, sexp_sint_t n, sexp root_thread) {
 
   /* check blocked fds */
   pollfds = sexp_global(ctx, SEXP_G_THREADS_POLL_FDS);
-  if (sexp_pollfdsp(ctx, pollfds) && sexp_pollfds_num_fds(pollfds) > 0) {
-    pfds = sexp_pollfds_fds(pollfds);
-    k = poll(sexp_pollfds_fds(pollfds), sexp_pollfds_num_fds(pollfds), 0);
-    for (i=sexp_pollfds_num_fds(pollfds)-1; i>=0 && k>0; --i) {
-      if (pfds[i].revents > 0) { /* free all threads blocked on this fd */
-        k--;
-        /* maybe unblock the current thread */
-        evt = sexp_context_event(ctx);
-        if ((sexp_portp(evt) && (sexp_port_fileno(evt) == pfds[i].fd))
-            || (sexp_fixnump(evt) && (sexp_unbox_fixnum(evt) == pfds[i].fd))) {
-          sexp_context_waitp(ctx) = 0;
-          sexp_context_timeoutp(ctx) = 0;
-          sexp_context_event(ctx) = SEXP_FALSE;
-        }
-        /* maybe unblock paused threads */
-        for (ls1=SEXP_NULL, ls2=paused; sexp_pairp(ls2); ) {
-          /* TODO: distinguish input and output on the same fd? */
-          evt = sexp_context_event(sexp_car(ls2));
-          if ((sexp_portp(evt) && sexp_port_fileno(evt) == pfds[i].fd)
-              || (sexp_fixnump(evt) && sexp_unbox_fixnum(evt) == pfds[i].fd)) {
-            sexp_context_waitp(sexp_car(ls2)) = 0;
-            sexp_context_timeoutp(sexp_car(ls2)) = 0;
-            sexp_context_event(sexp_car(ls2)) = SEXP_FALSE;
-            if (ls1==SEXP_NULL)
-              sexp_global(ctx, SEXP_G_THREADS_PAUSED) = paused = sexp_cdr(ls2);
-            else
-              sexp_cdr(ls1) = sexp_cdr(ls2);
-            tmp = sexp_cdr(ls2);
-            sexp_cdr(ls2) = SEXP_NULL;
-            if (sexp_car(ls2) != ctx) {
-              if (! sexp_pairp(sexp_global(ctx, SEXP_G_THREADS_BACK))) {
-                sexp_global(ctx, SEXP_G_THREADS_FRONT) = front = ls2;
-              } else {
-                sexp_cdr(sexp_global(ctx, SEXP_G_THREADS_BACK)) = ls2;
-              }
-              sexp_global(ctx, SEXP_G_THREADS_BACK) = ls2;
-            }
-            ls2 = tmp;
-          } else {
-            ls1 = ls2;
-            ls2 = sexp_cdr(ls2);
-          }
-        }
-        if (i < (sexp_pollfds_num_fds(pollfds) - 1)) {
-          pfds[i] = pfds[sexp_pollfds_num_fds(pollfds) - 1];
-        }
-        sexp_pollfds_num_fds(pollfds) -= 1;
-      }
-    }
+  if (sexp_pollfdsp(ctx, pollfds) && sexp_pollfds_pending(pollfds) > 0) {
+    sexp_wait_pollfds(ctx, pollfds, 0);
+    front  = sexp_global(ctx, SEXP_G_THREADS_FRONT);
+    paused = sexp_global(ctx, SEXP_G_THREADS_PAUSED);
   }
 
   /* if we've terminated, check threads joining us */
@@ -592,8 +796,6 @@ sexp sexp_scheduler (sexp ctx, sexp self, sexp_sint_t n, sexp root_thread) {
 
   if (sexp_context_waitp(res)) {
     /* the only thread available was waiting */
-    /* TODO: if another thread is blocked on I/O, wait on that with
-     * the appropriate minimum timeout */
     if (sexp_pairp(paused)
         && sexp_context_before(sexp_car(paused), sexp_context_timeval(res))) {
       tmp = res;
@@ -605,28 +807,44 @@ sexp sexp_scheduler (sexp ctx, sexp self, sexp_sint_t n, sexp root_thread) {
       sexp_delete_list(ctx, SEXP_G_THREADS_PAUSED, res);
     }
     paused = sexp_global(ctx, SEXP_G_THREADS_PAUSED);
-    usecs = 0;
-    if ((sexp_context_timeval(res).tv_sec == 0)
-        && (sexp_context_timeval(res).tv_usec == 0)) {
-      /* no timeout, wait for default 10ms */
-      usecs = 10*1000;
-    } else {
-      /* wait until the next timeout, or at most 10ms */
+    /* the next deadline is res's, or else the first timed paused thread's */
+    deadline = sexp_context_timeval(res);
+    if (deadline.tv_sec == 0 && deadline.tv_usec == 0 && sexp_pairp(paused))
+      deadline = sexp_context_timeval(sexp_car(paused));
+    usecs = -1;
+    if (deadline.tv_sec != 0 || deadline.tv_usec != 0) {
+      usecs = 0;
       gettimeofday(&tval, NULL);
-      if (tval.tv_sec <= sexp_context_timeval(res).tv_sec) {
-        usecs = (sexp_context_timeval(res).tv_sec - tval.tv_sec) * 1000000;
-        if (tval.tv_usec < sexp_context_timeval(res).tv_usec || usecs > 0)
-          usecs += sexp_context_timeval(res).tv_usec - tval.tv_usec;
+      if (tval.tv_sec <= deadline.tv_sec) {
+        usecs = (deadline.tv_sec - tval.tv_sec) * 1000000;
+        if (tval.tv_usec < deadline.tv_usec || usecs > 0)
+          usecs += deadline.tv_usec - tval.tv_usec;
       }
-      if (usecs > 10*1000) {
+    }
+    if (sexp_pollfdsp(ctx, pollfds) && sexp_pollfds_pending(pollfds) > 0) {
+      /* block on the fds until one is ready or the next deadline */
+      if (usecs > (sexp_sint_t)SEXP_MAX_POLL_WAIT*1000) usecs = SEXP_MAX_POLL_WAIT*1000;
+      sexp_wait_pollfds(ctx, pollfds, usecs < 0 ? -1 : (int)((usecs + 999) / 1000));
+      if (sexp_context_waitp(res) && gettimeofday(&tval, NULL) == 0
+          && sexp_context_before(res, tval)) {
+        sexp_context_waitp(res) = 0;
+        sexp_context_timeoutp(res) = 1;
+      }
+    } else {
+      if (sexp_context_timeval(res).tv_sec == 0
+          && sexp_context_timeval(res).tv_usec == 0) {
+        /* no timeout, wait for default 10ms */
+        usecs = 10*1000;
+      } else if (usecs > 10*1000) {
+        /* wait until the next timeout, or at most 10ms */
         usecs = 10*1000;
       } else {
         sexp_context_waitp(res) = 0;
         sexp_context_timeoutp(res) = 1;
       }
+      /* take a nap to avoid busy looping */
+      usleep(usecs);
     }
-    /* take a nap to avoid busy looping */
-    usleep(usecs);
   }
 
   sexp_gc_release1(ctx);
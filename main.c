@@ -55,8 +55,20 @@ void sexp_usage(int err) {
          "  -R[<module>] - run main from a module\n"
          "  -t <module.proc> - trace a procedure\n"
          "  -T           - disable TCO (dangerous)\n"
+#if SEXP_USE_LAZY_LOAD
+         "  -L           - compile procedures and load libraries lazily\n"
+#endif
+#if SEXP_USE_PROFILE_LOAD
+         "  -P[<file>]   - profile loading, reporting to <file> at exit\n"
+#endif
+#if SEXP_USE_FASL
+         "  -c           - load and write precompiled .fasl files for sources\n"
+#endif
+#if SEXP_USE_ZYGOTE
+         "  -Z <socket>  - serve forked copies of this process on <socket>\n"
+#endif
 #if SEXP_USE_IMAGE_LOADING
-         "  -d <file>    - dump an image file and exit\n"
+         "  -d <file>    - dump an image file (or C source for <file>.c) and exit\n"
          "  -i <file>    - load an image file\n"
 #endif
          );
@@ -243,24 +255,29 @@ static sexp sexp_add_import_binding (sexp ctx, sexp env) {
   return env;
 }
 
-static sexp sexp_load_standard_repl_env (sexp ctx, sexp env, sexp k, int bootp, int nonblocking) {
+/* build the interaction env on top of the standard env e */
+static sexp sexp_load_repl_env (sexp ctx, sexp env, int bootp, int nonblocking) {
   sexp_gc_var1(e);
   sexp_gc_preserve1(ctx, e);
-  e = sexp_load_standard_env(ctx, env, k);
-  if (!sexp_exceptionp(e)) {
+  e = env;
 #if SEXP_USE_MODULES
-    if (!bootp)
-      e = sexp_eval_string(ctx, sexp_default_environment, -1, sexp_global(ctx, SEXP_G_META_ENV));
-    if (!sexp_exceptionp(e))
-      sexp_add_import_binding(ctx, e);
+  if (!bootp)
+    e = sexp_eval_string(ctx, sexp_default_environment, -1, sexp_global(ctx, SEXP_G_META_ENV));
+  if (!sexp_exceptionp(e))
+    sexp_add_import_binding(ctx, e);
 #endif
-    if (!sexp_exceptionp(e))
-      e = sexp_load_standard_params(ctx, e, nonblocking);
-  }
+  if (!sexp_exceptionp(e))
+    e = sexp_load_standard_params(ctx, e, nonblocking);
   sexp_gc_release1(ctx);
   return e;
 }
 
+#if ! SEXP_USE_STATIC_IMAGE
+static sexp sexp_load_standard_repl_env (sexp ctx, sexp env, sexp k, int bootp, int nonblocking) {
+  sexp e = sexp_load_standard_env(ctx, env, k);
+  return sexp_exceptionp(e) ? e : sexp_load_repl_env(ctx, e, bootp, nonblocking);
+}
+
 static void do_init_context (sexp* ctx, sexp* env, sexp_uint_t heap_size,
                              sexp_uint_t heap_max_size, sexp_sint_t fold_case) {
   *ctx = sexp_make_eval_context(NULL, NULL, NULL, heap_size, heap_max_size);
@@ -273,14 +290,59 @@ static void do_init_context (sexp* ctx, sexp* env, sexp_uint_t heap_size,
 #endif
   *env = sexp_context_env(*ctx);
 }
+#endif
 
 #define handle_noarg() if (argv[i][2] != '\0') { \
     fprintf(stderr, "option %c doesn't take any argument but got: %s\n", argv[i][1], argv[i]); \
     exit_failure();                                                     \
   }
 
+#if SEXP_USE_PROFILE_LOAD
+#define start_load_profile() if (load_profile && *load_profile) sexp_load_profile_start(ctx, load_profile)
+#else
+#define start_load_profile()
+#endif
+
+#if SEXP_USE_STATIC_IMAGE
+/* boot from the image linked into the executable, which already has */
+/* the standard environment loaded */
+static void do_init_static_image (sexp* ctx, sexp* env, sexp_uint_t heap_size,
+                                  sexp_uint_t heap_max_size, sexp_sint_t fold_case) {
+  *ctx = sexp_load_image_from_memory(sexp_static_image, sexp_static_image_size,
+                                     heap_size, heap_max_size);
+  if (! *ctx || ! sexp_contextp(*ctx)) {
+    fprintf(stderr, "chibi-scheme: couldn't load static image: %s\n",
+            sexp_load_image_err());
+    exit_failure();
+  }
+#if SEXP_USE_FOLD_CASE_SYMS
+  sexp_global(*ctx, SEXP_G_FOLD_CASE_P) = sexp_make_boolean(fold_case);
+#endif
+  /* the image may have been dumped from a repl env, start over from */
+  /* the standard env under the meta env */
+  *env = sexp_context_env(*ctx);
+#if SEXP_USE_MODULES
+  if (sexp_envp(sexp_global(*ctx, SEXP_G_META_ENV)))
+    *env = sexp_env_parent(sexp_global(*ctx, SEXP_G_META_ENV));
+#endif
+  sexp_context_env(*ctx) = *env;
+  sexp_init_module_path(*ctx);
+}
+
+#define init_context() if (! ctx) do {                                  \
+      do_init_static_image(&ctx, &env, heap_size, heap_max_size, fold_case); \
+      start_load_profile();                                             \
+      sexp_gc_preserve4(ctx, tmp, sym, args, env);                      \
+    } while (0)
+
+#define load_init(bootp) if (! init_loaded++) do {                      \
+      init_context();                                                   \
+      check_exception(ctx, env=sexp_load_repl_env(ctx, env, bootp, nonblocking)); \
+    } while (0)
+#else
 #define init_context() if (! ctx) do {                                  \
       do_init_context(&ctx, &env, heap_size, heap_max_size, fold_case); \
+      start_load_profile();                                             \
       sexp_gc_preserve4(ctx, tmp, sym, args, env);                      \
     } while (0)
 
@@ -288,6 +350,327 @@ static void do_init_context (sexp* ctx, sexp* env, sexp_uint_t heap_size,
       init_context();                                                   \
       check_exception(ctx, env=sexp_load_standard_repl_env(ctx, env, SEXP_SEVEN, bootp, nonblocking)); \
     } while (0)
+#endif
+
+#if SEXP_USE_ZYGOTE
+#include <signal.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+/* Fork-server mode.  The server (-Z <socket>) loads everything up to */
+/* the -Z option, then forks a worker per connection which inherits  */
+/* the warm heap and continues with the client's command line.  The  */
+/* client (any chibi-scheme run with CHIBI_ZYGOTE set) sends its      */
+/* argv, environment, cwd and stdio fds, and waits for the worker's   */
+/* exit status, forwarding signals to it in the meantime.  Commands   */
+/* which a worker couldn't run as a fresh process would, because of   */
+/* startup options or environment, are run normally instead.          */
+/*                                                                    */
+/* request:  unsigned hdr[3] = {len, argc, envc} + SCM_RIGHTS 0,1,2,  */
+/*           then len bytes of NUL-terminated cwd, argv, environ      */
+/* response: pid_t pid from the worker, 0 if it declines the request, */
+/*           then int exit status from the server                     */
+
+extern char **environ;
+
+static int zygote_write_all (int fd, const void *buf, size_t len) {
+  ssize_t n;
+  while (len > 0) {
+    if ((n = write(fd, buf, len)) < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return 0;
+    buf = (const char*)buf + n;
+    len -= n;
+  }
+  return 1;
+}
+
+static int zygote_read_all (int fd, void *buf, size_t len) {
+  ssize_t n;
+  while (len > 0) {
+    if ((n = read(fd, buf, len)) < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return 0;
+    buf = (char*)buf + n;
+    len -= n;
+  }
+  return 1;
+}
+
+static int zygote_socket (const char *path, struct sockaddr_un *addr) {
+  if (strlen(path) >= sizeof(addr->sun_path)) return -1;
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  strcpy(addr->sun_path, path);
+  return socket(AF_UNIX, SOCK_STREAM, 0);
+}
+
+/* variables read when the context is created */
+static const char* zygote_startup_vars[] = {
+  SEXP_MODULE_PATH_VAR, SEXP_NO_SYSTEM_PATH_VAR, SEXP_FASL_DIRECTORY_VAR,
+  SEXP_LOAD_PROFILE_VAR, NULL
+};
+
+/* true iff argv has only options which a worker handles as a fresh */
+/* process would, i.e. none which apply to the startup of the server */
+static int zygote_args_ok (int argc, char **argv) {
+  const char *name = strrchr(argv[0], '/');
+  int i;
+  if (strncmp(name ? name + 1 : argv[0], "scheme-r7rs", strlen("scheme-r7rs")) == 0)
+    return 0;
+  for (i=1; i < argc && argv[i][0] == '-'; i++) {
+    switch (argv[i][1]) {
+    case 'e': case 'p': case 'l': case 'm': case 't':
+      if (argv[i][2] == '\0') i++;
+      break;
+    case 'R':
+      if (argv[i][2] == '\0' && i+1 < argc && argv[i+1][0] != '-') i++;
+      break;
+    case 'r':
+      break;
+    case '-':
+      return argv[i][2] == '\0';
+    default:
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static pid_t zygote_worker = 0;
+
+/* the worker leads its own process group, as a job would */
+static void zygote_forward_signal (int sig) {
+  if (zygote_worker > 0) kill(-zygote_worker, sig);
+}
+
+/* returns only if no server is listening on path */
+static void zygote_client (const char *path, int argc, char **argv) {
+  struct sockaddr_un addr;
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  char cbuf[CMSG_SPACE(3*sizeof(int))], cwd[4096], *buf, *p;
+  unsigned int hdr[3];
+  int fd, i, status, fds[3] = {0, 1, 2};
+  pid_t pid;
+  size_t len;
+  if (! zygote_args_ok(argc, argv) || (fd = zygote_socket(path, &addr)) < 0)
+    return;
+  if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0
+      || ! getcwd(cwd, sizeof(cwd))) {
+    close(fd);
+    return;
+  }
+  len = strlen(cwd) + 1;
+  for (i=0; i<argc; i++) len += strlen(argv[i]) + 1;
+  for (hdr[2]=0; environ[hdr[2]]; hdr[2]++) len += strlen(environ[hdr[2]]) + 1;
+  if (! (buf = p = (char*) malloc(len))) {
+    close(fd);
+    return;
+  }
+  p += sprintf(p, "%s", cwd) + 1;
+  for (i=0; i<argc; i++) p += sprintf(p, "%s", argv[i]) + 1;
+  for (i=0; environ[i]; i++) p += sprintf(p, "%s", environ[i]) + 1;
+  hdr[0] = len;
+  hdr[1] = argc;
+  memset(&msg, 0, sizeof(msg));
+  iov.iov_base = hdr;
+  iov.iov_len = sizeof(hdr);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cbuf;
+  msg.msg_controllen = sizeof(cbuf);
+  cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+  /* once the request is sent the server owns it, unless it declines */
+  if (sendmsg(fd, &msg, 0) != sizeof(hdr) || ! zygote_write_all(fd, buf, len)
+      || ! zygote_read_all(fd, &pid, sizeof(pid)))
+    exit_failure();
+  free(buf);
+  if (pid == 0) {
+    close(fd);
+    return;
+  }
+  zygote_worker = pid;
+  signal(SIGINT, zygote_forward_signal);
+  signal(SIGTERM, zygote_forward_signal);
+  signal(SIGHUP, zygote_forward_signal);
+  signal(SIGQUIT, zygote_forward_signal);
+  if (! zygote_read_all(fd, &status, sizeof(status)))
+    exit_failure();
+  exit(status);
+}
+
+/* the client's value of var, from its NULL-terminated environ */
+static const char *zygote_getenv (char **env, const char *var) {
+  size_t len = strlen(var);
+  for ( ; *env; env++)
+    if (strncmp(*env, var, len) == 0 && (*env)[len] == '=')
+      return *env + len + 1;
+  return NULL;
+}
+
+static int zygote_env_ok (char **env) {
+  const char **var, *mine, *theirs;
+  for (var=zygote_startup_vars; *var; var++) {
+    mine = getenv(*var);
+    theirs = zygote_getenv(env, *var);
+    if (mine ? ! theirs || strcmp(mine, theirs) : theirs != NULL)
+      return 0;
+  }
+  return 1;
+}
+
+/* in the worker: adopt the client's fds, cwd and environment, and */
+/* return its command line */
+static char **zygote_receive (int conn, int *argcp) {
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  char cbuf[CMSG_SPACE(3*sizeof(int))], *buf, *p, **argv;
+  unsigned int hdr[3], i;
+  int fds[3];
+  pid_t pid;
+  memset(&msg, 0, sizeof(msg));
+  iov.iov_base = hdr;
+  iov.iov_len = sizeof(hdr);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cbuf;
+  msg.msg_controllen = sizeof(cbuf);
+  if (recvmsg(conn, &msg, 0) != sizeof(hdr)
+      || ! (cmsg = CMSG_FIRSTHDR(&msg)) || cmsg->cmsg_type != SCM_RIGHTS
+      || cmsg->cmsg_len != CMSG_LEN(sizeof(fds))
+      || ! (buf = (char*) malloc(hdr[0] + 1))
+      || ! (argv = (char**) calloc(hdr[1] + hdr[2] + 2, sizeof(char*)))
+      || ! zygote_read_all(conn, buf, hdr[0]))
+    _exit(70);
+  buf[hdr[0]] = '\0';
+  memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+  p = buf + strlen(buf) + 1;
+  for (i=0; i<hdr[1]+hdr[2]; i++, p += strlen(p) + 1)
+    argv[i + (i >= hdr[1])] = p;
+  /* the context was built from our environment, not the client's */
+  pid = zygote_env_ok(argv + hdr[1] + 1) ? getpid() : 0;
+  if (! zygote_write_all(conn, &pid, sizeof(pid)) || pid == 0)
+    _exit(0);
+  close(conn);
+  for (i=0; i<3; i++) {
+    dup2(fds[i], i);
+    if (fds[i] > 2) close(fds[i]);
+  }
+  if (chdir(buf) != 0)
+    perror("chibi-scheme: couldn't change to client directory");
+  environ = argv + hdr[1] + 1;
+  *argcp = hdr[1];
+  return argv;
+}
+
+static int zygote_sigchld_pipe[2];
+
+static void zygote_sigchld (int sig) {
+  int err = errno;
+  if (write(zygote_sigchld_pipe[1], "", 1) < 0) {}
+  errno = err;
+}
+
+/* never returns in the server, returns the request's command line */
+/* in each forked worker */
+static char **zygote_serve (sexp ctx, const char *path, int *argcp) {
+  struct sockaddr_un addr;
+  struct pollfd pfd[2];
+  struct { pid_t pid; int fd; } *workers = NULL, *tmp;
+  size_t num_workers = 0, max_workers = 0, k;
+  mode_t mask;
+  pid_t pid;
+  int listener, conn, status;
+  char c;
+  if ((listener = zygote_socket(path, &addr)) < 0) {
+    fprintf(stderr, "chibi-scheme: invalid socket path: %s\n", path);
+    exit_failure();
+  }
+  unlink(path);
+  mask = umask(077);   /* only our user may run code in the server */
+  if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) < 0
+      || listen(listener, 64) < 0 || pipe(zygote_sigchld_pipe) < 0) {
+    perror("chibi-scheme: couldn't listen");
+    exit_failure();
+  }
+  umask(mask);
+  fcntl(zygote_sigchld_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(zygote_sigchld_pipe[1], F_SETFL, O_NONBLOCK);
+  signal(SIGCHLD, zygote_sigchld);
+  signal(SIGPIPE, SIG_IGN);   /* clients which fell back have hung up */
+#if ! SEXP_USE_BOEHM
+  /* start each worker with as much free heap as possible, since */
+  /* collecting writes mark bits into the pages it shares with us */
+  sexp_gc(ctx, NULL);
+#endif
+  fflush(stdout);
+  fflush(stderr);
+  pfd[0].fd = listener;
+  pfd[1].fd = zygote_sigchld_pipe[0];
+  pfd[0].events = pfd[1].events = POLLIN;
+  for (;;) {
+    if (poll(pfd, 2, -1) < 0)
+      continue;
+    if (pfd[1].revents) {
+      while (read(zygote_sigchld_pipe[0], &c, 1) > 0)
+        ;
+      while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        for (k=0; k<num_workers && workers[k].pid != pid; k++)
+          ;
+        if (k == num_workers) continue;
+        status = WIFEXITED(status) ? WEXITSTATUS(status)
+          : WIFSIGNALED(status) ? 128 + WTERMSIG(status) : 70;
+        zygote_write_all(workers[k].fd, &status, sizeof(status));
+        close(workers[k].fd);
+        workers[k] = workers[--num_workers];
+      }
+    }
+    if (! (pfd[0].revents & POLLIN) || (conn = accept(listener, NULL, NULL)) < 0)
+      continue;
+    if (num_workers == max_workers) {
+      tmp = realloc(workers, (max_workers*2 + 8) * sizeof(*workers));
+      if (! tmp) {
+        close(conn);
+        continue;
+      }
+      workers = tmp;
+      max_workers = max_workers*2 + 8;
+    }
+    if ((pid = fork()) == 0) {
+      /* as for a fresh process, whatever the server's dispositions */
+      signal(SIGCHLD, SIG_DFL);
+      signal(SIGINT, SIG_DFL);
+      signal(SIGTERM, SIG_DFL);
+      signal(SIGHUP, SIG_DFL);
+      signal(SIGQUIT, SIG_DFL);
+      signal(SIGPIPE, SIG_DFL);
+      /* detach from the server's terminal, the client forwards signals */
+      setsid();
+      close(listener);
+      close(zygote_sigchld_pipe[0]);
+      close(zygote_sigchld_pipe[1]);
+      for (k=0; k<num_workers; k++)
+        close(workers[k].fd);
+      free(workers);
+      return zygote_receive(conn, argcp);
+    } else if (pid < 0) {
+      close(conn);
+    } else {
+      workers[num_workers].pid = pid;
+      workers[num_workers++].fd = conn;
+    }
+  }
+}
+#endif
 
 /* static globals for the sake of resuming from within emscripten */
 #ifdef EMSCRIPTEN
@@ -301,8 +684,14 @@ sexp run_main (int argc, char **argv) {
 #endif
   char *arg;
   const char *prefix=NULL, *suffix=NULL, *main_symbol=NULL, *main_module=NULL;
+#if SEXP_USE_PROFILE_LOAD
+  const char *load_profile=getenv(SEXP_LOAD_PROFILE_VAR);
+#endif
   sexp_sint_t i, j, c, quit=0, print=0, init_loaded=0, mods_loaded=0,
     fold_case=SEXP_DEFAULT_FOLD_CASE_SYMS, nonblocking=0;
+#if SEXP_USE_ZYGOTE
+  int zygote_argc;
+#endif
   sexp_uint_t heap_size=0, heap_max_size=SEXP_MAXIMUM_HEAP_SIZE;
   sexp out=SEXP_FALSE, ctx=NULL, ls;
   sexp_gc_var4(tmp, sym, args, env);
@@ -397,8 +786,13 @@ sexp run_main (int argc, char **argv) {
     case 'Q':
       init_context();
       mods_loaded = 1;
-      if (! init_loaded++)
+      if (! init_loaded++) {
+#if SEXP_USE_STATIC_IMAGE
+        /* the image only has the standard env, make a primitive one */
+        sexp_context_env(ctx) = env = sexp_make_primitive_env(ctx, SEXP_SEVEN);
+#endif
         sexp_load_standard_ports(ctx, env, stdin, stdout, stderr, 0);
+      }
       handle_noarg();
       break;
     case 'q':
@@ -455,6 +849,7 @@ sexp run_main (int argc, char **argv) {
         ctx = NULL;
       } else {
         env = sexp_load_standard_params(ctx, sexp_context_env(ctx), nonblocking);
+        start_load_profile();
         init_loaded++;
       }
 #endif
@@ -462,7 +857,9 @@ sexp run_main (int argc, char **argv) {
     case 'd':
       if (! init_loaded++) {
         init_context();
+#if ! SEXP_USE_STATIC_IMAGE
         env = sexp_load_standard_env(ctx, env, SEXP_SEVEN);
+#endif
       }
       arg = ((argv[i][2] == '\0') ? argv[++i] : argv[i]+2);
 #if SEXP_USE_IMAGE_LOADING
@@ -509,6 +906,37 @@ sexp run_main (int argc, char **argv) {
       init_context(); sexp_global(ctx, SEXP_G_NO_TAIL_CALLS_P) = SEXP_TRUE;
       handle_noarg();
       break;
+#if SEXP_USE_PROFILE_LOAD
+    case 'P':
+      load_profile = argv[i][2] == '\0' ? "-" : argv[i]+2;
+      if (ctx) start_load_profile();
+      break;
+#endif
+#if SEXP_USE_LAZY_LOAD
+    case 'L':
+      init_context(); sexp_global(ctx, SEXP_G_LAZY_LOAD_P) = SEXP_TRUE;
+      handle_noarg();
+      break;
+#endif
+#if SEXP_USE_FASL
+    case 'c':
+      init_context(); sexp_global(ctx, SEXP_G_FASL_P) = SEXP_TRUE;
+      handle_noarg();
+      break;
+#endif
+#if SEXP_USE_ZYGOTE
+    case 'Z':
+      arg = ((argv[i][2] == '\0') ? argv[++i] : argv[i]+2);
+      check_nonull_arg('Z', arg);
+      load_init(0);
+      /* workers continue here with the client's command line */
+      argv = zygote_serve(ctx, arg, &zygote_argc);
+      argc = zygote_argc;
+      i = 0;
+      quit = mods_loaded = 0;
+      main_symbol = main_module = NULL;
+      break;
+#endif
     case 't':
       mods_loaded = 1;
       load_init(1);
@@ -653,6 +1081,11 @@ void sexp_resume() {
 #endif
 
 int main (int argc, char **argv) {
+#if SEXP_USE_ZYGOTE
+  const char *zygote = getenv(SEXP_ZYGOTE_VAR);
+  if (zygote && *zygote)
+    zygote_client(zygote, argc, argv);
+#endif
 #if SEXP_USE_PRINT_BACKTRACE_ON_SEGFAULT
   signal(SIGSEGV, sexp_segfault_handler); 
 #endif
@@ -159,6 +159,9 @@ _OP(SEXP_OPC_IO, SEXP_OP_PEEK_CHAR, 0, 3, _I(SEXP_CHAR), _I(SEXP_IPORT), SEXP_FA
 _FN1OPTP(_I(SEXP_BOOLEAN), _I(SEXP_IPORT), "char-ready?", (sexp)"current-input-port", sexp_char_ready_p),
 _FN1OPTP(_I(SEXP_OBJECT), _I(SEXP_IPORT), "read", (sexp)"current-input-port", sexp_read_op),
 _FN2OPTP(SEXP_VOID,_I(SEXP_OBJECT), _I(SEXP_OPORT), "write", (sexp)"current-output-port", sexp_write_op),
+#if SEXP_USE_NATIVE_WRITE_SHARED
+_FN3(_I(SEXP_BOOLEAN), _I(SEXP_OBJECT), _I(SEXP_OPORT), _I(SEXP_BOOLEAN), "%write-shared", 0, sexp_write_shared_op),
+#endif
 _FN1OPTP(SEXP_VOID, _I(SEXP_OPORT), "flush-output", (sexp)"current-output-port", sexp_flush_output_op),
 _FN2(_I(SEXP_BOOLEAN), _I(SEXP_OBJECT), _I(SEXP_OBJECT), "equal?", 0, sexp_equalp_op),
 _FN4(_I(SEXP_BOOLEAN), _I(SEXP_OBJECT), _I(SEXP_OBJECT), _I(SEXP_OBJECT), "equal?/bounded", 0, sexp_equalp_bound),
@@ -171,10 +174,10 @@ _FN1(SEXP_NULL, SEXP_NULL, "reverse", 0, sexp_reverse_op),
 _FN1(SEXP_NULL, SEXP_NULL, "reverse!", 0, sexp_nreverse_op),
 _FN2(SEXP_NULL, SEXP_NULL, SEXP_NULL, "append2", 0, sexp_append2_op),
 _FN1(_I(SEXP_VECTOR), SEXP_NULL, "list->vector", 0, sexp_list_to_vector_op),
-_FN1(_I(SEXP_IPORT), _I(SEXP_STRING), "open-input-file", 0, sexp_open_input_file_op),
-_FN1(_I(SEXP_OPORT), _I(SEXP_STRING), "open-output-file", 0, sexp_open_output_file_op),
-_FN1(_I(SEXP_IPORT), _I(SEXP_STRING), "open-binary-input-file", 0, sexp_open_binary_input_file),
-_FN1(_I(SEXP_OPORT), _I(SEXP_STRING), "open-binary-output-file", 0, sexp_open_binary_output_file),
+_FN2OPT(_I(SEXP_IPORT), _I(SEXP_STRING), _I(SEXP_FIXNUM), "open-input-file", SEXP_FALSE, sexp_open_input_file_op),
+_FN2OPT(_I(SEXP_OPORT), _I(SEXP_STRING), _I(SEXP_FIXNUM), "open-output-file", SEXP_FALSE, sexp_open_output_file_op),
+_FN2OPT(_I(SEXP_IPORT), _I(SEXP_STRING), _I(SEXP_FIXNUM), "open-binary-input-file", SEXP_FALSE, sexp_open_binary_input_file),
+_FN2OPT(_I(SEXP_OPORT), _I(SEXP_STRING), _I(SEXP_FIXNUM), "open-binary-output-file", SEXP_FALSE, sexp_open_binary_output_file),
 _FN1(SEXP_VOID, _I(SEXP_IPORT), "close-input-port", 0, sexp_close_port_op),
 _FN1(SEXP_VOID, _I(SEXP_OPORT), "close-output-port", 0, sexp_close_port_op),
 _FN0(_I(SEXP_ENV), "make-environment", 0, sexp_make_env_op),
@@ -186,6 +189,13 @@ _FN2OPTP(_I(SEXP_OBJECT), _I(SEXP_OBJECT), _I(SEXP_ENV), "compile", (sexp)"inter
 _FN2OPTP(_I(SEXP_OBJECT), _I(SEXP_OBJECT), _I(SEXP_ENV), "generate", (sexp)"interaction-environment", sexp_generate_op),
 _FN2OPTP(SEXP_VOID, _I(SEXP_STRING), _I(SEXP_ENV), "%load", (sexp)"interaction-environment", sexp_load_op),
 _FN4(SEXP_VOID, _I(SEXP_ENV), _I(SEXP_ENV), _I(SEXP_OBJECT), "%import", 0, sexp_env_import_op),
+_FN2(_I(SEXP_OBJECT), _I(SEXP_OBJECT), _I(SEXP_PROCEDURE), "%make-lazy-env", 0, sexp_make_lazy_env_op),
+_FN2(SEXP_VOID, _I(SEXP_ENV), _I(SEXP_STRING), "%note-module-file", 0, sexp_note_module_file_op),
+_FN1(_I(SEXP_BOOLEAN), _I(SEXP_OBJECT), "%load-profile-begin", 0, sexp_load_profile_begin_op),
+_FN1(SEXP_VOID, _I(SEXP_OBJECT), "%load-profile-end", 0, sexp_load_profile_end_op),
+#if SEXP_USE_NATIVE_SYNTAX_RULES
+_FN4(_I(SEXP_OBJECT), _I(SEXP_PAIR), _I(SEXP_OBJECT), _I(SEXP_PROCEDURE), "%syntax-rules-expand", 0, sexp_syntax_rules_expand_op),
+#endif
 _FN2OPTP(SEXP_VOID, _I(SEXP_EXCEPTION), _I(SEXP_OPORT), "print-exception", (sexp)"current-error-port", sexp_print_exception_op),
 _FN1OPTP(SEXP_VOID, _I(SEXP_OPORT), "print-stack-trace", (sexp)"current-error-port", sexp_stack_trace_op),
 _FN3OPT(SEXP_VOID, _I(SEXP_OBJECT), _I(SEXP_OBJECT), _I(SEXP_OBJECT), "warn-undefs", SEXP_FALSE, sexp_warn_undefs_op),
@@ -200,7 +210,7 @@ _FN2(_I(SEXP_OBJECT), _I(SEXP_OBJECT), SEXP_NULL, "memq", 0, sexp_memq_op),
 _FN2(_I(SEXP_OBJECT), _I(SEXP_OBJECT), SEXP_NULL, "assq", 0, sexp_assq_op),
 _FN3(_I(SEXP_SYNCLO), _I(SEXP_ENV), SEXP_NULL, _I(SEXP_OBJECT), "make-syntactic-closure", 0, sexp_make_synclo_op),
 _FN1(_I(SEXP_OBJECT), _I(SEXP_OBJECT), "strip-syntactic-closures", 0, sexp_strip_synclos),
-_FN0(_I(SEXP_OPORT), "open-output-string", 0, sexp_open_output_string_op),
+_FN1OPT(_I(SEXP_OPORT), _I(SEXP_FIXNUM), "open-output-string", SEXP_FALSE, sexp_open_output_string_op),
 _FN1(_I(SEXP_IPORT), _I(SEXP_STRING), "open-input-string", 0, sexp_open_input_string_op),
 _FN1(_I(SEXP_STRING), _I(SEXP_OPORT), "get-output-string", 0, sexp_get_output_string_op),
 _FN2OPT(_I(SEXP_IPORT), _I(SEXP_FIXNUM), _I(SEXP_BOOLEAN), "open-input-file-descriptor", SEXP_FALSE, sexp_open_input_file_descriptor),
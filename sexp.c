@@ -19,6 +19,22 @@ struct sexp_huff_entry {
 #include <io.h>
 #endif
 
+#if defined(_WIN32) || defined(PLAN9)
+#define SEXP_USE_WRITEV 0
+struct iovec {void *iov_base; size_t iov_len;};
+#else
+#define SEXP_USE_WRITEV 1
+#include <sys/uio.h>
+#endif
+
+#if SEXP_USE_MMAP_PORTS
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+/* batch size for writev, well under any system's IOV_MAX */
+#define SEXP_WRITEV_MAX_CHUNKS 64
+
 static int sexp_initialized_p = 0;
 
 static const char sexp_separators[] = {
@@ -85,8 +101,15 @@ sexp sexp_alloc_tagged_aux(sexp ctx, size_t size, sexp_uint_t tag sexp_current_s
   return res;
 }
 
+#if SEXP_USE_NATIVE_WRITE_SHARED
+struct sexp_shared_labels;
+static sexp sexp_write_labeled (sexp ctx, sexp obj, sexp out, struct sexp_shared_labels *labels, sexp_sint_t bound);
+#endif
+
 #if SEXP_USE_OBJECT_BRACE_LITERALS
-sexp sexp_write_simple_object (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp writer, sexp out) {
+/* writes slots with the writer procedure if given, else with the */
+/* shared structure labels if given, else with plain write */
+static sexp sexp_write_braces (sexp ctx, sexp obj, sexp writer, sexp out, void *labels, sexp_sint_t bound) {
   sexp t, x;
   sexp_gc_var1(args);
   sexp_sint_t i, len, nulls=0;
@@ -117,6 +140,10 @@ sexp sexp_write_simple_object (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sex
           sexp_car(args) = x;
           x = sexp_apply(ctx, writer, args);
           if (sexp_exceptionp(x)) sexp_print_exception(ctx, x, out);
+#if SEXP_USE_NATIVE_WRITE_SHARED
+        } else if (labels) {
+          sexp_write_labeled(ctx, x, out, (struct sexp_shared_labels*)labels, bound+1);
+#endif
         } else {
           sexp_write(ctx, sexp_slot_ref(obj, i), out);
         }
@@ -129,6 +156,10 @@ sexp sexp_write_simple_object (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sex
   sexp_write_char(ctx, '}', out);
   return SEXP_VOID;
 }
+
+sexp sexp_write_simple_object (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp writer, sexp out) {
+  return sexp_write_braces(ctx, obj, writer, out, NULL, 0);
+}
 #else
 #define sexp_write_simple_object NULL
 #endif
@@ -221,6 +252,10 @@ sexp sexp_finalize_port (sexp ctx, sexp self, sexp_sint_t n, sexp port) {
     if (sexp_port_stream(port) && ! sexp_port_no_closep(port))
       /* close the stream */
       fclose(sexp_port_stream(port));
+#if SEXP_USE_MMAP_PORTS
+    if (sexp_mapped_portp(port))
+      munmap(sexp_cpointer_value(sexp_port_cookie(port)), sexp_port_size(port));
+#endif
     sexp_port_offset(port) = 0;
     sexp_port_size(port) = 0;
   }
@@ -249,6 +284,13 @@ sexp sexp_finalize_uvector (sexp ctx, sexp self, sexp_sint_t n, sexp obj) {
 }
 #endif
 
+/* the env index, when present, is the last traced env slot */
+#if SEXP_USE_HASH_ENVS
+#define SEXP_ENV_FIELD_LEN ((sexp_offsetof(env, index) - sexp_offsetof(env, parent)) / sizeof(sexp) + 1)
+#else
+#define SEXP_ENV_FIELD_LEN (3+SEXP_USE_RENAME_BINDINGS)
+#endif
+
 static struct sexp_type_struct _sexp_type_specs[] = {
   {(sexp)"Object", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_OBJECT, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"Type", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_TYPE, sexp_offsetof(type, name), 9, 9, 0, 0, sexp_sizeof(type), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
@@ -283,14 +325,14 @@ static struct sexp_type_struct _sexp_type_specs[] = {
   {(sexp)"Procedure", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_PROCEDURE, sexp_offsetof(procedure, bc), 2, 2, 0, 0, sexp_sizeof(procedure), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"Macro", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_MACRO, sexp_offsetof(macro, proc), 4, 4, 0, 0, sexp_sizeof(macro), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"Sc", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, (sexp)sexp_write_simple_object, NULL, NULL, SEXP_SYNCLO, sexp_offsetof(synclo, env), 4, 4, 0, 0, sexp_sizeof(synclo), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
-  {(sexp)"Environment", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_ENV, sexp_offsetof(env, parent), 3+SEXP_USE_RENAME_BINDINGS, 3+SEXP_USE_RENAME_BINDINGS, 0, 0, sexp_sizeof(env), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
+  {(sexp)"Environment", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_ENV, sexp_offsetof(env, parent), 3+SEXP_USE_RENAME_BINDINGS, SEXP_ENV_FIELD_LEN, 0, 0, sexp_sizeof(env), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"Bytecode", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_BYTECODE, sexp_offsetof(bytecode, name), 3, 3, 0, 0, sexp_sizeof(bytecode), offsetof(struct sexp_struct, value.bytecode.length), 1, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"Core-Form", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_CORE, sexp_offsetof(core, name), 1, 1, 0, 0, sexp_sizeof(core), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
 #if SEXP_USE_STABLE_ABI || SEXP_USE_DL
   {(sexp)"Dynamic-Library", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, SEXP_FINALIZE_DLN, SEXP_DL, sexp_offsetof(dl, file), 1, 1, 0, 0, sexp_sizeof(dl), 0, 0, 0, 0, 0, 0, 0, 0, SEXP_FINALIZE_DL},
 #endif
   {(sexp)"Opcode", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, NULL, NULL, NULL, SEXP_OPCODE, sexp_offsetof(opcode, name), 11, 11, 0, 0, sexp_sizeof(opcode), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
-  {(sexp)"Lambda", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, (sexp)sexp_write_simple_object, NULL, NULL, SEXP_LAMBDA, sexp_offsetof(lambda, name), 11, 11, 0, 0, sexp_sizeof(lambda), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
+  {(sexp)"Lambda", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, (sexp)sexp_write_simple_object, NULL, NULL, SEXP_LAMBDA, sexp_offsetof(lambda, name), 13, 13, 0, 0, sexp_sizeof(lambda), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"If", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, (sexp)sexp_write_simple_object, NULL, NULL, SEXP_CND, sexp_offsetof(cnd, test), 4, 4, 0, 0, sexp_sizeof(cnd), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"Ref", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, (sexp)sexp_write_simple_object, NULL, NULL, SEXP_REF, sexp_offsetof(ref, name), 3, 3, 0, 0, sexp_sizeof(ref), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
   {(sexp)"Set!", SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, SEXP_FALSE, (sexp)sexp_write_simple_object, NULL, NULL, SEXP_SET, sexp_offsetof(set, var), 3, 3, 0, 0, sexp_sizeof(set), 0, 0, 0, 0, 0, 0, 0, 0, NULL},
@@ -517,6 +559,12 @@ static const char* sexp_initial_features[] = {
 #endif
 #if SEXP_USE_RATIOS
   "ratios",
+#endif
+#if SEXP_USE_NATIVE_SYNTAX_RULES
+  "native-syntax-rules",
+#endif
+#if SEXP_USE_NATIVE_WRITE_SHARED
+  "native-write-shared",
 #endif
   "r7rs",
   "chibi",
@@ -531,10 +579,15 @@ void sexp_init_context_globals (sexp ctx) {
   sexp_context_globals(ctx)
     = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_G_NUM_GLOBALS), SEXP_VOID);
 #if ! SEXP_USE_GLOBAL_SYMBOLS
-  sexp_global(ctx, SEXP_G_SYMBOLS) = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_SYMBOL_TABLE_SIZE), SEXP_NULL);
+  sexp_global(ctx, SEXP_G_SYMBOLS) = sexp_make_vector(ctx, sexp_make_fixnum(SEXP_SYMTAB_SIZE), SEXP_ZERO);
+  sexp_vector_data(sexp_global(ctx, SEXP_G_SYMBOLS))[SEXP_SYMTAB_TABLE]
+    = sexp_make_vector(ctx, sexp_make_fixnum(2*SEXP_SYMBOL_TABLE_INITIAL_SIZE), SEXP_FALSE);
+  sexp_vector_data(sexp_global(ctx, SEXP_G_SYMBOLS))[SEXP_SYMTAB_OLD] = SEXP_FALSE;
 #endif
   sexp_global(ctx, SEXP_G_STRICT_P) = SEXP_FALSE;
   sexp_global(ctx, SEXP_G_NO_TAIL_CALLS_P) = SEXP_FALSE;
+  sexp_global(ctx, SEXP_G_NO_PEEPHOLE_P) = SEXP_FALSE;
+  sexp_global(ctx, SEXP_G_EVAL_CACHE) = SEXP_FALSE;
 #if SEXP_USE_FOLD_CASE_SYMS
   sexp_global(ctx, SEXP_G_FOLD_CASE_P) = sexp_make_boolean(SEXP_DEFAULT_FOLD_CASE_SYMS);
 #endif
@@ -1048,6 +1101,13 @@ sexp sexp_equalp_bound (sexp ctx, sexp self, sexp_sint_t n, sexp a, sexp b, sexp
 #if SEXP_USE_FLONUMS && ! SEXP_USE_IMMEDIATE_FLONUMS
   if (sexp_pointer_tag(a) == SEXP_FLONUM)
     return sexp_flonum_eqv(a, b) ? bound : SEXP_FALSE;
+#endif
+#if ! SEXP_USE_PACKED_STRINGS
+  /* strings may be views into larger bytes, compare just the contents */
+  if (sexp_pointer_tag(a) == SEXP_STRING)
+    return (sexp_string_size(a) == sexp_string_size(b)
+            && !memcmp(sexp_string_data(a), sexp_string_data(b), sexp_string_size(a)))
+      ? bound : SEXP_FALSE;
 #endif
   /* check limits */
   if (sexp_unbox_fixnum(bound) < 0 || sexp_unbox_fixnum(depth) < 0)
@@ -1231,10 +1291,62 @@ void sexp_utf8_encode_char (unsigned char* p, int len, int c) {
   }
 }
 
+#if SEXP_USE_STRING_INDEX_TABLE
+/* A string's charlens caches how to find a char by index.  It starts */
+/* out unknown (NULL, #f or a fixnum count of the bytes scanned by    */
+/* index lookups so far).  Once lookups have scanned more than the    */
+/* whole string it's indexed: ASCII-only strings get #t and are then  */
+/* indexed directly, others get a table of the cursor of every        */
+/* SEXP_STRING_INDEX_TABLE_CHUNK_SIZE'th char, preceded by the length. */
+/* sexp_update_string_index_lookup resets it when the chars move.     */
+static void sexp_build_string_index (sexp ctx, sexp s) {
+  unsigned char *p, *q, *end;
+  sexp_sint_t numchunks, len, i, k, *chunks;
+  sexp_gc_var2(tmp, table);
+  len = sexp_string_utf8_length((unsigned char*)sexp_string_data(s), sexp_string_size(s));
+  if (len == (sexp_sint_t)sexp_string_size(s)) {
+    sexp_string_charlens(s) = SEXP_TRUE;
+    return;
+  }
+  sexp_gc_preserve2(ctx, tmp, table);
+  tmp = s;
+  numchunks = len / SEXP_STRING_INDEX_TABLE_CHUNK_SIZE;
+  table = sexp_make_bytes(ctx, sexp_make_fixnum((numchunks+1) * sizeof(sexp_sint_t)), SEXP_VOID);
+  if (sexp_bytesp(table)) {
+    chunks = (sexp_sint_t*)sexp_bytes_data(table);
+    chunks[0] = len;
+    p = q = (unsigned char*)sexp_string_data(s);
+    end = p + sexp_string_size(s);
+    for (i=1; i<=numchunks; i++) {
+      for (k=0; k<SEXP_STRING_INDEX_TABLE_CHUNK_SIZE && q<end; k++)
+        q += sexp_utf8_initial_byte_count(*q);
+      chunks[i] = q - p;
+    }
+    sexp_string_charlens(s) = table;
+  }
+  sexp_gc_release2(ctx);
+}
+
+sexp_uint_t sexp_string_indexed_length (sexp s) {
+  sexp charlens = sexp_string_charlens(s);
+  sexp_uint_t len;
+  if (charlens == SEXP_TRUE)
+    return sexp_string_size(s);
+  else if (charlens && sexp_bytesp(charlens))
+    return ((sexp_sint_t*)sexp_bytes_data(charlens))[0];
+  len = sexp_string_utf8_length((unsigned char*)sexp_string_data(s), sexp_string_size(s));
+  if (len == sexp_string_size(s))
+    sexp_string_charlens(s) = SEXP_TRUE;
+  else   /* counts towards indexing if the string is also indexed */
+    sexp_string_charlens(s) = sexp_make_fixnum(sexp_string_size(s) + (sexp_fixnump(charlens) ? sexp_unbox_fixnum(charlens) : 0));
+  return len;
+}
+#endif
+
 sexp sexp_string_index_to_cursor (sexp ctx, sexp self, sexp_sint_t n, sexp str, sexp index) {
 #if SEXP_USE_STRING_INDEX_TABLE
   sexp charlens;
-  sexp_sint_t* chunklens;
+  sexp_sint_t* chunks;
   sexp_sint_t chunk;
 #endif
   sexp_sint_t i, j, limit;
@@ -1246,13 +1358,17 @@ sexp sexp_string_index_to_cursor (sexp ctx, sexp self, sexp_sint_t n, sexp str,
   i = sexp_unbox_fixnum(index);
   j = 0;
 #if SEXP_USE_STRING_INDEX_TABLE
-  if (i > SEXP_STRING_INDEX_TABLE_CHUNK_SIZE) {
-    charlens = sexp_string_charlens(str);
-    if (charlens) {
-      chunklens = (sexp_sint_t*)sexp_bytes_data(charlens);
-      chunk = i / SEXP_STRING_INDEX_TABLE_CHUNK_SIZE - 1;
-      j = chunklens[chunk];
-      i -= (chunk+1) * SEXP_STRING_INDEX_TABLE_CHUNK_SIZE;
+  charlens = sexp_string_charlens(str);
+  if (charlens == SEXP_TRUE) {
+    if (i < 0 || i > limit)
+      return sexp_user_exception(ctx, self, "string-index->cursor: index out of range", index);
+    return sexp_make_string_cursor(i);
+  } else if (charlens && sexp_bytesp(charlens)) {
+    chunks = (sexp_sint_t*)sexp_bytes_data(charlens);
+    chunk = i / SEXP_STRING_INDEX_TABLE_CHUNK_SIZE;
+    if (chunk > 0 && i <= chunks[0]) {
+      j = chunks[chunk];
+      i -= chunk * SEXP_STRING_INDEX_TABLE_CHUNK_SIZE;
     }
   }
 #endif
@@ -1260,15 +1376,45 @@ sexp sexp_string_index_to_cursor (sexp ctx, sexp self, sexp_sint_t n, sexp str,
     j += sexp_utf8_initial_byte_count(p[j]);
   if (i != 0)
     return sexp_user_exception(ctx, self, "string-index->cursor: index out of range", index);
+#if SEXP_USE_STRING_INDEX_TABLE
+  /* index the string once lookups have cost more than a full scan */
+  if (!(charlens && sexp_bytesp(charlens)) && j > SEXP_STRING_INDEX_TABLE_CHUNK_SIZE) {
+    i = j + (sexp_fixnump(charlens) ? sexp_unbox_fixnum(charlens) : 0);
+    if (i > limit)
+      sexp_build_string_index(ctx, str);
+    else
+      sexp_string_charlens(str) = sexp_make_fixnum(i);
+  }
+#endif
   return sexp_make_string_cursor(j);
 }
 
 sexp sexp_string_cursor_to_index (sexp ctx, sexp self, sexp_sint_t n, sexp str, sexp offset) {
   sexp_sint_t off = sexp_unbox_string_cursor(offset);
+#if SEXP_USE_STRING_INDEX_TABLE
+  sexp_sint_t lo, hi, mid, *chunks;
+#endif
   sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, str);
   sexp_assert_type(ctx, sexp_string_cursorp, SEXP_STRING_CURSOR, offset);
   if (off < 0 || off > (sexp_sint_t)sexp_string_size(str))
     return sexp_user_exception(ctx, self, "string-cursor->index: offset out of range", offset);
+#if SEXP_USE_STRING_INDEX_TABLE
+  if (sexp_string_charlens(str) == SEXP_TRUE) {
+    return sexp_make_fixnum(off);
+  } else if (sexp_string_charlens(str) && sexp_bytesp(sexp_string_charlens(str))) {
+    /* count from the last indexed char at or before off */
+    chunks = (sexp_sint_t*)sexp_bytes_data(sexp_string_charlens(str));
+    lo = 0;
+    hi = sexp_bytes_length(sexp_string_charlens(str)) / sizeof(sexp_sint_t) - 1;
+    while (lo < hi) {
+      mid = (lo + hi + 1) / 2;
+      if (chunks[mid] <= off) lo = mid; else hi = mid - 1;
+    }
+    mid = lo ? chunks[lo] : 0;
+    return sexp_make_fixnum(lo * SEXP_STRING_INDEX_TABLE_CHUNK_SIZE
+                            + sexp_string_utf8_length((unsigned char*)sexp_string_data(str) + mid, off - mid));
+  }
+#endif
   return sexp_make_fixnum(sexp_string_utf8_length((unsigned char*)sexp_string_data(str), off));
 }
 
@@ -1279,36 +1425,6 @@ sexp sexp_string_cursor_offset (sexp ctx, sexp self, sexp_sint_t n, sexp cur) {
 
 #endif
 
-#if SEXP_USE_STRING_INDEX_TABLE
-void sexp_update_string_index_lookup(sexp ctx, sexp s) {
-  char *p;
-  sexp_sint_t numchunks, len, i, *chunks;
-  sexp_gc_var1(tmp);
-  if (sexp_string_size(s) < SEXP_STRING_INDEX_TABLE_CHUNK_SIZE*1.2) {
-    sexp_string_charlens(s) = NULL; /* don't build table for just a few chars */
-    return;
-  }
-  sexp_gc_preserve1(ctx, tmp);
-  tmp = s;
-  len = sexp_string_utf8_length((unsigned char*) sexp_string_data(s), sexp_string_size(s));
-  numchunks = ((len + SEXP_STRING_INDEX_TABLE_CHUNK_SIZE - 1) / SEXP_STRING_INDEX_TABLE_CHUNK_SIZE) - 1;
-  sexp_string_charlens(s) =
-    sexp_make_bytes_op(ctx, NULL, 2, sexp_make_fixnum(numchunks * sizeof(sexp_sint_t)), SEXP_VOID);
-  chunks = (sexp_sint_t*)sexp_bytes_data(sexp_string_charlens(s));
-  p = sexp_string_data(s);
-  i = 0;
-  while (1) {
-    p += sexp_utf8_initial_byte_count(*p);
-    if (++i % SEXP_STRING_INDEX_TABLE_CHUNK_SIZE == 0) {
-      chunks[i/SEXP_STRING_INDEX_TABLE_CHUNK_SIZE - 1] = p - sexp_string_data(s);
-      if (i / SEXP_STRING_INDEX_TABLE_CHUNK_SIZE >= numchunks-1)
-        break;
-    }
-  }
-  sexp_gc_release1(ctx);
-}
-#endif
-
 sexp sexp_make_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp len, sexp ch)
 {
   sexp i = (sexp_charp(ch) ? sexp_make_fixnum(sexp_unbox_character(ch)) : ch);
@@ -1342,6 +1458,10 @@ sexp sexp_make_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp len, sexp ch)
   sexp_string_offset(s) = 0;
   sexp_string_size(s) = sexp_bytes_length(b);
   sexp_update_string_index_lookup(ctx, s);
+#if SEXP_USE_STRING_INDEX_TABLE
+  if (sexp_charp(ch) && sexp_unbox_character(ch) < 0x80)
+    sexp_string_charlens(s) = SEXP_TRUE;
+#endif
   sexp_gc_release2(ctx);
   return s;
 #endif
@@ -1360,6 +1480,33 @@ sexp sexp_c_string (sexp ctx, const char *str, sexp_sint_t slen) {
   return s;
 }
 
+#if SEXP_USE_SHARED_SUBSTRINGS
+/* a long enough suffix of a string is returned as a view of the same */
+/* bytes, which are still NUL-terminated at its end.  Middle ranges */
+/* would need every C use of sexp_string_data to take a length, so  */
+/* they are copied.  The bytes are marked shared, and any string     */
+/* using them copies them when first mutated.  Nothing tracks when  */
+/* the other strings are collected, so the mark stays and the copy  */
+/* happens even if the mutated string is by then the only user.     */
+static int sexp_substring_sharablep (sexp str, sexp_sint_t start, sexp_sint_t end) {
+  return end == (sexp_sint_t)sexp_string_size(str)
+    && end - start >= SEXP_SHARED_SUBSTRING_MIN_SIZE
+    && (end - start) * SEXP_SHARED_SUBSTRING_MAX_RATIO
+       >= (sexp_sint_t)sexp_bytes_length(sexp_string_bytes(str))
+    && sexp_string_data(str)[end] == '\0';
+}
+
+sexp sexp_string_unshare_bytes (sexp ctx, sexp str) {
+  sexp b = sexp_make_bytes(ctx, sexp_make_fixnum(sexp_string_size(str)), SEXP_VOID);
+  if (sexp_exceptionp(b)) return b;
+  memcpy(sexp_bytes_data(b), sexp_string_data(str), sexp_string_size(str));
+  sexp_bytes_data(b)[sexp_string_size(str)] = '\0';
+  sexp_string_bytes(str) = b;
+  sexp_string_offset(str) = 0;
+  return SEXP_VOID;
+}
+#endif
+
 sexp sexp_substring_op (sexp ctx, sexp self, sexp_sint_t n, sexp str, sexp start, sexp end) {
   sexp res;
   sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, str);
@@ -1373,36 +1520,49 @@ sexp sexp_substring_op (sexp ctx, sexp self, sexp_sint_t n, sexp str, sexp start
       || (sexp_unbox_string_cursor(end) > (sexp_sint_t)sexp_string_size(str))
       || (end < start))
     return sexp_range_exception(ctx, str, start, end);
-  res = sexp_make_string(ctx, sexp_make_fixnum(sexp_unbox_string_cursor(end) - sexp_unbox_string_cursor(start)), SEXP_VOID);
-  memcpy(sexp_string_data(res),
-         sexp_string_data(str)+sexp_unbox_string_cursor(start),
-         sexp_string_size(res));
-  sexp_string_data(res)[sexp_string_size(res)] = '\0';
+#if SEXP_USE_SHARED_SUBSTRINGS
+  if (sexp_substring_sharablep(str, sexp_unbox_string_cursor(start), sexp_unbox_string_cursor(end))) {
+    res = sexp_alloc_type(ctx, string, SEXP_STRING);
+    if (sexp_exceptionp(res)) return res;
+    sexp_string_bytes(res) = sexp_string_bytes(str);
+    sexp_string_offset(res) = sexp_string_offset(str) + sexp_unbox_string_cursor(start);
+    sexp_string_size(res) = sexp_unbox_string_cursor(end) - sexp_unbox_string_cursor(start);
+    sexp_sharedp(sexp_string_bytes(str)) = 1;
+  } else
+#endif
+  {
+    res = sexp_make_string(ctx, sexp_make_fixnum(sexp_unbox_string_cursor(end) - sexp_unbox_string_cursor(start)), SEXP_VOID);
+    if (sexp_exceptionp(res)) return res;
+    memcpy(sexp_string_data(res),
+           sexp_string_data(str)+sexp_unbox_string_cursor(start),
+           sexp_string_size(res));
+    sexp_string_data(res)[sexp_string_size(res)] = '\0';
+  }
   sexp_update_string_index_lookup(ctx, res);
+#if SEXP_USE_STRING_INDEX_TABLE
+  if (sexp_string_charlens(str) == SEXP_TRUE)   /* still ASCII */
+    sexp_string_charlens(res) = SEXP_TRUE;
+#endif
   return res;
 }
 
 sexp sexp_subbytes_op (sexp ctx, sexp self, sexp_sint_t n, sexp vec, sexp start, sexp end) {
   sexp res;
-  sexp_gc_var1(str);
   sexp_assert_type(ctx, sexp_bytesp, SEXP_BYTES, vec);
   sexp_assert_type(ctx, sexp_fixnump, SEXP_FIXNUM, start);
   if (sexp_not(end))
     end = sexp_make_fixnum(sexp_bytes_length(vec));
   sexp_assert_type(ctx, sexp_fixnump, SEXP_FIXNUM, end);
-  sexp_gc_preserve1(ctx, str);
-#if SEXP_USE_PACKED_STRINGS
-  str = sexp_c_string(ctx, sexp_bytes_data(vec), sexp_bytes_length(vec));
-#else
-  str = sexp_alloc_type(ctx, string, SEXP_STRING);
-  sexp_string_bytes(str) = vec;
-  sexp_string_offset(str) = 0;
-  sexp_string_size(str) = sexp_bytes_length(vec);
-#endif
-  res = sexp_substring_op(ctx, self, n, str, sexp_fixnum_to_string_cursor(start), sexp_fixnum_to_string_cursor(end));
+  if ((sexp_unbox_fixnum(start) < 0)
+      || (sexp_unbox_fixnum(start) > (sexp_sint_t)sexp_bytes_length(vec))
+      || (sexp_unbox_fixnum(end) < 0)
+      || (sexp_unbox_fixnum(end) > (sexp_sint_t)sexp_bytes_length(vec))
+      || (end < start))
+    return sexp_range_exception(ctx, vec, start, end);
+  res = sexp_make_bytes(ctx, sexp_fx_sub(end, start), SEXP_VOID);
   if (!sexp_exceptionp(res))
-    res = sexp_string_to_bytes(ctx, res);
-  sexp_gc_release1(ctx);
+    memcpy(sexp_bytes_data(res), sexp_bytes_data(vec)+sexp_unbox_fixnum(start),
+           sexp_bytes_length(res));
   return res;
 }
 
@@ -1462,6 +1622,92 @@ static sexp_uint_t sexp_string_hash(const char *str, sexp_sint_t len,
 
 #endif
 
+#if ! SEXP_USE_GLOBAL_SYMBOLS
+
+/* The symbol table is open-addressed, with each symbol followed by */
+/* its cached hash shifted left one bit.  The low bit marks symbols */
+/* returned since the last gc, which are kept even if unreferenced */
+/* since C code may be holding them unrooted.  Deleted slots hold */
+/* void.  Growing allocates a new table and moves a few old slots */
+/* over on each intern, so no single call pays for the whole rehash. */
+
+#define SEXP_SYMTAB_MIGRATE_STEP 16
+
+#define sexp_symtab_ref(tab, i) (sexp_vector_data(tab)[i])
+#define sexp_symtab_capacity(table) (sexp_vector_length(table) / 2)
+
+static sexp sexp_symtab_lookup (sexp table, const char *str, sexp_sint_t len,
+                                sexp_uint_t hash) {
+  sexp x, *v = sexp_vector_data(table);
+  sexp_uint_t mask = sexp_symtab_capacity(table) - 1, i = hash & mask;
+  for ( ; (x=v[i*2]) != SEXP_FALSE; i = (i+1) & mask)
+    if (x != SEXP_VOID
+        && ((sexp_uint_t)sexp_unbox_fixnum(v[i*2+1]) >> 1) == hash
+        && sexp_lsymbol_length(x) == len
+        && ! memcmp(str, sexp_lsymbol_data(x), len)) {
+      v[i*2+1] = sexp_make_fixnum((hash << 1) | 1);
+      return x;
+    }
+  return NULL;
+}
+
+/* returns 1 if the symbol took a previously empty slot */
+static int sexp_symtab_insert (sexp table, sexp sym, sexp hash) {
+  sexp x, *v = sexp_vector_data(table);
+  sexp_uint_t mask = sexp_symtab_capacity(table) - 1;
+  sexp_uint_t i = ((sexp_uint_t)sexp_unbox_fixnum(hash) >> 1) & mask;
+  for ( ; (x=v[i*2]) != SEXP_FALSE && x != SEXP_VOID; i = (i+1) & mask)
+    ;
+  v[i*2] = sym;
+  v[i*2+1] = hash;
+  return x == SEXP_FALSE;
+}
+
+static void sexp_symtab_migrate (sexp tab, sexp_uint_t n) {
+  sexp x, old = sexp_symtab_ref(tab, SEXP_SYMTAB_OLD), table = sexp_symtab_ref(tab, SEXP_SYMTAB_TABLE);
+  sexp_uint_t i = sexp_unbox_fixnum(sexp_symtab_ref(tab, SEXP_SYMTAB_MIGRATE));
+  sexp_uint_t used = sexp_unbox_fixnum(sexp_symtab_ref(tab, SEXP_SYMTAB_USED));
+  if (! sexp_vectorp(old)) return;
+  for ( ; n > 0 && i < sexp_symtab_capacity(old); n--, i++) {
+    x = sexp_vector_data(old)[i*2];
+    if (x != SEXP_FALSE && x != SEXP_VOID) {
+      used += sexp_symtab_insert(table, x, sexp_vector_data(old)[i*2+1]);
+      sexp_vector_data(old)[i*2] = SEXP_VOID;
+    }
+  }
+  sexp_symtab_ref(tab, SEXP_SYMTAB_USED) = sexp_make_fixnum(used);
+  if (i < sexp_symtab_capacity(old)) {
+    sexp_symtab_ref(tab, SEXP_SYMTAB_MIGRATE) = sexp_make_fixnum(i);
+  } else {
+    sexp_symtab_ref(tab, SEXP_SYMTAB_OLD) = SEXP_FALSE;
+    sexp_symtab_ref(tab, SEXP_SYMTAB_MIGRATE) = SEXP_ZERO;
+  }
+}
+
+/* make room for one more symbol, starting a rehash if needed */
+static sexp sexp_symtab_reserve (sexp ctx) {
+  sexp tab = sexp_context_symbols(ctx), table;
+  sexp_uint_t size, used;
+  table = sexp_symtab_ref(tab, SEXP_SYMTAB_TABLE);
+  used = sexp_unbox_fixnum(sexp_symtab_ref(tab, SEXP_SYMTAB_USED));
+  if ((used + 1) * 4 <= sexp_symtab_capacity(table) * 3)
+    return SEXP_VOID;
+  sexp_symtab_migrate(tab, (sexp_uint_t)-1);
+  size = SEXP_SYMBOL_TABLE_INITIAL_SIZE;
+  while (size < (sexp_unbox_fixnum(sexp_symtab_ref(tab, SEXP_SYMTAB_COUNT)) + 1) * 4)
+    size <<= 1;
+  table = sexp_make_vector(ctx, sexp_make_fixnum(size*2), SEXP_FALSE);
+  if (sexp_exceptionp(table))   /* keep filling the current table */
+    return used + 1 < sexp_symtab_capacity(sexp_symtab_ref(tab, SEXP_SYMTAB_TABLE)) ? SEXP_VOID : table;
+  sexp_symtab_ref(tab, SEXP_SYMTAB_OLD) = sexp_symtab_ref(tab, SEXP_SYMTAB_TABLE);
+  sexp_symtab_ref(tab, SEXP_SYMTAB_TABLE) = table;
+  sexp_symtab_ref(tab, SEXP_SYMTAB_MIGRATE) = SEXP_ZERO;
+  sexp_symtab_ref(tab, SEXP_SYMTAB_USED) = SEXP_ZERO;
+  return SEXP_VOID;
+}
+
+#endif
+
 sexp sexp_intern(sexp ctx, const char *str, sexp_sint_t len) {
 #if SEXP_USE_HUFF_SYMS
   struct sexp_huff_entry he;
@@ -1470,7 +1716,12 @@ sexp sexp_intern(sexp ctx, const char *str, sexp_sint_t len) {
 #endif
   sexp ls, tmp;
   sexp_gc_var1(sym);
+#if SEXP_USE_GLOBAL_SYMBOLS
   sexp_sint_t bucket=0;
+#else
+  sexp_uint_t hash=0;
+  sexp tab;
+#endif
 #if (SEXP_USE_HASH_SYMS || SEXP_USE_HUFF_SYMS)
   sexp_sint_t i=0, res=FNV_OFFSET_BASIS;
   const char *p=str;
@@ -1499,6 +1750,7 @@ sexp sexp_intern(sexp ctx, const char *str, sexp_sint_t len) {
 
  normal_intern:
 #endif
+#if SEXP_USE_GLOBAL_SYMBOLS
 #if SEXP_USE_HASH_SYMS
   bucket = (sexp_string_hash(p, len-i, res) % SEXP_SYMBOL_TABLE_SIZE);
 #endif
@@ -1506,6 +1758,18 @@ sexp sexp_intern(sexp ctx, const char *str, sexp_sint_t len) {
     if ((sexp_lsymbol_length(tmp=sexp_car(ls)) == len)
         && ! strncmp(str, sexp_lsymbol_data(tmp), len))
       return sexp_car(ls);
+#else
+#if SEXP_USE_HASH_SYMS
+  hash = sexp_string_hash(str, len, FNV_OFFSET_BASIS) & ((sexp_uint_t)SEXP_MAX_FIXNUM >> 1);
+#endif
+  tab = sexp_context_symbols(ctx);
+  sexp_symtab_migrate(tab, SEXP_SYMTAB_MIGRATE_STEP);
+  if ((tmp = sexp_symtab_lookup(sexp_symtab_ref(tab, SEXP_SYMTAB_TABLE), str, len, hash)))
+    return tmp;
+  ls = sexp_symtab_ref(tab, SEXP_SYMTAB_OLD);
+  if (sexp_vectorp(ls) && (tmp = sexp_symtab_lookup(ls, str, len, hash)))
+    return tmp;
+#endif
 
   /* not found, make a new symbol */
   sexp_gc_preserve1(ctx, sym);
@@ -1515,7 +1779,22 @@ sexp sexp_intern(sexp ctx, const char *str, sexp_sint_t len) {
   sym = sexp_string_bytes(sym);
 #endif
   sexp_pointer_tag(sym) = SEXP_SYMBOL;
+#if SEXP_USE_GLOBAL_SYMBOLS
   sexp_push(ctx, sexp_context_symbols(ctx)[bucket], sym);
+#else
+  tmp = sexp_symtab_reserve(ctx);
+  if (sexp_exceptionp(tmp)) {
+    sexp_gc_release1(ctx);
+    return tmp;
+  }
+  tab = sexp_context_symbols(ctx);
+  if (sexp_symtab_insert(sexp_symtab_ref(tab, SEXP_SYMTAB_TABLE), sym,
+                         sexp_make_fixnum((hash << 1) | 1)))
+    sexp_symtab_ref(tab, SEXP_SYMTAB_USED)
+      = sexp_fx_add(sexp_symtab_ref(tab, SEXP_SYMTAB_USED), SEXP_ONE);
+  sexp_symtab_ref(tab, SEXP_SYMTAB_COUNT)
+    = sexp_fx_add(sexp_symtab_ref(tab, SEXP_SYMTAB_COUNT), SEXP_ONE);
+#endif
   sexp_gc_release1(ctx);
   return sym;
 }
@@ -1569,6 +1848,38 @@ sexp sexp_make_cpointer (sexp ctx, sexp_uint_t type_id, void *value,
 /* start 4 bytes in so we can always unread a utf8 char in peek-char */
 #define BUF_START 4
 
+/* a custom port's reader or writer may have resized its text buffer */
+/* or shared its bytes with a substring, but the port keeps filling */
+/* the buffer in place, so make sure it owns and points to its bytes */
+static void sexp_sync_custom_port_buffer (sexp ctx, sexp p) {
+#if ! SEXP_USE_PACKED_STRINGS
+  if (!sexp_port_binaryp(p)) {
+    sexp_string_unshare(ctx, sexp_port_buffer(p));
+    sexp_port_buf(p) = sexp_string_data(sexp_port_buffer(p));
+    sexp_update_string_index_lookup(ctx, sexp_port_buffer(p));
+  }
+#endif
+}
+
+/* the capacity of an input port's buffer, which sexp_port_size only */
+/* gives once the buffer is full */
+static sexp_sint_t sexp_port_buf_capacity (sexp p) {
+  sexp buf = sexp_port_customp(p) ? sexp_port_buffer(p) : sexp_port_cookie(p);
+  if (sexp_pairp(buf)) buf = sexp_car(buf);
+  return sexp_stringp(buf) ? (sexp_sint_t)sexp_string_size(buf)
+    : sexp_bytesp(buf) ? (sexp_sint_t)sexp_bytes_length(buf) : SEXP_PORT_BUFFER_SIZE;
+}
+
+/* the default buffer size for a port on fd, larger for regular files */
+sexp_sint_t sexp_default_port_buffer_size (int fd) {
+#if defined(S_ISREG) && !defined(PLAN9)
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    return SEXP_FILE_PORT_BUFFER_SIZE;
+#endif
+  return SEXP_PORT_BUFFER_SIZE;
+}
+
 int sexp_buffered_read_char (sexp ctx, sexp p) {
   sexp_gc_var2(tmp, origbytes);
   int res = 0;
@@ -1577,7 +1888,7 @@ int sexp_buffered_read_char (sexp ctx, sexp p) {
   } else if (!sexp_port_openp(p)) {
     return EOF;
   } else if (sexp_port_stream(p)) {
-    res = fread(sexp_port_buf(p) + BUF_START, 1, SEXP_PORT_BUFFER_SIZE - BUF_START, sexp_port_stream(p));
+    res = fread(sexp_port_buf(p) + BUF_START, 1, sexp_port_buf_capacity(p) - BUF_START, sexp_port_stream(p));
     if (res >= 0) {
       sexp_port_offset(p) = BUF_START;
       sexp_port_size(p) = res + BUF_START;
@@ -1585,7 +1896,7 @@ int sexp_buffered_read_char (sexp ctx, sexp p) {
              ? ((unsigned char*)sexp_port_buf(p))[sexp_port_offset(p)++] : EOF);
     }
   } else if (sexp_filenop(sexp_port_fd(p))) {
-    res = read(sexp_port_fileno(p), sexp_port_buf(p) + BUF_START, SEXP_PORT_BUFFER_SIZE - BUF_START);
+    res = read(sexp_port_fileno(p), sexp_port_buf(p) + BUF_START, sexp_port_buf_capacity(p) - BUF_START);
     if (res >= 0) {
       sexp_port_offset(p) = BUF_START;
       sexp_port_size(p) = res + BUF_START;
@@ -1594,18 +1905,17 @@ int sexp_buffered_read_char (sexp ctx, sexp p) {
     }
   } else if (sexp_port_customp(p)) {
     sexp_gc_preserve2(ctx, tmp, origbytes);
-    tmp = sexp_list2(ctx, sexp_make_fixnum(BUF_START), sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE));
     origbytes = sexp_port_binaryp(p) && !SEXP_USE_PACKED_STRINGS ? sexp_string_bytes(sexp_port_buffer(p)) : sexp_port_buffer(p);
-    tmp = sexp_cons(ctx, origbytes, tmp);
+    /* reuse the port's argument list, sexp_apply copies it to the stack */
+    tmp = sexp_port_frame(p);
+    sexp_car(tmp) = origbytes;
+    sexp_cadr(tmp) = sexp_make_fixnum(BUF_START);
+    sexp_caddr(tmp) = sexp_make_fixnum(sexp_port_buf_capacity(p));
     tmp = sexp_apply(ctx, sexp_port_reader(p), tmp);
+    sexp_sync_custom_port_buffer(ctx, p);
     if (sexp_fixnump(tmp) && sexp_unbox_fixnum(tmp) > BUF_START) {
       sexp_port_offset(p) = BUF_START;
       sexp_port_size(p) = sexp_unbox_fixnum(tmp);
-      if (!sexp_port_binaryp(p) && !SEXP_USE_PACKED_STRINGS
-          && origbytes != sexp_string_bytes(sexp_port_buffer(p))) {
-        /* handle resize */
-        memcpy(sexp_port_buf(p), sexp_string_data(sexp_port_buffer(p)), sexp_port_size(p));
-      }
       res = ((sexp_port_offset(p) < sexp_port_size(p))
              ? ((unsigned char*)sexp_port_buf(p))[sexp_port_offset(p)++] : EOF);
     } else {
@@ -1637,7 +1947,7 @@ int sexp_buffered_write_string_n (sexp ctx, const char *str,
     sexp_port_offset(p) = sexp_port_size(p);
     if ((res = sexp_buffered_flush(ctx, p, 0)))
       return written + diff;
-    written += sexp_port_size(p);
+    written += diff;
     str += diff;
     len -= diff;
   }
@@ -1650,6 +1960,106 @@ int sexp_buffered_write_string (sexp ctx, const char *str, sexp p) {
   return sexp_buffered_write_string_n(ctx, str, strlen(str), p);
 }
 
+/* move a string port's buffered output onto its chunk list.  A buffer */
+/* at least half full is handed over as is, viewed by a string without */
+/* copying, and replaced with one twice the size, so n bytes of output */
+/* take O(log n) chunks and are copied once, by get-output-string. */
+static int sexp_spill_string_port (sexp ctx, sexp p) {
+  sexp_sint_t off = sexp_port_offset(p), size = sexp_port_size(p);
+  int res = 0;
+  sexp_gc_var2(tmp, buf);
+  sexp_gc_preserve2(ctx, tmp, buf);
+#if ! SEXP_USE_PACKED_STRINGS
+  if (off >= size/2) {
+    if (size < SEXP_STRING_PORT_MAX_CHUNK_SIZE) size *= 2;
+    buf = sexp_make_bytes(ctx, sexp_make_fixnum(size), SEXP_VOID);
+    if (!sexp_exceptionp(buf))
+      tmp = sexp_alloc_type(ctx, string, SEXP_STRING);
+    if (sexp_exceptionp(buf) || sexp_exceptionp(tmp)) {
+      res = -1;
+    } else {
+      sexp_string_bytes(tmp) = sexp_car(sexp_port_cookie(p));
+      sexp_string_offset(tmp) = 0;
+      sexp_string_size(tmp) = off;
+#if SEXP_USE_STRING_INDEX_TABLE
+      sexp_string_charlens(tmp) = SEXP_FALSE;
+#endif
+      sexp_push(ctx, sexp_cdr(sexp_port_cookie(p)), tmp);
+      sexp_car(sexp_port_cookie(p)) = buf;
+      sexp_port_buf(p) = sexp_bytes_data(buf);
+      sexp_port_size(p) = size;
+      sexp_port_offset(p) = 0;
+    }
+  } else
+#endif
+  {
+    tmp = sexp_c_string(ctx, sexp_port_buf(p), off);
+    if (tmp && sexp_stringp(tmp)) {
+      sexp_push(ctx, sexp_cdr(sexp_port_cookie(p)), tmp);
+      sexp_port_offset(p) = 0;
+    } else {
+      res = -1;
+    }
+  }
+  sexp_gc_release2(ctx);
+  return res;
+}
+
+/* a vectored custom port queues each full buffer, and hands its */
+/* writer the whole list at once when SEXP_WRITEV_MAX_CHUNKS are */
+/* pending or the port is explicitly flushed or closed.  The chunks */
+/* field is a pair holding the pending chunks in its car.  A text */
+/* buffer's bytes are handed over to its chunk without copying, and */
+/* the port gets fresh ones, so the writer is free to keep chunks. */
+static int sexp_flush_vectored_port (sexp ctx, sexp p, int forcep) {
+  sexp_sint_t off = sexp_port_offset(p);
+  int res = 0;
+  sexp_gc_var2(tmp, bytes);
+  sexp_gc_preserve2(ctx, tmp, bytes);
+  if (off > 0) {
+#if ! SEXP_USE_PACKED_STRINGS
+    if (!sexp_port_binaryp(p)) {
+      bytes = sexp_make_bytes(ctx, sexp_make_fixnum(sexp_bytes_length(sexp_string_bytes(sexp_port_buffer(p)))), SEXP_VOID);
+      if (!sexp_exceptionp(bytes))
+        tmp = sexp_alloc_type(ctx, string, SEXP_STRING);
+      if (sexp_exceptionp(bytes) || sexp_exceptionp(tmp)) {
+        res = -1;
+      } else {
+        sexp_string_bytes(tmp) = sexp_string_bytes(sexp_port_buffer(p));
+        sexp_string_offset(tmp) = sexp_string_offset(sexp_port_buffer(p));
+        sexp_string_size(tmp) = off;
+#if SEXP_USE_STRING_INDEX_TABLE
+        sexp_string_charlens(tmp) = SEXP_FALSE;
+#endif
+        sexp_string_bytes(sexp_port_buffer(p)) = bytes;
+        sexp_port_buf(p) = sexp_string_data(sexp_port_buffer(p));
+      }
+    } else
+#endif
+    if (sexp_port_binaryp(p)) {
+      tmp = sexp_make_bytes(ctx, sexp_make_fixnum(off), SEXP_VOID);
+      if (sexp_bytesp(tmp)) memcpy(sexp_bytes_data(tmp), sexp_port_buf(p), off);
+    } else {
+      tmp = sexp_c_string(ctx, sexp_port_buf(p), off);
+    }
+    if (res || sexp_exceptionp(tmp)) {
+      res = -1;
+    } else {
+      sexp_push(ctx, sexp_car(sexp_port_chunks(p)), tmp);
+      sexp_port_offset(p) = 0;
+    }
+  }
+  if (res == 0 && sexp_pairp(sexp_car(sexp_port_chunks(p)))
+      && (forcep || sexp_unbox_fixnum(sexp_length(ctx, sexp_car(sexp_port_chunks(p)))) >= SEXP_WRITEV_MAX_CHUNKS)) {
+    bytes = sexp_nreverse(ctx, sexp_car(sexp_port_chunks(p)));
+    sexp_car(sexp_port_chunks(p)) = SEXP_NULL;
+    tmp = sexp_apply1(ctx, sexp_port_writer(p), bytes);
+    res = (sexp_fixnump(tmp) && sexp_unbox_fixnum(tmp) > 0) ? 0 : -1;
+  }
+  sexp_gc_release2(ctx);
+  return res;
+}
+
 int sexp_buffered_flush (sexp ctx, sexp p, int forcep) {
   sexp_sint_t res = 0, off;
   sexp_gc_var1(tmp);
@@ -1676,23 +2086,23 @@ int sexp_buffered_flush (sexp ctx, sexp p, int forcep) {
     }
   } else if (!sexp_port_openp(p)) {
     return -1;
-  } else if (sexp_port_offset(p) > 0) {
+  } else if (sexp_port_offset(p) > 0
+             || (forcep && sexp_port_customp(p) && sexp_pairp(sexp_port_chunks(p))
+                 && sexp_pairp(sexp_car(sexp_port_chunks(p))))) {
     sexp_gc_preserve1(ctx, tmp);
-    if (sexp_port_customp(p)) {   /* custom port */
-      tmp = sexp_list2(ctx, SEXP_ZERO, sexp_make_fixnum(sexp_port_offset(p)));
-      tmp = sexp_cons(ctx, sexp_port_binaryp(p) ? sexp_string_bytes(sexp_port_buffer(p)) : sexp_port_buffer(p), tmp);
+    if (sexp_port_customp(p) && sexp_pairp(sexp_port_chunks(p))) {
+      res = sexp_flush_vectored_port(ctx, p, forcep);
+    } else if (sexp_port_customp(p)) {   /* custom port */
+      tmp = sexp_port_frame(p);
+      sexp_car(tmp) = sexp_port_binaryp(p) ? sexp_string_bytes(sexp_port_buffer(p)) : sexp_port_buffer(p);
+      sexp_cadr(tmp) = SEXP_ZERO;
+      sexp_caddr(tmp) = sexp_make_fixnum(sexp_port_offset(p));
       tmp = sexp_apply(ctx, sexp_port_writer(p), tmp);
+      sexp_sync_custom_port_buffer(ctx, p);
       sexp_port_offset(p) = 0;
       res = (sexp_fixnump(tmp) && sexp_unbox_fixnum(tmp) > 0) ? 0 : -1;
     } else {                      /* string port */
-      tmp = sexp_c_string(ctx, sexp_port_buf(p), off);
-      if (tmp && sexp_stringp(tmp)) {
-        sexp_push(ctx, sexp_cdr(sexp_port_cookie(p)), tmp);
-        sexp_port_offset(p) = 0;
-        res = 0;
-      } else {
-        res = -1;
-      }
+      res = sexp_spill_string_port(ctx, p);
     }
     sexp_gc_release1(ctx);
   }
@@ -1712,19 +2122,24 @@ sexp sexp_open_input_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp str) {
   return res;
 }
 
-sexp sexp_open_output_string_op (sexp ctx, sexp self, sexp_sint_t n) {
+sexp sexp_open_output_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp size_hint) {
+  sexp_sint_t size = SEXP_PORT_BUFFER_SIZE;
   sexp_gc_var1(res);
+  if (sexp_fixnump(size_hint) && sexp_unbox_fixnum(size_hint) > size)
+    size = sexp_unbox_fixnum(size_hint);
+  else if (sexp_truep(size_hint) && !sexp_fixnump(size_hint))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, size_hint);
   sexp_gc_preserve1(ctx, res);
   res = sexp_make_output_port(ctx, NULL, SEXP_FALSE);
   if (!sexp_exceptionp(res)) {
     sexp_port_cookie(res) = sexp_cons(ctx, SEXP_FALSE, SEXP_NULL);
     sexp_car(sexp_port_cookie(res)) =
-      sexp_make_bytes(ctx, sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE), SEXP_VOID);
+      sexp_make_bytes(ctx, sexp_make_fixnum(size), SEXP_VOID);
     if (sexp_exceptionp(sexp_car(sexp_port_cookie(res)))) {
       res = sexp_car(sexp_port_cookie(res));
     } else {
       sexp_port_buf(res) = sexp_bytes_data(sexp_car(sexp_port_cookie(res)));
-      sexp_port_size(res) = SEXP_PORT_BUFFER_SIZE;
+      sexp_port_size(res) = size;
       sexp_port_offset(res) = 0;
       sexp_port_binaryp(res) = 0;
     }
@@ -1733,45 +2148,106 @@ sexp sexp_open_output_string_op (sexp ctx, sexp self, sexp_sint_t n) {
   return res;
 }
 
-sexp sexp_get_output_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp out) {
-  sexp res;
-  sexp_gc_var3(ls, rev, tmp);
+/* validate a string port, returning the total size of its output */
+static sexp sexp_output_string_size (sexp ctx, sexp self, sexp out) {
+  sexp ls;
+  sexp_sint_t len;
   sexp_assert_type(ctx, sexp_oportp, SEXP_OPORT, out);
   if (!sexp_port_openp(out))
     return sexp_xtype_exception(ctx, self, "output port is closed", out);
   if (!sexp_pairp(sexp_port_cookie(out)))
     return sexp_xtype_exception(ctx, self, "not a string output port", out);
-  sexp_gc_preserve3(ctx, ls, rev, tmp);
-  if (sexp_port_offset(out) > 0) {
-    tmp = sexp_c_string(ctx, sexp_port_buf(out), sexp_port_offset(out));
-    rev = sexp_cons(ctx, tmp, sexp_cdr(sexp_port_cookie(out)));
-  } else {
-    rev = sexp_cdr(sexp_port_cookie(out));
-  }
-  ls = sexp_reverse(ctx, rev);
-  res = SEXP_FALSE;
-  for (tmp = ls; sexp_pairp(tmp); tmp = sexp_cdr(tmp))
-    if (!sexp_stringp(sexp_car(tmp)))
-      res = sexp_xtype_exception(ctx, self, "not an output string port", out);
-  if (!sexp_nullp(tmp))
-    res = sexp_xtype_exception(ctx, self, "not an output string port", out);
-  if (!sexp_exceptionp(res))
-    res = sexp_string_concatenate(ctx, ls, SEXP_FALSE);
-  sexp_gc_release3(ctx);
+  len = sexp_port_offset(out);
+  for (ls = sexp_cdr(sexp_port_cookie(out)); sexp_pairp(ls); ls = sexp_cdr(ls))
+    if (!sexp_stringp(sexp_car(ls)))
+      return sexp_xtype_exception(ctx, self, "not an output string port", out);
+    else
+      len += sexp_string_size(sexp_car(ls));
+  if (!sexp_nullp(ls))
+    return sexp_xtype_exception(ctx, self, "not an output string port", out);
+  return sexp_make_fixnum(len);
+}
+
+sexp sexp_get_output_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp out) {
+  sexp ls, res = sexp_output_string_size(ctx, self, out);
+  char *p;
+  if (sexp_exceptionp(res)) return res;
+  res = sexp_make_string(ctx, res, SEXP_VOID);
+  if (sexp_exceptionp(res)) return res;
+  /* the chunks are newest first, so fill the result from the end */
+  p = sexp_string_data(res) + sexp_string_size(res) - sexp_port_offset(out);
+  memcpy(p, sexp_port_buf(out), sexp_port_offset(out));
+  for (ls = sexp_cdr(sexp_port_cookie(out)); sexp_pairp(ls); ls = sexp_cdr(ls)) {
+    p -= sexp_string_size(sexp_car(ls));
+    memcpy(p, sexp_string_data(sexp_car(ls)), sexp_string_size(sexp_car(ls)));
+  }
+  sexp_update_string_index_lookup(ctx, res);
   return res;
 }
 
+/* write the output accumulated so far in string port out to dst */
+/* without concatenating it, using writev for file descriptor ports */
+sexp sexp_write_output_string_op (sexp ctx, sexp self, sexp_sint_t n, sexp out, sexp dst) {
+  sexp ls, res = sexp_output_string_size(ctx, self, out);
+  sexp_sint_t i, k, len;
+  struct iovec *iov;
+  if (sexp_exceptionp(res)) return res;
+  sexp_assert_type(ctx, sexp_oportp, SEXP_OPORT, dst);
+  if (!sexp_port_openp(dst))
+    return sexp_xtype_exception(ctx, self, "output port is closed", dst);
+  if (dst == out)
+    return sexp_xtype_exception(ctx, self, "can't write a port to itself", dst);
+  for (k = 0, ls = sexp_cdr(sexp_port_cookie(out)); sexp_pairp(ls); ls = sexp_cdr(ls))
+    k++;
+  iov = (struct iovec*) malloc((k+1) * sizeof(struct iovec));
+  if (!iov)
+    return sexp_global(ctx, SEXP_G_OOM_ERROR);
+  /* the chunks are newest first, followed by the live buffer */
+  for (i = k, ls = sexp_cdr(sexp_port_cookie(out)); sexp_pairp(ls); ls = sexp_cdr(ls)) {
+    iov[--i].iov_base = sexp_string_data(sexp_car(ls));
+    iov[i].iov_len = sexp_string_size(sexp_car(ls));
+  }
+  iov[k].iov_base = sexp_port_buf(out);
+  iov[k++].iov_len = sexp_port_offset(out);
+  i = 0;
+#if SEXP_USE_WRITEV
+  if (sexp_filenop(sexp_port_fd(dst)) && !sexp_port_stream(dst)) {
+    sexp_flush(ctx, dst);
+    while (i < k && sexp_port_offset(dst) == 0) {
+      len = writev(sexp_port_fileno(dst), iov + i,
+                   k - i < SEXP_WRITEV_MAX_CHUNKS ? k - i : SEXP_WRITEV_MAX_CHUNKS);
+      if (len < 0) {
+        if (errno == EINTR) continue;
+        break;  /* leave the rest to the buffered writes below */
+      }
+      for ( ; i < k && len >= (sexp_sint_t)iov[i].iov_len; i++)
+        len -= iov[i].iov_len;
+      if (i < k) {
+        iov[i].iov_base = (char*)iov[i].iov_base + len;
+        iov[i].iov_len -= len;
+      }
+    }
+  }
+#endif
+  for ( ; i < k; i++)
+    sexp_write_string_n(ctx, (char*)iov[i].iov_base, iov[i].iov_len, dst);
+  free(iov);
+  return SEXP_VOID;
+}
+
 sexp sexp_open_input_file_descriptor (sexp ctx, sexp self, sexp_sint_t n, sexp fileno, sexp shutdownp) {
+  sexp_sint_t size;
   sexp_gc_var2(res, str);
   sexp_assert_type(ctx, sexp_filenop, SEXP_FILENO, fileno);
   if (sexp_fileno_fd(fileno) < 0)
     return sexp_file_exception(ctx, self, "invalid file descriptor", fileno);
   sexp_gc_preserve2(ctx, res, str);
-  str = sexp_make_string(ctx, sexp_make_fixnum(SEXP_PORT_BUFFER_SIZE), SEXP_VOID);
+  size = sexp_default_port_buffer_size(sexp_fileno_fd(fileno));
+  str = sexp_make_string(ctx, sexp_make_fixnum(size), SEXP_VOID);
   res = sexp_open_input_string(ctx, str);
   if (!sexp_exceptionp(res)) {
     sexp_port_fd(res) = fileno;
-    sexp_port_offset(res) = SEXP_PORT_BUFFER_SIZE;
+    sexp_port_offset(res) = size;
     sexp_port_binaryp(res) = 1;
     sexp_port_shutdownp(res) = sexp_truep(shutdownp);
     sexp_fileno_count(fileno)++;
@@ -1789,6 +2265,103 @@ sexp sexp_open_output_file_descriptor (sexp ctx, sexp self, sexp_sint_t n, sexp
   return res;
 }
 
+#if SEXP_USE_MMAP_PORTS
+sexp sexp_open_mmap_input_file_op (sexp ctx, sexp self, sexp_sint_t n, sexp path, sexp binaryp) {
+  int fd;
+  struct stat st;
+  void *addr = MAP_FAILED;
+  sexp_gc_var2(res, ptr);
+  sexp_assert_type(ctx, sexp_stringp, SEXP_STRING, path);
+  fd = open(sexp_string_data(path), O_RDONLY);
+  if (fd < 0)
+    return sexp_file_exception(ctx, self, "couldn't open input file", path);
+  /* map writably but privately so pushing back a char is always safe */
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    addr = mmap(NULL, st.st_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  sexp_gc_preserve2(ctx, res, ptr);
+  if (addr == MAP_FAILED) {
+    /* empty files, pipes and devices fall back to an fd port */
+#if SEXP_USE_GREEN_THREADS
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+#endif
+    ptr = sexp_make_fileno(ctx, sexp_make_fixnum(fd), SEXP_FALSE);
+    res = sexp_exceptionp(ptr) ? ptr
+      : sexp_open_input_file_descriptor(ctx, self, 2, ptr, SEXP_FALSE);
+  } else {
+    close(fd);
+    res = sexp_make_input_port(ctx, NULL, path);
+    if (!sexp_exceptionp(res))
+      ptr = sexp_make_cpointer(ctx, SEXP_CPOINTER, addr, SEXP_FALSE, 0);
+    if (sexp_exceptionp(res) || sexp_exceptionp(ptr)) {
+      munmap(addr, st.st_size);
+      if (!sexp_exceptionp(res)) res = ptr;
+    } else {
+      /* the mapping's length is the port's size, which never changes */
+      sexp_port_cookie(res) = ptr;
+      sexp_port_buf(res) = (char*)addr;
+      sexp_port_offset(res) = 0;
+      sexp_port_size(res) = st.st_size;
+    }
+  }
+  if (sexp_portp(res))
+    sexp_port_binaryp(res) = sexp_truep(binaryp);
+  sexp_gc_release2(ctx);
+  return res;
+}
+#endif
+
+sexp sexp_set_port_buffer_size_op (sexp ctx, sexp self, sexp_sint_t n, sexp port, sexp size) {
+  sexp_sint_t len, pending;
+  sexp_gc_var1(buf);
+  sexp_assert_type(ctx, sexp_portp, SEXP_IPORT, port);
+  sexp_assert_type(ctx, sexp_fixnump, SEXP_FIXNUM, size);
+  len = sexp_unbox_fixnum(size);
+  if (!sexp_port_openp(port))
+    return sexp_xtype_exception(ctx, self, "port is closed", port);
+  if (sexp_port_stream(port))
+    return sexp_xtype_exception(ctx, self, "can't resize a stdio port's buffer after opening", port);
+  if (sexp_iportp(port) && !sexp_filenop(sexp_port_fd(port))
+      && !sexp_port_customp(port))
+    return sexp_xtype_exception(ctx, self, "string input ports have no separate buffer", port);
+  if (sexp_oportp(port)) {
+    if (sexp_port_offset(port) > 0)
+      sexp_flush(ctx, port);
+    pending = sexp_port_offset(port);
+  } else {
+    pending = sexp_port_size(port) - sexp_port_offset(port);
+  }
+  if (len < 2*BUF_START || len < pending + BUF_START)
+    return sexp_xtype_exception(ctx, self, "port buffer size too small", size);
+  sexp_gc_preserve1(ctx, buf);
+  if (sexp_pairp(sexp_port_cookie(port)))
+    buf = sexp_make_bytes(ctx, size, SEXP_VOID);
+  else
+    buf = sexp_make_string(ctx, size, SEXP_VOID);
+  if (!sexp_exceptionp(buf)) {
+    /* move any pending data to the new buffer */
+    if (sexp_oportp(port)) {
+      memcpy(sexp_stringp(buf) ? sexp_string_data(buf) : sexp_bytes_data(buf),
+             sexp_port_buf(port), pending);
+      sexp_port_size(port) = len;
+    } else {
+      memcpy(sexp_string_data(buf) + BUF_START,
+             sexp_port_buf(port) + sexp_port_offset(port), pending);
+      sexp_port_offset(port) = BUF_START;
+      sexp_port_size(port) = BUF_START + pending;
+    }
+    if (sexp_port_customp(port))
+      sexp_vector_set(sexp_port_cookie(port), SEXP_ONE, buf);
+    else if (sexp_pairp(sexp_port_cookie(port)))
+      sexp_car(sexp_port_cookie(port)) = buf;
+    else
+      sexp_port_cookie(port) = buf;
+    sexp_port_buf(port) = sexp_stringp(buf) ? sexp_string_data(buf) : sexp_bytes_data(buf);
+    buf = SEXP_VOID;
+  }
+  sexp_gc_release1(ctx);
+  return buf;
+}
+
 #if SEXP_USE_WEAK_REFERENCES
 sexp sexp_make_ephemeron_op(sexp ctx, sexp self, sexp_sint_t n, sexp key, sexp value) {
   sexp res = sexp_alloc_type(ctx, pair, SEXP_EPHEMERON);
@@ -2066,6 +2639,403 @@ sexp sexp_char_ready_p (sexp ctx, sexp self, sexp_sint_t n, sexp in) {
 
 #define NUMBUF_LEN 32
 
+#if SEXP_USE_FLONUMS
+
+/* Shortest round-trip flonum output using Grisu3 from Loitsch, */
+/* "Printing Floating-Point Numbers Quickly and Accurately with */
+/* Integers".  Grisu3 rejects the ~0.5% of values for which it can't */
+/* prove its digits are the shortest, and those fall back to printf. */
+
+typedef struct {unsigned long long f; int e;} sexp_diy_fp;
+
+/* normalized approximations of 10^k for k = -348, -340, ..., 340 */
+static const struct {unsigned long long f; short e, k;} sexp_cached_pow10[] = {
+  {0xfa8fd5a0081c0288ULL, -1220, -348},
+  {0xbaaee17fa23ebf76ULL, -1193, -340},
+  {0x8b16fb203055ac76ULL, -1166, -332},
+  {0xcf42894a5dce35eaULL, -1140, -324},
+  {0x9a6bb0aa55653b2dULL, -1113, -316},
+  {0xe61acf033d1a45dfULL, -1087, -308},
+  {0xab70fe17c79ac6caULL, -1060, -300},
+  {0xff77b1fcbebcdc4fULL, -1034, -292},
+  {0xbe5691ef416bd60cULL, -1007, -284},
+  {0x8dd01fad907ffc3cULL, -980, -276},
+  {0xd3515c2831559a83ULL, -954, -268},
+  {0x9d71ac8fada6c9b5ULL, -927, -260},
+  {0xea9c227723ee8bcbULL, -901, -252},
+  {0xaecc49914078536dULL, -874, -244},
+  {0x823c12795db6ce57ULL, -847, -236},
+  {0xc21094364dfb5637ULL, -821, -228},
+  {0x9096ea6f3848984fULL, -794, -220},
+  {0xd77485cb25823ac7ULL, -768, -212},
+  {0xa086cfcd97bf97f4ULL, -741, -204},
+  {0xef340a98172aace5ULL, -715, -196},
+  {0xb23867fb2a35b28eULL, -688, -188},
+  {0x84c8d4dfd2c63f3bULL, -661, -180},
+  {0xc5dd44271ad3cdbaULL, -635, -172},
+  {0x936b9fcebb25c996ULL, -608, -164},
+  {0xdbac6c247d62a584ULL, -582, -156},
+  {0xa3ab66580d5fdaf6ULL, -555, -148},
+  {0xf3e2f893dec3f126ULL, -529, -140},
+  {0xb5b5ada8aaff80b8ULL, -502, -132},
+  {0x87625f056c7c4a8bULL, -475, -124},
+  {0xc9bcff6034c13053ULL, -449, -116},
+  {0x964e858c91ba2655ULL, -422, -108},
+  {0xdff9772470297ebdULL, -396, -100},
+  {0xa6dfbd9fb8e5b88fULL, -369, -92},
+  {0xf8a95fcf88747d94ULL, -343, -84},
+  {0xb94470938fa89bcfULL, -316, -76},
+  {0x8a08f0f8bf0f156bULL, -289, -68},
+  {0xcdb02555653131b6ULL, -263, -60},
+  {0x993fe2c6d07b7facULL, -236, -52},
+  {0xe45c10c42a2b3b06ULL, -210, -44},
+  {0xaa242499697392d3ULL, -183, -36},
+  {0xfd87b5f28300ca0eULL, -157, -28},
+  {0xbce5086492111aebULL, -130, -20},
+  {0x8cbccc096f5088ccULL, -103, -12},
+  {0xd1b71758e219652cULL, -77, -4},
+  {0x9c40000000000000ULL, -50, 4},
+  {0xe8d4a51000000000ULL, -24, 12},
+  {0xad78ebc5ac620000ULL, 3, 20},
+  {0x813f3978f8940984ULL, 30, 28},
+  {0xc097ce7bc90715b3ULL, 56, 36},
+  {0x8f7e32ce7bea5c70ULL, 83, 44},
+  {0xd5d238a4abe98068ULL, 109, 52},
+  {0x9f4f2726179a2245ULL, 136, 60},
+  {0xed63a231d4c4fb27ULL, 162, 68},
+  {0xb0de65388cc8ada8ULL, 189, 76},
+  {0x83c7088e1aab65dbULL, 216, 84},
+  {0xc45d1df942711d9aULL, 242, 92},
+  {0x924d692ca61be758ULL, 269, 100},
+  {0xda01ee641a708deaULL, 295, 108},
+  {0xa26da3999aef774aULL, 322, 116},
+  {0xf209787bb47d6b85ULL, 348, 124},
+  {0xb454e4a179dd1877ULL, 375, 132},
+  {0x865b86925b9bc5c2ULL, 402, 140},
+  {0xc83553c5c8965d3dULL, 428, 148},
+  {0x952ab45cfa97a0b3ULL, 455, 156},
+  {0xde469fbd99a05fe3ULL, 481, 164},
+  {0xa59bc234db398c25ULL, 508, 172},
+  {0xf6c69a72a3989f5cULL, 534, 180},
+  {0xb7dcbf5354e9beceULL, 561, 188},
+  {0x88fcf317f22241e2ULL, 588, 196},
+  {0xcc20ce9bd35c78a5ULL, 614, 204},
+  {0x98165af37b2153dfULL, 641, 212},
+  {0xe2a0b5dc971f303aULL, 667, 220},
+  {0xa8d9d1535ce3b396ULL, 694, 228},
+  {0xfb9b7cd9a4a7443cULL, 720, 236},
+  {0xbb764c4ca7a44410ULL, 747, 244},
+  {0x8bab8eefb6409c1aULL, 774, 252},
+  {0xd01fef10a657842cULL, 800, 260},
+  {0x9b10a4e5e9913129ULL, 827, 268},
+  {0xe7109bfba19c0c9dULL, 853, 276},
+  {0xac2820d9623bf429ULL, 880, 284},
+  {0x80444b5e7aa7cf85ULL, 907, 292},
+  {0xbf21e44003acdd2dULL, 933, 300},
+  {0x8e679c2f5e44ff8fULL, 960, 308},
+  {0xd433179d9c8cb841ULL, 986, 316},
+  {0x9e19db92b4e31ba9ULL, 1013, 324},
+  {0xeb96bf6ebadf77d9ULL, 1039, 332},
+  {0xaf87023b9bf0ee6bULL, 1066, 340}
+};
+
+#define SEXP_CACHED_POW10_OFFSET 348
+#define SEXP_CACHED_POW10_STEP 8
+#define SEXP_GRISU_MIN_EXP (-60)
+
+static sexp_diy_fp sexp_diy_mul (sexp_diy_fp x, sexp_diy_fp y) {
+  unsigned long long m32 = 0xFFFFFFFFULL, a = x.f >> 32, b = x.f & m32,
+    c = y.f >> 32, d = y.f & m32, ac = a*c, bc = b*c, ad = a*d, bd = b*d, tmp;
+  sexp_diy_fp res;
+  tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1ULL << 31);
+  res.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  res.e = x.e + y.e + 64;
+  return res;
+}
+
+static sexp_diy_fp sexp_diy_normalize (sexp_diy_fp x) {
+  while (! (x.f & 0xFFC0000000000000ULL)) {x.f <<= 10; x.e -= 10;}
+  while (! (x.f & 0x8000000000000000ULL)) {x.f <<= 1; x.e--;}
+  return x;
+}
+
+static int sexp_grisu_round_weed (char *buf, int len,
+                                  unsigned long long dist_too_high_w,
+                                  unsigned long long unsafe,
+                                  unsigned long long rest,
+                                  unsigned long long ten_kappa,
+                                  unsigned long long unit) {
+  unsigned long long small_dist = dist_too_high_w - unit,
+    big_dist = dist_too_high_w + unit;
+  while (rest < small_dist && unsafe - rest >= ten_kappa
+         && (rest + ten_kappa < small_dist
+             || small_dist - rest >= rest + ten_kappa - small_dist)) {
+    buf[len-1]--;
+    rest += ten_kappa;
+  }
+  if (rest < big_dist && unsafe - rest >= ten_kappa
+      && (rest + ten_kappa < big_dist
+          || big_dist - rest > rest + ten_kappa - big_dist))
+    return 0;
+  return 2*unit <= rest && rest <= unsafe - 4*unit;
+}
+
+/* writes the shortest digits of positive finite f to buf such that */
+/* f = digits * 10^*exp10, returning the number of digits or 0 if */
+/* they can't be determined */
+static int sexp_grisu3 (double f, char *buf, int *exp10) {
+  unsigned long long bits, integrals, fractionals, divisor, unit = 1;
+  sexp_diy_fp w, lo, hi, c, too_low, too_high, one;
+  unsigned long long unsafe;
+  int i, k, kappa, len = 0, biased_e;
+  memcpy(&bits, &f, sizeof(bits));
+  biased_e = (int)((bits >> 52) & 0x7FF);
+  w.f = bits & 0xFFFFFFFFFFFFFULL;
+  if (biased_e) {
+    w.f |= 0x10000000000000ULL;
+    w.e = biased_e - 1075;
+  } else {
+    w.e = -1074;
+  }
+  /* the boundaries halfway to the neighboring doubles */
+  hi.f = (w.f << 1) + 1; hi.e = w.e - 1;
+  hi = sexp_diy_normalize(hi);
+  if (w.f == 0x10000000000000ULL && biased_e > 1) {
+    lo.f = (w.f << 2) - 1; lo.e = w.e - 2;
+  } else {
+    lo.f = (w.f << 1) - 1; lo.e = w.e - 1;
+  }
+  lo.f <<= lo.e - hi.e; lo.e = hi.e;
+  w = sexp_diy_normalize(w);
+  /* scale by a cached 10^k so the product's exponent is in [-60, -32] */
+  k = (int)ceil((SEXP_GRISU_MIN_EXP - (w.e + 64) + 63) * 0.30102999566398114);
+  i = (SEXP_CACHED_POW10_OFFSET + k - 1) / SEXP_CACHED_POW10_STEP + 1;
+  c.f = sexp_cached_pow10[i].f; c.e = sexp_cached_pow10[i].e;
+  w = sexp_diy_mul(w, c);
+  lo = sexp_diy_mul(lo, c);
+  hi = sexp_diy_mul(hi, c);
+  /* generate digits of too_high until inside the unsafe interval */
+  too_low.f = lo.f - unit; too_low.e = lo.e;
+  too_high.f = hi.f + unit; too_high.e = hi.e;
+  unsafe = too_high.f - too_low.f;
+  one.f = 1ULL << -w.e; one.e = w.e;
+  integrals = too_high.f >> -one.e;
+  fractionals = too_high.f & (one.f - 1);
+  for (kappa = 10, divisor = 1000000000; divisor > integrals; kappa--)
+    divisor /= 10;
+  while (kappa > 0) {
+    buf[len++] = (char)('0' + integrals / divisor);
+    integrals %= divisor;
+    kappa--;
+    if ((integrals << -one.e) + fractionals < unsafe) {
+      *exp10 = kappa - sexp_cached_pow10[i].k;
+      return sexp_grisu_round_weed(buf, len, too_high.f - w.f, unsafe,
+                                   (integrals << -one.e) + fractionals,
+                                   divisor << -one.e, unit) ? len : 0;
+    }
+    divisor /= 10;
+  }
+  for (;;) {
+    fractionals *= 10;
+    unit *= 10;
+    unsafe *= 10;
+    buf[len++] = (char)('0' + (fractionals >> -one.e));
+    fractionals &= one.f - 1;
+    kappa--;
+    if (fractionals < unsafe) {
+      *exp10 = kappa - sexp_cached_pow10[i].k;
+      return sexp_grisu_round_weed(buf, len, (too_high.f - w.f) * unit,
+                                   unsafe, fractionals, one.f, unit) ? len : 0;
+    }
+  }
+}
+
+int sexp_double_to_chars (double f, char *buf) {
+  char digits[20], *s = buf, *e;
+  int i, len, exp10, x;
+  double tmp;
+#if SEXP_USE_INFINITIES
+  if (isinf(f) || isnan(f)) {
+    strcpy(buf, isnan(f) ? "+nan.0" : f < 0 ? "-inf.0" : "+inf.0");
+    return 6;
+  }
+#endif
+  if (signbit(f)) {
+    *s++ = '-';
+    f = -f;
+  }
+  if (f == 0) {
+    strcpy(s, "0.0");
+    return s - buf + 3;
+  }
+  len = sexp_grisu3(f, digits, &exp10);
+  if (! len) {
+    i = snprintf(s, SEXP_DOUBLE_BUF_LEN-1, "%.15lg", f);
+    if (sscanf(s, "%lg", &tmp) == 1 && tmp != f) {
+      i = snprintf(s, SEXP_DOUBLE_BUF_LEN-1, "%.16lg", f);
+      if (sscanf(s, "%lg", &tmp) == 1 && tmp != f)
+        i = snprintf(s, SEXP_DOUBLE_BUF_LEN-1, "%.17lg", f);
+    }
+    if (!strchr(s, '.')) {
+      e = strchr(s, 'e');
+      x = e ? e - s : i;
+      memmove(s + x + 2, s + x, i - x + 1);
+      s[x] = '.'; s[x+1] = '0';
+      i += 2;
+    }
+    return s - buf + i;
+  }
+  /* lay the digits out as %.<n>lg would for n = max(len, 15), but */
+  /* always with a decimal point */
+  x = exp10 + len - 1;
+  if (x < -4 || x >= (len > 15 ? len : 15)) {
+    *s++ = digits[0];
+    *s++ = '.';
+    if (len > 1) {
+      memcpy(s, digits+1, len-1);
+      s += len-1;
+    } else {
+      *s++ = '0';
+    }
+    *s++ = 'e';
+    *s++ = (x < 0 ? '-' : '+');
+    if (x < 0) x = -x;
+    if (x >= 100) *s++ = (char)('0' + x/100);
+    *s++ = (char)('0' + x/10%10);
+    *s++ = (char)('0' + x%10);
+  } else if (x < 0) {
+    *s++ = '0'; *s++ = '.';
+    for (i = -1; i > x; i--) *s++ = '0';
+    memcpy(s, digits, len);
+    s += len;
+  } else if (len <= x + 1) {
+    memcpy(s, digits, len);
+    s += len;
+    for (i = len; i <= x; i++) *s++ = '0';
+    *s++ = '.'; *s++ = '0';
+  } else {
+    memcpy(s, digits, x + 1);
+    s += x + 1;
+    *s++ = '.';
+    memcpy(s, digits + x + 1, len - x - 1);
+    s += len - x - 1;
+  }
+  *s = '\0';
+  return s - buf;
+}
+
+
+static const double sexp_exact_pow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static double sexp_diy_to_double (sexp_diy_fp x) {
+  unsigned long long bits;
+  double res;
+  while (x.f > 0x1FFFFFFFFFFFFFULL) {x.f >>= 1; x.e++;}
+  if (x.e >= 972)
+    return HUGE_VAL;
+  if (x.e < -1074)
+    return 0.0;
+  while (x.e > -1074 && ! (x.f & 0x10000000000000ULL)) {x.f <<= 1; x.e--;}
+  bits = (x.f & 0xFFFFFFFFFFFFFULL)
+    | ((unsigned long long)((x.e == -1074 && ! (x.f & 0x10000000000000ULL)) ? 0 : x.e + 1075) << 52);
+  memcpy(&res, &bits, sizeof(res));
+  return res;
+}
+
+/* approximates m * 10^exp10 for m of at most 19 digits with the */
+/* cached powers, tracking the error in eighths of an ulp, and */
+/* returns 0 if it's too close to halfway between doubles to round */
+static int sexp_diy_strtod (unsigned long long m, int len, long exp10, double *res) {
+  sexp_diy_fp x, c;
+  unsigned long long error = 0, half_way, low_bits;
+  int i, r, old_e, mag, sig_size, prec, shift;
+  x.f = m; x.e = 0;
+  x = sexp_diy_normalize(x);
+  i = (int)((exp10 + SEXP_CACHED_POW10_OFFSET) / SEXP_CACHED_POW10_STEP);
+  r = (int)(exp10 - sexp_cached_pow10[i].k);
+  if (r > 0) {
+    c.f = (unsigned long long)sexp_exact_pow10[r]; c.e = 0;
+    x = sexp_diy_mul(x, sexp_diy_normalize(c));
+    if (19 - len < r) error += 4;
+  }
+  c.f = sexp_cached_pow10[i].f; c.e = sexp_cached_pow10[i].e;
+  x = sexp_diy_mul(x, c);
+  error += 4 + (error ? 1 : 0) + 4;
+  old_e = x.e;
+  x = sexp_diy_normalize(x);
+  error <<= old_e - x.e;
+  /* the number of low bits rounded off, more for denormals */
+  mag = 64 + x.e;
+  sig_size = mag >= -1074 + 53 ? 53 : mag <= -1074 ? 0 : mag + 1074;
+  prec = 64 - sig_size;
+  if (prec + 3 >= 64) {
+    shift = prec + 3 - 64 + 1;
+    x.f >>= shift; x.e += shift;
+    error = (error >> shift) + 1 + 8;
+    prec -= shift;
+  }
+  low_bits = (x.f & ((1ULL << prec) - 1)) * 8;
+  half_way = (1ULL << (prec - 1)) * 8;
+  x.f >>= prec; x.e += prec;
+  if (low_bits >= half_way + error)
+    x.f++;
+  if (half_way - error < low_bits && low_bits < half_way + error)
+    return 0;
+  *res = sexp_diy_to_double(x);
+  return 1;
+}
+
+/* returns the double nearest digits * 10^exp10.  Mantissas up to 2^53 */
+/* with small exponents need a single correctly rounded multiply or */
+/* divide (Clinger's fast path), up to 19 digits are approximated with */
+/* the cached powers when that's unambiguous, and anything else is left */
+/* to strtod on the exponent-only form, which avoids the locale's */
+/* decimal point.  Callers may drop digits past SEXP_MAX_DECIMAL_DIGITS */
+/* if they append a '1' when any dropped digit was nonzero. */
+double sexp_decimal_to_double (const char *digits, int len, long exp10) {
+  char buf[SEXP_MAX_DECIMAL_DIGITS + 24];
+  unsigned long long m = 0, m2;
+  double res;
+  long e;
+  int i;
+  while (len > 0 && *digits == '0')
+    digits++, len--;
+  while (len > 0 && digits[len-1] == '0')
+    len--, exp10++;
+  if (len == 0 || exp10 + len <= -324)
+    return 0.0;
+  if (exp10 + len - 1 >= 309)
+    return HUGE_VAL;
+  if (len <= 19) {
+    for (i=0; i<len; i++)
+      m = m*10 + (digits[i] - '0');
+#if ! defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+    if (m <= (1ULL<<53)) {
+      if (exp10 < 0 && exp10 >= -22)
+        return (double)m / sexp_exact_pow10[-exp10];
+      for (e = exp10, m2 = m; e > 22 && m2 <= (1ULL<<53)/10; e--)
+        m2 *= 10;
+      if (e >= 0 && e <= 22)
+        return (double)m2 * sexp_exact_pow10[e];
+    }
+#endif
+    if (sexp_diy_strtod(m, len, exp10, &res))
+      return res;
+  }
+  if (len > SEXP_MAX_DECIMAL_DIGITS + 1) {
+    exp10 += len - SEXP_MAX_DECIMAL_DIGITS - 1;
+    len = SEXP_MAX_DECIMAL_DIGITS + 1;
+  }
+  memcpy(buf, digits, len);
+  snprintf(buf + len, sizeof(buf) - len, "e%ld", exp10);
+  return strtod(buf, NULL);
+}
+
+#endif
+
 static struct {const char* name; char ch;} sexp_char_names[] = {
   {"newline", '\n'},
   {"return", '\r'},
@@ -2088,8 +3058,8 @@ sexp sexp_write_one (sexp ctx, sexp obj, sexp out, sexp_sint_t bound) {
 #endif
   sexp_uint_t len, c;
   sexp_sint_t i=0;
-#if SEXP_USE_FLONUMS
-  double f, ftmp;
+#if SEXP_USE_IMMEDIATE_FLONUMS
+  double f;
 #endif
 #if SEXP_USE_BYTEVECTOR_LITERALS && SEXP_BYTEVECTOR_HEX_LITERALS
   char buf[5];
@@ -2141,25 +3111,7 @@ sexp sexp_write_one (sexp ctx, sexp obj, sexp out, sexp_sint_t bound) {
 #if SEXP_USE_FLONUMS
 #if ! SEXP_USE_IMMEDIATE_FLONUMS
     case SEXP_FLONUM:
-      f = sexp_flonum_value(obj);
-#if SEXP_USE_INFINITIES
-      if (isinf(f) || isnan(f)) {
-        numbuf[0] = (isinf(f) && f < 0 ? '-' : '+');
-        strncpy(numbuf+1, isinf(f) ? "inf.0" : "nan.0", NUMBUF_LEN-1);
-      } else
-#endif
-      {
-        i = snprintf(numbuf, NUMBUF_LEN, "%.15lg", f);
-        if (sscanf(numbuf, "%lg", &ftmp) == 1 && ftmp != f) {
-          i = snprintf(numbuf, NUMBUF_LEN, "%.16lg", f);
-          if (sscanf(numbuf, "%lg", &ftmp) == 1 && ftmp != f) {
-            i = snprintf(numbuf, NUMBUF_LEN, "%.17lg", f);
-          }
-        }
-        if (!strchr(numbuf, '.') && !strchr(numbuf, 'e')) {
-          numbuf[i++] = '.'; numbuf[i++] = '0'; numbuf[i++] = '\0';
-        }
-      }
+      sexp_double_to_chars(sexp_flonum_value(obj), numbuf);
       sexp_write_string(ctx, numbuf, out);
       break;
 #endif
@@ -2438,6 +3390,271 @@ sexp sexp_write_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp out) {
   return res;
 }
 
+#if SEXP_USE_NATIVE_WRITE_SHARED
+/* Shared structure for write and write-shared.  Pairs, vectors and  */
+/* objects with the default brace printer are nodes.  Small acyclic */
+/* data is recognized by a walk without any bookkeeping, which can't */
+/* terminate on a cycle, so it gives up after a fixed budget.  The   */
+/* top level list spine isn't charged, and checks for a cdr cycle    */
+/* with a tortoise and hare instead, so long flat lists stay on the  */
+/* fast path.  Other data gets a pointer table marking which nodes   */
+/* need labels.  Data nested past SEXP_DEFAULT_WRITE_BOUND, where     */
+/* sexp_write_one would write "...", is left to the general writer.  */
+
+#define SEXP_WRITE_SHARED_BUDGET 10000
+
+#define SEXP_SHARED_VISITING 1
+#define SEXP_SHARED_DONE     2
+#define SEXP_SHARED_LABEL    4
+
+struct sexp_shared_labels {
+  sexp *keys;
+  sexp_sint_t *vals;   /* flags while scanning, then 0, -1 or label+1 */
+  sexp_uint_t size, count;
+  sexp_sint_t next;
+};
+
+/* 1 for pairs and vectors, 2 for brace printed objects, 0 for leaves */
+/* and -1 for objects with a custom printer, which we can't follow   */
+static int sexp_shared_node_kind (sexp ctx, sexp x) {
+  sexp t;
+  if (sexp_pairp(x) || sexp_vectorp(x)) return 1;
+  if (! sexp_pointerp(x) || sexp_pointer_tag(x) >= sexp_context_num_types(ctx))
+    return 0;
+  t = sexp_object_type(ctx, x);
+  if (! (sexp_typep(t) && sexp_type_print(t) && sexp_truep(sexp_type_print(t))))
+    return 0;
+#if SEXP_USE_OBJECT_BRACE_LITERALS
+  if (sexp_opcodep(sexp_type_print(t))
+      && sexp_opcode_func(sexp_type_print(t)) == (sexp_proc1)sexp_write_simple_object)
+    return 2;
+#endif
+  return -1;
+}
+
+/* returns the remaining budget, or -1 if exhausted or unsupported */
+static sexp_sint_t sexp_shared_tree_walk (sexp ctx, sexp x, sexp_sint_t budget, sexp_sint_t depth) {
+  sexp_sint_t i, len;
+  sexp slow = x;
+  int kind, step = 0;
+  while (budget >= 0) {
+    if (! (kind = sexp_shared_node_kind(ctx, x)))
+      return budget;
+    if (kind < 0 || depth >= SEXP_DEFAULT_WRITE_BOUND - 1)
+      return -1;
+    if (sexp_pairp(x)) {
+      budget = sexp_shared_tree_walk(ctx, sexp_car(x), budget, depth+1);
+      x = sexp_cdr(x);
+      if (! sexp_pairp(x)) {
+        depth++;              /* a dotted tail is written one level down */
+      } else if (depth > 0) {
+        budget--;
+      } else {
+        if ((step ^= 1) == 0)
+          slow = sexp_cdr(slow);
+        if (x == slow)
+          return -1;
+      }
+      continue;
+    }
+    len = sexp_vectorp(x) ? sexp_vector_length(x)
+      : sexp_type_num_slots_of_object(sexp_object_type(ctx, x), x);
+    for (i=0; i<len && budget >= 0; i++)
+      budget = sexp_shared_tree_walk(ctx, sexp_vectorp(x) ? sexp_vector_ref(x, sexp_make_fixnum(i)) : sexp_slot_ref(x, i), budget-1, depth+1);
+    return budget;
+  }
+  return -1;
+}
+
+static sexp_sint_t *sexp_shared_labels_ref (struct sexp_shared_labels *labels, sexp x) {
+  sexp_uint_t mask = labels->size - 1, i = (((sexp_uint_t)x >> 3) * 0x9E3779B1uL) & mask;
+  for ( ; labels->keys[i]; i = (i + 1) & mask)
+    if (labels->keys[i] == x)
+      return labels->vals + i;
+  return NULL;
+}
+
+/* returns the new entry's value, NULL if x was already present */
+static sexp_sint_t *sexp_shared_labels_add (struct sexp_shared_labels *labels, sexp x, int *oomp) {
+  sexp_uint_t mask, i, j, size = labels->size;
+  sexp *keys = labels->keys;
+  sexp_sint_t *vals = labels->vals;
+  if ((labels->count + 1) * 2 > size) {
+    labels->size = size ? size * 2 : 256;
+    labels->keys = (sexp*) calloc(labels->size, sizeof(sexp));
+    labels->vals = (sexp_sint_t*) calloc(labels->size, sizeof(sexp_sint_t));
+    if (! labels->keys || ! labels->vals) {
+      free(labels->keys);
+      free(labels->vals);
+      labels->keys = keys;
+      labels->vals = vals;
+      labels->size = size;
+      *oomp = 1;
+      return NULL;
+    }
+    for (j=0; j<size; j++)
+      if (keys[j]) {
+        mask = labels->size - 1;
+        for (i=(((sexp_uint_t)keys[j] >> 3) * 0x9E3779B1uL) & mask; labels->keys[i]; i = (i + 1) & mask)
+          ;
+        labels->keys[i] = keys[j];
+        labels->vals[i] = vals[j];
+      }
+    free(keys);
+    free(vals);
+  }
+  mask = labels->size - 1;
+  for (i=(((sexp_uint_t)x >> 3) * 0x9E3779B1uL) & mask; labels->keys[i]; i = (i + 1) & mask)
+    if (labels->keys[i] == x)
+      return NULL;
+  labels->keys[i] = x;
+  labels->count++;
+  return labels->vals + i;
+}
+
+/* marks nodes reached more than once, or only those reached again */
+/* while still being visited (i.e. cycles) if cyclicp, returning -1 */
+/* for unsupported objects, data nested too deep for sexp_write_one */
+/* to write in full, or out of memory */
+static int sexp_shared_scan (sexp ctx, sexp x, struct sexp_shared_labels *labels, int cyclicp, sexp_sint_t depth) {
+  sexp start = x, *elts;
+  sexp_sint_t *val, i, len, spine = 0;
+  int kind, oom = 0, res = 0;
+  for ( ; ; x = sexp_cdr(x)) {
+    if (! (kind = sexp_shared_node_kind(ctx, x)))
+      break;
+    if (spine > 0 && ! sexp_pairp(x))
+      depth++;                /* a dotted tail is written one level down */
+    if (kind < 0 || depth >= SEXP_DEFAULT_WRITE_BOUND - 1)
+      return -1;
+    if (! (val = sexp_shared_labels_add(labels, x, &oom))) {
+      if (oom) return -1;
+      val = sexp_shared_labels_ref(labels, x);
+      if (! cyclicp || (*val & SEXP_SHARED_VISITING))
+        *val |= SEXP_SHARED_LABEL;
+      break;
+    }
+    *val = SEXP_SHARED_VISITING;
+    if (sexp_pairp(x)) {
+      spine++;
+      if ((res = sexp_shared_scan(ctx, sexp_car(x), labels, cyclicp, depth+1)) < 0)
+        return res;
+      continue;
+    }
+    elts = sexp_vectorp(x) ? sexp_vector_data(x) : NULL;
+    len = elts ? sexp_vector_length(x)
+      : sexp_type_num_slots_of_object(sexp_object_type(ctx, x), x);
+    for (i=0; i<len; i++)
+      if ((res = sexp_shared_scan(ctx, elts ? elts[i] : sexp_slot_ref(x, i), labels, cyclicp, depth+1)) < 0)
+        return res;
+    /* the elements may have moved the table */
+    val = sexp_shared_labels_ref(labels, x);
+    *val = (*val & ~SEXP_SHARED_VISITING) | SEXP_SHARED_DONE;
+    break;
+  }
+  for (x=start; spine > 0; x=sexp_cdr(x), spine--) {
+    val = sexp_shared_labels_ref(labels, x);
+    *val = (*val & ~SEXP_SHARED_VISITING) | SEXP_SHARED_DONE;
+  }
+  return res;
+}
+
+/* writes "#n#" and returns 1 for a node already written, writing */
+/* "#n=" first for a labeled node seen for the first time */
+static int sexp_write_label (sexp ctx, sexp obj, sexp out, struct sexp_shared_labels *labels) {
+  sexp_sint_t *val;
+  char buf[32];
+  if (! labels || ! (val = sexp_shared_labels_ref(labels, obj)) || *val == 0)
+    return 0;
+  if (*val > 0) {
+    snprintf(buf, sizeof(buf), "#%ld#", (long)(*val - 1));
+    sexp_write_string(ctx, buf, out);
+    return 1;
+  }
+  *val = ++labels->next;
+  snprintf(buf, sizeof(buf), "#%ld=", (long)(*val - 1));
+  sexp_write_string(ctx, buf, out);
+  return 0;
+}
+
+static sexp sexp_write_labeled (sexp ctx, sexp obj, sexp out, struct sexp_shared_labels *labels, sexp_sint_t bound) {
+  sexp x;
+  sexp_sint_t i, len, parens, *val;
+  int kind = sexp_shared_node_kind(ctx, obj);
+  if (kind <= 0 || bound >= SEXP_DEFAULT_WRITE_BOUND)
+    return sexp_write_one(ctx, obj, out, bound);
+  if (sexp_write_label(ctx, obj, out, labels))
+    return SEXP_VOID;
+  if (sexp_pairp(obj)) {
+    sexp_write_char(ctx, '(', out);
+    sexp_write_labeled(ctx, sexp_car(obj), out, labels, bound+1);
+    /* labeled tails are written dotted, in this loop rather than by */
+    /* recursion, so they nest at the same bound as the scan saw them */
+    for (x=sexp_cdr(obj), parens=1; sexp_pairp(x); x=sexp_cdr(x)) {
+      if (labels && (val = sexp_shared_labels_ref(labels, x)) && *val != 0) {
+        sexp_write_string(ctx, " . ", out);
+        if (sexp_write_label(ctx, x, out, labels))
+          break;
+        sexp_write_char(ctx, '(', out);
+        parens++;
+      } else {
+        sexp_write_char(ctx, ' ', out);
+      }
+      sexp_write_labeled(ctx, sexp_car(x), out, labels, bound+1);
+    }
+    if (! sexp_nullp(x) && ! sexp_pairp(x)) {
+      sexp_write_string(ctx, " . ", out);
+      sexp_write_labeled(ctx, x, out, labels, bound+1);
+    }
+    while (parens-- > 0)
+      sexp_write_char(ctx, ')', out);
+  } else if (sexp_vectorp(obj)) {
+    sexp_write_string(ctx, "#(", out);
+    len = sexp_vector_length(obj);
+    for (i=0; i<len; i++) {
+      if (i > 0) sexp_write_char(ctx, ' ', out);
+      sexp_write_labeled(ctx, sexp_vector_data(obj)[i], out, labels, bound+1);
+    }
+    sexp_write_char(ctx, ')', out);
+  } else {
+#if SEXP_USE_OBJECT_BRACE_LITERALS
+    return sexp_write_braces(ctx, obj, NULL, out, labels, bound);
+#endif
+  }
+  return SEXP_VOID;
+}
+
+sexp sexp_write_shared_op (sexp ctx, sexp self, sexp_sint_t n, sexp obj, sexp out, sexp cyclicp) {
+  struct sexp_shared_labels labels;
+  sexp_sint_t i;
+  sexp res = SEXP_TRUE;
+  sexp_assert_type(ctx, sexp_oportp, SEXP_OPORT, out);
+  memset(&labels, 0, sizeof(labels));
+  if (! (sexp_truep(cyclicp)
+         && sexp_shared_tree_walk(ctx, obj, SEXP_WRITE_SHARED_BUDGET, 0) >= 0)) {
+    if (sexp_shared_scan(ctx, obj, &labels, sexp_truep(cyclicp), 0) < 0) {
+      res = SEXP_FALSE;   /* let the caller fall back to the general writer */
+    } else {
+      for (i=0; i<(sexp_sint_t)labels.size; i++)
+        if (labels.keys[i])
+          labels.vals[i] = (labels.vals[i] & SEXP_SHARED_LABEL) ? -1 : 0;
+    }
+  }
+  if (res == SEXP_TRUE) {
+#if SEXP_USE_GREEN_THREADS
+    sexp_maybe_block_output_port(ctx, out);
+#endif
+    sexp_write_labeled(ctx, obj, out, labels.size ? &labels : NULL, 0);
+#if SEXP_USE_GREEN_THREADS
+    sexp_maybe_unblock_port(ctx, out);
+#endif
+  }
+  free(labels.keys);
+  free(labels.vals);
+  return res;
+}
+#endif
+
 #if SEXP_USE_UTF8_STRINGS
 int sexp_write_utf8_char (sexp ctx, int c, sexp out) {
   unsigned char buf[8];
@@ -2467,16 +3684,52 @@ sexp sexp_flush_output_op (sexp ctx, sexp self, sexp_sint_t n, sexp out) {
 
 #define INIT_STRING_BUFFER_SIZE 128
 
+/* true if no input follows what's in the port's buffer, so a token */
+/* running to the end of the buffer is complete */
+#define sexp_port_buf_finalp(p) (!sexp_port_stream(p) && !sexp_filenop(sexp_port_fd(p)) && !sexp_port_customp(p))
+
+static int sexp_count_newlines (const char *str, sexp_sint_t len) {
+  const char *end = str + len;
+  int res = 0;
+  for ( ; (str = (const char*) memchr(str, '\n', end - str)); str++)
+    res++;
+  return res;
+}
+
 sexp sexp_read_string (sexp ctx, sexp in, int sentinel) {
 #if SEXP_USE_UTF8_STRINGS
   int len;
 #endif
   int c, i=0;
-  sexp_sint_t size=INIT_STRING_BUFFER_SIZE;
+  sexp_sint_t size=INIT_STRING_BUFFER_SIZE, n;
   char initbuf[INIT_STRING_BUFFER_SIZE];
-  char *buf=initbuf, *tmp;
+  char *buf=initbuf, *tmp, *start, *end, *esc;
   sexp res = SEXP_FALSE;
 
+  /* scan the port buffer directly, taking the string as is if it */
+  /* has no escapes or else copying the text up to the first one */
+  if (sexp_port_buf(in)) {
+    start = sexp_port_buf(in) + sexp_port_offset(in);
+    n = sexp_port_size(in) - sexp_port_offset(in);
+    end = (char*) memchr(start, sentinel, n);
+    esc = (char*) memchr(start, '\\', end ? end - start : n);
+    if (end && ! esc) {
+      sexp_port_line(in) += sexp_count_newlines(start, end - start);
+      sexp_port_offset(in) += end - start + 1;
+      return sexp_c_string(ctx, start, end - start);
+    }
+    n = (esc ? esc : start + n) - start;
+    if (n + 4 >= size) {
+      while (n + 4 >= size) size *= 2;
+      buf = (char*) sexp_malloc(size);
+      if (!buf) return sexp_global(ctx, SEXP_G_OOM_ERROR);
+    }
+    memcpy(buf, start, n);
+    i = n;
+    sexp_port_line(in) += sexp_count_newlines(start, n);
+    sexp_port_offset(in) += n;
+  }
+
   for (c = sexp_read_char(ctx, in); c != sentinel; c = sexp_read_char(ctx, in)) {
     if (c == '\\') {
       c = sexp_read_char(ctx, in);
@@ -2549,16 +3802,217 @@ sexp sexp_read_string (sexp ctx, sexp in, int sentinel) {
   return res;
 }
 
+/* read up to the next delimiter, which is consumed but not included, */
+/* copying whole runs out of the port buffer; delims is a char, a */
+/* string of ascii chars, or #f for any of \n, \r or \r\n */
+sexp sexp_read_delimited_op (sexp ctx, sexp self, sexp_sint_t n, sexp in, sexp delims, sexp max) {
+  char initbuf[INIT_STRING_BUFFER_SIZE], table[256];
+  char *buf=initbuf, *tmp, *start, *end, *stop;
+  int c, delim='\n', tablep=0, linep=0, donep=0;
+  sexp_sint_t size=INIT_STRING_BUFFER_SIZE, i=0, k, j, limit=-1, count=-1;
+  sexp_gc_var1(res);
+  sexp_assert_type(ctx, sexp_iportp, SEXP_IPORT, in);
+  if (!sexp_port_openp(in))
+    return sexp_xtype_exception(ctx, self, "port is closed", in);
+  if (sexp_fixnump(max))
+    limit = sexp_unbox_fixnum(max) < 0 ? 0 : sexp_unbox_fixnum(max);
+  else if (! sexp_not(max))
+    return sexp_type_exception(ctx, self, SEXP_FIXNUM, max);
+  if (sexp_not(delims)) {
+    linep = 1;
+  } else if (sexp_charp(delims)) {
+    delim = sexp_unbox_character(delims);
+    if (delim < 0 || delim >= 0x80)
+      return sexp_xtype_exception(ctx, self, "delimiter must be ASCII", delims);
+  } else if (sexp_stringp(delims)) {
+    memset(table, 0, sizeof(table));
+    for (j = 0; j < (sexp_sint_t)sexp_string_size(delims); j++) {
+      delim = ((unsigned char*)sexp_string_data(delims))[j];
+      if (delim >= 0x80)
+        return sexp_xtype_exception(ctx, self, "delimiters must be ASCII", delims);
+      table[delim] = 1;
+    }
+    tablep = sexp_string_size(delims) != 1;
+  } else {
+    return sexp_type_exception(ctx, self, SEXP_STRING, delims);
+  }
+#if SEXP_USE_GREEN_THREADS
+  errno = 0;
+#endif
+  sexp_gc_preserve1(ctx, res);
+  res = SEXP_EOF;
+
+  for (;;) {
+    if (sexp_port_buf(in) && sexp_port_offset(in) < sexp_port_size(in)) {
+      start = sexp_port_buf(in) + sexp_port_offset(in);
+      end = sexp_port_buf(in) + sexp_port_size(in);
+      if (tablep) {
+        for (stop = start; stop < end && !table[(unsigned char)*stop]; stop++)
+          ;
+        if (stop == end) stop = NULL;
+      } else {
+        stop = (char*) memchr(start, delim, end - start);
+        if (linep && (tmp = (char*) memchr(start, '\r', (stop ? stop : end) - start)))
+          stop = tmp;
+      }
+      k = (stop ? stop : end) - start;
+      if (limit >= 0 && i + k > limit) {
+        /* the run may hold more than limit chars, cut it at the first */
+        /* char past the limit, keeping any trailing utf8 bytes */
+#if SEXP_USE_UTF8_STRINGS
+        if (count < 0)
+          for (count = j = 0; j < i; j++)
+            if ((buf[j] & 0xC0) != 0x80) count++;
+        for (j = 0; j < k; j++)
+          if ((start[j] & 0xC0) != 0x80 && count++ == limit) {
+            count--; k = j; stop = NULL; donep = 1;
+            break;
+          }
+#else
+        k = limit - i; stop = NULL; donep = 1;
+#endif
+      }
+      if (i == 0 && (stop || donep)) {
+        /* the whole result is in the buffer, take it as is */
+        res = sexp_c_string(ctx, start, k);
+      } else {
+        if (i + k + 1 >= size) {
+          while (i + k + 1 >= size) size *= 2;
+          tmp = (char*) sexp_malloc(size);
+          if (!tmp) {res = sexp_global(ctx, SEXP_G_OOM_ERROR); break;}
+          memcpy(tmp, buf, i);
+          if (buf != initbuf) free(buf);
+          buf = tmp;
+        }
+        memcpy(buf + i, start, k);
+        i += k;
+      }
+      if (!linep) sexp_port_line(in) += sexp_count_newlines(start, k);
+      sexp_port_offset(in) += k;
+      if (donep) {
+        if (res == SEXP_EOF) res = SEXP_VOID;
+        break;
+      }
+      if (stop) {
+        sexp_port_offset(in)++;
+        c = *stop;
+        goto found;
+      }
+    }
+    /* the buffer is empty, or there is none: take a single char */
+    c = sexp_read_char(ctx, in);
+    if (c == EOF) {
+#if SEXP_USE_GREEN_THREADS
+      if (errno == EAGAIN
+          && (sexp_port_stream(in) ? ferror(sexp_port_stream(in)) : sexp_filenop(sexp_port_fd(in)))) {
+        if (sexp_port_stream(in)) clearerr(sexp_port_stream(in));
+        if (i > 0 && sexp_port_buf(in)) {
+          /* put back what we've read so the retry starts over */
+          if (sexp_port_buf_capacity(in) < i + BUF_START) {
+            res = sexp_set_port_buffer_size_op(ctx, self, 2, in, sexp_make_fixnum(i + sexp_port_buf_capacity(in)));
+            if (sexp_exceptionp(res)) break;
+          }
+          memcpy(sexp_port_buf(in) + BUF_START, buf, i);
+          sexp_port_offset(in) = BUF_START;
+          sexp_port_size(in) = BUF_START + i;
+          if (!linep) sexp_port_line(in) -= sexp_count_newlines(buf, i);
+          i = 0;
+        }
+        if (i == 0) {
+          if (sexp_applicablep(sexp_global(ctx, SEXP_G_THREADS_BLOCKER)))
+            sexp_apply2(ctx, sexp_global(ctx, SEXP_G_THREADS_BLOCKER), in, SEXP_FALSE);
+          res = sexp_global(ctx, SEXP_G_IO_BLOCK_ERROR);
+          break;
+        }
+      }
+#endif
+      if (i > 0) res = SEXP_VOID;
+      break;
+    }
+    if (tablep ? table[c] : (c == delim || (linep && c == '\r')))
+      goto found;
+#if SEXP_USE_UTF8_STRINGS
+    if (limit >= 0 && i >= limit && (c & 0xC0) != 0x80) {
+      if (count < 0)
+        for (count = j = 0; j < i; j++)
+          if ((buf[j] & 0xC0) != 0x80) count++;
+      if (count++ == limit) {
+        sexp_push_char(ctx, c, in);
+        res = SEXP_VOID;
+        break;
+      }
+    }
+#else
+    if (limit >= 0 && i >= limit) {
+      sexp_push_char(ctx, c, in);
+      res = SEXP_VOID;
+      break;
+    }
+#endif
+    if (c == '\n') sexp_port_line(in)++;
+    buf[i++] = c;
+    if (i + 1 >= size) {
+      tmp = (char*) sexp_malloc(size*2);
+      if (!tmp) {res = sexp_global(ctx, SEXP_G_OOM_ERROR); break;}
+      memcpy(tmp, buf, i);
+      if (buf != initbuf) free(buf);
+      buf = tmp;
+      size *= 2;
+    }
+    continue;
+  found:
+    /* consume the delimiter, and the \n of a \r\n line ending */
+    if (c == '\n') {
+      sexp_port_line(in)++;
+    } else if (linep && c == '\r') {
+      c = sexp_read_char(ctx, in);
+      if (c == '\n') sexp_port_line(in)++;
+      else sexp_push_char(ctx, c, in);
+    }
+    if (res == SEXP_EOF) res = SEXP_VOID;
+    break;
+  }
+
+  if (res == SEXP_VOID)
+    res = sexp_c_string(ctx, buf, i);
+  if (buf != initbuf) free(buf);
+  sexp_gc_release1(ctx);
+  return res;
+}
+
 sexp sexp_read_symbol (sexp ctx, sexp in, int init, int internp) {
   int c, i=0, size=INIT_STRING_BUFFER_SIZE;
   char initbuf[INIT_STRING_BUFFER_SIZE];
-  char *buf=initbuf, *tmp;
+  char *buf=initbuf, *tmp, *start, *end, *p;
   sexp res=SEXP_VOID;
 #if SEXP_USE_FOLD_CASE_SYMS
   int foldp = sexp_port_fold_casep(in);
   init = (foldp ? sexp_tolower(init) : init);
 #endif
 
+  /* take the symbol straight from the port buffer if it ends there */
+  /* without escapes, and init was the char just read from it */
+  if (sexp_port_buf(in)
+#if SEXP_USE_FOLD_CASE_SYMS
+      && ! foldp
+#endif
+      ) {
+    start = sexp_port_buf(in) + sexp_port_offset(in);
+    end = sexp_port_buf(in) + sexp_port_size(in);
+    for (p = start; p < end; p++) {
+      c = *(unsigned char*)p;
+      if (c == '\\' || (c < 0x80 && sexp_separators[c]))
+        break;
+    }
+    if ((p < end ? *p != '\\' : sexp_port_buf_finalp(in))
+        && (init == EOF || (sexp_port_offset(in) > 0 && start[-1] == init))) {
+      if (init != EOF) start--;
+      sexp_port_offset(in) = p - sexp_port_buf(in);
+      return (internp ? sexp_intern(ctx, start, p - start)
+              : sexp_c_string(ctx, start, p - start));
+    }
+  }
+
   if (init != EOF)
     buf[i++] = init;
 
@@ -2685,19 +4139,43 @@ sexp sexp_read_polar_tail (sexp ctx, sexp in, sexp magnitude) {
 #endif
 #endif
 
-sexp sexp_read_float_tail (sexp ctx, sexp in, double whole, int negp) {
+/* iwhole is the integer part whole was rounded from, if exactp */
+static sexp sexp_read_decimal_tail (sexp ctx, sexp in, double whole, unsigned long long iwhole, int exactp, int negp) {
   int c, c2;
   sexp exponent=SEXP_VOID;
   long double val=0.0, scale=10, e=0.0;
+#if SEXP_USE_FLONUMS
+  char digits[SEXP_MAX_DECIMAL_DIGITS + 1];
+  int i, len = 0, fraclen = 0, stickyp = 0;
+  unsigned long long m;
+#endif
+  double d;
   sexp_gc_var1(res);
   sexp_gc_preserve1(ctx, res);
+#if SEXP_USE_FLONUMS
+  if (exactp && iwhole > 0) {
+    for (m = iwhole; m > 0; m /= 10)
+      digits[len++] = (char)('0' + m % 10);
+    for (i = 0; i < len/2; i++)
+      c = digits[i], digits[i] = digits[len-1-i], digits[len-1-i] = (char)c;
+  }
+#endif
   for (c=sexp_read_char(ctx, in); sexp_isdigit(c);
-       c=sexp_read_char(ctx, in), val*=10, scale*=10)
+       c=sexp_read_char(ctx, in), val*=10, scale*=10) {
     val += digit_value(c);
+#if SEXP_USE_FLONUMS
+    if (len < SEXP_MAX_DECIMAL_DIGITS) {
+      if (len > 0 || c != '0') digits[len++] = c;
+      fraclen++;
+    } else if (c != '0') {
+      stickyp = 1;
+    }
+#endif
+  }
 #if SEXP_USE_PLACEHOLDER_DIGITS
   for (; c==SEXP_PLACEHOLDER_DIGIT;
        c=sexp_read_char(ctx, in), val*=10, scale*=10)
-    val += sexp_placeholder_digit_value(10);
+    val += sexp_placeholder_digit_value(10), exactp = 0;
 #endif
   val /= scale;
   val += whole;
@@ -2716,26 +4194,36 @@ sexp sexp_read_float_tail (sexp ctx, sexp in, double whole, int negp) {
       exponent = (sexp_complex_real(res) == SEXP_ZERO ? sexp_complex_imag(res) : sexp_complex_real(res));
     }
 #endif
+    if (! sexp_fixnump(exponent)) exactp = 0;
     e = (sexp_fixnump(exponent) ? sexp_unbox_fixnum(exponent)
          : sexp_flonump(exponent) ? sexp_flonum_value(exponent) : 0.0);
+  }
+#if SEXP_USE_FLONUMS
+  if (exactp) {
+    if (stickyp) digits[len++] = '1', fraclen++;
+    d = sexp_decimal_to_double(digits, len, (long)e - fraclen);
+    if (negp) d = -d;
+  } else
+#endif
+  if (e != 0.0)
+    d = fabsl(e) > 320 ? exp(log(val) + e*M_LN10) : val * pow(10, e);
+  else
+    d = val;
 #if SEXP_USE_COMPLEX
-    if (sexp_complexp(res)) {
-      if (sexp_complex_real(res) == SEXP_ZERO) {
-        sexp_complex_imag(res) = sexp_make_flonum(ctx, val * pow(10, e));
-      } else {
-        sexp_complex_real(res) = sexp_make_flonum(ctx, val * pow(10, e));
-      }
-      sexp_gc_release1(ctx);
-      return res;
+  if (sexp_complexp(res)) {
+    if (sexp_complex_real(res) == SEXP_ZERO) {
+      sexp_complex_imag(res) = sexp_make_flonum(ctx, d);
+    } else {
+      sexp_complex_real(res) = sexp_make_flonum(ctx, d);
     }
-#endif
+    sexp_gc_release1(ctx);
+    return res;
   }
-  if (e != 0.0)
-    val = fabsl(e) > 320 ? exp(log(val) + e*M_LN10) : val * pow(10, e);
+#endif
 #if SEXP_USE_FLONUMS
-  res = sexp_make_flonum(ctx, val);
+  res = sexp_make_flonum(ctx, d);
 #else
-  res = sexp_make_fixnum((sexp_uint_t)val);
+  res = sexp_make_fixnum((sexp_uint_t)d);
 #endif
   if (!is_precision_indicator(c)) {
 #if SEXP_USE_COMPLEX
@@ -2758,6 +4246,12 @@ sexp sexp_read_float_tail (sexp ctx, sexp in, double whole, int negp) {
   return res;
 }
 
+sexp sexp_read_float_tail (sexp ctx, sexp in, double whole, int negp) {
+  /* the digits are only collected for an exact integer part */
+  int exactp = whole >= 0 && whole < 9007199254740992.0 && whole == floor(whole);
+  return sexp_read_decimal_tail(ctx, in, whole, (unsigned long long)(exactp ? whole : 0), exactp, negp);
+}
+
 #if SEXP_USE_RATIOS
 sexp sexp_make_ratio (sexp ctx, sexp num, sexp den) {
   sexp res = sexp_alloc_type(ctx, ratio, SEXP_RATIO);
@@ -2894,7 +4388,7 @@ sexp sexp_read_number (sexp ctx, sexp in, int base, int exactp) {
     if (base != 10)
       return sexp_read_error(ctx, "found non-base 10 float", SEXP_NULL, in);
     if (c!='.') sexp_push_char(ctx, c, in);
-    return sexp_read_float_tail(ctx, in, val, negativep);
+    return sexp_read_decimal_tail(ctx, in, val, val, 1, negativep);
   } else if (c=='/') {
     sexp_gc_preserve2(ctx, res, den);
     den = sexp_read_number(ctx, in, base, exactp);
@@ -3123,6 +4617,62 @@ sexp sexp_list_to_uvector_op(sexp ctx, sexp self, sexp_sint_t n, sexp etype, sex
 
 sexp sexp_read_one (sexp ctx, sexp in, sexp *shares);
 
+/* reads a plain decimal integer or flonum lying entirely in the port */
+/* buffer, returning NULL to defer anything else to sexp_read_number */
+static sexp sexp_read_decimal_fast (sexp ctx, sexp in, int negp) {
+  const char *p = sexp_port_buf(in);
+  sexp_sint_t i = sexp_port_offset(in), size = sexp_port_size(in),
+    start = i, intlen, fraclen = 0, val = 0;
+  int inexactp = 0;
+#if SEXP_USE_FLONUMS
+  char digits[SEXP_MAX_DECIMAL_DIGITS];
+  long e = 0, esign = 1;
+  double d;
+#endif
+  if (! p) return NULL;
+  /* integer parts past a fixnum are read as bignums, even with exponents */
+  for ( ; i < size && sexp_isdigit((unsigned char)p[i]); i++) {
+    if (val > (SEXP_MAX_FIXNUM - 9) / 10)
+      return NULL;
+    val = val * 10 + digit_value(p[i]);
+  }
+  intlen = i - start;
+  if (i < size && p[i] == '.') {
+    for (inexactp = 1, i++; i < size && sexp_isdigit((unsigned char)p[i]); i++)
+      ;
+    fraclen = i - start - intlen - 1;
+  }
+#if SEXP_USE_FLONUMS
+  if (i < size && (p[i] == 'e' || p[i] == 'E')) {
+    inexactp = 1;
+    if (++i < size && (p[i] == '+' || p[i] == '-'))
+      esign = (p[i++] == '-' ? -1 : 1);
+    if (i >= size || ! sexp_isdigit((unsigned char)p[i]))
+      return NULL;
+    for ( ; i < size && sexp_isdigit((unsigned char)p[i]); i++)
+      if (e < 100000) e = e * 10 + digit_value(p[i]);
+  }
+#endif
+  if (intlen + fraclen == 0
+      || (i < size ? ! sexp_is_separator((unsigned char)p[i]) : ! sexp_port_buf_finalp(in)))
+    return NULL;
+  if (! inexactp) {
+    sexp_port_offset(in) = i;
+    return sexp_make_fixnum(negp ? -val : val);
+  }
+#if SEXP_USE_FLONUMS
+  if (intlen + fraclen > SEXP_MAX_DECIMAL_DIGITS)
+    return NULL;
+  memcpy(digits, p + start, intlen);
+  memcpy(digits + intlen, p + start + intlen + 1, fraclen);
+  d = sexp_decimal_to_double(digits, (int)(intlen + fraclen), esign * e - (long)fraclen);
+  sexp_port_offset(in) = i;
+  return sexp_make_flonum(ctx, negp ? -d : d);
+#else
+  return NULL;
+#endif
+}
+
 sexp sexp_read_raw (sexp ctx, sexp in, sexp *shares) {
   char *str;
   int c1, c2, line;
@@ -3575,6 +5125,8 @@ sexp sexp_read_raw (sexp ctx, sexp in, sexp *shares) {
     if ((c2 == '.' && sexp_isdigit(sexp_peek_char(ctx, in)))
         || sexp_isdigit(c2)) {
       sexp_push_char(ctx, c2, in);
+      if ((res = sexp_read_decimal_fast(ctx, in, c1 == '-')))
+        break;
       res = sexp_read_number(ctx, in, 10, 0);
       if ((c1 == '-') && ! sexp_exceptionp(res)) {
 #if SEXP_USE_FLONUMS
@@ -3665,7 +5217,8 @@ sexp sexp_read_raw (sexp ctx, sexp in, sexp *shares) {
   case '0': case '1': case '2': case '3': case '4':
   case '5': case '6': case '7': case '8': case '9':
     sexp_push_char(ctx, c1, in);
-    res = sexp_read_number(ctx, in, 10, 0);
+    if (! (res = sexp_read_decimal_fast(ctx, in, 0)))
+      res = sexp_read_number(ctx, in, 10, 0);
     break;
   default:
     res = sexp_read_symbol(ctx, in, c1, 1);
@@ -0,0 +1 @@
+(8 2 3)
@@ -0,0 +1,20 @@
+
+(define (bump x)
+  (set! x (+ x 1))
+  (* x 2))
+
+(define (captured)
+  (let ((x 1))
+    (let ((get (lambda () x)))
+      (set! x 2)
+      (get))))
+
+(define (reentered)
+  (let ((n 0) (k #f))
+    (call-with-current-continuation (lambda (c) (set! k c)))
+    (set! n (+ n 1))
+    (if (< n 3) (k #f))
+    n))
+
+(write (list (bump 3) (captured) (reentered)))
+(newline)
@@ -0,0 +1,3 @@
+(6 55)
+(8 6)
+(0 -2)
@@ -0,0 +1,15 @@
+
+(define (add x y) (+ x y))
+(define (twice x) (add (add x x) x))
+(define (loop n acc) (if (zero? n) acc (loop (- n 1) (add acc n))))
+
+(write (list (twice 2) (loop 10 0)))
+(newline)
+
+(set! add (lambda (x y) (* x y)))
+(write (list (twice 2) (loop 3 1)))
+(newline)
+
+(set! add (lambda (x . rest) (- x (length rest))))
+(write (list (twice 2) (loop 3 1)))
+(newline)
@@ -0,0 +1,5 @@
+(0 50 99)
+(0 redefined 100)
+(macro 1 98)
+(10 78 macro)
+(again 12 5)
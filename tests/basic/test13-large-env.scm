@@ -0,0 +1,39 @@
+
+;; enough top-level definitions to index the frame
+
+(define (name i) (string->symbol (string-append "v" (number->string i))))
+
+(let lp ((i 0))
+  (if (< i 100)
+      (begin
+        (eval `(define ,(name i) ,i) (interaction-environment))
+        (lp (+ i 1)))))
+
+(write (list v0 v50 v99))
+(newline)
+
+(define v50 'redefined)
+(set! v99 (+ v99 1))
+(write (list v0 v50 v99))
+(newline)
+
+(define (v7) 'procedure)
+(define-syntax v7 (syntax-rules () ((v7) 'macro)))
+(define v100 (v7))
+(write (list v100 v1 v98))
+(newline)
+
+;; unlinking v8 below leaves the index of env2 stale until refilled
+(define env2 (primitive-environment 7))
+(let lp ((i 0))
+  (if (< i 40)
+      (begin
+        (eval `(define ,(name i) ,(* i 2)) env2)
+        (lp (+ i 1)))))
+(define (v8) 'procedure)
+(define-syntax v8 (syntax-rules () ((v8) 'macro)))
+(write (list (eval 'v5 env2) (eval 'v39 env2) (v8)))
+(newline)
+(eval '(define v5 'again) env2)
+(write (list (eval 'v5 env2) (eval 'v6 env2) v5))
+(newline)
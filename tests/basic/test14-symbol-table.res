@@ -0,0 +1,3 @@
+#t
+#t
+#t
@@ -0,0 +1,24 @@
+
+;; enough symbols to grow the table and collect the unreferenced ones
+
+(define (sym prefix i)
+  (string->symbol (string-append prefix (number->string i))))
+
+(define kept
+  (let lp ((i 0) (acc '()))
+    (if (< i 2000) (lp (+ i 1) (cons (sym "kept-" i) acc)) acc)))
+
+(let lp ((i 0))
+  (if (< i 50000)
+      (begin (sym "dropped-" i) (lp (+ i 1)))))
+
+(define (same? ls i)
+  (or (null? ls)
+      (and (eq? (car ls) (sym "kept-" i)) (same? (cdr ls) (- i 1)))))
+
+(write (same? kept 1999))
+(newline)
+(write (eq? (sym "dropped-" 7) (string->symbol "dropped-7")))
+(newline)
+(write (eq? 'quoted-symbol-in-code (string->symbol "quoted-symbol-in-code")))
+(newline)
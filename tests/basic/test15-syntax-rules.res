@@ -0,0 +1,5 @@
+2
+(((1 2) 3 4) (1 2 3))
+(6 #(x y end) (1 (2 3)) #f)
+(y ...)
+(2 1)
@@ -0,0 +1,50 @@
+
+;; pattern and template shapes handled by the native syntax-rules
+
+(define-syntax my-let*
+  (syntax-rules ()
+    ((my-let* () body ...) (let () body ...))
+    ((my-let* ((x v) rest ...) body ...)
+     (let ((x v)) (my-let* (rest ...) body ...)))))
+
+(define-syntax tail
+  (syntax-rules ()
+    ((tail a ... b c) '((a ...) b c))))
+
+(define-syntax flatten
+  (syntax-rules ()
+    ((flatten (a ...) ...) '(a ... ...))))
+
+(define-syntax vec
+  (syntax-rules (=>)
+    ((vec #(a ...) => f) (f a ...))
+    ((vec #(a ...)) #(a ... end))))
+
+(define-syntax dotted
+  (syntax-rules ()
+    ((dotted a . rest) '(a rest))))
+
+(define-syntax false
+  (syntax-rules ()
+    ((false _) #f)))
+
+(define-syntax escape
+  (syntax-rules ()
+    ((escape x) '(x (... ...)))))
+
+(define-syntax swap!
+  (syntax-rules ()
+    ((swap! a b) (let ((tmp a)) (set! a b) (set! b tmp)))))
+
+(write (my-let* ((a 1) (b (+ a 1))) (* a b)))
+(newline)
+(write (list (tail 1 2 3 4) (flatten (1 2) () (3))))
+(newline)
+(write (list (vec #(1 2 3) => +) (vec #(x y)) (dotted 1 2 3) (false 7)))
+(newline)
+(write (escape y))
+(newline)
+(let ((tmp 1) (x 2))
+  (swap! tmp x)
+  (write (list tmp x))
+  (newline))
@@ -0,0 +1,2 @@
+(0 103 39 0 11 78 (extra) (1 2 38 76 1))
+(0 103 39 0 12 78 (extra) (1 2 38 76 1))
@@ -0,0 +1,31 @@
+
+;; lambdas with enough params, locals and free vars to be indexed
+
+(define (numbers n)
+  (let lp ((i (- n 1)) (res '()))
+    (if (< i 0) res (lp (- i 1) (cons i res)))))
+
+(define (vars prefix n)
+  (map (lambda (i) (string->symbol (string-append prefix (number->string i))))
+       (numbers n)))
+
+(define params (vars "p" 40))
+(define locals (vars "l" 40))
+
+(define f
+  (eval
+   `(lambda (,@params . rest)
+      ,@(map (lambda (l p) `(define ,l (* 2 ,p))) locals params)
+      (set! p3 (+ p3 100))
+      (lambda (x)
+        (set! l5 (+ l5 x))
+        (list p0 p3 p39 l0 l5 l39 rest
+              ((lambda () (list p1 l1 p38 l38 x))))))
+   (interaction-environment)))
+
+(define g (apply f (append (numbers 40) (list (quote extra)))))
+
+(write (g 1))
+(newline)
+(write (g 1))
+(newline)
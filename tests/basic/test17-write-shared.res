@@ -0,0 +1,17 @@
+((1 2) (1 2))
+(#0=(1 2) #0#)
+(#(a "b" #\space) #(#(a "b" #\space) #(a "b" #\space)))
+(#0=#(a "b" #\space) #(#0# #0#))
+#0=(1 2 3 . #0#)
+#0=(1 2 3 . #0#)
+#0=(#0# y)
+#0=(#0# y)
+(#0=#(1 #0#) . #0#)
+(#0=#(1 #0#) . #0#)
+((1 2) (1 2))
+#t
+#t
+"(19998 19999 . #0#))"
+#f
+((#t #t) (#t #t) (#t #t) (#t #t))
+complete
@@ -0,0 +1,78 @@
+
+(import (scheme write))
+
+;; shared and cyclic structure found by the native scan
+
+(define (show x)
+  (write x)
+  (newline)
+  (write-shared x)
+  (newline))
+
+(define p (list 1 2))
+(show (list p p))
+(define v (vector 'a "b" #\space))
+(show (list v (vector v v)))
+(define c (list 1 2 3))
+(set-cdr! (cddr c) c)
+(show c)
+(define d (list 'x 'y))
+(set-car! d d)
+(show d)
+(define w (vector 1 2))
+(vector-set! w 1 w)
+(show (cons w w))
+(write-simple (list p p))
+(newline)
+
+;; long lists, past the walk budget, with and without a cycle
+
+(define (write->string x writer)
+  (let ((out (open-output-string)))
+    (writer x out)
+    (get-output-string out)))
+(define (iota-list n)
+  (let lp ((i (- n 1)) (res '()))
+    (if (< i 0) res (lp (- i 1) (cons i res)))))
+(define long (iota-list 200000))
+(define nested (list long (list->vector (iota-list 20000)) (list p p)))
+(write (equal? (write->string long write) (write->string long write-simple)))
+(newline)
+(write (equal? (write->string nested write) (write->string nested write-simple)))
+(newline)
+(define long-cycle (iota-list 20000))
+(set-cdr! (list-tail long-cycle 19999) (list-tail long-cycle 19998))
+(let ((s (write->string long-cycle write)))
+  (write (substring s (- (string-length s) 20) (string-length s))))
+(newline)
+
+;; write returns an unspecified value, not the native writer's #t
+(write (boolean? (write 'x (open-output-string))))
+(newline)
+
+;; data nested past the native writer's bound is written in full by
+;; the general writer, never truncated with ...
+
+(define (nest n x)
+  (if (zero? n) x (nest (- n 1) (list x))))
+(define (dotted-nest n x)
+  (if (zero? n) x (dotted-nest (- n 1) (cons 1 (vector x)))))
+(define (round-trips? x)
+  (let ((s (write->string x write)))
+    (and (equal? s (write->string x write-shared))
+         (equal? x (read (open-input-string s))))))
+(write (map (lambda (n)
+              (list (round-trips? (nest n "s"))
+                    (round-trips? (dotted-nest (quotient n 2) "s"))))
+            '(9998 9999 10000 10001)))
+(newline)
+(define all-tails
+  (let ((ls (iota-list 12000)))
+    (let lp ((x ls) (res '()))
+      (if (null? x) (cons ls res) (lp (cdr x) (cons x res))))))
+(let ((s (write->string all-tails write-shared)))
+  (write (let lp ((i 0))
+           (cond ((> (+ i 3) (string-length s)) 'complete)
+                 ((equal? "..." (substring s i (+ i 3))) 'truncated)
+                 (else (lp (+ i 1)))))))
+(newline)
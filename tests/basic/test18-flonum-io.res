@@ -0,0 +1,23 @@
+0.1 ok
+0.3 ok
+0.30000000000000004 ok
+1.0e+21 ok
+1.0e+22 ok
+1.0e+23 ok
+123456789012345.6 ok
+1.0e-05 ok
+0.0001 ok
+100.0 ok
+-2.5 ok
+-0.0 ok
+5.0e-324 ok
+2.2250738585072014e-308 ok
+1.7976931348623157e+308 ok
+9007199254740992.0 ok
+0.3333333333333333 ok
+2.225073858507201e-308
+0.30000000000000004
+9007199254740994.0
++inf.0
+0.0
+1.23456
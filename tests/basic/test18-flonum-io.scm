@@ -0,0 +1,18 @@
+
+;; shortest round-trip flonum output and correctly rounded input
+
+(define (show x)
+  (let ((s (number->string x)))
+    (display s)
+    (display (if (eqv? x (string->number s)) " ok" " mismatch"))
+    (newline)))
+
+(for-each show
+          (list 0.1 0.3 (+ 0.1 0.2) 1e21 1e22 1e23 123456789012345.6 1e-5
+                0.0001 100.0 -2.5 -0.0 5e-324 2.2250738585072014e-308
+                1.7976931348623157e308 9007199254740993.0 (/ 1. 3)))
+
+(for-each
+ (lambda (s) (write (string->number s)) (newline))
+ '("2.2250738585072011e-308" "0.30000000000000004441"
+   "9007199254740993.0000000001" "1e400" "1e-400" "123.456e-2"))
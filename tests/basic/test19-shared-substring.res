@@ -0,0 +1,7 @@
+(900 #\z 500)
+(#\a #\X #\a)
+(#\y #\z #\z)
+(#\x03bb 500 #\z #\a)
+(#t #t)
+("abcde" "!ef")
+(#\a #\- 400)
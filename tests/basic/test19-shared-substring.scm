@@ -0,0 +1,30 @@
+
+;; long suffix substrings share their parent's bytes until mutated
+
+(define (show . xs) (write xs) (newline))
+
+(define big (make-string 1000 #\a))
+(string-set! big 999 #\z)
+(define s1 (substring big 100 1000))
+(define s2 (string-copy big 500))
+(show (string-length s1) (string-ref s1 899) (string-length s2))
+
+(string-set! s1 0 #\X)
+(show (string-ref big 100) (string-ref s1 0) (string-ref s2 0))
+
+(string-set! big 999 #\y)
+(show (string-ref big 999) (string-ref s1 899) (string-ref s2 499))
+
+(string-set! s2 1 #\x3bb)
+(show (string-ref s2 1) (string-length s2) (string-ref s2 499)
+      (string-ref big 501))
+(show (equal? s2 (string-append s2)) (string=? s1 (substring s1 0)))
+
+(define lit "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz")
+(define s3 (substring lit 3))
+(string-set! s3 0 #\!)
+(show (substring lit 0 5) (substring s3 0 3))
+
+(define s4 (substring s2 100))
+(string-fill! s2 #\-)
+(show (string-ref s4 0) (string-ref s2 100) (string-length s4))
@@ -0,0 +1,3 @@
+(3000 #t #t #t #t)
+(#\x2603 #\j #t 3000)
+(#\x03bb #\b 300 #t)
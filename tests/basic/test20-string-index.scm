@@ -0,0 +1,37 @@
+
+;; string-ref by index through the lazily built string index
+
+(define (check s)
+  (let ((n (string-length s)))
+    (let loop ((i 0) (ok #t))
+      (if (< i n)
+          (let ((c (string-index->cursor s i)))
+            (loop (+ i 1)
+                  (and ok
+                       (eqv? (string-ref s i) (string-cursor-ref s c))
+                       (= i (string-cursor->index s c)))))
+          ok))))
+
+(define u
+  (let ((out (open-output-string)))
+    (do ((i 0 (+ i 1)))
+        ((= i 3000))
+      (write-char (if (zero? (modulo i 7))
+                      #\x3bb
+                      (integer->char (+ 97 (modulo i 26))))
+                  out))
+    (get-output-string out)))
+
+(write (list (string-length u) (check u) (check (make-string 500 #\a))
+             (check (substring u 100)) (check "h\xe9;llo")))
+(newline)
+
+(string-set! u 10 #\x2603)
+(write (list (string-ref u 10) (string-ref u 2999) (check u) (string-length u)))
+(newline)
+
+(define a (make-string 300 #\b))
+(check a)
+(string-set! a 5 #\x3bb)
+(write (list (string-ref a 5) (string-ref a 299) (string-length a) (check a)))
+(newline)
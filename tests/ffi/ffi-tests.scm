@@ -642,6 +642,63 @@ void f32vector_set(float* uv, int i, float v) {
    (f32vector-set uv 3 3.14)
    (test 3.14 (f32vector-ref uv 3))))
 
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;; The C eval API.
+
+(test-ffi
+ "eval string"
+ (begin
+   (c-declare "
+sexp make_child_env(sexp ctx, sexp self, sexp parent) {
+  sexp env = sexp_make_env(ctx);
+  if (sexp_envp(env)) sexp_env_parent(env) = parent;
+  return env;
+}
+sexp eval_string(sexp ctx, sexp self, sexp env, const char* str) {
+  return sexp_eval_string(ctx, str, -1, env);
+}
+sexp set_eval_string_cache(sexp ctx, sexp self, int size) {
+  return sexp_set_eval_string_cache(ctx, size);
+}
+sexp compile_and_call(sexp ctx, sexp self, sexp env, const char* str, int n) {
+  sexp_gc_var3(proc, res, ls);
+  sexp_gc_preserve3(ctx, proc, res, ls);
+  ls = SEXP_NULL;
+  proc = sexp_compile_string(ctx, str, -1, env);
+  for (res = proc; !sexp_exceptionp(res) && n > 0; n--) {
+    res = sexp_call_compiled(ctx, proc, env);
+    if (!sexp_exceptionp(res)) ls = sexp_cons(ctx, res, ls);
+  }
+  res = sexp_exceptionp(res) ? res : ls;
+  sexp_gc_release3(ctx);
+  return res;
+}
+")
+   (define-c sexp make-child-env ((value ctx sexp) (value self sexp) sexp))
+   (define-c sexp eval-string
+     ((value ctx sexp) (value self sexp) sexp string))
+   (define-c sexp set-eval-string-cache
+     ((value ctx sexp) (value self sexp) int))
+   (define-c sexp compile-and-call
+     ((value ctx sexp) (value self sexp) sexp string int)))
+ (let ((env (make-child-env (current-environment))))
+   (test '(3 3) (compile-and-call env "(+ 1 2)" 2))
+   (test-error (compile-and-call env "(+ 1" 1))
+   (test-error (compile-and-call env "undefined-var" 1))
+   (set-eval-string-cache 64)
+   (eval-string env "(define x 1)")
+   (test 1 (eval-string env "x"))
+   (eval-string env "(set! x 2)")
+   (test 2 (eval-string env "x"))
+   ;; cached code compiled before v was imported must not keep the
+   ;; undefined cell it made for v
+   (test-error (eval-string env "(v '(1 . 2))"))
+   (eval-string env "(import (rename (only (scheme base) car) (car v)))")
+   (test 1 (eval-string env "(v '(1 . 2))"))
+   (test 1 (eval-string env "(v '(1 . 2))"))
+   (set-eval-string-cache 0)
+   (test 1 (eval-string env "(v '(1 . 2))"))))
+
 ;; TODO: virtual method accessors
 
 (cleanup-shared-objects!)
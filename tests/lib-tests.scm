@@ -40,6 +40,7 @@
         (rename (chibi crypto md5-test) (run-tests run-md5-tests))
         (rename (chibi crypto rsa-test) (run-tests run-rsa-tests))
         (rename (chibi crypto sha2-test) (run-tests run-sha2-tests))
+        (rename (chibi disasm-test) (run-tests run-disasm-tests))
         (rename (chibi doc-test) (run-tests run-doc-tests))
         ;;(rename (chibi filesystem-test) (run-tests run-filesystem-tests))
         (rename (chibi generic-test) (run-tests run-generic-tests))
@@ -106,6 +107,7 @@
 (run-scheme-bytevector-tests)
 (run-base64-tests)
 (run-bytevector-tests)
+(run-disasm-tests)
 (run-doc-tests)
 (run-generic-tests)
 (run-io-tests)
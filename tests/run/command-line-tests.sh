@@ -26,6 +26,150 @@ for t in $TESTDIR/*.args; do
     i=$((i+1))
 done
 
+# Tests needing more than one run, or scratch files of their own.
+
+check_output() {
+    local name=$1 expected=$2 out
+    shift 2
+    out=$("$@" 2>&1)
+    if [ "$out" = "$expected" ]; then
+        echo "[PASS] $name"
+    else
+        echo "$@"
+        echo "expected: $expected"
+        echo "     got: $out"
+        echo "[FAIL] $name"
+        FAILURES=$((FAILURES + 1))
+    fi
+    i=$((i+1))
+}
+
+repl_chibi() {
+    echo "$1" | run_chibi
+}
+# the repl echoes only non-void results
+check_output repl-display "> 1> " repl_chibi '(display 1)'
+check_output repl-write "> \"a\"> " repl_chibi '(write "a")'
+
+SCRATCH=$(mktemp -d)
+trap 'rm -rf "$SCRATCH"' EXIT
+
+if run_chibi -h 2>&1 | grep -q '^ *-c '; then
+    cp -R $TESTDIR/fasl $SCRATCH/fasl
+    mkdir $SCRATCH/fasl-dir
+    fasl_chibi() {
+        run_chibi -A$SCRATCH/fasl "$@" -m'(ft m)' -p'(go 1)'
+    }
+    check_output fasl-write "expand 2" fasl_chibi -c
+    check_output fasl-written "" test -f $SCRATCH/fasl/ft/m.scm.fasl
+    check_output fasl-load "2" fasl_chibi -c
+    check_output fasl-without-c "expand 2" fasl_chibi
+    # an edit keeping the size, most likely within the same second
+    sed 's/(+ x 1)/(+ x 2)/' $TESTDIR/fasl/ft/m.scm > $SCRATCH/fasl/ft/m.scm
+    check_output fasl-stale "expand 3" fasl_chibi -c
+    check_output fasl-rewritten "3" fasl_chibi -c
+    export CHIBI_FASL_DIRECTORY=$SCRATCH/fasl-dir
+    check_output fasl-directory-write "expand 3" fasl_chibi -c
+    check_output fasl-directory-load "3" fasl_chibi -c
+    check_output fasl-directory-name "" \
+        test -f "$SCRATCH/fasl-dir/$(echo $SCRATCH | sed 's|%|%25|g;s|/|%2F|g')%2Ffasl%2Fft%2Fm.scm.fasl"
+    unset CHIBI_FASL_DIRECTORY
+    # macros from imported libraries are dependencies
+    fasl_n_chibi() {
+        run_chibi -A$SCRATCH/fasl "$@" -m'(ft n)' -p'(run 1)'
+    }
+    check_output fasl-import-write "11" fasl_n_chibi -c
+    sed 's/10/20/' $TESTDIR/fasl/ft/other.scm > $SCRATCH/fasl/ft/other.scm
+    check_output fasl-import-stale "21" fasl_n_chibi -c
+    # but libraries loaded earlier and not imported aren't
+    fasl_both_chibi() {
+        run_chibi -A$SCRATCH/fasl "$@" -m'(ft n)' -m'(ft m)' -p'(go 1)'
+    }
+    rm $SCRATCH/fasl/ft/m.scm.fasl
+    check_output fasl-unrelated-write "expand 3" fasl_both_chibi -c
+    sed 's/10/30/' $TESTDIR/fasl/ft/other.scm > $SCRATCH/fasl/ft/other.scm
+    check_output fasl-unrelated-edit "3" fasl_both_chibi -c
+fi
+
+if run_chibi -h 2>&1 | grep -q '^ *-Z '; then
+    # not through run_chibi, so that $! is the server itself
+    LD_LIBRARY_PATH=.:$LD_LIBRARY_PATH DYLD_LIBRARY_PATH=.:$DYLD_LIBRARY_PATH CHIBI_MODULE_PATH=lib ./chibi-scheme -Atests/run/lib -Z $SCRATCH/zygote.sock >/dev/null 2>&1 &
+    ZYGOTE_PID=$!
+    for n in 1 2 3 4 5 6 7 8 9 10; do
+        [ -S $SCRATCH/zygote.sock ] && break
+        sleep 1
+    done
+    zygote_chibi() {
+        CHIBI_ZYGOTE=$SCRATCH/zygote.sock run_chibi "$@"
+    }
+    zygote_status() {
+        zygote_chibi "$@" >/dev/null 2>&1
+        echo $?
+    }
+    # prints which of its arguments are in the module path
+    cat > $SCRATCH/zygote.scm <<EOF
+(import (scheme base) (scheme write) (scheme process-context) (chibi))
+(write (map (lambda (dir) (and (member dir (current-module-path)) #t))
+            (cdr (command-line))))
+(newline)
+(exit 3)
+EOF
+    # only the server has tests/run/lib in its path
+    check_output zygote-script "(#t)" \
+        zygote_chibi $SCRATCH/zygote.scm tests/run/lib
+    check_output zygote-status "3" zygote_status $SCRATCH/zygote.scm
+    check_output zygote-m-p "120" zygote_chibi -mfact -p '(fact 5)'
+    # startup options and environment fall back to a normal start
+    check_output zygote-option "#f" \
+        zygote_chibi -q -p '(and (member "tests/run/lib" (current-module-path)) #t)'
+    check_output zygote-env "(#f #t)" \
+        env CHIBI_ZYGOTE=$SCRATCH/zygote.sock \
+            LD_LIBRARY_PATH=.:$LD_LIBRARY_PATH \
+            DYLD_LIBRARY_PATH=.:$DYLD_LIBRARY_PATH \
+            CHIBI_MODULE_PATH=lib:$SCRATCH \
+            ./chibi-scheme $SCRATCH/zygote.scm tests/run/lib $SCRATCH
+    kill $ZYGOTE_PID
+    wait $ZYGOTE_PID 2>/dev/null
+fi
+
+if run_chibi -h 2>&1 | grep -q '^ *-P'; then
+    # the indentation of each named row relative to the first
+    profile_depths() {
+        run_chibi -P$SCRATCH/profile.txt -e '(import (srfi 69))' > /dev/null &&
+            awk -v names="$1" '
+                BEGIN { n = split(names, name, "|") }
+                { for (i = 1; i <= n; i++)
+                    if (substr($0, length($0) - length(name[i]) + 1) == name[i])
+                      col[i] = length($0) - length(name[i]) }
+                END { for (i = 1; i <= n; i++)
+                        printf "%s%d", (i > 1 ? " " : ""), col[i] - col[1] }' \
+                $SCRATCH/profile.txt
+    }
+    check_output profile-nested "0 2 2 2 4" profile_depths \
+        "(srfi 69)|lib/srfi/69.sld|lib/srfi/69/interface.scm|(srfi 9)|lib/srfi/9.scm"
+fi
+
+if [ -x ./chibi-scheme-image ]; then
+    image_chibi() {
+        LD_LIBRARY_PATH=.:$LD_LIBRARY_PATH DYLD_LIBRARY_PATH=.:$DYLD_LIBRARY_PATH CHIBI_MODULE_PATH=lib ./chibi-scheme-image "$@"
+    }
+    image_first_line() {
+        image_chibi "$@" 2>&1 | head -1
+    }
+    echo '(import (scheme base) (scheme write)) (display "script")' \
+         > $SCRATCH/image-script.scm
+    check_output image-p "3" image_chibi -p '(+ 1 2)'
+    check_output image-import "hi" \
+        image_chibi -e '(import (scheme write))' -e "(write 'hi)"
+    check_output image-script "script" image_chibi $SCRATCH/image-script.scm
+    check_output image-q "ERROR: undefined variable: string-map" \
+        image_first_line -q -p string-map
+    check_output image-Q "ERROR: undefined variable: list" \
+        image_first_line -Q -p list
+    check_output image-x "ERROR: undefined variable: string-map" \
+        image_first_line -xscheme.r5rs -p string-map
+fi
+
 if [ $FAILURES = 0 ]; then
     echo "command-line-tests: all ${i} tests passed"
 else
@@ -0,0 +1,7 @@
+;; noisy prints when expanded, which loading from a fasl skips
+(define-syntax noisy
+  (er-macro-transformer
+   (lambda (expr rename compare)
+     (display "expand ")
+     (cadr expr))))
+(define (go x) (noisy (+ x 1)))
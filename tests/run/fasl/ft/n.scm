@@ -0,0 +1 @@
+(define (run x) (bump x))
@@ -0,0 +1,3 @@
+(define-syntax bump
+  (syntax-rules ()
+    ((bump x) (+ x 10))))
@@ -0,0 +1 @@
+120
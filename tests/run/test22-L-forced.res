@@ -0,0 +1 @@
+lazy loaded (9 14 2)
@@ -0,0 +1 @@
+lazy loaded #t
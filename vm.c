@@ -109,9 +109,46 @@ static void sexp_inc_context_depth(sexp ctx, sexp_sint_t off) {
     sexp_context_max_depth(ctx) = sexp_context_depth(ctx);
 }
 
+const char* sexp_opcode_operands (int op) {
+  switch (op) {
+  case SEXP_OP_FCALL0:      case SEXP_OP_FCALL1:
+  case SEXP_OP_FCALL2:      case SEXP_OP_FCALL3:
+  case SEXP_OP_FCALL4:      case SEXP_OP_FCALLN:
+  case SEXP_OP_PUSH:
+  case SEXP_OP_GLOBAL_REF:  case SEXP_OP_GLOBAL_KNOWN_REF:
+  case SEXP_OP_PARAMETER_REF: case SEXP_OP_COMPILE_LAZY:
+    return "w";
+  case SEXP_OP_CALL:        case SEXP_OP_TAIL_CALL:
+  case SEXP_OP_RESERVE:
+  case SEXP_OP_JUMP:        case SEXP_OP_JUMP_UNLESS:
+  case SEXP_OP_STACK_REF:   case SEXP_OP_CLOSURE_REF:
+  case SEXP_OP_LOCAL_REF:   case SEXP_OP_LOCAL_SET:
+  case SEXP_OP_TYPEP:
+    return "i";
+  case SEXP_OP_MAKE: case SEXP_OP_SLOT_REF: case SEXP_OP_SLOT_SET:
+    return "ii";
+  case SEXP_OP_CALL_KNOWN:  case SEXP_OP_TAIL_CALL_KNOWN:
+    return "iw";                 /* num args, global cell */
+  case SEXP_OP_MAKE_PROCEDURE:   /* flags, num args, bytecode */
+    return "www";
+  default:
+    return op >= 0 && op < SEXP_OP_NUM_OPCODES ? "" : NULL;
+  }
+}
+
+int sexp_opcode_operand_size (int op) {
+  const char *s = sexp_opcode_operands(op);
+  int res = 0;
+  if (!s) return -1;
+  for ( ; *s; s++)
+    res += (*s == 'w') ? sizeof(sexp) : sizeof(sexp_operand_t);
+  return res;
+}
+
 static void bytecode_preserve (sexp ctx, sexp obj) {
   sexp ls = sexp_bytecode_literals(sexp_context_bc(ctx));
-  if (sexp_pointerp(obj) && !sexp_symbolp(obj)
+  /* interned symbols are only immortal without weak symbols */
+  if (sexp_pointerp(obj) && (SEXP_USE_WEAK_SYMBOLS || !sexp_symbolp(obj))
       && sexp_not(sexp_memq(ctx, obj, ls)))
     sexp_push(ctx, sexp_bytecode_literals(sexp_context_bc(ctx)), obj);
 }
@@ -127,6 +164,17 @@ static void sexp_emit_word (sexp ctx, sexp_uint_t val)  {
   sexp_inc_context_pos(ctx, sizeof(sexp));
 }
 
+static void sexp_emit_operand (sexp ctx, sexp_sint_t val)  {
+  unsigned char *data;
+  sexp_context_align_pos(ctx);
+  sexp_expand_bcode(ctx, sizeof(sexp_operand_t));
+  if (sexp_exceptionp(sexp_context_exception(ctx)))
+    return;
+  data = sexp_bytecode_data(sexp_context_bc(ctx));
+  *((sexp_operand_t*)(&(data[sexp_unbox_fixnum(sexp_context_pos(ctx))]))) = (sexp_operand_t)val;
+  sexp_inc_context_pos(ctx, sizeof(sexp_operand_t));
+}
+
 static void sexp_emit_push (sexp ctx, sexp obj) {
   sexp_emit(ctx, SEXP_OP_PUSH);
   sexp_emit_word(ctx, (sexp_uint_t)obj);
@@ -163,7 +211,7 @@ static sexp_sint_t sexp_context_make_label (sexp ctx) {
   sexp_sint_t label;
   sexp_context_align_pos(ctx);
   label = sexp_unbox_fixnum(sexp_context_pos(ctx));
-  sexp_inc_context_pos(ctx, sizeof(sexp_uint_t));
+  sexp_inc_context_pos(ctx, sizeof(sexp_operand_t));
   return label;
 }
 
@@ -171,7 +219,7 @@ static void sexp_context_patch_label (sexp ctx, sexp_sint_t label) {
   sexp bc = sexp_context_bc(ctx);
   unsigned char *data = sexp_bytecode_data(bc)+label;
   if (!sexp_exceptionp(sexp_context_exception(ctx)))
-    *((sexp_sint_t*)data) = sexp_unbox_fixnum(sexp_context_pos(ctx))-label;
+    *((sexp_operand_t*)data) = sexp_unbox_fixnum(sexp_context_pos(ctx))-label;
 }
 
 static void generate_lit (sexp ctx, sexp value) {
@@ -224,23 +272,19 @@ static void generate_cnd (sexp ctx, sexp name, sexp loc, sexp lam, sexp cnd) {
 }
 
 static void generate_non_global_ref (sexp ctx, sexp name, sexp cell,
-                                     sexp lambda, sexp fv, int unboxp) {
-  sexp_uint_t i;
+                                     sexp lambda, int unboxp) {
   sexp loc = sexp_cdr(cell);
   if (loc == lambda && sexp_lambdap(lambda)) {
     /* local ref */
     sexp_emit(ctx, SEXP_OP_LOCAL_REF);
-    sexp_emit_word(ctx, sexp_param_index(ctx, lambda, name));
+    sexp_emit_operand(ctx, sexp_param_index(ctx, lambda, name));
   } else {
     /* closure ref */
-    for (i=0; sexp_pairp(fv); fv=sexp_cdr(fv), i++)
-      if ((name == sexp_ref_name(sexp_car(fv)))
-          && (loc == sexp_ref_loc(sexp_car(fv))))
-        break;
     sexp_emit(ctx, SEXP_OP_CLOSURE_REF);
-    sexp_emit_word(ctx, i);
+    sexp_emit_operand(ctx, sexp_lambdap(lambda)
+                      ? sexp_free_var_index(ctx, lambda, name, loc) : 0);
   }
-  if (unboxp && (sexp_truep(sexp_memq(ctx, name, sexp_lambda_sv(loc)))))
+  if (unboxp && (sexp_truep(sexp_memq(ctx, name, sexp_lambda_bv(loc)))))
     sexp_emit(ctx, SEXP_OP_CDR);
   sexp_inc_context_depth(ctx, +1);
 }
@@ -264,7 +308,7 @@ static void generate_ref (sexp ctx, sexp ref, int unboxp) {
       sexp_emit_push(ctx, SEXP_VOID);
     } else {
       generate_non_global_ref(ctx, sexp_ref_name(ref), sexp_ref_cell(ref),
-                              lam, sexp_lambda_fv(lam), unboxp);
+                              lam, unboxp);
     }
   }
 }
@@ -291,14 +335,14 @@ static void generate_set (sexp ctx, sexp set) {
     sexp_emit(ctx, SEXP_OP_SET_CDR);
   } else {
     lambda = sexp_ref_loc(ref);
-    if (sexp_truep(sexp_memq(ctx, sexp_ref_name(ref), sexp_lambda_sv(lambda)))) {
-      /* stack or closure mutable vars are boxed */
+    if (sexp_truep(sexp_memq(ctx, sexp_ref_name(ref), sexp_lambda_bv(lambda)))) {
+      /* escaping mutable vars are boxed */
       generate_ref(ctx, ref, 0);
       sexp_emit(ctx, SEXP_OP_SET_CDR);
     } else {
-      /* internally defined variable */
+      /* internally defined or non-escaping mutable variable */
       sexp_emit(ctx, SEXP_OP_LOCAL_SET);
-      sexp_emit_word(ctx, sexp_param_index(ctx, lambda, sexp_ref_name(ref)));
+      sexp_emit_operand(ctx, sexp_param_index(ctx, lambda, sexp_ref_name(ref)));
     }
   }
   sexp_emit_push(ctx, SEXP_VOID);
@@ -384,16 +428,16 @@ static void generate_opcode_app (sexp ctx, sexp app) {
     /* AND is equivalent to ROT+DROP.  Note one AND for every STACK_REF. */
     if (num_args > 2) {
       sexp_emit(ctx, SEXP_OP_STACK_REF);
-      sexp_emit_word(ctx, 2);
+      sexp_emit_operand(ctx, 2);
       sexp_emit(ctx, SEXP_OP_STACK_REF);
-      sexp_emit_word(ctx, 2);
+      sexp_emit_operand(ctx, 2);
       sexp_emit(ctx, sexp_opcode_code(op));
       sexp_emit(ctx, SEXP_OP_AND);
       for (i=num_args-2; i>0; i--) {
         sexp_emit(ctx, SEXP_OP_STACK_REF);
-        sexp_emit_word(ctx, 3);
+        sexp_emit_operand(ctx, 3);
         sexp_emit(ctx, SEXP_OP_STACK_REF);
-        sexp_emit_word(ctx, 3);
+        sexp_emit_operand(ctx, 3);
         sexp_emit(ctx, sexp_opcode_code(op));
         sexp_emit(ctx, SEXP_OP_AND);
         sexp_emit(ctx, SEXP_OP_AND);
@@ -415,9 +459,9 @@ static void generate_opcode_app (sexp ctx, sexp app) {
     if ((sexp_opcode_class(op) != SEXP_OPC_CONSTRUCTOR)
         || sexp_opcode_code(op) == SEXP_OP_MAKE) {
       if (sexp_opcode_data(op))
-        sexp_emit_word(ctx, sexp_unbox_fixnum(sexp_opcode_data(op)));
+        sexp_emit_operand(ctx, sexp_unbox_fixnum(sexp_opcode_data(op)));
       if (sexp_opcode_data2(op))
-        sexp_emit_word(ctx, sexp_unbox_fixnum(sexp_opcode_data2(op)));
+        sexp_emit_operand(ctx, sexp_unbox_fixnum(sexp_opcode_data2(op)));
       if (sexp_opcode_data(op) || sexp_opcode_data2(op))
         bytecode_preserve(ctx, op);
     }
@@ -448,9 +492,9 @@ static void generate_opcode_app (sexp ctx, sexp app) {
 
   if (sexp_opcode_static_param_p(op))
     for (ls=sexp_cdr(app); sexp_pairp(ls); ls=sexp_cdr(ls))
-      sexp_emit_word(ctx, sexp_unbox_fixnum(sexp_litp(sexp_car(ls)) ?
-					    sexp_lit_value(sexp_car(ls)) :
-					    sexp_car(ls)));
+      sexp_emit_operand(ctx, sexp_unbox_fixnum(sexp_litp(sexp_car(ls)) ?
+					       sexp_lit_value(sexp_car(ls)) :
+					       sexp_car(ls)));
 
   if (sexp_opcode_return_type(op) == SEXP_VOID
       && sexp_opcode_class(op) != SEXP_OPC_FOREIGN)
@@ -460,6 +504,11 @@ static void generate_opcode_app (sexp ctx, sexp app) {
   sexp_gc_release1(ctx);
 }
 
+/* a procedure which can be entered without the arity checks */
+#define sexp_known_procedurep(x, n)                               \
+  (sexp_procedurep(x) && !sexp_procedure_variadic_p(x)            \
+   && sexp_procedure_num_args(x) == (sexp_sint_t)(n))
+
 static void generate_general_app (sexp ctx, sexp app) {
   sexp_uint_t len = sexp_unbox_fixnum(sexp_length(ctx, sexp_cdr(app))),
     tailp = sexp_context_tailp(ctx);
@@ -471,12 +520,27 @@ static void generate_general_app (sexp ctx, sexp app) {
   for (ls=sexp_reverse(ctx, sexp_cdr(app)); sexp_pairp(ls); ls=sexp_cdr(ls))
     sexp_generate(ctx, 0, 0, 0, sexp_car(ls));
 
+#if SEXP_USE_DIRECT_CALLS
+  /* call a global bound to a procedure of known arity directly */
+  if (sexp_refp(sexp_car(app)) && !sexp_lambdap(sexp_ref_loc(sexp_car(app)))
+      && sexp_known_procedurep(sexp_cdr(sexp_ref_cell(sexp_car(app))), len)) {
+    sexp_push_source(ctx, sexp_ref_source(sexp_car(app)));
+    sexp_emit(ctx, ((tailp && sexp_not(sexp_global(ctx, SEXP_G_NO_TAIL_CALLS_P))) ? SEXP_OP_TAIL_CALL_KNOWN : SEXP_OP_CALL_KNOWN));
+    sexp_emit_operand(ctx, len);
+    /* only the cell is kept, so a redefined procedure can be collected */
+    sexp_emit_word(ctx, (sexp_uint_t)sexp_ref_cell(sexp_car(app)));
+    bytecode_preserve(ctx, sexp_ref_cell(sexp_car(app)));
+    sexp_inc_context_depth(ctx, 1);
+  } else
+#endif
+  {
   /* push the operator onto the stack */
   sexp_generate(ctx, 0, 0, 0, sexp_car(app));
 
   /* maybe overwrite the current frame */
   sexp_emit(ctx, ((tailp && sexp_not(sexp_global(ctx, SEXP_G_NO_TAIL_CALLS_P))) ? SEXP_OP_TAIL_CALL : SEXP_OP_CALL));
-  sexp_emit_word(ctx, (sexp_uint_t)sexp_make_fixnum(len));
+  sexp_emit_operand(ctx, len);
+  }
 
   sexp_context_tailp(ctx) = (char)tailp;
   sexp_inc_context_depth(ctx, -len);
@@ -502,15 +566,15 @@ static void generate_tail_jump (sexp ctx, sexp name, sexp loc, sexp lam, sexp ap
   }
   for (ls1=ls3; sexp_pairp(ls1); ls1=sexp_cdr(ls1)) {
     sexp_emit(ctx, SEXP_OP_LOCAL_SET);
-    sexp_emit_word(ctx, sexp_param_index(ctx, lam, sexp_car(ls1)));
+    sexp_emit_operand(ctx, sexp_param_index(ctx, lam, sexp_car(ls1)));
   }
 
   /* drop the current result and jump */
   sexp_emit(ctx, SEXP_OP_JUMP);
   sexp_context_align_pos(ctx);
-  sexp_emit_word(ctx, (sexp_uint_t) (-sexp_unbox_fixnum(sexp_context_pos(ctx)) +
-				     (sexp_pairp(sexp_lambda_locals(lam))
-				      ? 1 + sizeof(sexp) : 0)));
+  sexp_emit_operand(ctx, -sexp_unbox_fixnum(sexp_context_pos(ctx)) +
+                    (sexp_pairp(sexp_lambda_locals(lam))
+                     ? 1 + sizeof(sexp_operand_t) : 0));
 
   sexp_context_tailp(ctx) = 1;
   sexp_gc_release3(ctx);
@@ -544,7 +608,7 @@ static int sexp_mutual_internal_definep(sexp ctx, sexp x, sexp fv) {
   return sexp_internal_definep(ctx, x)
     && sexp_ref_loc(x) == sexp_ref_loc(fv) && sexp_internal_definep(ctx, fv)
     && sexp_not(sexp_memq(ctx, sexp_ref_name(fv),
-                          sexp_lambda_sv(sexp_ref_loc(fv))));
+                          sexp_lambda_bv(sexp_ref_loc(fv))));
 }
 
 static int generate_lambda_locals (sexp ctx, sexp name, sexp loc, sexp lam, sexp x) {
@@ -564,7 +628,7 @@ static int generate_lambda_locals (sexp ctx, sexp name, sexp loc, sexp lam, sexp
 
 static int generate_lambda_body (sexp ctx, sexp name, sexp loc, sexp lam, sexp x, sexp prev_lam) {
   sexp_uint_t k, updatep, tailp;
-  sexp ls, ref, fv, prev_fv;
+  sexp ls, ref, fv;
   if (sexp_exceptionp(sexp_context_exception(ctx)))
     return 0;
   if (sexp_seqp(x)) {
@@ -592,7 +656,6 @@ static int generate_lambda_body (sexp ctx, sexp name, sexp loc, sexp lam, sexp x
     if (sexp_lambdap(sexp_set_value(x))) {
       /* update potentially changed bindings */
       fv = sexp_lambda_fv(sexp_set_value(x));
-      prev_fv = sexp_lambdap(prev_lam) ? sexp_lambda_fv(prev_lam) : SEXP_NULL;
       for (k=0; fv && sexp_pairp(fv); fv=sexp_cdr(fv), k++) {
         ref = sexp_car(fv);
         if (sexp_mutual_internal_definep(ctx, sexp_set_var(x), ref)) {
@@ -600,14 +663,14 @@ static int generate_lambda_body (sexp ctx, sexp name, sexp loc, sexp lam, sexp x
             updatep = 1;
             generate_non_global_ref(ctx, sexp_ref_name(sexp_set_var(x)),
                                     sexp_ref_cell(sexp_set_var(x)),
-                                    lam, sexp_lambda_fv(lam), 1);
+                                    lam, 1);
             sexp_emit(ctx, SEXP_OP_CLOSURE_VARS);
           }
           generate_non_global_ref(ctx, sexp_ref_name(ref), sexp_ref_cell(ref),
-                                  lam, sexp_lambda_fv(lam), 1);
+                                  lam, 1);
           sexp_emit_push(ctx, sexp_make_fixnum(k));
           sexp_emit(ctx, SEXP_OP_STACK_REF);
-          sexp_emit_word(ctx, 3);
+          sexp_emit_operand(ctx, 3);
           sexp_emit(ctx, SEXP_OP_VECTOR_SET);
           sexp_inc_context_depth(ctx, -1);
         }
@@ -621,59 +684,130 @@ static int generate_lambda_body (sexp ctx, sexp name, sexp loc, sexp lam, sexp x
 }
 #endif
 
-static void generate_lambda (sexp ctx, sexp name, sexp loc, sexp lam, sexp lambda) {
-  sexp ctx2, fv, ls, flags, len, ref, prev_lambda, prev_fv;
+/* compile the body of lambda to a new bytecode object */
+static sexp generate_lambda_code (sexp ctx, sexp name, sexp loc, sexp lam, sexp lambda) {
+  sexp ctx2, ls;
   sexp_sint_t k;
-  sexp_gc_var2(tmp, bc);
-  if (sexp_exceptionp(sexp_context_exception(ctx)))
-    return;
-  prev_lambda = sexp_context_lambda(ctx);
-  prev_fv = sexp_lambdap(prev_lambda) ? sexp_lambda_fv(prev_lambda) : SEXP_NULL;
-  fv = sexp_lambda_fv(lambda);
   ctx2 = sexp_make_eval_context(ctx, sexp_context_stack(ctx), sexp_context_env(ctx), 0, 0);
-  if (sexp_exceptionp(ctx2)) {
-    sexp_context_exception(ctx) = ctx2;
-    return;
-  }
+  if (sexp_exceptionp(ctx2))
+    return ctx2;
   sexp_context_lambda(ctx2) = lambda;
-  sexp_gc_preserve2(ctx, tmp, bc);
-  tmp = sexp_cons(ctx2, SEXP_ZERO, sexp_lambda_source(lambda));
   /* allocate space for local vars */
   k = sexp_unbox_fixnum(sexp_length(ctx, sexp_lambda_locals(lambda)));
   if (k > 0) {
 #if SEXP_USE_RESERVE_OPCODE
     sexp_emit(ctx2, SEXP_OP_RESERVE);
-    sexp_emit_word(ctx2, k);
+    sexp_emit_operand(ctx2, k);
 #else
     while (k--) sexp_emit_push(ctx2, SEXP_UNDEF);
 #endif
   }
-  /* box mutable vars */
-  for (ls=sexp_lambda_sv(lambda); sexp_pairp(ls); ls=sexp_cdr(ls)) {
+  /* box escaping mutable vars */
+  for (ls=sexp_lambda_bv(lambda); sexp_pairp(ls); ls=sexp_cdr(ls)) {
     k = sexp_param_index(ctx, lambda, sexp_car(ls));
     sexp_emit(ctx2, SEXP_OP_LOCAL_REF);
-    sexp_emit_word(ctx2, k);
+    sexp_emit_operand(ctx2, k);
     sexp_emit_push(ctx2, sexp_car(ls));
     sexp_emit(ctx2, SEXP_OP_CONS);
     sexp_emit(ctx2, SEXP_OP_LOCAL_SET);
-    sexp_emit_word(ctx2, k);
+    sexp_emit_operand(ctx2, k);
   }
   if (lam != lambda) loc = 0;
 #if SEXP_USE_UNBOXED_LOCALS
   sexp_context_tailp(ctx2) = 0;
   generate_lambda_locals(ctx2, name, loc, lambda, sexp_lambda_body(lambda));
   sexp_context_tailp(ctx2) = 1;
-  generate_lambda_body(ctx2, name, loc, lambda, sexp_lambda_body(lambda), prev_lambda);
+  generate_lambda_body(ctx2, name, loc, lambda, sexp_lambda_body(lambda), sexp_context_lambda(ctx));
 #else
   sexp_context_tailp(ctx2) = 1;
   sexp_generate(ctx2, name, loc, lam, sexp_lambda_body(lambda));
 #endif
+  return sexp_complete_bytecode(ctx2);
+}
+
+#if SEXP_USE_LAZY_LOAD
+/* In lazy mode a top-level lambda without free variables starts out */
+/* as a stub which compiles the real body the first time it's called. */
+static sexp generate_lazy_stub (sexp ctx, sexp name, sexp loc, sexp lam, sexp lambda) {
+  sexp res;
+  sexp_gc_var2(ctx2, info);
+  sexp_gc_preserve2(ctx, ctx2, info);
+  ctx2 = sexp_make_eval_context(ctx, sexp_context_stack(ctx), sexp_context_env(ctx), 0, 0);
+  if (sexp_exceptionp(ctx2)) {
+    sexp_gc_release2(ctx);
+    return ctx2;
+  }
+  info = sexp_make_vector(ctx2, SEXP_FIVE, SEXP_FALSE);
+  sexp_vector_set(info, SEXP_ZERO, lambda);
+  sexp_vector_set(info, SEXP_ONE, name ? name : SEXP_FALSE);
+  sexp_vector_set(info, SEXP_TWO, loc ? loc : SEXP_FALSE);
+  sexp_vector_set(info, SEXP_THREE, lam ? lam : SEXP_FALSE);
+  sexp_vector_set(info, SEXP_FOUR, sexp_context_env(ctx));
+  sexp_emit(ctx2, SEXP_OP_COMPILE_LAZY);
+  sexp_emit_word(ctx2, (sexp_uint_t)info);
+  bytecode_preserve(ctx2, info);
+  res = sexp_complete_bytecode(ctx2);
+  sexp_gc_release2(ctx);
+  return res;
+}
+
+/* called from the stub: replace the procedure's code with the */
+/* compiled body and return it */
+#define sexp_lazy_info_ref(info, i) \
+  (sexp_not(sexp_vector_ref(info, i)) ? NULL : sexp_vector_ref(info, i))
+
+static sexp sexp_compile_lazy (sexp ctx, sexp proc, sexp info) {
+  sexp lambda = sexp_vector_ref(info, SEXP_ZERO), res;
+  int phase;
+  sexp_gc_var1(ctx2);
+  sexp_gc_preserve1(ctx, ctx2);
+  sexp_load_phase_begin(phase, SEXP_LOAD_PHASE_GENERATE);
+  ctx2 = sexp_make_eval_context(ctx, sexp_context_stack(ctx), sexp_vector_ref(info, SEXP_FOUR), 0, 0);
+  if (sexp_exceptionp(ctx2)) {
+    res = ctx2;
+  } else {
+    res = generate_lambda_code(ctx2, sexp_lazy_info_ref(info, SEXP_ONE),
+                               sexp_lazy_info_ref(info, SEXP_TWO),
+                               sexp_lazy_info_ref(info, SEXP_THREE), lambda);
+    if (!sexp_exceptionp(res)) {
+      sexp_bytecode_name(res) = sexp_lambda_name(lambda);
+#if ! SEXP_USE_FULL_SOURCE_INFO
+      sexp_bytecode_source(res) = sexp_lambda_source(lambda);
+#endif
+      sexp_procedure_code(proc) = res;
+    }
+  }
+  sexp_load_phase_end(phase);
+  sexp_gc_release1(ctx);
+  return res;
+}
+#endif
+
+static void generate_lambda (sexp ctx, sexp name, sexp loc, sexp lam, sexp lambda) {
+  sexp fv, flags, len, ref, prev_lambda;
+  sexp_sint_t k;
+  sexp_gc_var2(tmp, bc);
+  if (sexp_exceptionp(sexp_context_exception(ctx)))
+    return;
+  prev_lambda = sexp_context_lambda(ctx);
+  fv = sexp_lambda_fv(lambda);
+  sexp_gc_preserve2(ctx, tmp, bc);
+#if SEXP_USE_LAZY_LOAD
+  if (sexp_nullp(fv) && !sexp_lambdap(prev_lambda)
+      && sexp_truep(sexp_global(ctx, SEXP_G_LAZY_LOAD_P))
+#if SEXP_USE_FASL
+      && sexp_not(sexp_global(ctx, SEXP_G_FASL_P))
+#endif
+      )
+    bc = generate_lazy_stub(ctx, name, loc, lam, lambda);
+  else
+#endif
+  bc = generate_lambda_code(ctx, name, loc, lam, lambda);
   flags = sexp_make_fixnum(sexp_not(sexp_listp(ctx, sexp_lambda_params(lambda)))
                            ? (SEXP_PROC_VARIADIC + (sexp_rest_unused_p(lambda)
                                                     ? SEXP_PROC_UNUSED_REST: 0))
                            : SEXP_PROC_NONE);
-  len = sexp_length(ctx2, sexp_lambda_params(lambda));
-  bc = sexp_complete_bytecode(ctx2);
+  len = sexp_length(ctx, sexp_lambda_params(lambda));
   if (sexp_exceptionp(bc)) {
     sexp_context_exception(ctx) = bc;
   } else {
@@ -683,8 +817,8 @@ static void generate_lambda (sexp ctx, sexp name, sexp loc, sexp lam, sexp lambd
 #endif
   if (sexp_nullp(fv)) {
     /* shortcut, no free vars */
-    tmp = sexp_make_vector(ctx2, SEXP_ZERO, SEXP_VOID);
-    tmp = sexp_make_procedure(ctx2, flags, len, bc, tmp);
+    tmp = sexp_make_vector(ctx, SEXP_ZERO, SEXP_VOID);
+    tmp = sexp_make_procedure(ctx, flags, len, bc, tmp);
     bytecode_preserve(ctx, tmp);
     generate_lit(ctx, tmp);
   } else {
@@ -696,10 +830,10 @@ static void generate_lambda (sexp ctx, sexp name, sexp loc, sexp lam, sexp lambd
     for (k=0; sexp_pairp(fv); fv=sexp_cdr(fv), k++) {
       ref = sexp_car(fv);
       generate_non_global_ref(ctx, sexp_ref_name(ref), sexp_ref_cell(ref),
-                              prev_lambda, prev_fv, 0);
+                              prev_lambda, 0);
       sexp_emit_push(ctx, sexp_make_fixnum(k));
       sexp_emit(ctx, SEXP_OP_STACK_REF);
-      sexp_emit_word(ctx, 3);
+      sexp_emit_operand(ctx, 3);
       sexp_emit(ctx, SEXP_OP_VECTOR_SET);
       sexp_inc_context_depth(ctx, -1);
     }
@@ -861,12 +995,12 @@ static sexp sexp_restore_stack (sexp ctx, sexp saved) {
 #endif
 
 #define _WORD0 ((sexp*)ip)[0]
-#define _UWORD0 ((sexp_uint_t*)ip)[0]
-#define _SWORD0 ((sexp_sint_t*)ip)[0]
 #define _WORD1 ((sexp*)ip)[1]
-#define _UWORD1 ((sexp_uint_t*)ip)[1]
-#define _SWORD1 ((sexp_sint_t*)ip)[1]
+#define _OPERAND0 ((sexp_operand_t*)ip)[0]
+#define _OPERAND1 ((sexp_operand_t*)ip)[1]
 #define _WORD2 ((sexp*)ip)[2]
+/* words following a single integer operand */
+#define _OPERAND_WORD0 ((sexp*)(ip+sizeof(sexp_operand_t)))[0]
 
 #define sexp_raise(msg, args)                                       \
   do {sexp_context_top(ctx) = top+1;                                \
@@ -984,6 +1118,20 @@ static void* sexp_thread_debug_event(sexp ctx) {
 #define sexp_ensure_stack(n)
 #endif
 
+/* push a call frame for the procedure tmp1 applied to the i args */
+/* on the stack, and jump to its code */
+#define sexp_enter_procedure()                                          \
+  _ARG1 = sexp_make_fixnum(i);                                          \
+  stack[top] = sexp_make_fixnum(ip+sizeof(sexp_operand_t)-sexp_bytecode_data(bc)); \
+  stack[top+1] = self;                                                  \
+  stack[top+2] = sexp_make_fixnum(fp);                                  \
+  top += 3;                                                             \
+  self = tmp1;                                                          \
+  bc = sexp_procedure_code(self);                                       \
+  ip = sexp_bytecode_data(bc);                                          \
+  cp = sexp_procedure_vars(self);                                       \
+  fp = top-4;
+
 /* used only when no thread scheduler has been loaded */
 #if SEXP_USE_POLL_PORT
 int sexp_poll_port(sexp ctx, sexp port, int inputp) {
@@ -1003,6 +1151,7 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
   unsigned char *ip;
   sexp bc, cp, *stack = sexp_stack_data(sexp_context_stack(ctx)), tmp;
   sexp_sint_t i, j, k, fp, top = sexp_stack_top(sexp_context_stack(ctx));
+  int knownp = 0;
 #if SEXP_USE_GREEN_THREADS
   sexp root_thread = ctx;
   sexp_sint_t fuel = sexp_context_refuel(ctx);
@@ -1019,7 +1168,7 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
   self = sexp_global(ctx, SEXP_G_FINAL_RESUMER);
   bc = sexp_procedure_code(self);
   cp = sexp_procedure_vars(self);
-  ip = sexp_bytecode_data(bc) - sizeof(sexp);
+  ip = sexp_bytecode_data(bc) - sizeof(sexp_operand_t);
   tmp1 = proc, tmp2 = args;
   i = sexp_unbox_fixnum(sexp_length(ctx, tmp2));
   sexp_ensure_stack(i + 64 + (sexp_procedurep(tmp1) ? sexp_bytecode_max_depth(sexp_procedure_code(tmp1)) : 0));
@@ -1173,7 +1322,7 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
                                 sexp_global(ctx, SEXP_G_RESUMECC_BYTECODE),
                                 tmp2);
     top++;
-    ip -= sizeof(sexp);
+    ip -= sizeof(sexp_operand_t);
     goto make_call;
   case SEXP_OP_APPLY1:
     tmp1 = _ARG1;
@@ -1189,7 +1338,7 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
     self = stack[fp+2];
     bc = sexp_procedure_code(self);
     cp = sexp_procedure_vars(self);
-    ip = (sexp_bytecode_data(bc)+sexp_unbox_fixnum(stack[fp+1])) - sizeof(sexp);
+    ip = (sexp_bytecode_data(bc)+sexp_unbox_fixnum(stack[fp+1])) - sizeof(sexp_operand_t);
     {
       int prev_top = top;
       for (top=fp-j+i-1; sexp_pairp(tmp2); tmp2=sexp_cdr(tmp2), top--)
@@ -1203,26 +1352,47 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
       }
     }
     goto make_call;
+  case SEXP_OP_TAIL_CALL_KNOWN:
+    _ALIGN_IP();
+    i = _OPERAND0;
+    tmp1 = sexp_cdr(_OPERAND_WORD0);
+    knownp = sexp_known_procedurep(tmp1, i);  /* fallback if the global was mutated */
+    _PUSH(tmp1);
+    goto tail_call;
   case SEXP_OP_TAIL_CALL:
     _ALIGN_IP();
-    i = sexp_unbox_fixnum(_WORD0);             /* number of params */
+    i = _OPERAND0;                             /* number of params */
     tmp1 = _ARG1;                              /* procedure to call */
+  tail_call:
     /* save frame info */
     tmp2 = stack[fp+3];                        /* previous fp */
     j = sexp_unbox_fixnum(stack[fp]);          /* previous num params */
     self = stack[fp+2];
     bc = sexp_procedure_code(self);
     cp = sexp_procedure_vars(self);
-    ip = (sexp_bytecode_data(bc)+sexp_unbox_fixnum(stack[fp+1])) - sizeof(sexp);
+    ip = (sexp_bytecode_data(bc)+sexp_unbox_fixnum(stack[fp+1])) - sizeof(sexp_operand_t);
     /* copy new args into place */
     for (k=0; k<i; k++)
       stack[fp-j+k] = stack[top-1-i+k];
     top = fp+i-j+1;
     fp = sexp_unbox_fixnum(tmp2);
+    if (knownp) {
+      knownp = 0;
+      goto make_known_call;
+    }
     goto make_call;
+  case SEXP_OP_CALL_KNOWN:
+    _ALIGN_IP();
+    i = _OPERAND0;
+    tmp1 = sexp_cdr(_OPERAND_WORD0);
+    _PUSH(tmp1);
+    ip += sizeof(sexp);  /* make_call skips the operand */
+    if (sexp_known_procedurep(tmp1, i))
+      goto make_known_call;
+    goto make_call;  /* fallback if the global was mutated */
   case SEXP_OP_CALL:
     _ALIGN_IP();
-    i = sexp_unbox_fixnum(_WORD0);
+    i = _OPERAND0;
     tmp1 = _ARG1;
   make_call:
     sexp_context_top(ctx) = top;
@@ -1265,17 +1435,30 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
       top++;
       i++;
     }
-    _ARG1 = sexp_make_fixnum(i);
-    stack[top] = sexp_make_fixnum(ip+sizeof(sexp)-sexp_bytecode_data(bc));
-    stack[top+1] = self;
-    stack[top+2] = sexp_make_fixnum(fp);
-    top += 3;
-    self = tmp1;
-    bc = sexp_procedure_code(self);
+    sexp_enter_procedure();
+    break;
+  make_known_call:
+    /* applicability and arity were checked by the caller */
+    sexp_context_top(ctx) = top;
+    sexp_ensure_stack(sexp_bytecode_max_depth(sexp_procedure_code(tmp1))+64);
+    sexp_enter_procedure();
+    break;
+#if SEXP_USE_LAZY_LOAD
+  case SEXP_OP_COMPILE_LAZY:
+    /* first call of a lazily compiled procedure, the frame is */
+    /* already set up so just switch to the real code */
+    _ALIGN_IP();
+    sexp_context_top(ctx) = top;
+    tmp1 = sexp_compile_lazy(ctx, self, _WORD0);
+    if (sexp_exceptionp(tmp1)) {
+      _PUSH(tmp1);
+      goto call_error_handler;
+    }
+    bc = tmp1;
+    sexp_ensure_stack(sexp_bytecode_max_depth(bc)+64);
     ip = sexp_bytecode_data(bc);
-    cp = sexp_procedure_vars(self);
-    fp = top-4;
     break;
+#endif
   case SEXP_OP_FCALL0:
     _ALIGN_IP();
     sexp_context_top(ctx) = top;
@@ -1324,13 +1507,13 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
   case SEXP_OP_JUMP_UNLESS:
     _ALIGN_IP();
     if (stack[--top] == SEXP_FALSE)
-      ip += _SWORD0;
+      ip += _OPERAND0;
     else
-      ip += sizeof(sexp_sint_t);
+      ip += sizeof(sexp_operand_t);
     break;
   case SEXP_OP_JUMP:
     _ALIGN_IP();
-    ip += _SWORD0;
+    ip += _OPERAND0;
     break;
   case SEXP_OP_PUSH:
     _ALIGN_IP();
@@ -1340,9 +1523,9 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
 #if SEXP_USE_RESERVE_OPCODE
   case SEXP_OP_RESERVE:
     _ALIGN_IP();
-    for (i=_SWORD0; i > 0; i--)
+    for (i=_OPERAND0; i > 0; i--)
       stack[top++] = SEXP_VOID;
-    ip += sizeof(sexp);
+    ip += sizeof(sexp_operand_t);
     break;
 #endif
   case SEXP_OP_DROP:
@@ -1382,25 +1565,25 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
 #endif
   case SEXP_OP_STACK_REF:
     _ALIGN_IP();
-    stack[top] = stack[top - _SWORD0];
-    ip += sizeof(sexp);
+    stack[top] = stack[top - _OPERAND0];
+    ip += sizeof(sexp_operand_t);
     top++;
     break;
   case SEXP_OP_LOCAL_REF:
     _ALIGN_IP();
-    stack[top] = stack[fp - 1 - _SWORD0];
-    ip += sizeof(sexp);
+    stack[top] = stack[fp - 1 - _OPERAND0];
+    ip += sizeof(sexp_operand_t);
     top++;
     break;
   case SEXP_OP_LOCAL_SET:
     _ALIGN_IP();
-    stack[fp - 1 - _SWORD0] = _POP();
-    ip += sizeof(sexp);
+    stack[fp - 1 - _OPERAND0] = _POP();
+    ip += sizeof(sexp_operand_t);
     break;
   case SEXP_OP_CLOSURE_REF:
     _ALIGN_IP();
-    _PUSH(sexp_vector_ref(cp, sexp_make_fixnum(_SWORD0)));
-    ip += sizeof(sexp);
+    _PUSH(sexp_vector_ref(cp, sexp_make_fixnum(_OPERAND0)));
+    ip += sizeof(sexp_operand_t);
     break;
   case SEXP_OP_CLOSURE_VARS:
     _ARG1 = sexp_procedure_vars(_ARG1);
@@ -1567,35 +1750,35 @@ sexp sexp_apply (sexp ctx, sexp proc, sexp args) {
     goto do_check_type;
   case SEXP_OP_TYPEP:
     _ALIGN_IP();
-    tmp1 = _ARG1, tmp2 = sexp_type_by_index(ctx, _UWORD0);
-    ip += sizeof(sexp);
+    tmp1 = _ARG1, tmp2 = sexp_type_by_index(ctx, _OPERAND0);
+    ip += sizeof(sexp_operand_t);
   do_check_type:
     _ARG1 = sexp_make_boolean(sexp_check_type(ctx, tmp1, tmp2));
     break;
   case SEXP_OP_MAKE:
     _ALIGN_IP();
     sexp_context_top(ctx) = top;
-    _PUSH(sexp_alloc_tagged(ctx, _UWORD1, _UWORD0));
+    _PUSH(sexp_alloc_tagged(ctx, _OPERAND1, _OPERAND0));
     /* initialize fields to void */
-    for (i=(_UWORD1-sexp_sizeof_header)/sizeof(sexp_uint_t) - 1; i>=0; i--)
+    for (i=(_OPERAND1-sexp_sizeof_header)/sizeof(sexp_uint_t) - 1; i>=0; i--)
       sexp_slot_set(_ARG1, i, SEXP_VOID);
-    ip += sizeof(sexp)*2;
+    ip += sizeof(sexp_operand_t)*2;
     break;
   case SEXP_OP_SLOT_REF:
     _ALIGN_IP();
-    if (! sexp_check_type(ctx, _ARG1, sexp_type_by_index(ctx, _UWORD0)))
-      sexp_raise("slot-ref: bad type", sexp_list2(ctx, sexp_type_name_by_index(ctx, _UWORD0), _ARG1));
-    _ARG1 = sexp_slot_ref(_ARG1, _UWORD1);
-    ip += sizeof(sexp)*2;
+    if (! sexp_check_type(ctx, _ARG1, sexp_type_by_index(ctx, _OPERAND0)))
+      sexp_raise("slot-ref: bad type", sexp_list2(ctx, sexp_type_name_by_index(ctx, _OPERAND0), _ARG1));
+    _ARG1 = sexp_slot_ref(_ARG1, _OPERAND1);
+    ip += sizeof(sexp_operand_t)*2;
     break;
   case SEXP_OP_SLOT_SET:
     _ALIGN_IP();
-    if (! sexp_check_type(ctx, _ARG1, sexp_type_by_index(ctx, _UWORD0)))
-      sexp_raise("slot-set!: bad type", sexp_list2(ctx, sexp_type_name_by_index(ctx, _UWORD0), _ARG1));
+    if (! sexp_check_type(ctx, _ARG1, sexp_type_by_index(ctx, _OPERAND0)))
+      sexp_raise("slot-set!: bad type", sexp_list2(ctx, sexp_type_name_by_index(ctx, _OPERAND0), _ARG1));
     else if (sexp_immutablep(_ARG1))
       sexp_raise("slot-set!: immutable object", sexp_list1(ctx, _ARG1));
-    sexp_slot_set(_ARG1, _UWORD1, _ARG2);
-    ip += sizeof(sexp)*2;
+    sexp_slot_set(_ARG1, _OPERAND1, _ARG2);
+    ip += sizeof(sexp_operand_t)*2;
     top-=2;
     break;
   case SEXP_OP_SLOTN_REF: